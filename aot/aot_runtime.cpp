@@ -0,0 +1,55 @@
+#include "common/logs.h"
+#include "aot/aot_runtime.h"
+#include "assembler/asm2byte/asm2byte.h"
+#include "runtime/runtime.h"
+
+#include <cstdlib>
+
+namespace evm::aot {
+
+bool ExecuteCompiledProgram(file_format::File *file, const char *asm_source, const byte_t *bytecode,
+                            size_t bytecode_size, runtime::Interpreter::CompiledFunction entry)
+{
+    asm2byte::AsmToByte asm2byte;
+    if (!asm2byte.ParseAsmString(asm_source, file)) {
+        PrintErr("Error when assembling embedded source of compiled program");
+        return false;
+    }
+
+    auto *runtime = runtime::Runtime::GetInstance();
+    if (runtime == nullptr) {
+        PrintErr("Runtime should be created before execution of compiled program");
+        return false;
+    }
+
+    return runtime->ExecuteCompiled(file, bytecode, bytecode_size, entry);
+}
+
+int CompiledMain(CompiledProgram program)
+{
+    if (!runtime::Runtime::Create()) {
+        PrintErr("Failed to create runtime");
+        return EXIT_FAILURE;
+    }
+
+    file_format::File file;
+    bool executed = program(&file);
+
+    runtime::Runtime::Destroy();
+
+    return executed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+void ReportUncompiledCall(size_t pc)
+{
+    PrintErr("Call of pc ", pc, " which is not an entry of any compiled function");
+    UNREACHABLE();
+}
+
+void ReportInvalidJump(size_t pc)
+{
+    PrintErr("Jump to pc ", pc, " which is not an instruction of compiled function");
+    UNREACHABLE();
+}
+
+} // namespace evm::aot
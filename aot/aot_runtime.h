@@ -0,0 +1,29 @@
+#ifndef EVM_AOT_AOT_RUNTIME_H
+#define EVM_AOT_AOT_RUNTIME_H
+
+#include "common/constants.h"
+#include "file_format/file.h"
+#include "runtime/interpreter/interpreter.h"
+
+#include <cstddef>
+
+namespace evm::aot {
+
+// Support functions for code generated by evm-aot
+
+using CompiledProgram = bool (*)(file_format::File *file);
+
+/// Assemble embedded source into file and execute compiled entry in the existing runtime.
+/// bytecode is the one which was compiled, it should be the same as the one assembled now.
+bool ExecuteCompiledProgram(file_format::File *file, const char *asm_source, const byte_t *bytecode,
+                            size_t bytecode_size, runtime::Interpreter::CompiledFunction entry);
+
+/// main() of compiled program: creates runtime and executes program
+int CompiledMain(CompiledProgram program);
+
+void ReportUncompiledCall(size_t pc);
+void ReportInvalidJump(size_t pc);
+
+} // namespace evm::aot
+
+#endif // EVM_AOT_AOT_RUNTIME_H
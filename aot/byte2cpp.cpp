@@ -0,0 +1,415 @@
+#include "common/logs.h"
+#include "aot/byte2cpp.h"
+
+#include <cstring>
+#include <iomanip>
+#include <queue>
+#include <sstream>
+
+namespace evm::aot {
+
+bool ByteToCpp::Generate(file_format::File *file, const std::string &asm_source, std::ostream &out)
+{
+    assert(file != nullptr);
+
+    if (!CollectInstructions(file)) {
+        return false;
+    }
+    CollectFunctionEntries(file);
+
+    std::vector<Function> functions;
+    for (size_t entry : function_entries_) {
+        Function function;
+        function.entry = entry;
+        if (!CollectFunctionBody(&function)) {
+            PrintErr("Cannot compile function at pc ", entry);
+            return false;
+        }
+        functions.push_back(std::move(function));
+    }
+
+    EmitPrologue(out);
+    EmitData(asm_source, out);
+
+    for (const auto &function : functions) {
+        out << "static bool " << GetFunctionName(function.entry) << "(runtime::Interpreter *interp, "
+            << "file_format::File *file);\n";
+    }
+
+    out << "\n// Dispatch of call instruction: call target is a register value, so it is known only at runtime\n"
+        << "static bool CallFunction(runtime::Interpreter *interp, file_format::File *file, size_t pc)\n"
+        << "{\n"
+        << "    switch (pc) {\n";
+    for (size_t entry : function_entries_) {
+        out << "        case " << entry << ":\n"
+            << "            return " << GetFunctionName(entry) << "(interp, file);\n";
+    }
+    out << "        default:\n"
+        << "            break;\n"
+        << "    }\n\n"
+        << "    aot::ReportUncompiledCall(pc);\n"
+        << "    return true;\n"
+        << "}\n\n";
+
+    for (const auto &function : functions) {
+        EmitFunction(function, out);
+    }
+
+    EmitEpilogue(out);
+
+    return static_cast<bool>(out);
+}
+
+bool ByteToCpp::CollectInstructions(file_format::File *file)
+{
+    bytecode_.clear();
+    instrs_.clear();
+
+    if (!file->ResolveDependencies()) {
+        PrintErr("File should be assembled before compilation");
+        return false;
+    }
+
+    file->EmitBytecode(&bytecode_);
+
+    auto *code_section = file->GetCodeSection();
+    entrypoint_ = code_section->GetOffset();
+
+    for (const auto &instr : code_section->GetInstructions()) {
+        size_t pc = entrypoint_ + instr.GetOffset();
+        instrs_.insert({pc, InstrInfo {instr.GetOpcode(), instr.GetBytesSize()}});
+    }
+
+    if (instrs_.empty()) {
+        PrintErr("Code section is empty");
+        return false;
+    }
+
+    return true;
+}
+
+void ByteToCpp::CollectFunctionEntries(file_format::File *file)
+{
+    function_entries_.clear();
+    function_entries_.push_back(entrypoint_);
+
+    std::set<size_t> label_pcs;
+    for (const auto &[name, offset] : file->GetCodeSection()->GetLabels()) {
+        label_pcs.insert(entrypoint_ + offset);
+    }
+
+    // Functions are called through register, which is set by movif with label as immediate
+    std::set<size_t> entries;
+    for (const auto &[pc, info] : instrs_) {
+        if (info.opcode != Opcode::MOVIF) {
+            continue;
+        }
+
+        int64_t imm = GetImm64(pc);
+        if (imm > 0 && label_pcs.count(imm) != 0 && static_cast<size_t>(imm) != entrypoint_) {
+            entries.insert(static_cast<size_t>(imm));
+        }
+    }
+
+    function_entries_.insert(function_entries_.end(), entries.begin(), entries.end());
+}
+
+void ByteToCpp::GetStaticSuccessors(size_t pc, std::vector<size_t> *successors, bool *is_dynamic) const
+{
+    const auto &info = instrs_.at(pc);
+    *is_dynamic = false;
+
+    switch (info.opcode) {
+        case Opcode::EXIT:
+        case Opcode::RET:
+            return;
+
+        case Opcode::JMP:
+        case Opcode::JMP_REL:
+        case Opcode::JMP_IF:
+            // Target is a register value
+            *is_dynamic = true;
+            if (info.opcode == Opcode::JMP_IF) {
+                successors->push_back(pc + info.size);
+            }
+            return;
+
+        case Opcode::JMP_IMM:
+            successors->push_back(pc + GetImm32(pc));
+            return;
+
+        case Opcode::JMP_IF_IMM:
+            successors->push_back(pc + GetImm32(pc));
+            successors->push_back(pc + info.size);
+            return;
+
+        case Opcode::CALL:
+            // Interpreter restores pc of the caller as pc of call + 8
+            successors->push_back(pc + 0x8);
+            return;
+
+        default:
+            successors->push_back(pc + info.size);
+            return;
+    }
+}
+
+bool ByteToCpp::CollectFunctionBody(Function *function) const
+{
+    std::queue<size_t> worklist;
+    worklist.push(function->entry);
+    function->instrs.insert(function->entry);
+
+    while (!worklist.empty()) {
+        size_t pc = worklist.front();
+        worklist.pop();
+
+        std::vector<size_t> successors;
+        bool is_dynamic = false;
+        GetStaticSuccessors(pc, &successors, &is_dynamic);
+
+        if (is_dynamic && !function->has_dynamic_jumps) {
+            // Any instruction may be a target of dynamic jump
+            function->has_dynamic_jumps = true;
+            for (const auto &it : instrs_) {
+                if (function->instrs.insert(it.first).second) {
+                    worklist.push(it.first);
+                }
+            }
+        }
+
+        for (size_t successor : successors) {
+            if (instrs_.count(successor) == 0) {
+                PrintErr("Control flow from pc ", pc, " goes to ", successor, " which is not an instruction");
+                return false;
+            }
+            if (function->instrs.insert(successor).second) {
+                worklist.push(successor);
+            }
+        }
+    }
+
+    return true;
+}
+
+int64_t ByteToCpp::GetImm64(size_t pc) const
+{
+    int64_t imm = 0;
+    std::memcpy(&imm, bytecode_.data() + pc + ISA_INSTR_SIZE, sizeof(imm));
+    return imm;
+}
+
+int32_t ByteToCpp::GetImm32(size_t pc) const
+{
+    int32_t imm = 0;
+    std::memcpy(&imm, bytecode_.data() + pc + ISA_INSTR_SIZE, sizeof(imm));
+    return imm;
+}
+
+void ByteToCpp::EmitPrologue(std::ostream &out) const
+{
+    out << "// Generated by evm-aot, do not edit\n\n"
+        << "#include \"aot/aot_runtime.h\"\n"
+        << "#include \"runtime/interpreter/interpreter_compiled-inl.h\"\n\n"
+        << "namespace evm::compiled {\n\n";
+}
+
+void ByteToCpp::EmitData(const std::string &asm_source, std::ostream &out) const
+{
+    static constexpr size_t BYTES_PER_LINE = 16;
+
+    out << "static const char ASM_SOURCE[] =";
+    out << "\n    \"";
+    for (char c : asm_source) {
+        switch (c) {
+            case '\n':
+                out << "\\n\"\n    \"";
+                break;
+            case '\\':
+                out << "\\\\";
+                break;
+            case '"':
+                out << "\\\"";
+                break;
+            case '\t':
+                out << "\\t";
+                break;
+            default:
+                if (std::isprint(static_cast<unsigned char>(c))) {
+                    out << c;
+                } else {
+                    out << "\\" << std::oct << std::setw(3) << std::setfill('0')
+                        << static_cast<int>(static_cast<unsigned char>(c)) << std::dec;
+                }
+        }
+    }
+    out << "\";\n\n";
+
+    // Operands are read from this array with constant offsets, so C++ compiler folds them
+    out << "static const byte_t BYTECODE[] = {";
+    for (size_t i = 0; i < bytecode_.size(); ++i) {
+        out << ((i % BYTES_PER_LINE == 0) ? "\n    " : " ") << "0x" << std::hex << std::setw(2) << std::setfill('0')
+            << static_cast<int>(bytecode_[i]) << std::dec << ",";
+    }
+    out << "\n};\n\n";
+}
+
+void ByteToCpp::EmitFunction(const Function &function, std::ostream &out) const
+{
+    // Entry is emitted first: instructions before it in the bytecode are reachable only by jumps
+    std::vector<size_t> order;
+    order.push_back(function.entry);
+    for (size_t pc : function.instrs) {
+        if (pc != function.entry) {
+            order.push_back(pc);
+        }
+    }
+
+    // Labels are emitted only for pcs which are targets of some goto
+    std::set<size_t> goto_targets;
+    std::vector<std::string> instrs_code;
+
+    auto emit_goto = [&goto_targets](std::ostream &code, size_t target, const char *indent) {
+        goto_targets.insert(target);
+        code << indent << "goto " << GetLabelName(target) << ";\n";
+    };
+
+    for (size_t i = 0; i < order.size(); ++i) {
+        size_t pc = order[i];
+        const auto &info = instrs_.at(pc);
+        size_t next_pc = (info.opcode == Opcode::CALL) ? pc + 0x8 : pc + info.size;
+        bool next_is_adjacent = (i + 1 < order.size()) && (order[i + 1] == next_pc);
+
+        std::ostringstream code;
+        code << "    interp->Exec" << GetInstrName(info.opcode) << "(file, BYTECODE, " << pc << ");\n";
+
+        switch (info.opcode) {
+            case Opcode::EXIT:
+                code << "    return true;\n";
+                break;
+
+            case Opcode::RET:
+                code << "    runtime::CompiledSafepoint();\n"
+                     << "    return false;\n";
+                break;
+
+            case Opcode::CALL:
+                code << "    runtime::CompiledSafepoint();\n"
+                     << "    if (CallFunction(interp, file, interp->GetPC())) {\n"
+                     << "        return true;\n"
+                     << "    }\n";
+                if (!next_is_adjacent) {
+                    emit_goto(code, next_pc, "    ");
+                }
+                break;
+
+            case Opcode::JMP_IMM:
+                code << "    runtime::CompiledSafepoint();\n";
+                emit_goto(code, pc + GetImm32(pc), "    ");
+                break;
+
+            case Opcode::JMP_IF_IMM:
+                code << "    runtime::CompiledSafepoint();\n"
+                     << "    if (interp->GetPC() == " << pc + GetImm32(pc) << ") {\n";
+                emit_goto(code, pc + GetImm32(pc), "        ");
+                code << "    }\n";
+                if (!next_is_adjacent) {
+                    emit_goto(code, next_pc, "    ");
+                }
+                break;
+
+            case Opcode::JMP:
+            case Opcode::JMP_REL:
+            case Opcode::JMP_IF:
+                code << "    runtime::CompiledSafepoint();\n"
+                     << "    goto dispatch;\n";
+                break;
+
+            default:
+                code << "    runtime::CompiledSafepoint();\n";
+                if (!next_is_adjacent) {
+                    emit_goto(code, next_pc, "    ");
+                }
+                break;
+        }
+
+        instrs_code.push_back(code.str());
+    }
+
+    std::ostringstream dispatch;
+    if (function.has_dynamic_jumps) {
+        dispatch << "dispatch:\n"
+                 << "    switch (interp->GetPC()) {\n";
+        for (size_t pc : function.instrs) {
+            dispatch << "        case " << pc << ":\n";
+            emit_goto(dispatch, pc, "            ");
+        }
+        dispatch << "        default:\n"
+                 << "            break;\n"
+                 << "    }\n\n"
+                 << "    aot::ReportInvalidJump(interp->GetPC());\n"
+                 << "    return true;\n";
+    }
+
+    out << "static bool " << GetFunctionName(function.entry) << "(runtime::Interpreter *interp, "
+        << "[[maybe_unused]] file_format::File *file)\n{\n";
+
+    for (size_t i = 0; i < order.size(); ++i) {
+        if (goto_targets.count(order[i]) != 0) {
+            out << GetLabelName(order[i]) << ":\n";
+        }
+        out << instrs_code[i];
+    }
+    out << dispatch.str();
+
+    out << "}\n\n";
+}
+
+void ByteToCpp::EmitEpilogue(std::ostream &out) const
+{
+    out << "bool RunCompiledProgram(file_format::File *file)\n"
+        << "{\n"
+        << "    return aot::ExecuteCompiledProgram(file, ASM_SOURCE, BYTECODE, sizeof(BYTECODE), "
+        << GetFunctionName(entrypoint_) << ");\n"
+        << "}\n\n"
+        << "} // namespace evm::compiled\n\n"
+        << "#ifndef EVM_AOT_NO_MAIN\n"
+        << "int main()\n"
+        << "{\n"
+        << "    return evm::aot::CompiledMain(evm::compiled::RunCompiledProgram);\n"
+        << "}\n"
+        << "#endif // EVM_AOT_NO_MAIN\n";
+}
+
+/* static */
+const char *ByteToCpp::GetInstrName(Opcode opcode)
+{
+    // clang-format off
+    #define DEFINE_INSTR(instr, opcode, interpret) \
+    case opcode:                                   \
+        return #instr;
+
+    switch (opcode) {
+        #include "isa/isa.def"
+
+        default:
+            return "INVALID";
+    }
+
+    #undef DEFINE_INSTR
+    // clang-format on
+}
+
+/* static */
+std::string ByteToCpp::GetFunctionName(size_t pc)
+{
+    return "Function_" + std::to_string(pc);
+}
+
+/* static */
+std::string ByteToCpp::GetLabelName(size_t pc)
+{
+    return "L_" + std::to_string(pc);
+}
+
+} // namespace evm::aot
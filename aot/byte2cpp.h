@@ -0,0 +1,76 @@
+#ifndef EVM_AOT_BYTE_TO_CPP_H
+#define EVM_AOT_BYTE_TO_CPP_H
+
+#include "common/macros.h"
+#include "common/constants.h"
+#include "file_format/file.h"
+#include "isa/opcodes.h"
+
+#include <map>
+#include <ostream>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace evm::aot {
+
+/// Ahead-of-time compiler: translates assembled file to C++ translation unit.
+/// Every instruction becomes a call of Interpreter::Exec<INSTR> with constant pc, jumps become gotos
+/// between labels and every call target becomes a separate C++ function.
+class ByteToCpp {
+public:
+    NO_COPY_SEMANTIC(ByteToCpp);
+    NO_MOVE_SEMANTIC(ByteToCpp);
+
+    ByteToCpp() = default;
+    ~ByteToCpp() = default;
+
+    /// asm_source is embedded into generated code: it is assembled again at startup
+    /// to recreate class descriptions and string pool for runtime
+    bool Generate(file_format::File *file, const std::string &asm_source, std::ostream &out);
+
+    /// Pcs of function entries, the first one is entrypoint of the program
+    const std::vector<size_t> &GetFunctionEntries() const
+    {
+        return function_entries_;
+    }
+
+private:
+    struct InstrInfo {
+        Opcode opcode {Opcode::INVALID};
+        size_t size {0};
+    };
+
+    struct Function {
+        size_t entry {0};
+        std::set<size_t> instrs;
+        bool has_dynamic_jumps {false};
+    };
+
+    bool CollectInstructions(file_format::File *file);
+    void CollectFunctionEntries(file_format::File *file);
+    bool CollectFunctionBody(Function *function) const;
+    void GetStaticSuccessors(size_t pc, std::vector<size_t> *successors, bool *is_dynamic) const;
+
+    int64_t GetImm64(size_t pc) const;
+    int32_t GetImm32(size_t pc) const;
+
+    void EmitPrologue(std::ostream &out) const;
+    void EmitData(const std::string &asm_source, std::ostream &out) const;
+    void EmitFunction(const Function &function, std::ostream &out) const;
+    void EmitEpilogue(std::ostream &out) const;
+
+    static const char *GetInstrName(Opcode opcode);
+    static std::string GetFunctionName(size_t pc);
+    static std::string GetLabelName(size_t pc);
+
+private:
+    std::vector<byte_t> bytecode_;
+    std::map<size_t, InstrInfo> instrs_; // absolute pc -> instruction
+    std::vector<size_t> function_entries_;
+    size_t entrypoint_ {0};
+};
+
+} // namespace evm::aot
+
+#endif // EVM_AOT_BYTE_TO_CPP_H
@@ -0,0 +1,54 @@
+#include "common/logs.h"
+#include "aot/byte2cpp.h"
+#include "assembler/asm2byte/asm2byte.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace evm::aot {
+
+int Main(int argc, char *argv[])
+{
+    if (argc != 3) {
+        PrintErr("Usage: evm-aot <input.ea> <output.cpp>");
+        return EXIT_FAILURE;
+    }
+
+    std::ifstream input(argv[1]);
+    if (!input) {
+        PrintErr("Cannot open file '", argv[1], "'");
+        return EXIT_FAILURE;
+    }
+
+    std::stringstream source;
+    source << input.rdbuf();
+
+    file_format::File file;
+    asm2byte::AsmToByte asm2byte;
+    if (!asm2byte.ParseAsmString(source.str(), &file)) {
+        PrintErr("Error when parsing asm file '", argv[1], "'");
+        return EXIT_FAILURE;
+    }
+
+    std::ofstream output(argv[2]);
+    if (!output) {
+        PrintErr("Cannot open file '", argv[2], "'");
+        return EXIT_FAILURE;
+    }
+
+    ByteToCpp byte2cpp;
+    if (!byte2cpp.Generate(&file, source.str(), output)) {
+        PrintErr("Error when compiling file '", argv[1], "'");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+} // namespace evm::aot
+
+int main(int argc, char *argv[])
+{
+    return evm::aot::Main(argc, argv);
+}
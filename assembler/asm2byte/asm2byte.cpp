@@ -1,6 +1,8 @@
 #include "common/logs.h"
 #include "common/opcode_to_str.h"
+#include "common/perf_counters.h"
 #include "common/str_to_opcode.h"
+#include "common/trace.h"
 #include "common/utils/string_operations.h"
 #include "file_format/class_section.h"
 #include "runtime/memory/type.h"
@@ -10,124 +12,239 @@
 #include "file_format/instruction.h"
 #include "asm2byte.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstdlib>
-#include <fstream>
+#include <cstring>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 namespace evm::asm2byte {
 
-bool AsmToByte::ParseAsm(file_format::File *file_arch)
+bool AsmToByte::ParseAsm(const std::vector<std::string_view> &sources, file_format::File *file_arch)
 {
-    PrepareLinesFromBuffer();
+    perf::ScopedPerfPhase perf_phase(perf::Phase::ASSEMBLY);
+    std::vector<Chunk> chunks;
+    {
+        trace::ScopedTrace trace_scope(trace::EventKind::ASM_BEGIN, trace::EventKind::ASM_END,
+                                       static_cast<uint8_t>(trace::AsmPhase::SPLIT_INTO_CHUNKS));
+        for (auto source : sources) {
+            SplitIntoChunks(source, &chunks);
+        }
+    }
 
-    if (!GenRawInstructions(file_arch)) {
+    if (chunks.size() == 1) {
+        Lexer lexer(chunks[0].source, chunks[0].first_line);
+        if (!GenRawInstructions(&lexer, file_arch)) {
+            PrintErr("Something went wrong");
+            return false;
+        }
+    } else if (!ParseChunks(chunks, file_arch)) {
         PrintErr("Something went wrong");
         return false;
     }
 
+    trace::ScopedTrace trace_scope(trace::EventKind::ASM_BEGIN, trace::EventKind::ASM_END,
+                                   static_cast<uint8_t>(trace::AsmPhase::RESOLVE_DEPENDENCIES));
     return file_arch->ResolveDependencies();
 }
 
-bool AsmToByte::ParseAsmFile(const char *filename, file_format::File *file_arch)
+bool AsmToByte::ParseChunks(const std::vector<Chunk> &chunks, file_format::File *file_arch)
 {
-    if (!ReadAsmFile(filename)) {
+    std::vector<file_format::File> chunk_files(chunks.size());
+    std::atomic<size_t> next_chunk {0};
+    std::atomic<bool> failed {false};
+
+    auto worker = [&]() {
+        for (size_t i = next_chunk++; i < chunks.size() && !failed; i = next_chunk++) {
+            Lexer lexer(chunks[i].source, chunks[i].first_line);
+            if (!GenRawInstructions(&lexer, &chunk_files[i])) {
+                failed = true;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t i = 1, n_workers = std::min(n_threads_, chunks.size()); i < n_workers; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    if (failed) {
         return false;
     }
 
-    return ParseAsm(file_arch);
+    // Chunks are appended in source order, so the result is the same as for sequential assembling
+    for (auto &chunk_file : chunk_files) {
+        if (!file_arch->Append(&chunk_file)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void AsmToByte::SplitIntoChunks(std::string_view source, std::vector<Chunk> *chunks) const
+{
+    size_t n_chunks = min_chunk_size_ == 0 ? n_threads_ : std::min(n_threads_, source.size() / min_chunk_size_);
+
+    size_t chunk_start = 0;
+    size_t first_line = 1;
+
+    for (size_t i = 1; i < n_chunks; ++i) {
+        size_t boundary = FindChunkBoundary(source, std::max(chunk_start, i * source.size() / n_chunks));
+        if (boundary == source.size()) {
+            break;
+        }
+
+        std::string_view chunk = source.substr(chunk_start, boundary - chunk_start);
+        chunks->push_back({chunk, first_line});
+
+        first_line += std::count(chunk.begin(), chunk.end(), '\n');
+        chunk_start = boundary;
+    }
+
+    chunks->push_back({source.substr(chunk_start), first_line});
 }
 
-bool AsmToByte::ParseAsmString(const std::string &asm_string, file_format::File *file_arch)
+/* static */
+size_t AsmToByte::FindChunkBoundary(std::string_view source, size_t pos)
 {
-    file_buffer_ = asm_string;
-    return ParseAsm(file_arch);
+    // Chunk may start only at a label line: it cannot be inside of a class definition,
+    // so every chunk is assembled independently of others
+    constexpr std::string_view SPACES = " \t\r\v\f";
+    constexpr std::string_view TOKEN_END = " \t\r\v\f,;'\n";
+
+    size_t line_start = source.find('\n', pos);
+    while (line_start != std::string_view::npos) {
+        ++line_start;
+
+        size_t token_start = source.find_first_not_of(SPACES, line_start);
+        if (token_start == std::string_view::npos) {
+            break;
+        }
+
+        size_t token_end = std::min(source.find_first_of(TOKEN_END, token_start), source.size());
+        if (token_end > token_start && source[token_end - 1] == ':') {
+            return line_start;
+        }
+
+        line_start = source.find('\n', token_start);
+    }
+
+    return source.size();
 }
 
-bool AsmToByte::ReadAsmFile(const char *filename)
+/* static */
+bool AsmToByte::MapFile(const char *filename, std::string_view *contents)
 {
     if (filename == nullptr) {
         PrintErr("Filename argument is nullptr");
         return false;
     }
 
-    std::ifstream file(filename, std::ios::binary | std::ios::ate);
-    if (!file) {
+    int fd = open(filename, O_RDONLY);
+    if (fd == -1) {
         PrintErr("Filename ", filename, " didn't open due to some error");
         return false;
     }
 
-    std::streamsize filesize = file.tellg();
-    file.seekg(0, std::ios::beg);
+    struct stat file_stat {};
+    if (fstat(fd, &file_stat) == -1) {
+        PrintErr("Cannot get size of file ", filename, ", errno = ", errno);
+        close(fd);
+        return false;
+    }
 
-    file_buffer_.resize(filesize);
+    auto filesize = static_cast<size_t>(file_stat.st_size);
+    if (filesize == 0) {
+        close(fd);
+        *contents = {};
+        return true;
+    }
 
-    if (!file.read(file_buffer_.data(), filesize)) {
-        PrintErr("Cannot read file into buffer");
+    void *mapping = mmap(nullptr, filesize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        PrintErr("Cannot map file ", filename, " into memory, errno = ", errno);
         return false;
     }
 
-    file.close();
+    // The file is read once from start to end
+    madvise(mapping, filesize, MADV_SEQUENTIAL);
 
+    *contents = {static_cast<const char *>(mapping), filesize};
     return true;
 }
 
-void AsmToByte::PrepareLinesFromBuffer()
+/* static */
+void AsmToByte::UnmapFile(std::string_view contents)
 {
-    std::size_t line_start_idx = 0;
-    size_t i = 0;
+    if (!contents.empty()) {
+        munmap(const_cast<char *>(contents.data()), contents.size());
+    }
+}
 
-    bool in_line = false;
-    bool in_string = false;
+bool AsmToByte::ParseAsmFile(const char *filename, file_format::File *file_arch)
+{
+    return ParseAsmFiles({filename}, file_arch);
+}
 
-    do {
-        if (in_line == false) {
-            if (std::isspace(file_buffer_[i])) {
-                continue;
-            } else {
-                line_start_idx = i;
-                in_line = true;
-            }
-        } else {
-            if (std::isspace(file_buffer_[i])) {
-                if (file_buffer_[i] == '\n' || file_buffer_[i] == '\0') {
-                    file_buffer_[i] = '\0';
-                    in_line = false;
-                    in_string = false;
-                    lines_.push_back(LineInfo {file_buffer_.substr(line_start_idx, i - line_start_idx + 1)});
-                } else if (in_string != true) {
-                    file_buffer_[i] = '\0';
-                }
-            } else if (file_buffer_[i] == ',' || file_buffer_[i] == ';') {
-                file_buffer_[i] = '\0';
-            } else if (file_buffer_[i] == '\'') {
-                file_buffer_[i] = '\0';
-
-                if (in_string == false)
-                    in_string = true;
-                else
-                    in_string = false;
-            } else if (std::isprint(file_buffer_[i]) == 0) {
-                PrintErr("Invalid symbol is assembler file: ", file_buffer_[i]);
-            }
+bool AsmToByte::ParseAsmFiles(const std::vector<const char *> &filenames, file_format::File *file_arch)
+{
+    std::vector<std::string_view> sources;
+
+    bool mapped = true;
+    for (const char *filename : filenames) {
+        std::string_view contents;
+        if (!MapFile(filename, &contents)) {
+            mapped = false;
+            break;
         }
-    } while (++i < file_buffer_.size());
+        sources.push_back(contents);
+    }
 
-    if (in_line == true) {
-        lines_.push_back(LineInfo {file_buffer_.substr(line_start_idx, file_buffer_.size() - 1) + '\0'});
+    bool parsed = mapped && ParseAsm(sources, file_arch);
+
+    for (auto contents : sources) {
+        UnmapFile(contents);
     }
+
+    return parsed;
+}
+
+bool AsmToByte::ParseAsmString(std::string_view asm_string, file_format::File *file_arch)
+{
+    return ParseAsm({asm_string}, file_arch);
 }
 
-bool AsmToByte::GenRawInstructions(file_format::File *file_arch)
+bool AsmToByte::ParseAsmStrings(const std::vector<std::string_view> &asm_strings, file_format::File *file_arch)
 {
+    return ParseAsm(asm_strings, file_arch);
+}
+
+bool AsmToByte::GenRawInstructions(Lexer *lexer, file_format::File *file_arch)
+{
+    trace::ScopedTrace trace_scope(trace::EventKind::ASM_BEGIN, trace::EventKind::ASM_END,
+                                   static_cast<uint8_t>(trace::AsmPhase::GEN_RAW_INSTRUCTIONS));
+
     file_format::ClassSection *class_section = file_arch->GetHeader()->GetClassSection();
     file_format::StringPool *string_pool = file_arch->GetHeader()->GetStringPool();
     file_format::CodeSection *code_section = file_arch->GetCodeSection();
 
     bool in_class_defition = false;
 
-    for (auto &it : lines_) {
-        std::vector<std::string> line_args = it.GetArgs();
+    LineInfo line_args;
 
+    while (lexer->NextLine(&line_args)) {
         // Label
         if (line_args[0].back() == ':') {
             code_section->AddLabel(line_args[0]);
@@ -135,9 +252,9 @@ bool AsmToByte::GenRawInstructions(file_format::File *file_arch)
         }
 
         // Class definition start/end
-        if (!line_args[0].compare(".class")) {
+        if (line_args[0] == ".class") {
             if (in_class_defition == false) {
-                class_section->AddInstance(line_args[1]);
+                class_section->AddInstance(std::string(line_args[1]));
                 in_class_defition = true;
             } else {
                 in_class_defition = false;
@@ -151,34 +268,38 @@ bool AsmToByte::GenRawInstructions(file_format::File *file_arch)
             file_format::ClassField::Type type = memory::GetTypeFromString(line_args[0]);
             auto class_idx = static_cast<ssize_t>(type);
             size_t idx_of_name = 1;
+            std::string class_ref_name;
 
             if (type == file_format::ClassField::Type::CLASS_OBJECT) {
                 idx_of_name = 2;
 
-                class_idx = class_section->GetIdxOfInstance(line_args[1]);
+                // Class may be defined in another chunk, it's then resolved by name after chunks are merged
+                class_idx = class_section->GetIdxOfInstance(std::string(line_args[1]));
                 if (class_idx == -1) {
-                    PrintErr("Usage of undefined class \"", line_args[1], "\"");
-                    return false;
+                    class_idx = 0;
+                    class_ref_name = line_args[1];
                 }
             }
 
-            evm::file_format::ClassField class_field {line_args[idx_of_name]};
+            std::string_view field_name = line_args[idx_of_name];
+            evm::file_format::ClassField class_field {std::string(field_name)};
+            class_field.SetClassRefName(class_ref_name);
 
             // Now check if it is array
-            size_t size_occurance_start = line_args[idx_of_name].find("[");
-            size_t size_occurance_end = line_args[idx_of_name].find("]");
+            size_t size_occurance_start = field_name.find('[');
+            size_t size_occurance_end = field_name.find(']');
             ssize_t array_size = 0;
 
-            if (size_occurance_start != std::string::npos) {
-                if (size_occurance_end > size_occurance_start && size_occurance_end != std::string::npos) {
-                    array_size = std::stol(line_args[idx_of_name].substr(
-                        size_occurance_start + 1, size_occurance_end - size_occurance_start - 1));
-                    if (array_size <= 0) {
-                        PrintErr("Invalid size of array \"", line_args[idx_of_name], "\"");
+            if (size_occurance_start != std::string_view::npos) {
+                if (size_occurance_end > size_occurance_start && size_occurance_end != std::string_view::npos) {
+                    std::string_view size_str =
+                        field_name.substr(size_occurance_start + 1, size_occurance_end - size_occurance_start - 1);
+                    if (!common::StrToNumber(size_str, &array_size) || array_size <= 0) {
+                        PrintErr("Invalid size of array \"", field_name, "\"");
                         return false;
                     }
 
-                    class_field.SetName(line_args[idx_of_name].substr(0, size_occurance_start));
+                    class_field.SetName(std::string(field_name.substr(0, size_occurance_start)));
                     type = file_format::ClassField::Type::ARRAY_OBJECT;
                 } else {
                     PrintErr("Invalid array declaration of class \"", line_args[1], "\"");
@@ -198,7 +319,7 @@ bool AsmToByte::GenRawInstructions(file_format::File *file_arch)
         // If we here, only assembler instruction is assumed to be in a line
         Opcode opcode = common::StringToOpcode(line_args[0]);
         if (opcode == Opcode::INVALID) {
-            PrintErr("Invalid instruction type");
+            PrintErr("Invalid instruction type \"", line_args[0], "\" in line ", line_args.GetLineNumber());
             return false;
         }
 
@@ -242,7 +363,11 @@ bool AsmToByte::GenRawInstructions(file_format::File *file_arch)
 
             case Opcode::POWER:
             case Opcode::STRCONCAT:
-            case Opcode::STRCMP: {
+            case Opcode::STRCMP:
+
+            case Opcode::ARR_ADD:
+            case Opcode::ARR_MUL:
+            case Opcode::ARR_INDEX_OF: {
                 instr->SetRd(GetRegisterIdxFromString(line_args[1]));
                 instr->SetRs1(GetRegisterIdxFromString(line_args[2]));
                 instr->SetRs2(GetRegisterIdxFromString(line_args[3]));
@@ -264,11 +389,15 @@ bool AsmToByte::GenRawInstructions(file_format::File *file_arch)
 
             case Opcode::MOV:
             case Opcode::CPOBJ:
+            case Opcode::CPOBJ_DEEP:
 
             case Opcode::CONVIF:
             case Opcode::CONVFI:
 
             case Opcode::ARR_SIZE:
+            case Opcode::ARR_SUM:
+            case Opcode::ARR_MIN:
+            case Opcode::ARR_MAX:
 
             case Opcode::SIN:
             case Opcode::COS: {
@@ -284,14 +413,15 @@ bool AsmToByte::GenRawInstructions(file_format::File *file_arch)
 
                 int64_t immediate = 0;
 
-                if (common::IsNumber<int64_t>(line_args[2])) {
-                    immediate = std::stol(line_args[2]);
-                } else if (common::IsNumber<double>(line_args[2])) {
-                    double double_imm = std::stod(line_args[2]);
+                double double_imm = 0;
+
+                if (common::StrToNumber(line_args[2], &immediate)) {
+                    // Integer immediate is parsed in place
+                } else if (common::StrToNumber(line_args[2], &double_imm)) {
                     std::memcpy(&immediate, &double_imm, sizeof(immediate));
                 } else {
-                    code_section->AddInstrToResolve(line_args[2], instr, file_format::CodeSection::ResolutionReason::LABEL_REF);
                     immediate = 0;
+                    code_section->AddInstrToResolve(line_args[2], instr, file_format::CodeSection::ResolutionReason::LABEL_REF);
                 }
 
                 instr->Set64Imm(immediate);
@@ -305,10 +435,12 @@ bool AsmToByte::GenRawInstructions(file_format::File *file_arch)
 
                 int32_t immediate = 0;
 
-                if (common::IsNumber<int32_t>(line_args[2])) {
-                    immediate = std::stol(line_args[2]);
-                } else if (common::IsNumber<double>(line_args[2])) {
-                    PrintErr("Error immediate in jump arg ", std::stol(line_args[2]), "; Arg should be integer");
+                double double_imm = 0;
+
+                if (common::StrToNumber(line_args[2], &immediate)) {
+                    // Integer immediate is parsed in place
+                } else if (common::StrToNumber(line_args[2], &double_imm)) {
+                    PrintErr("Error immediate in jump arg ", line_args[2], "; Arg should be integer");
                     return false;
                 } else {
                     code_section->AddInstrToResolve(line_args[2], instr, file_format::CodeSection::ResolutionReason::LABEL_REF);
@@ -320,12 +452,29 @@ bool AsmToByte::GenRawInstructions(file_format::File *file_arch)
 
             // RS1, RS2
 
-            case Opcode::JMP_IF: {
+            case Opcode::JMP_IF:
+            case Opcode::ARR_FILL: {
                 instr->SetRs1(GetRegisterIdxFromString(line_args[1]));
                 instr->SetRs2(GetRegisterIdxFromString(line_args[2]));
                 break;
             }
 
+            // RS1, ARG1, RS2, ARG2, ARG3
+
+            case Opcode::ARR_COPY: {
+                if (line_args.size() != 6) {
+                    PrintErr("arr_copy requires 5 arguments: dst, dst_pos, src, src_pos, len");
+                    return false;
+                }
+
+                instr->SetRs1(GetRegisterIdxFromString(line_args[1]));
+                instr->SetArg(0, GetRegisterIdxFromString(line_args[2]));
+                instr->SetRs2(GetRegisterIdxFromString(line_args[3]));
+                instr->SetArg(1, GetRegisterIdxFromString(line_args[4]));
+                instr->SetArg(2, GetRegisterIdxFromString(line_args[5]));
+                break;
+            }
+
             // RD
 
             case Opcode::SCANI:
@@ -340,10 +489,12 @@ bool AsmToByte::GenRawInstructions(file_format::File *file_arch)
             case Opcode::JMP_IMM: {
                 int32_t immediate = 0;
 
-                if (common::IsNumber<int32_t>(line_args[1])) {
-                    immediate = std::stol(line_args[1]);
-                } else if (common::IsNumber<double>(line_args[1])) {
-                    PrintErr("Error immediate in jump arg ", std::stol(line_args[1]), "; Arg should be integer");
+                double double_imm = 0;
+
+                if (common::StrToNumber(line_args[1], &immediate)) {
+                    // Integer immediate is parsed in place
+                } else if (common::StrToNumber(line_args[1], &double_imm)) {
+                    PrintErr("Error immediate in jump arg ", line_args[1], "; Arg should be integer");
                     return false;
                 } else {
                     code_section->AddInstrToResolve(line_args[1], instr, file_format::CodeSection::ResolutionReason::LABEL_REF);
@@ -391,10 +542,8 @@ bool AsmToByte::GenRawInstructions(file_format::File *file_arch)
                 code_section->AddInstrToResolve(line_args[2], instr, file_format::CodeSection::ResolutionReason::CLASS_REF);
 
                 int32_t arr_size = 0;
-                if (common::IsNumber<int32_t>(line_args[3])) {
-                    arr_size = std::stol(line_args[3]);
-                } else {
-                    PrintErr("Error immediate in newarr arg ", std::stol(line_args[1]), "; Arg should be integer");
+                if (!common::StrToNumber(line_args[3], &arr_size)) {
+                    PrintErr("Error immediate in newarr arg ", line_args[3], "; Arg should be integer");
                     return false;
                 }
 
@@ -425,12 +574,13 @@ bool AsmToByte::GenRawInstructions(file_format::File *file_arch)
 
             case Opcode::NEWSTR:
             case Opcode::STR_IMMUT: {
-                if (!string_pool->HasInstance(line_args[2])) {
-                    string_pool->AddInstance(line_args[2]);
+                std::string literal {line_args[2]};
+                if (!string_pool->HasInstance(literal)) {
+                    string_pool->AddInstance(literal);
                 }
 
                 instr->SetRd(GetRegisterIdxFromString(line_args[1]));
-                instr->SetStringOp(line_args[2]);
+                instr->SetStringOp(std::move(literal));
                 instr->Set32Imm(0);
                 string_pool->AddInstrToResolve(instr);
 
@@ -446,28 +596,25 @@ bool AsmToByte::GenRawInstructions(file_format::File *file_arch)
         code_section->ValidateLastInstr();
     }
 
-    return true;
+    return !lexer->HasError();
 }
 
 /* static */
-int AsmToByte::GetRegisterIdxFromString(const std::string &reg_name)
+int AsmToByte::GetRegisterIdxFromString(std::string_view reg_name)
 {
-    if (reg_name.front() != 'x') {
+    if (reg_name.empty() || reg_name.front() != 'x') {
         PrintErr("Invalid register prefix: ", reg_name, "; Only x prefix is support");
         return -1;
     }
 
-    std::string::const_iterator it = reg_name.begin() + 1;
-    while (it != reg_name.end() && std::isdigit(*it)) {
-        ++it;
-    }
-
-    if (it != reg_name.end()) {
+    int reg_idx = 0;
+    if (reg_name.size() == 1 || !std::isdigit(static_cast<unsigned char>(reg_name[1])) ||
+        !common::StrToNumber(reg_name.substr(1), &reg_idx)) {
         PrintErr("Invalid register name: ", reg_name, "; Only <x number> format is supported");
         return false;
     }
 
-    return std::stoi(reg_name.substr(1, reg_name.size() - 1));
+    return reg_idx;
 }
 
 } // namespace evm::asm2byte
@@ -3,14 +3,18 @@
 
 #include "common/macros.h"
 #include "file_format/file.h"
-#include "line.h"
+#include "lexer.h"
 
-#include <vector>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace evm::asm2byte {
 
 class AsmToByte {
+public:
+    static constexpr size_t MIN_CHUNK_SIZE_DEFAULT = 64 * 1024;
+
 public:
     NO_COPY_SEMANTIC(AsmToByte);
     NO_MOVE_SEMANTIC(AsmToByte);
@@ -18,27 +22,45 @@ public:
     AsmToByte() = default;
     ~AsmToByte() = default;
 
-    bool ParseAsmString(const std::string &asm_string, file_format::File *file_arch);
-    bool ParseAsmFile(const char *filename, file_format::File *file_arch);
-
-    void SetFileBuffer(const std::string &buffer)
+    // Sources of at least two min_chunk_size are split into chunks which are assembled on n_threads threads,
+    // then merged and resolved as a whole. Single thread is used by default
+    void SetParallelism(size_t n_threads, size_t min_chunk_size = MIN_CHUNK_SIZE_DEFAULT)
     {
-        file_buffer_ = buffer;
+        n_threads_ = n_threads == 0 ? 1 : n_threads;
+        min_chunk_size_ = min_chunk_size;
     }
 
+    // Source is only viewed during parsing, it is neither copied nor modified
+    bool ParseAsmString(std::string_view asm_string, file_format::File *file_arch);
+    // Sources are assembled as one program in the given order
+    bool ParseAsmStrings(const std::vector<std::string_view> &asm_strings, file_format::File *file_arch);
+
+    // File is mapped into memory and lexed in place
+    bool ParseAsmFile(const char *filename, file_format::File *file_arch);
+    bool ParseAsmFiles(const std::vector<const char *> &filenames, file_format::File *file_arch);
+
 private:
-    bool ParseAsm(file_format::File *file_arch);
-    bool ReadAsmFile(const char *filename);
+    struct Chunk {
+        std::string_view source;
+        size_t first_line;
+    };
 
-    void PrepareLinesFromBuffer();
-    bool GenRawInstructions(file_format::File *file_arch);
+    bool ParseAsm(const std::vector<std::string_view> &sources, file_format::File *file_arch);
+    bool ParseChunks(const std::vector<Chunk> &chunks, file_format::File *file_arch);
+    void SplitIntoChunks(std::string_view source, std::vector<Chunk> *chunks) const;
 
-    static int GetRegisterIdxFromString(const std::string &reg_name);
+    static size_t FindChunkBoundary(std::string_view source, size_t pos);
 
-private:
-    std::string file_buffer_;
+    static bool MapFile(const char *filename, std::string_view *contents);
+    static void UnmapFile(std::string_view contents);
 
-    std::vector<LineInfo> lines_;
+    bool GenRawInstructions(Lexer *lexer, file_format::File *file_arch);
+
+    static int GetRegisterIdxFromString(std::string_view reg_name);
+
+private:
+    size_t n_threads_ {1};
+    size_t min_chunk_size_ {MIN_CHUNK_SIZE_DEFAULT};
 };
 
 } // namespace evm::asm2byte
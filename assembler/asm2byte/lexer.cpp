@@ -0,0 +1,82 @@
+#include "common/logs.h"
+#include "lexer.h"
+
+#include <cctype>
+
+namespace evm::asm2byte {
+
+bool Lexer::AddToken(LineInfo *line, size_t start, size_t end)
+{
+    if (line->n_tokens_ == LineInfo::MAX_TOKENS) {
+        PrintErr("Too many tokens in line ", line_number_, "; At most ", LineInfo::MAX_TOKENS, " are supported");
+        has_error_ = true;
+        return false;
+    }
+
+    line->tokens_[line->n_tokens_++] = source_.substr(start, end - start);
+    return true;
+}
+
+bool Lexer::NextLine(LineInfo *line)
+{
+    while (pos_ < source_.size()) {
+        ++line_number_;
+        line->n_tokens_ = 0;
+        line->line_number_ = line_number_;
+
+        while (pos_ < source_.size() && !IsLineEnd(source_[pos_])) {
+            char c = source_[pos_];
+
+            if (IsSeparator(c)) {
+                ++pos_;
+                continue;
+            }
+
+            size_t start = pos_;
+
+            if (c == '\'') {
+                ++start;
+                do {
+                    ++pos_;
+                } while (pos_ < source_.size() && source_[pos_] != '\'' && !IsLineEnd(source_[pos_]));
+
+                if (pos_ == source_.size() || source_[pos_] != '\'') {
+                    PrintErr("Unterminated string literal in line ", line_number_);
+                    has_error_ = true;
+                    return false;
+                }
+
+                if (!AddToken(line, start, pos_)) {
+                    return false;
+                }
+                ++pos_;
+                continue;
+            }
+
+            while (pos_ < source_.size() && !IsSeparator(source_[pos_]) && !IsLineEnd(source_[pos_]) &&
+                   source_[pos_] != '\'') {
+                if (std::isprint(static_cast<unsigned char>(source_[pos_])) == 0) {
+                    PrintErr("Invalid symbol in line ", line_number_, ": code ", static_cast<int>(source_[pos_]));
+                    has_error_ = true;
+                    return false;
+                }
+                ++pos_;
+            }
+
+            if (!AddToken(line, start, pos_)) {
+                return false;
+            }
+        }
+
+        // Skip line end
+        ++pos_;
+
+        if (line->n_tokens_ != 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+} // namespace evm::asm2byte
@@ -0,0 +1,89 @@
+#ifndef EVM_ASSEMBLER_ASM_TO_BYTE_LEXER_H
+#define EVM_ASSEMBLER_ASM_TO_BYTE_LEXER_H
+
+#include "common/macros.h"
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+namespace evm::asm2byte {
+
+// Tokens of a single source line. Tokens are views into the source buffer, no copies are made
+class LineInfo {
+public:
+    static constexpr size_t MAX_TOKENS = 16;
+
+    DEFAULT_MOVE_SEMANTIC(LineInfo);
+    DEFAULT_COPY_SEMANTIC(LineInfo);
+
+    LineInfo() = default;
+    ~LineInfo() = default;
+
+    // Missing tokens are empty, so accessing an absent argument is safe
+    std::string_view operator[](size_t idx) const
+    {
+        return idx < n_tokens_ ? tokens_[idx] : std::string_view {};
+    }
+
+    size_t size() const
+    {
+        return n_tokens_;
+    }
+
+    size_t GetLineNumber() const
+    {
+        return line_number_;
+    }
+
+private:
+    friend class Lexer;
+
+    std::array<std::string_view, MAX_TOKENS> tokens_ {};
+    size_t n_tokens_ {0};
+    size_t line_number_ {0};
+};
+
+// Single pass lexer over assembler source.
+// Whitespaces, ',' and ';' separate tokens, text in single quotes is one token.
+class Lexer {
+public:
+    NO_COPY_SEMANTIC(Lexer);
+    NO_MOVE_SEMANTIC(Lexer);
+
+    // first_line is the number of the first source line in error messages
+    explicit Lexer(std::string_view source, size_t first_line = 1) : source_(source), line_number_(first_line - 1) {}
+    ~Lexer() = default;
+
+    // Fills line with tokens of the next non-empty line.
+    // Returns false at the end of source or on error, HasError() tells them apart
+    bool NextLine(LineInfo *line);
+
+    bool HasError() const
+    {
+        return has_error_;
+    }
+
+private:
+    static bool IsSeparator(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f' || c == ',' || c == ';';
+    }
+
+    static bool IsLineEnd(char c)
+    {
+        return c == '\n' || c == '\0';
+    }
+
+    bool AddToken(LineInfo *line, size_t start, size_t end);
+
+private:
+    std::string_view source_;
+    size_t pos_ {0};
+    size_t line_number_ {0};
+    bool has_error_ {false};
+};
+
+} // namespace evm::asm2byte
+
+#endif // EVM_ASSEMBLER_ASM_TO_BYTE_LEXER_H
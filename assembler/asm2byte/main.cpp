@@ -1,27 +1,49 @@
 #include "asm2byte.h"
+#include "common/utils/string_operations.h"
+
 #include <cstdlib>
+#include <string_view>
+#include <thread>
+#include <vector>
 
 namespace evm::asm2byte {
 
 int Main(int argc, char *argv[])
 {
-    if (argc != 2) {
-        PrintErr("Only filename arg is required");
+    size_t n_threads = std::thread::hardware_concurrency();
+    std::vector<const char *> filenames;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::string_view(argv[i]) == "-j") {
+            if (i + 1 == argc || !common::StrToNumber(argv[i + 1], &n_threads)) {
+                PrintErr("-j requires number of threads");
+                return EXIT_FAILURE;
+            }
+            ++i;
+            continue;
+        }
+        filenames.push_back(argv[i]);
+    }
+
+    if (filenames.empty()) {
+        PrintErr("Usage: asm2byte [-j <threads>] <file.ea>...");
         return EXIT_FAILURE;
     }
 
     file_format::File file_arch("out.ea");
 
     auto asm2byte = AsmToByte();
-    bool parsed = asm2byte.ParseAsmFile(argv[1], &file_arch);
+    asm2byte.SetParallelism(n_threads);
+
+    bool parsed = asm2byte.ParseAsmFiles(filenames, &file_arch);
     if (!parsed) {
-        PrintErr("Error when parsing asm file '", argv[1], "'");
+        PrintErr("Error when parsing asm file '", filenames[0], "'");
         return EXIT_FAILURE;
     }
 
     bool dumped = file_arch.EmitBytecode();
     if (!dumped) {
-        PrintErr("Error when dumping bytecode of file '", argv[1], "'");
+        PrintErr("Error when dumping bytecode of file '", filenames[0], "'");
         return EXIT_FAILURE;
     }
 
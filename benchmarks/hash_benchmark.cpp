@@ -0,0 +1,66 @@
+#include "common/utils/crc32.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace evm::benchmarks {
+
+using Crc32Impl = uint32_t (*)(const uint8_t *, size_t, uint32_t);
+
+// Amount of data hashed for each string size
+static constexpr size_t BYTES_PER_MEASUREMENT = 256 * 1024 * 1024;
+
+static constexpr size_t MIN_STRING_SIZE = 8;
+static constexpr size_t MAX_STRING_SIZE = 1024 * 1024;
+
+static double MeasureThroughput(Crc32Impl impl, const std::vector<uint8_t> &buffer, size_t string_size)
+{
+    size_t n_iterations = BYTES_PER_MEASUREMENT / string_size;
+    size_t n_strings = buffer.size() / string_size;
+
+    volatile uint32_t sink = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < n_iterations; ++i) {
+        sink = sink + impl(buffer.data() + (i % n_strings) * string_size, string_size, 0);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    return static_cast<double>(n_iterations * string_size) / seconds / (1024 * 1024);
+}
+
+int Main()
+{
+    // Several strings of maximum size to avoid hashing the same hot cache lines only
+    std::vector<uint8_t> buffer(4 * MAX_STRING_SIZE);
+    for (size_t i = 0; i < buffer.size(); ++i) {
+        buffer[i] = static_cast<uint8_t>(std::rand());
+    }
+
+    bool hw_supported = common::IsCrc32HwSupported();
+
+    std::printf("%10s %20s %20s %20s\n", "size", "slicing-by-8, MB/s", "sse4.2, MB/s", "selected, MB/s");
+    for (size_t size = MIN_STRING_SIZE; size <= MAX_STRING_SIZE; size *= 2) {
+        double slicing = MeasureThroughput(common::Crc32SlicingBy8, buffer, size);
+        double hw = hw_supported ? MeasureThroughput(common::Crc32Sse42, buffer, size) : 0.0;
+        double selected = MeasureThroughput(common::Crc32, buffer, size);
+
+        std::printf("%10zu %20.1f %20.1f %20.1f\n", size, slicing, hw, selected);
+    }
+
+    if (!hw_supported) {
+        std::printf("SSE4.2 is not supported by CPU, hardware implementation was skipped\n");
+    }
+
+    return EXIT_SUCCESS;
+}
+
+} // namespace evm::benchmarks
+
+int main()
+{
+    return evm::benchmarks::Main();
+}
@@ -0,0 +1,34 @@
+# Runs benchmark NAME of the corpus by evm: output of all runs is checked against NAME.expected,
+# the timing report of evm --bench is written to RESULTS_DIR/NAME.json
+
+file(MAKE_DIRECTORY ${RESULTS_DIR})
+set(report ${RESULTS_DIR}/${NAME}.json)
+
+execute_process(
+    COMMAND ${EVM} ${FLAGS} --bench ${RUNS} --warmup ${WARMUP} --bench-out ${report} ${SOURCE_DIR}/${NAME}.ea
+    OUTPUT_VARIABLE output
+    RESULT_VARIABLE result
+)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "Benchmark ${NAME} failed: ${result}")
+endif()
+
+# Debug logs of the VM share stdout with the program, timings of such builds aren't representative anyway
+string(REGEX REPLACE "\\[[^\n]*, line [0-9]+\\] [^\n]*\n" "" output "${output}")
+
+# Program prints its output once per run, warmup ones included
+file(READ ${SOURCE_DIR}/${NAME}.expected expected_once)
+set(expected "")
+math(EXPR n_runs "${RUNS} + ${WARMUP}")
+foreach(run RANGE 1 ${n_runs})
+    string(APPEND expected "${expected_once}")
+endforeach()
+if(NOT output STREQUAL expected)
+    message(FATAL_ERROR "Output of benchmark ${NAME} differs from ${NAME}.expected")
+endif()
+
+file(READ ${report} report_json)
+string(REGEX MATCH "\"median\": ([0-9]+)" median_match "${report_json}")
+math(EXPR median_ms "${CMAKE_MATCH_1} / 1000000")
+string(REGEX MATCH "\"instructions\": ([0-9]+)" instructions_match "${report_json}")
+message(STATUS "${NAME}: median ${median_ms} ms, ${CMAKE_MATCH_1} instructions, report ${report}")
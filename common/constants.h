@@ -23,6 +23,7 @@ static constexpr size_t DWORD_SIZE = sizeof(dword_t);
 static constexpr size_t BITS_PER_BYTE = 1 << 3;
 static constexpr size_t KBYTE_SIZE    = 1 << 10;
 static constexpr size_t MBYTE_SIZE    = 1 << 20;
+static constexpr size_t GBYTE_SIZE    = 1 << 30;
 
 using bit_size_t = byte_t;
 
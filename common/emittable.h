@@ -4,12 +4,43 @@
 #include "common/constants.h"
 #include "common/macros.h"
 
+#include <cassert>
 #include <cstring>
 #include <string>
 #include <vector>
 
 namespace evm {
 
+// Output cursor over a buffer which is sized for the whole bytecode in advance,
+// so every field is written in place during a single pass
+class EmitBuffer {
+public:
+    NO_COPY_SEMANTIC(EmitBuffer);
+    NO_MOVE_SEMANTIC(EmitBuffer);
+
+    EmitBuffer(byte_t *data, size_t size) : data_(data), size_(size) {}
+    ~EmitBuffer() = default;
+
+    // Returns the next size bytes of buffer and moves past them
+    byte_t *Advance(size_t size)
+    {
+        assert(pos_ + size <= size_);
+        byte_t *ptr = data_ + pos_;
+        pos_ += size;
+        return ptr;
+    }
+
+    size_t GetPosition() const
+    {
+        return pos_;
+    }
+
+private:
+    byte_t *data_;
+    size_t size_;
+    size_t pos_ {0};
+};
+
 class Emittable {
 public:
     using EmitNameSize = byte_t;
@@ -42,39 +73,38 @@ public:
         return sizeof(EmitNameSize) + name_.size() + 1;
     }
 
+    // Space is filled later, when its contents become known
     template <typename T>
-    static T *EmitEmptyBytecode(std::vector<byte_t> *out_arr)
+    static T *EmitEmptyBytecode(EmitBuffer *out_arr)
     {
-        auto curr_size = out_arr->size();
-        out_arr->insert(out_arr->end(), sizeof(T), 0);
-        return reinterpret_cast<T *>(out_arr->data() + curr_size);
+        return reinterpret_cast<T *>(EmitEmptyBytecode(out_arr, sizeof(T)));
     }
 
-    static void *EmitEmptyBytecode(std::vector<byte_t> *out_arr, EmitSize insert_size)
+    static void *EmitEmptyBytecode(EmitBuffer *out_arr, EmitSize insert_size)
     {
-        auto curr_size = out_arr->size();
-        out_arr->insert(out_arr->end(), insert_size, 0);
-        return out_arr->data() + curr_size;
+        void *emitted_empty_data = out_arr->Advance(insert_size);
+        memset(emitted_empty_data, 0, insert_size);
+        return emitted_empty_data;
     }
 
     template <typename T>
-    static EmitSize EmitBytecode(std::vector<byte_t> *out_arr, const T *obj)
+    static EmitSize EmitBytecode(EmitBuffer *out_arr, const T *obj)
     {
-        T *emitted_empty_data = EmitEmptyBytecode<T>(out_arr);
-        memcpy(emitted_empty_data, obj, sizeof(T));
+        memcpy(out_arr->Advance(sizeof(T)), obj, sizeof(T));
 
         return sizeof(T);
     }
 
-    static EmitSize EmitBytecode(std::vector<byte_t> *out_arr, const void *obj, EmitSize insert_size, EmitSize cpy_size)
+    static EmitSize EmitBytecode(EmitBuffer *out_arr, const void *obj, EmitSize insert_size, EmitSize cpy_size)
     {
-        void *emitted_empty_data = EmitEmptyBytecode(out_arr, insert_size);
-        memcpy(emitted_empty_data, obj, cpy_size);
+        byte_t *emitted_data = out_arr->Advance(insert_size);
+        memcpy(emitted_data, obj, cpy_size);
+        memset(emitted_data + cpy_size, 0, insert_size - cpy_size);
 
         return insert_size;
     }
 
-    EmitSize EmitBytecode(std::vector<byte_t> *out_arr)
+    EmitSize EmitBytecode(EmitBuffer *out_arr)
     {
         const EmitNameSize name_size = name_.size() + 1;
         EmitSize emit_size = 0;
@@ -241,10 +271,10 @@ public:
         return offset_ + Emittable::GetSize() + sizeof(EmitSize) + n_instances * sizeof(EmitRef);
     }
 
-    EmitSize EmitBytecode(std::vector<byte_t> *out_arr)
+    EmitSize EmitBytecode(EmitBuffer *out_arr)
     {
         const EmitSize n_instances = instances_.size();
-        const EmitSize bytecode_size = out_arr->size();
+        const EmitSize bytecode_size = out_arr->GetPosition();
         std::vector<EmitRef *> instances_starts;
 
         EmitSize emit_size = 0;
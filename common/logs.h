@@ -2,14 +2,40 @@
 #define EVM_LOGS_H
 
 #include <cstddef>
+#include <cstdint>
 #include <iostream>
 #include <sstream>
 
 namespace evm::logger {
 
+/// Categories of debug logs, each of them is compiled in or out separately with EVM_LOG_CATEGORIES mask
+enum LogCategory : uint32_t {
+    LOG_GENERAL = 1U << 0,
+    LOG_INTERPRETER = 1U << 1, // every executed instruction
+    LOG_OBJECTS = 1U << 2,     // allocations and field accesses of objects and arrays
+    LOG_MEMORY = 1U << 3,      // allocators and GC
+    LOG_JIT = 1U << 4,
+    LOG_OPT = 1U << 5,
+};
+
+// Debug builds log everything except categories written on every instruction or object access
+#ifndef EVM_LOG_CATEGORIES
+#ifdef NDEBUG
+#define EVM_LOG_CATEGORIES 0
+#else
+#define EVM_LOG_CATEGORIES (~(evm::logger::LOG_INTERPRETER | evm::logger::LOG_OBJECTS))
+#endif
+#endif
+
+constexpr bool IsLogEnabled(LogCategory category)
+{
+    return (static_cast<uint32_t>(EVM_LOG_CATEGORIES) & category) != 0;
+}
+
+// Logs are not flushed: the trace ring buffer (common/trace.h) is the one to keep events up to a crash
 static inline void PrintLogRecursive(const char *file_name, size_t line, std::ostringstream &message)
 {
-    std::cout << "[" << file_name << ", line " << line << "] " << message.str() << std::endl;
+    std::cout << "[" << file_name << ", line " << line << "] " << message.str() << '\n';
 }
 
 static inline void PrintErrRecursive(const char *file_name, size_t line, std::ostringstream &message)
@@ -49,11 +75,15 @@ static inline void PrErr(const char *file_name, size_t line, const Args &...args
 
 } // namespace evm::logger
 
-#ifdef NDEBUG
-#define PrintLog(...)
-#else
-#define PrintLog(...) evm::logger::PrLog(__FILE__, __LINE__, __VA_ARGS__)
-#endif
+// Arguments of disabled categories are not evaluated
+#define PrintLogCat(category, ...)                                                  \
+    do {                                                                            \
+        if constexpr (evm::logger::IsLogEnabled(evm::logger::LOG_##category)) {     \
+            evm::logger::PrLog(__FILE__, __LINE__, __VA_ARGS__);                    \
+        }                                                                           \
+    } while (0)
+
+#define PrintLog(...) PrintLogCat(GENERAL, __VA_ARGS__)
 
 #define PrintErr(...) evm::logger::PrErr(__FILE__, __LINE__, __VA_ARGS__)
 
@@ -35,9 +35,9 @@
 
 #define MEMBER_OFFSET(T, F) offsetof(T, F)
 
-// Inline (disabled for DEBUG)
+// Inline (forced inlining is disabled for DEBUG, but functions are still inline to be defined in headers)
 #if !defined(NDEBUG)
-#define ALWAYS_INLINE
+#define ALWAYS_INLINE inline
 #else
 #define ALWAYS_INLINE __attribute__((always_inline)) inline
 #endif
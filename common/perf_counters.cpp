@@ -0,0 +1,268 @@
+#include "common/perf_counters.h"
+#include "common/logs.h"
+
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace evm::perf {
+
+bool PerfCounters::is_enabled_ = false;
+
+namespace {
+
+constexpr size_t N_PHASES = static_cast<size_t>(Phase::N_PHASES);
+constexpr size_t N_COUNTERS = static_cast<size_t>(Counter::N_COUNTERS);
+
+const char *const PHASE_NAMES[] = {"interpreter", "gc_mark", "gc_sweep", "assembly", "jit"};
+static_assert(sizeof(PHASE_NAMES) / sizeof(PHASE_NAMES[0]) == N_PHASES);
+
+const char *const COUNTER_NAMES[] = {"cycles",     "instructions",  "branch_misses", "l1d_read_misses",
+                                     "llc_misses", "task_clock_ns", "page_faults"};
+static_assert(sizeof(COUNTER_NAMES) / sizeof(COUNTER_NAMES[0]) == N_COUNTERS);
+
+struct EventConfig {
+    uint32_t type;
+    uint64_t config;
+};
+
+constexpr uint64_t CACHE_READ_MISS =
+    (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+
+const EventConfig EVENTS[] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | CACHE_READ_MISS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+};
+static_assert(sizeof(EVENTS) / sizeof(EVENTS[0]) == N_COUNTERS);
+
+// Layout of read() of the group with PERF_FORMAT_GROUP and both PERF_FORMAT_TOTAL_TIME_* flags
+struct GroupReadFormat {
+    uint64_t nr;
+    uint64_t time_enabled;
+    uint64_t time_running;
+    uint64_t values[N_COUNTERS];
+};
+
+int g_fds[N_COUNTERS] = {-1, -1, -1, -1, -1, -1, -1};
+int g_leader_fd = -1;
+// Counters opened by the last Enable(), kept after Disable() for the report
+bool g_is_available[N_COUNTERS] {};
+// Counters in the order of values of the group read
+Counter g_group_order[N_COUNTERS] {};
+size_t g_group_size = 0;
+
+uint64_t g_last_values[N_COUNTERS] {};
+uint64_t g_totals[N_PHASES][N_COUNTERS] {};
+uint64_t g_time_enabled = 0;
+uint64_t g_time_running = 0;
+
+Phase g_phases[PerfCounters::MAX_NESTING] {};
+size_t g_depth = 0;
+
+int OpenEvent(const EventConfig &event, int group_fd)
+{
+    perf_event_attr attr {};
+    attr.size = sizeof(attr);
+    attr.type = event.type;
+    attr.config = event.config;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // Group is started at once by its leader; kernel is excluded to work with default perf_event_paranoid
+    attr.disabled = group_fd == -1 ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+}
+
+void CloseEvents()
+{
+    for (int &fd : g_fds) {
+        if (fd != -1) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    g_leader_fd = -1;
+    g_group_size = 0;
+}
+
+bool ReadGroup(GroupReadFormat *data)
+{
+    ssize_t size = read(g_leader_fd, data, sizeof(*data));
+    return size >= static_cast<ssize_t>(3 * sizeof(uint64_t)) && data->nr == g_group_size;
+}
+
+} // namespace
+
+/* static */
+bool PerfCounters::Enable()
+{
+    Disable();
+
+    for (size_t i = 0; i < N_COUNTERS; ++i) {
+        int fd = OpenEvent(EVENTS[i], g_leader_fd);
+        g_is_available[i] = fd != -1;
+        if (fd == -1) {
+            PrintLog("perf counter ", COUNTER_NAMES[i], " is not available: ", std::strerror(errno));
+            continue;
+        }
+        g_fds[i] = fd;
+        if (g_leader_fd == -1) {
+            g_leader_fd = fd;
+        }
+        g_group_order[g_group_size++] = static_cast<Counter>(i);
+    }
+    if (g_leader_fd == -1) {
+        PrintErr("No performance counters are available: ", std::strerror(errno));
+        return false;
+    }
+
+    std::memset(g_totals, 0, sizeof(g_totals));
+    std::memset(g_last_values, 0, sizeof(g_last_values));
+    g_time_enabled = 0;
+    g_time_running = 0;
+    g_depth = 0;
+
+    ioctl(g_leader_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(g_leader_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    is_enabled_ = true;
+    return true;
+}
+
+/* static */
+void PerfCounters::Disable()
+{
+    if (is_enabled_) {
+        Accumulate();
+        ioctl(g_leader_fd, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        is_enabled_ = false;
+    }
+    // Totals are kept for the report
+    CloseEvents();
+}
+
+/* static */
+bool PerfCounters::IsAvailable(Counter counter)
+{
+    return g_is_available[static_cast<size_t>(counter)];
+}
+
+/* static */
+void PerfCounters::Accumulate()
+{
+    GroupReadFormat data {};
+    if (!ReadGroup(&data)) {
+        return;
+    }
+    g_time_enabled = data.time_enabled;
+    g_time_running = data.time_running;
+
+    for (size_t i = 0; i < g_group_size; ++i) {
+        auto counter = static_cast<size_t>(g_group_order[i]);
+        uint64_t delta = data.values[i] - g_last_values[counter];
+        g_last_values[counter] = data.values[i];
+        // Counts outside of any phase aren't attributed
+        if (g_depth > 0) {
+            size_t top = (g_depth < MAX_NESTING ? g_depth : MAX_NESTING) - 1;
+            g_totals[static_cast<size_t>(g_phases[top])][counter] += delta;
+        }
+    }
+}
+
+/* static */
+void PerfCounters::EnterPhaseSlow(Phase phase)
+{
+    Accumulate();
+    // Phases nested too deep are counted as the enclosing one
+    if (g_depth < MAX_NESTING) {
+        g_phases[g_depth] = phase;
+    }
+    ++g_depth;
+}
+
+/* static */
+void PerfCounters::ExitPhaseSlow()
+{
+    if (g_depth == 0) {
+        return;
+    }
+    Accumulate();
+    --g_depth;
+}
+
+/* static */
+uint64_t PerfCounters::GetTotal(Phase phase, Counter counter)
+{
+    return g_totals[static_cast<size_t>(phase)][static_cast<size_t>(counter)];
+}
+
+/* static */
+const char *PerfCounters::GetPhaseName(Phase phase)
+{
+    return PHASE_NAMES[static_cast<size_t>(phase)];
+}
+
+/* static */
+const char *PerfCounters::GetCounterName(Counter counter)
+{
+    return COUNTER_NAMES[static_cast<size_t>(counter)];
+}
+
+/* static */
+void PerfCounters::Report(FILE *file)
+{
+    if (is_enabled_) {
+        Accumulate();
+    }
+
+    std::fprintf(file, "# Performance counters of user space per phase, n/a marks unavailable counters\n");
+    std::fprintf(file, "%-12s", "phase");
+    for (size_t counter = 0; counter < N_COUNTERS; ++counter) {
+        std::fprintf(file, " %16s", COUNTER_NAMES[counter]);
+    }
+    std::fprintf(file, " %8s %14s\n", "ipc", "branch_mpki");
+
+    bool has_cycles = IsAvailable(Counter::CYCLES);
+    bool has_instrs = IsAvailable(Counter::INSTRUCTIONS);
+    bool has_branch_misses = IsAvailable(Counter::BRANCH_MISSES);
+    for (size_t phase = 0; phase < N_PHASES; ++phase) {
+        const uint64_t *totals = g_totals[phase];
+        std::fprintf(file, "%-12s", PHASE_NAMES[phase]);
+        for (size_t counter = 0; counter < N_COUNTERS; ++counter) {
+            if (IsAvailable(static_cast<Counter>(counter))) {
+                std::fprintf(file, " %16lu", static_cast<unsigned long>(totals[counter]));
+            } else {
+                std::fprintf(file, " %16s", "n/a");
+            }
+        }
+
+        auto cycles = static_cast<double>(totals[static_cast<size_t>(Counter::CYCLES)]);
+        auto instrs = static_cast<double>(totals[static_cast<size_t>(Counter::INSTRUCTIONS)]);
+        auto branch_misses = static_cast<double>(totals[static_cast<size_t>(Counter::BRANCH_MISSES)]);
+        if (has_cycles && has_instrs && cycles > 0) {
+            std::fprintf(file, " %8.2f", instrs / cycles);
+        } else {
+            std::fprintf(file, " %8s", "n/a");
+        }
+        if (has_instrs && has_branch_misses && instrs > 0) {
+            std::fprintf(file, " %14.2f\n", branch_misses * 1000 / instrs);
+        } else {
+            std::fprintf(file, " %14s\n", "n/a");
+        }
+    }
+
+    // Group is multiplexed with other users of the PMU, its counts are then lower than the real ones
+    if (g_time_running != 0 && g_time_running < g_time_enabled) {
+        std::fprintf(file, "# counters were running %.1f%% of the time\n",
+                     100.0 * static_cast<double>(g_time_running) / static_cast<double>(g_time_enabled));
+    }
+}
+
+} // namespace evm::perf
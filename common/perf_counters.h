@@ -0,0 +1,110 @@
+#ifndef EVM_COMMON_PERF_COUNTERS_H
+#define EVM_COMMON_PERF_COUNTERS_H
+
+#include "common/macros.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+namespace evm::perf {
+
+enum class Phase : uint8_t {
+    INTERPRETER, // bytecode and compiled code, without nested phases below
+    GC_MARK,
+    GC_SWEEP,
+    ASSEMBLY, // counted on the parsing thread only
+    JIT,      // compilation of regions
+    N_PHASES,
+};
+
+enum class Counter : uint8_t {
+    CYCLES,
+    INSTRUCTIONS,
+    BRANCH_MISSES,
+    L1D_READ_MISSES,
+    LLC_MISSES,
+    // Software counters of the kernel, they are available where the hardware ones aren't
+    TASK_CLOCK_NS,
+    PAGE_FAULTS,
+    N_COUNTERS,
+};
+
+/// Counters of perf_event_open attributed to phases of the VM. Phases nest: counts of a nested phase
+/// aren't added to the enclosing one, so totals of phases don't overlap.
+/// All counters are one group of the calling thread, read with a single syscall at each phase switch.
+/// Counters which can't be opened (no PMU in containers and VMs, perf_event_paranoid) are reported as
+/// unavailable; when none can be opened phases cost one check of a flag.
+class PerfCounters {
+public:
+    static constexpr size_t MAX_NESTING = 8;
+
+    NO_COPY_SEMANTIC(PerfCounters);
+    NO_MOVE_SEMANTIC(PerfCounters);
+
+    /// Opens and starts counters, returns false if none of them is available
+    static bool Enable();
+    static void Disable();
+
+    static bool IsEnabled()
+    {
+        return is_enabled_;
+    }
+
+    static bool IsAvailable(Counter counter);
+
+    static ALWAYS_INLINE void EnterPhase(Phase phase)
+    {
+        if (UNLIKELY(is_enabled_)) {
+            EnterPhaseSlow(phase);
+        }
+    }
+
+    static ALWAYS_INLINE void ExitPhase()
+    {
+        if (UNLIKELY(is_enabled_)) {
+            ExitPhaseSlow();
+        }
+    }
+
+    static uint64_t GetTotal(Phase phase, Counter counter);
+
+    /// Table of totals per phase, with derived IPC and miss rates
+    static void Report(FILE *file);
+
+    static const char *GetPhaseName(Phase phase);
+    static const char *GetCounterName(Counter counter);
+
+private:
+    PerfCounters() = default;
+
+    static void EnterPhaseSlow(Phase phase);
+    static void ExitPhaseSlow();
+
+    // Adds counts since the previous read to the innermost phase
+    static void Accumulate();
+
+private:
+    static bool is_enabled_;
+};
+
+/// Counts the scope as the given phase
+class ScopedPerfPhase {
+public:
+    NO_COPY_SEMANTIC(ScopedPerfPhase);
+    NO_MOVE_SEMANTIC(ScopedPerfPhase);
+
+    explicit ScopedPerfPhase(Phase phase)
+    {
+        PerfCounters::EnterPhase(phase);
+    }
+
+    ~ScopedPerfPhase()
+    {
+        PerfCounters::ExitPhase();
+    }
+};
+
+} // namespace evm::perf
+
+#endif // EVM_COMMON_PERF_COUNTERS_H
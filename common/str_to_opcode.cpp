@@ -1,31 +1,109 @@
 #include "common/str_to_opcode.h"
-#include "common/utils/string_operations.h"
 #include "isa/opcodes.h"
 
-#include <unordered_map>
+#include <array>
+#include <bit>
+#include <cstdint>
 
 namespace evm::common {
 
+namespace {
+
 // clang-format off
 
-Opcode StringToOpcode(const std::string &opcode_str)
-{
-    static std::unordered_map<std::string, Opcode> str_opcode_map;
+#define DEFINE_INSTR(instr, opcode, interpret) #instr,
+
+constexpr std::string_view OPCODE_NAMES[] = {
+    #include "isa/isa.def"
+};
+
+#undef DEFINE_INSTR
 
-    #define DEFINE_INSTR(instr, opcode, interpret) str_opcode_map[StrToLower(#instr)] = static_cast<Opcode>(opcode);
+#define DEFINE_INSTR(instr, opcode, interpret) static_cast<Opcode>(opcode),
 
+constexpr Opcode OPCODE_VALUES[] = {
     #include "isa/isa.def"
+};
 
-    #undef DEFINE_INSTR
+#undef DEFINE_INSTR
 
-    auto it = str_opcode_map.find(opcode_str);
-    if (it == str_opcode_map.end()) {
-        return Opcode::INVALID;
+// clang-format on
+
+constexpr size_t N_OPCODES = std::size(OPCODE_NAMES);
+static_assert(N_OPCODES < UINT8_MAX, "Opcode indices must fit into a table slot");
+
+// Sparse table keeps the search for a collision-free seed short
+constexpr size_t TABLE_SIZE = std::bit_ceil(N_OPCODES * 8);
+constexpr uint8_t EMPTY_SLOT = UINT8_MAX;
+
+// Mnemonics are compared in lower case, so hash ignores the case bit too
+constexpr uint32_t Hash(std::string_view str, uint32_t seed)
+{
+    uint32_t hash = seed;
+    for (char c : str) {
+        hash = (hash ^ static_cast<uint8_t>(c | 0x20)) * 0x01000193;
     }
+    return hash ^ (hash >> 15);
+}
+
+struct PerfectHashTable {
+    uint32_t seed;
+    std::array<uint8_t, TABLE_SIZE> slots;
+};
+
+// Looks for a seed which maps every mnemonic to its own slot, done once during compilation
+constexpr PerfectHashTable BuildTable()
+{
+    PerfectHashTable table {};
+
+    for (uint32_t seed = 0x811c9dc5;; ++seed) {
+        table.seed = seed;
+        table.slots.fill(EMPTY_SLOT);
+
+        bool has_collision = false;
+        for (size_t i = 0; i < N_OPCODES && !has_collision; ++i) {
+            uint8_t &slot = table.slots[Hash(OPCODE_NAMES[i], seed) & (TABLE_SIZE - 1)];
+            has_collision = slot != EMPTY_SLOT;
+            slot = static_cast<uint8_t>(i);
+        }
 
-    return it->second;
+        if (!has_collision) {
+            return table;
+        }
+    }
 }
 
-// clang-format on
+constexpr PerfectHashTable OPCODE_TABLE = BuildTable();
+
+bool IsLowercaseOf(std::string_view str, std::string_view upper_name)
+{
+    if (str.size() != upper_name.size()) {
+        return false;
+    }
+
+    for (size_t i = 0; i < str.size(); ++i) {
+        char c = upper_name[i];
+        if (c >= 'A' && c <= 'Z') {
+            c = static_cast<char>(c - 'A' + 'a');
+        }
+        if (str[i] != c) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace
+
+Opcode StringToOpcode(std::string_view opcode_str)
+{
+    uint8_t idx = OPCODE_TABLE.slots[Hash(opcode_str, OPCODE_TABLE.seed) & (TABLE_SIZE - 1)];
+    if (idx == EMPTY_SLOT || !IsLowercaseOf(opcode_str, OPCODE_NAMES[idx])) {
+        return Opcode::INVALID;
+    }
+
+    return OPCODE_VALUES[idx];
+}
 
 } // namespace evm::common
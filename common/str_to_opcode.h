@@ -1,7 +1,7 @@
 #ifndef EVM_COMMON_STR_TO_OPCODE_H
 #define EVM_COMMON_STR_TO_OPCODE_H
 
-#include <string>
+#include <string_view>
 
 namespace evm {
 enum Opcode : int;
@@ -9,7 +9,8 @@ enum Opcode : int;
 
 namespace evm::common {
 
-Opcode StringToOpcode(const std::string &opcode_str);
+/// Lookup of lowercase mnemonic, returns Opcode::INVALID for unknown ones
+Opcode StringToOpcode(std::string_view opcode_str);
 
 } // namespace evm::common
 
@@ -0,0 +1,354 @@
+#include "common/trace.h"
+#include "isa/opcodes.h"
+
+#include <algorithm>
+#include <bit>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <unistd.h>
+#include <vector>
+
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+namespace evm::trace {
+
+std::atomic<uint32_t> Tracer::enabled_kinds_ {0};
+std::atomic<uint64_t> Tracer::head_ {0};
+Event *Tracer::events_ {nullptr};
+size_t Tracer::mask_ {0};
+size_t Tracer::allocation_threshold_ {Tracer::DEFAULT_ALLOCATION_THRESHOLD};
+
+namespace {
+
+// clang-format off
+#define DEFINE_INSTR(instr, opcode, interpret) #instr,
+const char *const OPCODE_NAMES[] = {
+    #include "isa/isa.def"
+};
+#undef DEFINE_INSTR
+// clang-format on
+
+const char *const KIND_NAMES[] = {"instr", "gc_begin", "gc_end",    "jit_begin", "jit_end",
+                                  "call",  "ret",      "alloc",     "asm_begin", "asm_end"};
+static_assert(sizeof(KIND_NAMES) / sizeof(KIND_NAMES[0]) == static_cast<size_t>(EventKind::N_KINDS));
+
+const char *const GC_PHASE_NAMES[] = {"mark", "mark_finalize", "sweep", "roots"};
+const char *const ASM_PHASE_NAMES[] = {"split_into_chunks", "gen_raw_instructions", "resolve_dependencies"};
+
+template <size_t N>
+const char *GetName(const char *const (&names)[N], size_t idx)
+{
+    return idx < N ? names[idx] : "unknown";
+}
+
+const char *GetCodeName(const Event &event)
+{
+    switch (event.kind) {
+        case EventKind::INSTRUCTION:
+            return GetName(OPCODE_NAMES, event.code);
+        case EventKind::GC_BEGIN:
+        case EventKind::GC_END:
+            return GetName(GC_PHASE_NAMES, event.code);
+        case EventKind::ASM_BEGIN:
+        case EventKind::ASM_END:
+            return GetName(ASM_PHASE_NAMES, event.code);
+        default:
+            return "-";
+    }
+}
+
+std::atomic<uint32_t> g_n_threads {0};
+
+uint32_t GetThreadNumber()
+{
+    thread_local uint32_t number = g_n_threads++;
+    return number;
+}
+
+// Calibration point of GetTime() taken by Enable()
+uint64_t g_start_ticks = 0;
+uint64_t g_start_ns = 0;
+
+uint64_t GetMonotonicNs()
+{
+    // clock_gettime is async-signal-safe, unlike std::chrono
+    timespec ts {};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000U + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+// Lines of the dump are formatted in a stack buffer without allocations
+class LineWriter {
+public:
+    explicit LineWriter(int fd) : fd_(fd) {}
+
+    void Str(const char *str)
+    {
+        size_t length = std::strlen(str);
+        if (length > sizeof(buffer_) - size_) {
+            length = sizeof(buffer_) - size_;
+        }
+        std::memcpy(buffer_ + size_, str, length);
+        size_ += length;
+    }
+
+    void Uint(uint64_t value, unsigned base = 10)
+    {
+        char digits[24];
+        size_t n_digits = 0;
+        do {
+            digits[n_digits++] = "0123456789abcdef"[value % base];
+            value /= base;
+        } while (value != 0);
+        while (n_digits > 0 && size_ < sizeof(buffer_)) {
+            buffer_[size_++] = digits[--n_digits];
+        }
+    }
+
+    void Flush()
+    {
+        Str("\n");
+        for (size_t written = 0; written < size_;) {
+            ssize_t res = write(fd_, buffer_ + written, size_ - written);
+            if (res <= 0) {
+                break;
+            }
+            written += static_cast<size_t>(res);
+        }
+        size_ = 0;
+    }
+
+private:
+    int fd_;
+    char buffer_[160];
+    size_t size_ {0};
+};
+
+void HandleSignal(int signal)
+{
+    const char *header = signal == SIGUSR1 ? "Trace dump requested" : "Fatal signal, dumping trace";
+    LineWriter writer(STDERR_FILENO);
+    writer.Str(header);
+    writer.Flush();
+    Tracer::Dump(STDERR_FILENO);
+
+    // Default action was restored by SA_RESETHAND, the signal is delivered again when the handler returns
+    if (signal != SIGUSR1) {
+        raise(signal);
+    }
+}
+
+} // namespace
+
+/* static */
+void Tracer::Enable(size_t capacity, uint32_t kinds, size_t allocation_threshold)
+{
+    enabled_kinds_.store(0, std::memory_order_relaxed);
+    allocation_threshold_ = allocation_threshold;
+
+    capacity = std::bit_ceil(capacity == 0 ? 1 : capacity);
+    if (events_ == nullptr || mask_ + 1 != capacity) {
+        delete[] events_;
+        events_ = new Event[capacity]();
+        mask_ = capacity - 1;
+    } else {
+        std::memset(static_cast<void *>(events_), 0, capacity * sizeof(Event));
+    }
+    head_.store(0, std::memory_order_relaxed);
+
+    g_start_ticks = GetTime();
+    g_start_ns = GetMonotonicNs();
+
+    enabled_kinds_.store(kinds, std::memory_order_release);
+}
+
+/* static */
+void Tracer::Disable()
+{
+    // Buffer is kept for dumps after the traced code
+    enabled_kinds_.store(0, std::memory_order_relaxed);
+}
+
+/* static */
+void Tracer::RecordSlow(EventKind kind, uint8_t code, uint32_t pc, uint16_t arg)
+{
+    uint64_t index = head_.fetch_add(1, std::memory_order_relaxed);
+    Event *event = &events_[index & mask_];
+    event->time = GetTime();
+    event->pc = pc;
+    event->thread = GetThreadNumber();
+    event->kind = kind;
+    event->code = code;
+    event->arg = arg;
+    // Slot is published last, readers skip slots which are being rewritten
+    __atomic_store_n(&event->index, index + 1, __ATOMIC_RELEASE);
+}
+
+/* static */
+size_t Tracer::Collect(Event *out, size_t max_events)
+{
+    if (events_ == nullptr) {
+        return 0;
+    }
+
+    uint64_t head = head_.load(std::memory_order_acquire);
+    uint64_t capacity = mask_ + 1;
+    uint64_t first = head > capacity ? head - capacity : 0;
+
+    size_t n_collected = 0;
+    for (uint64_t index = first; index < head && n_collected < max_events; ++index) {
+        const Event &event = events_[index & mask_];
+        if (__atomic_load_n(&event.index, __ATOMIC_ACQUIRE) != index + 1) {
+            continue;
+        }
+        out[n_collected] = event;
+        out[n_collected].index = index;
+        ++n_collected;
+    }
+    return n_collected;
+}
+
+/* static */
+void Tracer::Dump(int fd)
+{
+    LineWriter writer(fd);
+    uint64_t head = head_.load(std::memory_order_acquire);
+    writer.Str("# index time_ns event name pc");
+    writer.Flush();
+    if (events_ == nullptr) {
+        return;
+    }
+
+    double ns_per_tick = GetNsPerTick();
+    uint64_t capacity = mask_ + 1;
+    for (uint64_t index = head > capacity ? head - capacity : 0; index < head; ++index) {
+        const Event &event = events_[index & mask_];
+        if (__atomic_load_n(&event.index, __ATOMIC_ACQUIRE) != index + 1) {
+            continue;
+        }
+
+        uint64_t ticks = event.time >= g_start_ticks ? event.time - g_start_ticks : 0;
+        writer.Uint(index);
+        writer.Str(" ");
+        writer.Uint(static_cast<uint64_t>(static_cast<double>(ticks) * ns_per_tick));
+        writer.Str(" ");
+        writer.Str(GetName(KIND_NAMES, static_cast<size_t>(event.kind)));
+        writer.Str(" ");
+        writer.Str(GetCodeName(event));
+        writer.Str(" 0x");
+        writer.Uint(event.pc, 16);
+        writer.Flush();
+    }
+}
+
+/* static */
+bool Tracer::ExportChromeTrace(const char *path, const std::function<std::string(uint32_t pc)> &pc_name)
+{
+    std::vector<Event> events(mask_ + 1);
+    events.resize(Collect(events.data(), events.size()));
+
+    FILE *file = std::fopen(path, "w");
+    if (file == nullptr) {
+        return false;
+    }
+
+    // Spans are "B"/"E" pairs on the track of the recording thread, timestamps are in microseconds
+    double us_per_tick = GetNsPerTick() / 1000;
+    std::fprintf(file, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n");
+    bool is_first = true;
+    for (const Event &event : events) {
+        const char *phase = nullptr;
+        const char *category = nullptr;
+        std::string name = GetCodeName(event);
+        std::string args;
+        switch (event.kind) {
+            case EventKind::GC_BEGIN:
+            case EventKind::GC_END:
+                phase = event.kind == EventKind::GC_BEGIN ? "B" : "E";
+                category = "gc";
+                break;
+            case EventKind::ASM_BEGIN:
+            case EventKind::ASM_END:
+                phase = event.kind == EventKind::ASM_BEGIN ? "B" : "E";
+                category = "assembler";
+                break;
+            case EventKind::JIT_BEGIN:
+            case EventKind::JIT_END:
+                phase = event.kind == EventKind::JIT_BEGIN ? "B" : "E";
+                category = "jit";
+                name = "compile " + pc_name(event.pc);
+                break;
+            case EventKind::CALL:
+                phase = "B";
+                category = "bytecode";
+                name = pc_name(event.pc);
+                break;
+            case EventKind::RET:
+                phase = "E";
+                category = "bytecode";
+                name.clear();
+                break;
+            case EventKind::ALLOCATION:
+                phase = "i";
+                category = "memory";
+                name = "alloc";
+                args = ", \"s\": \"t\", \"args\": {\"size\": " + std::to_string(event.pc) + "}";
+                break;
+            default:
+                continue;
+        }
+
+        double ts = static_cast<double>(event.time - std::min(event.time, g_start_ticks)) * us_per_tick;
+        std::fprintf(file,
+                     "%s{\"name\": \"%s\", \"cat\": \"%s\", \"ph\": \"%s\", \"ts\": %.3f, "
+                     "\"pid\": 1, \"tid\": %u%s}",
+                     is_first ? "" : ",\n", name.c_str(), category, phase, ts, event.thread, args.c_str());
+        is_first = false;
+    }
+    std::fprintf(file, "\n]}\n");
+    return std::fclose(file) == 0;
+}
+
+/* static */
+void Tracer::InstallSignalHandlers()
+{
+    struct sigaction action {};
+    action.sa_handler = HandleSignal;
+    sigemptyset(&action.sa_mask);
+
+    action.sa_flags = SA_RESETHAND;
+    for (int signal : {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT}) {
+        sigaction(signal, &action, nullptr);
+    }
+
+    action.sa_flags = SA_RESTART;
+    sigaction(SIGUSR1, &action, nullptr);
+}
+
+/* static */
+uint64_t Tracer::GetTime()
+{
+#if defined(__x86_64__)
+    return __rdtsc();
+#else
+    return GetMonotonicNs();
+#endif
+}
+
+/* static */
+double Tracer::GetNsPerTick()
+{
+#if defined(__x86_64__)
+    uint64_t ticks = GetTime() - g_start_ticks;
+    uint64_t ns = GetMonotonicNs() - g_start_ns;
+    return ticks == 0 ? 1.0 : static_cast<double>(ns) / static_cast<double>(ticks);
+#else
+    return 1.0;
+#endif
+}
+
+} // namespace evm::trace
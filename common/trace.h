@@ -0,0 +1,168 @@
+#ifndef EVM_COMMON_TRACE_H
+#define EVM_COMMON_TRACE_H
+
+#include "common/macros.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace evm::trace {
+
+enum class EventKind : uint8_t {
+    INSTRUCTION, // code is opcode, pc is pc of the instruction
+    GC_BEGIN,    // code is GcPhase
+    GC_END,
+    JIT_BEGIN, // pc is the start of compiled region
+    JIT_END,
+    CALL,       // pc is the first instruction of callee
+    RET,        // pc is the return address in caller
+    ALLOCATION, // pc is the size of object
+    ASM_BEGIN,  // code is AsmPhase
+    ASM_END,
+    N_KINDS,
+};
+
+enum class GcPhase : uint8_t {
+    MARK,
+    MARK_FINALIZE,
+    SWEEP,
+    ROOTS,
+};
+
+enum class AsmPhase : uint8_t {
+    SPLIT_INTO_CHUNKS,
+    GEN_RAW_INSTRUCTIONS,
+    RESOLVE_DEPENDENCIES,
+};
+
+constexpr uint32_t KindBit(EventKind kind)
+{
+    return 1U << static_cast<uint32_t>(kind);
+}
+
+/// Binary record of the ring buffer, written without formatting
+struct Event {
+    uint64_t time;  // ticks of Tracer::GetTime()
+    uint64_t index; // sequence number, the slot holds a complete event when it matches
+    uint32_t pc;
+    uint32_t thread; // small sequential number of the recording thread
+    EventKind kind;
+    uint8_t code;
+    uint16_t arg;
+};
+
+/// In-memory ring buffer of the last events. Writers only reserve a slot with atomic increment,
+/// so recording is lock-free and cheap enough to be kept in release builds; disabled tracer costs one load.
+/// Buffer is dumped on demand (Dump(), SIGUSR1) or when the process crashes (see InstallSignalHandlers()),
+/// or exported as a timeline for Chrome trace viewer and Perfetto.
+class Tracer {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 1U << 16;
+    static constexpr uint32_t ALL_KINDS = KindBit(EventKind::N_KINDS) - 1;
+    // Timeline is too dense with every instruction
+    static constexpr uint32_t TIMELINE_KINDS = ALL_KINDS & ~KindBit(EventKind::INSTRUCTION);
+    static constexpr size_t DEFAULT_ALLOCATION_THRESHOLD = 4096;
+
+    NO_COPY_SEMANTIC(Tracer);
+    NO_MOVE_SEMANTIC(Tracer);
+
+    /// Capacity is rounded up to a power of two, events over it overwrite the oldest ones.
+    /// Only events of the given kinds are recorded, allocations are recorded from the given size
+    static void Enable(size_t capacity = DEFAULT_CAPACITY, uint32_t kinds = ALL_KINDS,
+                       size_t allocation_threshold = DEFAULT_ALLOCATION_THRESHOLD);
+    static void Disable();
+
+    static bool IsEnabled()
+    {
+        return enabled_kinds_.load(std::memory_order_relaxed) != 0;
+    }
+
+    static bool IsEnabled(EventKind kind)
+    {
+        return (enabled_kinds_.load(std::memory_order_relaxed) & KindBit(kind)) != 0;
+    }
+
+    static ALWAYS_INLINE void Record(EventKind kind, uint8_t code, uint32_t pc, uint16_t arg = 0)
+    {
+        if (LIKELY(!IsEnabled(kind))) {
+            return;
+        }
+        RecordSlow(kind, code, pc, arg);
+    }
+
+    static ALWAYS_INLINE void RecordAllocation(size_t size)
+    {
+        if (LIKELY(!IsEnabled(EventKind::ALLOCATION)) || size < allocation_threshold_) {
+            return;
+        }
+        RecordSlow(EventKind::ALLOCATION, 0, static_cast<uint32_t>(size), 0);
+    }
+
+    /// Copies events from the oldest one to out, returns the number of copied events
+    static size_t Collect(Event *out, size_t max_events);
+
+    /// Number of recorded events, including overwritten ones
+    static uint64_t GetRecordedCount()
+    {
+        return head_.load(std::memory_order_acquire);
+    }
+
+    /// Writes events as text lines, only async-signal-safe calls are used
+    static void Dump(int fd);
+
+    /// Writes events in Chrome trace event format, pc_name gives names to called functions and compiled regions
+    static bool ExportChromeTrace(const char *path, const std::function<std::string(uint32_t pc)> &pc_name);
+
+    /// Dumps the buffer to stderr on SIGSEGV, SIGBUS, SIGFPE, SIGILL and SIGABRT before the default action,
+    /// and on SIGUSR1 without stopping the process
+    static void InstallSignalHandlers();
+
+    static uint64_t GetTime();
+
+    /// Duration of a tick of GetTime() measured from Enable() till now
+    static double GetNsPerTick();
+
+private:
+    Tracer() = default;
+
+    static void RecordSlow(EventKind kind, uint8_t code, uint32_t pc, uint16_t arg);
+
+private:
+    static std::atomic<uint32_t> enabled_kinds_;
+    static std::atomic<uint64_t> head_;
+    static Event *events_;
+    static size_t mask_;
+    static size_t allocation_threshold_;
+};
+
+/// Records the begin event at construction and the end event when the scope is left
+class ScopedTrace {
+public:
+    NO_COPY_SEMANTIC(ScopedTrace);
+    NO_MOVE_SEMANTIC(ScopedTrace);
+
+    ScopedTrace(EventKind begin, EventKind end, uint8_t code, uint32_t pc = 0) : end_(end), code_(code), pc_(pc)
+    {
+        Tracer::Record(begin, code, pc);
+    }
+
+    ~ScopedTrace()
+    {
+        Tracer::Record(end_, code_, pc_);
+    }
+
+private:
+    EventKind end_;
+    uint8_t code_;
+    uint32_t pc_;
+};
+
+} // namespace evm::trace
+
+#define TRACE_EVENT(kind, code, pc) \
+    evm::trace::Tracer::Record(evm::trace::EventKind::kind, static_cast<uint8_t>(code), static_cast<uint32_t>(pc))
+
+#endif // EVM_COMMON_TRACE_H
@@ -0,0 +1,178 @@
+#ifndef EVM_COMMON_UTILS_CHUNKED_VECTOR_H
+#define EVM_COMMON_UTILS_CHUNKED_VECTOR_H
+
+#include "common/macros.h"
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace evm::common {
+
+// Sequence with stable element addresses: elements are stored in chunks of fixed capacity which are never
+// reallocated, so pointers to elements survive growth. Chunks of another sequence can be moved to the end
+// of this one without moving elements themselves
+template <typename T, size_t CHUNK_CAPACITY = 1024>
+class ChunkedVector {
+    using Chunk = std::vector<T>;
+
+    template <bool IS_CONST>
+    class Iterator {
+        using ChunkPtr = std::conditional_t<IS_CONST, const std::unique_ptr<Chunk>, std::unique_ptr<Chunk>>;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<IS_CONST, const T *, T *>;
+        using reference = std::conditional_t<IS_CONST, const T &, T &>;
+
+        Iterator() = default;
+        Iterator(ChunkPtr *chunk, ChunkPtr *chunks_end, size_t idx) : chunk_(chunk), chunks_end_(chunks_end), idx_(idx)
+        {
+            SkipEmptyChunks();
+        }
+
+        reference operator*() const
+        {
+            return (**chunk_)[idx_];
+        }
+
+        pointer operator->() const
+        {
+            return &(**chunk_)[idx_];
+        }
+
+        Iterator &operator++()
+        {
+            if (++idx_ == (*chunk_)->size()) {
+                ++chunk_;
+                idx_ = 0;
+                SkipEmptyChunks();
+            }
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            Iterator prev = *this;
+            ++(*this);
+            return prev;
+        }
+
+        bool operator==(const Iterator &other) const
+        {
+            return chunk_ == other.chunk_ && idx_ == other.idx_;
+        }
+
+    private:
+        void SkipEmptyChunks()
+        {
+            while (chunk_ != chunks_end_ && (*chunk_)->empty()) {
+                ++chunk_;
+            }
+        }
+
+        ChunkPtr *chunk_ {nullptr};
+        ChunkPtr *chunks_end_ {nullptr};
+        size_t idx_ {0};
+    };
+
+public:
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+public:
+    NO_COPY_SEMANTIC(ChunkedVector);
+    DEFAULT_MOVE_SEMANTIC(ChunkedVector);
+
+    ChunkedVector() = default;
+    ~ChunkedVector() = default;
+
+    template <typename... Args>
+    T &emplace_back(Args &&...args)
+    {
+        if (chunks_.empty() || chunks_.back()->size() == CHUNK_CAPACITY) {
+            chunks_.push_back(std::make_unique<Chunk>());
+            chunks_.back()->reserve(CHUNK_CAPACITY);
+        }
+
+        ++size_;
+        return chunks_.back()->emplace_back(std::forward<Args>(args)...);
+    }
+
+    void push_back(T &&value)
+    {
+        emplace_back(std::move(value));
+    }
+
+    // Moves all elements of other to the end, their addresses are not changed
+    void Splice(ChunkedVector *other)
+    {
+        for (auto &chunk : other->chunks_) {
+            chunks_.push_back(std::move(chunk));
+        }
+
+        size_ += other->size_;
+        other->clear();
+    }
+
+    T &back()
+    {
+        assert(!empty());
+        return chunks_.back()->back();
+    }
+
+    const T &back() const
+    {
+        assert(!empty());
+        return chunks_.back()->back();
+    }
+
+    size_t size() const
+    {
+        return size_;
+    }
+
+    bool empty() const
+    {
+        return size_ == 0;
+    }
+
+    void clear()
+    {
+        chunks_.clear();
+        size_ = 0;
+    }
+
+    iterator begin()
+    {
+        return iterator(chunks_.data(), chunks_.data() + chunks_.size(), 0);
+    }
+
+    iterator end()
+    {
+        return iterator(chunks_.data() + chunks_.size(), chunks_.data() + chunks_.size(), 0);
+    }
+
+    const_iterator begin() const
+    {
+        return const_iterator(chunks_.data(), chunks_.data() + chunks_.size(), 0);
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator(chunks_.data() + chunks_.size(), chunks_.data() + chunks_.size(), 0);
+    }
+
+private:
+    std::vector<std::unique_ptr<Chunk>> chunks_;
+    size_t size_ {0};
+};
+
+} // namespace evm::common
+
+#endif // EVM_COMMON_UTILS_CHUNKED_VECTOR_H
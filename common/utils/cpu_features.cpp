@@ -0,0 +1,24 @@
+#include "common/utils/cpu_features.h"
+
+namespace evm::common {
+
+static CpuFeatures DetectCpuFeatures()
+{
+    CpuFeatures features;
+
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    features.sse42 = __builtin_cpu_supports("sse4.2");
+    features.avx2 = __builtin_cpu_supports("avx2");
+#endif
+
+    return features;
+}
+
+const CpuFeatures &GetCpuFeatures()
+{
+    static const CpuFeatures features = DetectCpuFeatures();
+    return features;
+}
+
+} // namespace evm::common
@@ -0,0 +1,16 @@
+#ifndef EVM_COMMON_UTILS_CPU_FEATURES_H
+#define EVM_COMMON_UTILS_CPU_FEATURES_H
+
+namespace evm::common {
+
+struct CpuFeatures {
+    bool sse42 {false};
+    bool avx2 {false};
+};
+
+/// Features are queried via CPUID only once, on the first call
+const CpuFeatures &GetCpuFeatures();
+
+} // namespace evm::common
+
+#endif // EVM_COMMON_UTILS_CPU_FEATURES_H
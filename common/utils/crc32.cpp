@@ -0,0 +1,131 @@
+#include "common/utils/crc32.h"
+#include "common/utils/cpu_features.h"
+
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#endif
+
+namespace evm::common {
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "Slicing-by-8 implementation relies on little endian");
+
+// Reversed Castagnoli polynomial: the same one is used by SSE4.2 crc32 instruction
+static constexpr uint32_t CRC32C_POLY = 0x82f63b78;
+static constexpr size_t N_SLICES = 8;
+
+using Crc32Tables = std::array<std::array<uint32_t, 256>, N_SLICES>;
+
+static constexpr Crc32Tables GenerateCrc32Tables()
+{
+    Crc32Tables tables {};
+
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t crc = i;
+        for (size_t bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ ((crc & 1) ? CRC32C_POLY : 0);
+        }
+        tables[0][i] = crc;
+    }
+
+    for (uint32_t i = 0; i < 256; ++i) {
+        for (size_t slice = 1; slice < N_SLICES; ++slice) {
+            uint32_t prev = tables[slice - 1][i];
+            tables[slice][i] = (prev >> 8) ^ tables[0][prev & UINT8_MAX];
+        }
+    }
+
+    return tables;
+}
+
+static constexpr Crc32Tables CRC32_TABLES = GenerateCrc32Tables();
+
+uint32_t Crc32SlicingBy8(const uint8_t *data, size_t len, uint32_t crc)
+{
+    crc ^= UINT32_MAX;
+
+    while (len >= N_SLICES) {
+        uint64_t word = 0;
+        std::memcpy(&word, data, sizeof(word));
+
+        uint32_t lo = crc ^ static_cast<uint32_t>(word);
+        uint32_t hi = static_cast<uint32_t>(word >> 32);
+
+        // clang-format off
+        crc = CRC32_TABLES[7][lo & UINT8_MAX]         ^ CRC32_TABLES[6][(lo >> 8) & UINT8_MAX] ^
+              CRC32_TABLES[5][(lo >> 16) & UINT8_MAX] ^ CRC32_TABLES[4][lo >> 24] ^
+              CRC32_TABLES[3][hi & UINT8_MAX]         ^ CRC32_TABLES[2][(hi >> 8) & UINT8_MAX] ^
+              CRC32_TABLES[1][(hi >> 16) & UINT8_MAX] ^ CRC32_TABLES[0][hi >> 24];
+        // clang-format on
+
+        data += N_SLICES;
+        len -= N_SLICES;
+    }
+
+    while (len--) {
+        crc = CRC32_TABLES[0][(crc ^ *data++) & UINT8_MAX] ^ (crc >> 8);
+    }
+
+    return crc ^ UINT32_MAX;
+}
+
+#if defined(__x86_64__)
+
+__attribute__((target("sse4.2"))) uint32_t Crc32Sse42(const uint8_t *data, size_t len, uint32_t crc)
+{
+    uint64_t crc64 = crc ^ UINT32_MAX;
+
+    while (len >= sizeof(uint64_t)) {
+        uint64_t word = 0;
+        std::memcpy(&word, data, sizeof(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+
+        data += sizeof(uint64_t);
+        len -= sizeof(uint64_t);
+    }
+
+    auto crc32 = static_cast<uint32_t>(crc64);
+    while (len--) {
+        crc32 = _mm_crc32_u8(crc32, *data++);
+    }
+
+    return crc32 ^ UINT32_MAX;
+}
+
+bool IsCrc32HwSupported()
+{
+    return GetCpuFeatures().sse42;
+}
+
+#else
+
+uint32_t Crc32Sse42(const uint8_t *data, size_t len, uint32_t crc)
+{
+    return Crc32SlicingBy8(data, len, crc);
+}
+
+bool IsCrc32HwSupported()
+{
+    return false;
+}
+
+#endif // __x86_64__
+
+using Crc32Impl = uint32_t (*)(const uint8_t *, size_t, uint32_t);
+
+static Crc32Impl SelectCrc32Impl()
+{
+    return IsCrc32HwSupported() ? Crc32Sse42 : Crc32SlicingBy8;
+}
+
+// Selected once during static initialization
+static const Crc32Impl CRC32_IMPL = SelectCrc32Impl();
+
+uint32_t Crc32(const uint8_t *data, size_t len, uint32_t crc)
+{
+    return CRC32_IMPL(data, len, crc);
+}
+
+} // namespace evm::common
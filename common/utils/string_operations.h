@@ -1,7 +1,9 @@
 #ifndef EVM_COMMON_UTILS_STRING_OPERATIONS_H
 #define EVM_COMMON_UTILS_STRING_OPERATIONS_H
 
+#include <charconv>
 #include <string>
+#include <string_view>
 #include <sstream>
 
 namespace evm::common {
@@ -15,6 +17,19 @@ bool IsNumber(const std::string &str)
     return ((std::istringstream(str) >> number >> std::ws).eof());
 }
 
+/// Parse the whole string as a number without allocations, leading '+' is allowed
+template <typename Numeric>
+bool StrToNumber(std::string_view str, Numeric *number)
+{
+    if (!str.empty() && str.front() == '+') {
+        str.remove_prefix(1);
+    }
+
+    const char *end = str.data() + str.size();
+    auto [ptr, error] = std::from_chars(str.data(), end, *number);
+    return error == std::errc() && ptr == end;
+}
+
 } // namespace evm::common
 
 #endif // EVM_COMMON_UTILS_STRING_OPERATIONS_H
@@ -1,6 +1,7 @@
 #ifndef EVM_ASSEMBLER_ASM_TO_BYTE__CLASS_SECTION_H
 #define EVM_ASSEMBLER_ASM_TO_BYTE__CLASS_SECTION_H
 
+#include "common/logs.h"
 #include "common/macros.h"
 #include "common/constants.h"
 #include "common/emittable.h"
@@ -37,6 +38,17 @@ public:
         return class_idx_;
     }
 
+    // Class of another chunk is referred by name till classes of all chunks are merged
+    void SetClassRefName(const std::string &class_name)
+    {
+        class_ref_name_ = class_name;
+    }
+
+    const std::string &GetClassRefName() const
+    {
+        return class_ref_name_;
+    }
+
     void SetArraySize(size_t array_size)
     {
         array_size_ = array_size;
@@ -88,7 +100,7 @@ public:
         return sizeof(Type) + sizeof(EmitClassIdx) + sizeof(EmitArraySize) + Emittable::GetSize();
     }
 
-    EmitSize EmitBytecode(std::vector<byte_t> *out_arr)
+    EmitSize EmitBytecode(EmitBuffer *out_arr)
     {
         EmitSize emit_size = 0;
 
@@ -119,6 +131,9 @@ private:
     // if class_idx_ < 0 then element respond to cast static_cast<Type>(class_idx_)
     EmitClassIdx class_idx_ = -1;
     EmitArraySize array_size_ = 0;
+
+    // Not emitted: empty when class_idx_ is resolved
+    std::string class_ref_name_;
 };
 
 class Class : public Section<ClassField> {
@@ -146,6 +161,45 @@ public:
     {
         return 0; // Class section do nothing in runtime
     }
+
+    // Moves classes of separately assembled section to the end of this one
+    void Append(ClassSection *other)
+    {
+        auto class_idx_shift = static_cast<int16_t>(instances_.size());
+
+        for (auto &cls : *other->GetInstances()) {
+            for (auto &field : *cls.GetInstances()) {
+                // Negative indices are primitive types, fields referring to classes by name are resolved later
+                auto class_idx = static_cast<int16_t>(field.GetClassRefIdx());
+                if (class_idx >= 0 && field.GetClassRefName().empty()) {
+                    field.SetClassRefIdx(static_cast<hword_t>(class_idx + class_idx_shift));
+                }
+            }
+            instances_.push_back(std::move(cls));
+        }
+
+        other->ClearInstances();
+    }
+
+    // Resolves fields referring to classes by name, once all classes of the program are in the section
+    bool ResolveClassRefs()
+    {
+        for (auto &cls : instances_) {
+            for (auto &field : *cls.GetInstances()) {
+                if (field.GetClassRefName().empty()) {
+                    continue;
+                }
+                ssize_t class_idx = GetIdxOfInstance(field.GetClassRefName());
+                if (class_idx == -1) {
+                    PrintErr("Usage of undefined class \"", field.GetClassRefName(), "\"");
+                    return false;
+                }
+                field.SetClassRefIdx(static_cast<hword_t>(class_idx));
+                field.SetClassRefName({});
+            }
+        }
+        return true;
+    }
 };
 
 } // namespace evm::file_format
@@ -4,6 +4,7 @@
 #include "common/logs.h"
 #include "common/config.h"
 #include "common/utils/bitops.h"
+#include "common/utils/chunked_vector.h"
 #include "common/macros.h"
 #include "common/constants.h"
 #include "common/emittable.h"
@@ -12,6 +13,7 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <stack>
 
@@ -19,8 +21,6 @@ namespace evm::file_format {
 
 class CodeSection : public Offsetable {
 public:
-    static constexpr size_t N_MAX_INSTRS = 1 << 15;
-
     enum class ResolutionReason {
         LABEL_REF,
         CLASS_REF,
@@ -29,12 +29,9 @@ public:
 
 public:
     DEFAULT_MOVE_SEMANTIC(CodeSection);
-    DEFAULT_COPY_SEMANTIC(CodeSection);
+    NO_COPY_SEMANTIC(CodeSection);
 
-    CodeSection(const std::string &name, EmitRef offset = 0) : Offsetable(name, offset)
-    {
-        instructions_.reserve(N_MAX_INSTRS);
-    }
+    CodeSection(const std::string &name, EmitRef offset = 0) : Offsetable(name, offset) {}
 
     ~CodeSection() = default;
 
@@ -43,13 +40,25 @@ public:
         return size_;
     }
 
+    // Instructions never move, so references to them in resolution tables are stable
+    const common::ChunkedVector<Instruction> &GetInstructions() const
+    {
+        return instructions_;
+    }
+
+    /// Offsets of labels relative to the code section
+    const std::unordered_map<std::string, size_t> &GetLabels() const
+    {
+        return labels_;
+    }
+
     // ':' at the end of label
-    void AddLabel(const std::string &label)
+    void AddLabel(std::string_view label)
     {
-        labels_.insert({label.substr(0, label.size() - 1), size_});
+        labels_.emplace(label.substr(0, label.size() - 1), size_);
     }
 
-    Instruction *AddInstr(const std::string &name, const Opcode opcode)
+    Instruction *AddInstr(std::string_view name, const Opcode opcode)
     {
         if (need_to_validate_last_instr_ == true) {
             PrintErr("Cannot add instruction [", name, ", opcode=", (int)opcode,
@@ -57,9 +66,9 @@ public:
             return nullptr;
         }
 
-        instructions_.push_back({name, opcode});
+        Instruction *instr = &instructions_.emplace_back(std::string(name), opcode);
         need_to_validate_last_instr_ = true;
-        return &instructions_.back();
+        return instr;
     }
 
     void ValidateLastInstr()
@@ -69,18 +78,18 @@ public:
         need_to_validate_last_instr_ = false;
     }
 
-    void AddInstrToResolve(const std::string &unresolved_name, Instruction *instr,
+    void AddInstrToResolve(std::string_view unresolved_name, Instruction *instr,
                            ResolutionReason reason = ResolutionReason::LABEL_REF)
     {
         switch (reason) {
             case ResolutionReason::LABEL_REF:
-                label_resolution_table_.push({unresolved_name, instr});
+                label_resolution_table_.push({std::string(unresolved_name), instr});
                 break;
             case ResolutionReason::CLASS_REF:
-                class_resolution_table_.push({unresolved_name, instr});
+                class_resolution_table_.push({std::string(unresolved_name), instr});
                 break;
             case ResolutionReason::CLASS_FIELD_REF:
-                class_fields_resolution_table_.push({unresolved_name, instr});
+                class_fields_resolution_table_.push({std::string(unresolved_name), instr});
                 break;
             default:
                 return;
@@ -108,7 +117,29 @@ public:
         return resolved_labels && resolved_classes && resolved_class_fields;
     }
 
-    EmitSize EmitBytecode(std::vector<byte_t> *out_arr)
+    // Moves instructions, labels and unresolved references of separately assembled section to the end of this one
+    void Append(CodeSection *other)
+    {
+        for (auto &instr : other->instructions_) {
+            instr.SetOffset(instr.GetOffset() + size_);
+        }
+        instructions_.Splice(&other->instructions_);
+
+        for (auto &[label, offset] : other->labels_) {
+            labels_.emplace(label, offset + size_);
+        }
+
+        AppendResolutionTable(&label_resolution_table_, &other->label_resolution_table_);
+        AppendResolutionTable(&class_resolution_table_, &other->class_resolution_table_);
+        AppendResolutionTable(&class_fields_resolution_table_, &other->class_fields_resolution_table_);
+
+        size_ += other->size_;
+
+        other->labels_.clear();
+        other->size_ = 0;
+    }
+
+    EmitSize EmitBytecode(EmitBuffer *out_arr)
     {
         EmitSize instrs_size = 0;
         for (auto &it : instructions_) {
@@ -129,6 +160,17 @@ public:
     }
 
 private:
+    using ResolutionTable = std::stack<std::pair<std::string, Instruction *>>;
+
+    static void AppendResolutionTable(ResolutionTable *to, ResolutionTable *from)
+    {
+        // Tables are resolved as a whole, so order of references doesn't matter
+        while (!from->empty()) {
+            to->push(std::move(from->top()));
+            from->pop();
+        }
+    }
+
     size_t ResolveLabelRefs()
     {
         size_t n_unresolved_labels = 0;
@@ -228,12 +270,12 @@ private:
     }
 
 private:
-    std::stack<std::pair<std::string, Instruction *>> label_resolution_table_;
-    std::stack<std::pair<std::string, Instruction *>> class_resolution_table_;
-    std::stack<std::pair<std::string, Instruction *>> class_fields_resolution_table_;
+    ResolutionTable label_resolution_table_;
+    ResolutionTable class_resolution_table_;
+    ResolutionTable class_fields_resolution_table_;
 
     std::unordered_map<std::string, size_t> labels_;
-    std::vector<Instruction> instructions_;
+    common::ChunkedVector<Instruction> instructions_;
 
     size_t size_ = 0;
     bool need_to_validate_last_instr_ = false;
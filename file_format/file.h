@@ -8,6 +8,7 @@
 #include "header.h"
 #include "code_section.h"
 
+#include <cassert>
 #include <fstream>
 #include <vector>
 
@@ -16,7 +17,7 @@ namespace evm::file_format {
 class File : public Emittable {
 public:
     DEFAULT_MOVE_SEMANTIC(File);
-    DEFAULT_COPY_SEMANTIC(File);
+    NO_COPY_SEMANTIC(File);
 
     File() : Emittable(""), header_(""), code_section_(".code") {}
 
@@ -39,12 +40,35 @@ public:
         return (*classes)[idx_in_class_section];
     }
 
+    // Moves contents of separately assembled file to the end of this one.
+    // Dependencies of both files must not be resolved yet, they are resolved for the merged file
+    bool Append(File *other)
+    {
+        if (resolved_dependencies_ || other->resolved_dependencies_) {
+            PrintErr("Cannot append files with resolved dependencies");
+            return false;
+        }
+
+        // Instructions keep their addresses, so references to them stay valid
+        code_section_.Append(&other->code_section_);
+        header_.GetStringPool()->Append(other->header_.GetStringPool());
+        header_.GetClassSection()->Append(other->header_.GetClassSection());
+
+        return true;
+    }
+
     bool ResolveDependencies()
     {
         if (resolved_dependencies_ == true) {
             return true;
         }
 
+        ClassSection *class_section = header_.GetClassSection();
+        if (class_section->ResolveClassRefs() == false) {
+            PrintErr("Couldn't resolve all class references of fields");
+            return false;
+        }
+
         StringPool *string_pool = header_.GetStringPool();
         string_pool->SetOffset(header_.GetDataOffset());
 
@@ -53,7 +77,6 @@ public:
             return false;
         }
 
-        ClassSection *class_section = header_.GetClassSection();
         class_section->SetOffset(string_pool->GetOffset() + string_pool->GetSize());
 
         code_section_.SetOffset(class_section->GetOffset() + class_section->GetSize());
@@ -65,9 +88,22 @@ public:
         return resolved_dependencies_ = true;
     }
 
+    size_t GetBytecodeSize() const
+    {
+        return header_.GetSize() + code_section_.GetSize();
+    }
+
+    // Output is sized once and every section is written straight into it
     EmitSize EmitBytecode(std::vector<byte_t> *bytecode)
     {
-        return header_.EmitBytecode(bytecode) + code_section_.EmitBytecode(bytecode);
+        assert(bytecode->empty());
+        bytecode->resize(GetBytecodeSize());
+
+        EmitBuffer buffer(bytecode->data(), bytecode->size());
+        EmitSize emit_size = header_.EmitBytecode(&buffer) + code_section_.EmitBytecode(&buffer);
+        assert(buffer.GetPosition() == bytecode->size());
+
+        return emit_size;
     }
 
     bool EmitBytecode()
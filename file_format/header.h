@@ -78,13 +78,12 @@ public:
         return code_section_offset_;
     }
 
-    EmitSize EmitBytecode(std::vector<byte_t> *out_arr)
+    // Header is always emitted at the start of bytecode
+    EmitSize EmitBytecode(EmitBuffer *out_arr)
     {
-        assert(out_arr->size() == 0);
+        assert(out_arr->GetPosition() == 0);
         EmitRef current_offset = 0;
 
-        out_arr->reserve(GetDataOffset() + string_pool_.GetSize() + class_section_.GetSize());
-
         const EmitMagic magic = MAGIC_NUMBER;
         Emittable::EmitBytecode<EmitMagic>(out_arr, &magic);
 
@@ -92,15 +91,15 @@ public:
         auto *class_section_offset = Emittable::EmitEmptyBytecode<EmitRef>(out_arr);
         auto *code_section_offset = Emittable::EmitEmptyBytecode<EmitRef>(out_arr);
 
-        string_pool_offset_ = current_offset = out_arr->size();
+        string_pool_offset_ = current_offset = out_arr->GetPosition();
         memcpy(string_pool_offset, &current_offset, sizeof(current_offset));
         string_pool_.EmitBytecode(out_arr);
 
-        class_section_offset_ = current_offset = out_arr->size();
+        class_section_offset_ = current_offset = out_arr->GetPosition();
         memcpy(class_section_offset, &current_offset, sizeof(current_offset));
         class_section_.EmitBytecode(out_arr);
 
-        code_section_offset_ = current_offset = out_arr->size();
+        code_section_offset_ = current_offset = out_arr->GetPosition();
         memcpy(code_section_offset, &current_offset, sizeof(current_offset));
 
         return current_offset;
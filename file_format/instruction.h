@@ -152,7 +152,7 @@ public:
         bytcode_offset_ = offset;
     }
 
-    size_t GetOffset()
+    size_t GetOffset() const
     {
         return bytcode_offset_;
     }
@@ -168,34 +168,35 @@ public:
                (have_args_ == true) * runtime::Frame::N_PASSED_ARGS_DEFAULT;
     }
 
-    EmitSize EmitBytecode(std::vector<byte_t> *out_arr)
+    EmitSize EmitBytecode(EmitBuffer *out_arr)
     {
-        out_arr->push_back(static_cast<byte_t>(opcode_));
-        out_arr->push_back(rd_);
-        out_arr->push_back(rs1_);
-        out_arr->push_back(rs2_);
+        const size_t bytes_size = GetBytesSize();
+        byte_t *out = out_arr->Advance(bytes_size);
+
+        *out++ = static_cast<byte_t>(opcode_);
+        *out++ = rd_;
+        *out++ = rs1_;
+        *out++ = rs2_;
 
         if (obj_op_ == true) {
-            out_arr->push_back(obj_rs_);
-            out_arr->push_back(obj_field_type_);
+            *out++ = obj_rs_;
+            *out++ = obj_field_type_;
         } else if (new_arr_) {
-            out_arr->push_back(arr_size_rs_);
-            out_arr->push_back(0); // for alognment
+            *out++ = arr_size_rs_;
+            *out++ = 0; // for alognment
         }
 
         if (imm_.is_set_) {
-            size_t prev_size = out_arr->size();
-            out_arr->insert(out_arr->end(), imm_.num_bytes_, 0);
-            void *imm_ptr =
-                (imm_.num_bytes_ == 4) ? static_cast<void *>(&(imm_.imm32_)) : static_cast<void *>(&(imm_.imm64_));
-            std::memcpy(out_arr->data() + prev_size, imm_ptr, imm_.num_bytes_);
-        } else if (have_args_ == true) {
-            for (size_t i = 0; i < runtime::Frame::N_PASSED_ARGS_DEFAULT; ++i) {
-                out_arr->push_back(args_[i]);
+            if (imm_.num_bytes_ == sizeof(imm_.imm32_)) {
+                std::memcpy(out, &imm_.imm32_, sizeof(imm_.imm32_));
+            } else {
+                std::memcpy(out, &imm_.imm64_, sizeof(imm_.imm64_));
             }
+        } else if (have_args_ == true) {
+            std::memcpy(out, args_, runtime::Frame::N_PASSED_ARGS_DEFAULT);
         }
 
-        return GetBytesSize();
+        return bytes_size;
     }
 
 private:
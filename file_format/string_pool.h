@@ -33,11 +33,28 @@ public:
 
     void AddInstance(const std::string &str)
     {
-        string_map_[str] = size_;
+        string_map_[str] = string_pull_.size();
         string_pull_.push_back(str);
+        string_offsets_.push_back(size_);
         size_ += str.size() + 1;
     }
 
+    size_t GetInstancesCount() const
+    {
+        return string_pull_.size();
+    }
+
+    const std::string &GetInstance(size_t idx) const
+    {
+        return string_pull_[idx];
+    }
+
+    /// Offset of the null-terminated literal in emitted bytecode, valid after the pool offset is set
+    size_t GetInstanceOffset(size_t idx) const
+    {
+        return string_offsets_[idx] + GetDataOffset();
+    }
+
     void AddInstrToResolve(Instruction *instr)
     {
         resolution_table_.push_back(instr);
@@ -50,8 +67,11 @@ public:
             return false;
         }
 
+        // Created strings refer to the literal by its index in the pool, immutable ones use bytecode directly
         for (auto &to_resolve : resolution_table_) {
-            to_resolve->Set32Imm(string_map_[to_resolve->GetStringOp()] + GetDataOffset());
+            size_t idx = string_map_[to_resolve->GetStringOp()];
+            size_t imm = to_resolve->GetOpcode() == Opcode::NEWSTR ? idx : GetInstanceOffset(idx);
+            to_resolve->Set32Imm(static_cast<int32_t>(imm));
         }
 
         resolution_table_.clear();
@@ -59,7 +79,26 @@ public:
         return true;
     }
 
-    EmitSize EmitBytecode(std::vector<byte_t> *out_arr)
+    // Merges strings of separately assembled pool together with references to them
+    void Append(StringPool *other)
+    {
+        for (auto &str : other->string_pull_) {
+            if (!HasInstance(str)) {
+                AddInstance(str);
+            }
+        }
+
+        resolution_table_.insert(resolution_table_.end(), other->resolution_table_.begin(),
+                                 other->resolution_table_.end());
+
+        other->string_map_.clear();
+        other->string_pull_.clear();
+        other->string_offsets_.clear();
+        other->resolution_table_.clear();
+        other->size_ = 0;
+    }
+
+    EmitSize EmitBytecode(EmitBuffer *out_arr)
     {
         EmitSize emit_size = Emittable::EmitBytecode(out_arr);
 
@@ -82,8 +121,9 @@ public:
     }
 
 private:
-    std::unordered_map<std::string, size_t> string_map_;
+    std::unordered_map<std::string, size_t> string_map_; // index of the literal
     std::vector<std::string> string_pull_;
+    std::vector<size_t> string_offsets_; // from the start of the pool data
     std::vector<Instruction *> resolution_table_;
 
     size_t size_ = 0;
@@ -0,0 +1,45 @@
+#ifndef EVM_FILE_FORMAT_SYMBOLIZER_H
+#define EVM_FILE_FORMAT_SYMBOLIZER_H
+
+#include "file_format/file.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace evm::file_format {
+
+/// Names pc of emitted bytecode with the closest label at or before it, code before the first label is "main"
+class Symbolizer {
+public:
+    explicit Symbolizer(File *file)
+    {
+        CodeSection *code_section = file->GetCodeSection();
+        for (const auto &[label, offset] : code_section->GetLabels()) {
+            labels_.emplace_back(code_section->GetOffset() + offset, label);
+        }
+        // Several labels at the same pc are named by the first one in alphabetical order
+        std::sort(labels_.begin(), labels_.end());
+        labels_.erase(std::unique(labels_.begin(), labels_.end(),
+                                  [](const auto &lhs, const auto &rhs) { return lhs.first == rhs.first; }),
+                      labels_.end());
+    }
+
+    const std::string &GetName(size_t pc) const
+    {
+        auto it = std::upper_bound(labels_.begin(), labels_.end(), pc,
+                                   [](size_t value, const auto &label) { return value < label.first; });
+        return it == labels_.begin() ? MAIN : std::prev(it)->second;
+    }
+
+private:
+    static inline const std::string MAIN = "main";
+
+    std::vector<std::pair<size_t, std::string>> labels_;
+};
+
+} // namespace evm::file_format
+
+#endif // EVM_FILE_FORMAT_SYMBOLIZER_H
@@ -19,6 +19,10 @@ enum Opcode : int {
 
 // clang-format on
 
+// Opcodes are encoded in bytecode: bulk array operations keep the numbers after CPOBJ_DEEP,
+// new instructions take numbers after the last one
+static_assert(Opcode::CPOBJ_DEEP == 0x38 && Opcode::ARR_FILL == 0x39 && Opcode::ARR_INDEX_OF == 0x40);
+
 } // namespace evm
 
 #endif // EVM_ISA_OPCODES_ISA_OPCODES_H
@@ -0,0 +1,386 @@
+#include "opt/inliner.h"
+
+namespace evm::opt {
+
+namespace {
+
+constexpr size_t N_REGS = runtime::Frame::N_FRAME_REGS_DEFAULT;
+
+Instr MakeMov(int64_t rd, int64_t rs)
+{
+    Instr instr;
+    instr.opcode = Opcode::MOV;
+    instr.operands = {{Operand::Kind::REGISTER, rd, "", true}, {Operand::Kind::REGISTER, rs, "", false}};
+    return instr;
+}
+
+Instr MakeJump(const std::string &label)
+{
+    Instr instr;
+    instr.opcode = Opcode::JMP_IMM;
+    instr.operands = {{Operand::Kind::LABEL, 0, label, false}};
+    return instr;
+}
+
+// Label of function if its address is loaded to register of call in the same basic block
+const std::string *FindCallTargetInBlock(const std::vector<Instr> &instrs, const BasicBlock &block, size_t call_idx)
+{
+    int func_reg = static_cast<int>(instrs[call_idx].operands[0].value);
+
+    for (size_t i = call_idx; i-- > block.begin;) {
+        const Instr &instr = instrs[i];
+        if (instr.removed || instr.GetDef() != func_reg) {
+            continue;
+        }
+
+        if (instr.opcode == Opcode::MOVIF && instr.operands[1].kind == Operand::Kind::LABEL) {
+            return &instr.operands[1].text;
+        }
+        return nullptr;
+    }
+
+    return nullptr;
+}
+
+void CollectReachable(const std::vector<BasicBlock> &blocks, size_t entry_block, std::vector<bool> *reachable)
+{
+    reachable->assign(blocks.size(), false);
+    (*reachable)[entry_block] = true;
+
+    std::vector<size_t> worklist {entry_block};
+    while (!worklist.empty()) {
+        size_t b = worklist.back();
+        worklist.pop_back();
+
+        for (size_t succ : blocks[b].succs) {
+            if (!(*reachable)[succ]) {
+                (*reachable)[succ] = true;
+                worklist.push_back(succ);
+            }
+        }
+    }
+}
+
+void CollectRegs(const Instr &instr, RegSet *regs)
+{
+    for (const auto &operand : instr.operands) {
+        if (operand.kind == Operand::Kind::REGISTER) {
+            regs->set(operand.value);
+        }
+    }
+}
+
+} // namespace
+
+// Register defined once in function is initialized on all paths to the call if it is not live at function entry
+const std::string *Inliner::FindCallTarget(const std::vector<Function> &functions,
+                                           const std::vector<size_t> &caller_functions, const Instr &call) const
+{
+    auto func_reg = static_cast<size_t>(call.operands[0].value);
+    const std::string *label = nullptr;
+
+    for (size_t function_idx : caller_functions) {
+        const Function &function = functions[function_idx];
+        if (!function.label_regs.test(func_reg) || block_in_[function.entry_block].test(func_reg) ||
+            (label != nullptr && *label != *function.labels[func_reg])) {
+            return nullptr;
+        }
+        label = function.labels[func_reg];
+    }
+
+    return label;
+}
+
+bool Inliner::Run(Program *program)
+{
+    program->BuildCfg();
+    const auto &blocks = program->GetBlocks();
+    const auto &instrs = *program->GetInstrs();
+
+    callees_.clear();
+    std::vector<RegSet> block_out;
+    ComputeLiveness(*program, &block_in_, &block_out);
+
+    // Block belongs to all functions it is reachable from
+    std::vector<Function> functions;
+    std::vector<std::vector<size_t>> functions_of_block(blocks.size());
+    std::vector<bool> reachable;
+
+    for (size_t entry_block = 0; entry_block < blocks.size(); ++entry_block) {
+        if (!blocks[entry_block].is_entry) {
+            continue;
+        }
+
+        CollectReachable(blocks, entry_block, &reachable);
+
+        Function function;
+        function.entry_block = entry_block;
+        RegSet defined;
+
+        for (size_t b = 0; b < blocks.size(); ++b) {
+            if (!reachable[b]) {
+                continue;
+            }
+            functions_of_block[b].push_back(functions.size());
+
+            for (size_t i = blocks[b].begin; i < blocks[b].end; ++i) {
+                const Instr &instr = instrs[i];
+                if (instr.removed) {
+                    continue;
+                }
+                CollectRegs(instr, &function.regs);
+
+                int def = instr.GetDef();
+                if (def < 0) {
+                    continue;
+                }
+                if (defined.test(def)) {
+                    function.label_regs.reset(def);
+                } else if (instr.opcode == Opcode::MOVIF && instr.operands[1].kind == Operand::Kind::LABEL) {
+                    function.label_regs.set(def);
+                    function.labels[def] = &instr.operands[1].text;
+                }
+                defined.set(def);
+            }
+        }
+        functions.push_back(function);
+    }
+
+    // Instructions between target of backward jump and the jump are in a loop
+    std::vector<int> loop_depth(instrs.size() + 1, 0);
+    for (size_t i = 0; i < instrs.size(); ++i) {
+        if (instrs[i].removed || !instrs[i].IsJump()) {
+            continue;
+        }
+        size_t target = program->GetLabelTarget(instrs[i].GetJumpTarget());
+        if (target <= i) {
+            ++loop_depth[target];
+            --loop_depth[i + 1];
+        }
+    }
+    for (size_t i = 1; i < loop_depth.size(); ++i) {
+        loop_depth[i] += loop_depth[i - 1];
+    }
+
+    std::vector<CallSite> sites;
+
+    for (size_t b = 0; b < blocks.size(); ++b) {
+        for (size_t i = blocks[b].begin; i < blocks[b].end; ++i) {
+            if (instrs[i].removed || instrs[i].opcode != Opcode::CALL || functions_of_block[b].empty()) {
+                continue;
+            }
+
+            const std::string *label = FindCallTargetInBlock(instrs, blocks[b], i);
+            if (label == nullptr) {
+                label = FindCallTarget(functions, functions_of_block[b], instrs[i]);
+            }
+            const Callee *callee = label != nullptr ? FindCallee(*program, *label) : nullptr;
+            if (callee == nullptr) {
+                continue;
+            }
+
+            size_t max_size = loop_depth[i] > 0 ? MAX_HOT_CALLEE_SIZE : MAX_COLD_CALLEE_SIZE;
+            if (callee->instrs.size() > max_size || callee->instrs.size() > growth_budget_) {
+                continue;
+            }
+
+            // Registers of a new frame except arguments are zero, inlined code would read registers of the caller
+            size_t n_args = instrs[i].operands.size() - 1;
+            if ((callee->live_in >> n_args).any()) {
+                continue;
+            }
+
+            RegSet caller_regs;
+            for (size_t function : functions_of_block[b]) {
+                caller_regs |= functions[function].regs;
+            }
+
+            std::vector<int> reg_map(N_REGS, -1);
+            size_t free_reg = 0;
+            for (size_t reg = 0; reg < N_REGS && free_reg < N_REGS; ++reg) {
+                if (!callee->used_regs.test(reg)) {
+                    continue;
+                }
+                while (free_reg < N_REGS && caller_regs.test(free_reg)) {
+                    ++free_reg;
+                }
+                if (free_reg < N_REGS) {
+                    reg_map[reg] = static_cast<int>(free_reg);
+                    caller_regs.set(free_reg);
+                }
+            }
+            if (free_reg == N_REGS) {
+                continue;
+            }
+
+            for (size_t function : functions_of_block[b]) {
+                functions[function].regs |= caller_regs;
+            }
+
+            sites.emplace_back();
+            InlineCall(program, *callee, i, reg_map, &sites.back());
+
+            growth_budget_ -= callee->instrs.size();
+            ++n_inlined_calls_;
+        }
+    }
+
+    // From the end of code: indices of remaining call sites are not changed
+    auto &mutable_instrs = *program->GetInstrs();
+    for (auto it = sites.rbegin(); it != sites.rend(); ++it) {
+        if (it->accr_idx) {
+            mutable_instrs[*it->accr_idx] = std::move(it->accr_replacement);
+        }
+        program->ReplaceInstr(it->call_idx, std::move(it->instrs), std::move(it->labels));
+    }
+
+    return !sites.empty();
+}
+
+const Inliner::Callee *Inliner::FindCallee(const Program &program, const std::string &label)
+{
+    auto [it, inserted] = callees_.try_emplace(label);
+    if (!inserted) {
+        return it->second ? &*it->second : nullptr;
+    }
+
+    const auto &blocks = program.GetBlocks();
+    const auto &instrs = *program.GetInstrs();
+
+    size_t entry = program.GetLabelTarget(label);
+    size_t entry_block = program.GetBlockOf(entry);
+    if (entry_block == Program::NO_BLOCK) {
+        return nullptr;
+    }
+
+    // Function consists of blocks reachable from its entry
+    std::vector<bool> in_function;
+    CollectReachable(blocks, entry_block, &in_function);
+
+    Callee callee;
+    callee.entry = entry;
+    callee.live_in = block_in_[entry_block];
+    size_t n_rets = 0;
+
+    for (size_t b = 0; b < blocks.size(); ++b) {
+        if (!in_function[b]) {
+            continue;
+        }
+
+        // Execution falls through the end of code
+        if (b + 1 == blocks.size() && !instrs[blocks[b].end - 1].IsTerminator()) {
+            return nullptr;
+        }
+
+        for (size_t i = blocks[b].begin; i < blocks[b].end; ++i) {
+            const Instr &instr = instrs[i];
+            if (instr.removed) {
+                continue;
+            }
+
+            // Only leaf functions are inlined, so inlining never recurses
+            if (instr.opcode == Opcode::CALL) {
+                return nullptr;
+            }
+
+            if (instr.opcode == Opcode::RET) {
+                ++n_rets;
+                callee.returned_reg = -1;
+                if (!callee.instrs.empty() && callee.instrs.back() >= blocks[b].begin &&
+                    instrs[callee.instrs.back()].opcode == Opcode::RACC) {
+                    callee.returned_reg = static_cast<int>(instrs[callee.instrs.back()].operands[0].value);
+                }
+            }
+
+            CollectRegs(instr, &callee.used_regs);
+            callee.instrs.push_back(i);
+        }
+    }
+
+    if (n_rets != 1) {
+        callee.returned_reg = -1;
+    }
+
+    it->second = std::move(callee);
+    return &*it->second;
+}
+
+void Inliner::InlineCall(Program *program, const Callee &callee, size_t call_idx, const std::vector<int> &reg_map,
+                         CallSite *site)
+{
+    const auto &instrs = *program->GetInstrs();
+    const Instr &call = instrs[call_idx];
+
+    // labels.back() are placed before the next added instruction
+    site->call_idx = call_idx;
+    site->labels.emplace_back();
+    auto add_instr = [site](Instr instr) {
+        site->instrs.push_back(std::move(instr));
+        site->labels.emplace_back();
+    };
+
+    // Arguments are passed in the first registers of callee
+    for (size_t arg = 0; arg + 1 < call.operands.size(); ++arg) {
+        if (reg_map[arg] >= 0) {
+            add_instr(MakeMov(reg_map[arg], call.operands[arg + 1].value));
+        }
+    }
+
+    std::unordered_map<size_t, std::string> local_labels;
+    for (size_t idx : callee.instrs) {
+        if (instrs[idx].IsJump()) {
+            size_t target = program->GetLabelTarget(instrs[idx].GetJumpTarget());
+            if (local_labels.count(target) == 0) {
+                local_labels.emplace(target, program->CreateLabel("inlined"));
+            }
+        }
+    }
+
+    if (callee.instrs.front() != callee.entry) {
+        local_labels.emplace(callee.entry, program->CreateLabel("inlined"));
+        add_instr(MakeJump(local_labels.at(callee.entry)));
+    }
+
+    std::string return_label = program->CreateLabel("inlined_return");
+
+    for (size_t idx : callee.instrs) {
+        auto label_it = local_labels.find(idx);
+        if (label_it != local_labels.end()) {
+            site->labels.back().push_back(label_it->second);
+        }
+
+        Instr instr = instrs[idx];
+        for (auto &operand : instr.operands) {
+            if (operand.kind == Operand::Kind::REGISTER) {
+                operand.value = reg_map[operand.value];
+            }
+        }
+
+        if (instr.IsJump()) {
+            instr.operands.back().text = local_labels.at(program->GetLabelTarget(instrs[idx].GetJumpTarget()));
+        } else if (instr.opcode == Opcode::RET) {
+            instr = MakeJump(return_label);
+        }
+
+        add_instr(std::move(instr));
+    }
+
+    site->labels.back().push_back(return_label);
+
+    // Returned value is read from register directly, accumulator is still set by racc
+    if (callee.returned_reg < 0) {
+        return;
+    }
+
+    size_t next = call_idx + 1;
+    while (next < instrs.size() && instrs[next].removed && !program->HasLabels(next)) {
+        ++next;
+    }
+
+    if (next < instrs.size() && !program->HasLabels(next) && instrs[next].opcode == Opcode::ACCR) {
+        site->accr_idx = next;
+        site->accr_replacement = MakeMov(instrs[next].operands[0].value, reg_map[callee.returned_reg]);
+    }
+}
+
+} // namespace evm::opt
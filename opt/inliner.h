@@ -0,0 +1,86 @@
+#ifndef EVM_OPT_INLINER_H
+#define EVM_OPT_INLINER_H
+
+#include "common/macros.h"
+#include "opt/liveness.h"
+#include "opt/program.h"
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace evm::opt {
+
+/// Substitutes bodies of small leaf functions instead of calls: call pushes a new frame and copies arguments,
+/// inlined body uses registers of the caller which the caller doesn't use itself.
+/// Target of call is known if its address is loaded by movif in the same basic block
+/// or by the only movif of the register in the calling function
+class Inliner {
+public:
+    // Calls in loops are executed many times, bigger functions are inlined there
+    static constexpr size_t MAX_HOT_CALLEE_SIZE = 32;
+    static constexpr size_t MAX_COLD_CALLEE_SIZE = 8;
+    static constexpr size_t MIN_GROWTH_BUDGET = 256;
+
+public:
+    NO_COPY_SEMANTIC(Inliner);
+    NO_MOVE_SEMANTIC(Inliner);
+
+    /// Inlined code adds at most growth_budget instructions to the program
+    explicit Inliner(size_t growth_budget) : growth_budget_(growth_budget) {}
+    ~Inliner() = default;
+
+    /// Returns true if any call is inlined
+    bool Run(Program *program);
+
+    size_t GetNumInlinedCalls() const
+    {
+        return n_inlined_calls_;
+    }
+
+private:
+    struct Callee {
+        std::vector<size_t> instrs; // live instructions of function in program order
+        size_t entry {0};
+        RegSet live_in;
+        RegSet used_regs;
+        // Register put to accumulator right before the only ret, -1 if there is no such
+        int returned_reg {-1};
+    };
+
+    struct CallSite {
+        size_t call_idx {0};
+        std::vector<Instr> instrs;
+        std::vector<std::vector<std::string>> labels;
+        // Reading of accumulator after the call replaced with mov from returned register
+        std::optional<size_t> accr_idx;
+        Instr accr_replacement;
+    };
+
+    struct Function {
+        size_t entry_block {0};
+        RegSet regs;
+        // Registers defined only by movif with label
+        RegSet label_regs;
+        std::array<const std::string *, runtime::Frame::N_FRAME_REGS_DEFAULT> labels {};
+    };
+
+    const std::string *FindCallTarget(const std::vector<Function> &functions,
+                                      const std::vector<size_t> &caller_functions, const Instr &call) const;
+    const Callee *FindCallee(const Program &program, const std::string &label);
+    void InlineCall(Program *program, const Callee &callee, size_t call_idx, const std::vector<int> &reg_map,
+                    CallSite *site);
+
+private:
+    size_t growth_budget_;
+    size_t n_inlined_calls_ {0};
+    std::unordered_map<std::string, std::optional<Callee>> callees_;
+    std::vector<RegSet> block_in_;
+};
+
+} // namespace evm::opt
+
+#endif // EVM_OPT_INLINER_H
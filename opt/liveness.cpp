@@ -0,0 +1,50 @@
+#include "opt/liveness.h"
+
+namespace evm::opt {
+
+void UpdateLiveness(const Instr &instr, RegSet *live)
+{
+    for (const auto &operand : instr.operands) {
+        if (operand.kind == Operand::Kind::REGISTER && operand.is_def) {
+            live->reset(operand.value);
+        }
+    }
+    for (const auto &operand : instr.operands) {
+        if (operand.kind == Operand::Kind::REGISTER && !operand.is_def) {
+            live->set(operand.value);
+        }
+    }
+}
+
+void ComputeLiveness(const Program &program, std::vector<RegSet> *block_in, std::vector<RegSet> *block_out)
+{
+    const auto &blocks = program.GetBlocks();
+    const auto &instrs = *program.GetInstrs();
+
+    block_in->assign(blocks.size(), RegSet());
+    block_out->assign(blocks.size(), RegSet());
+
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (size_t b = blocks.size(); b-- > 0;) {
+            RegSet live;
+            for (size_t succ : blocks[b].succs) {
+                live |= (*block_in)[succ];
+            }
+            (*block_out)[b] = live;
+
+            for (size_t i = blocks[b].end; i-- > blocks[b].begin;) {
+                if (!instrs[i].removed) {
+                    UpdateLiveness(instrs[i], &live);
+                }
+            }
+
+            if (live != (*block_in)[b]) {
+                (*block_in)[b] = live;
+                changed = true;
+            }
+        }
+    }
+}
+
+} // namespace evm::opt
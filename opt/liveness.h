@@ -0,0 +1,23 @@
+#ifndef EVM_OPT_LIVENESS_H
+#define EVM_OPT_LIVENESS_H
+
+#include "opt/program.h"
+#include "runtime/memory/frame.h"
+
+#include <bitset>
+#include <vector>
+
+namespace evm::opt {
+
+using RegSet = std::bitset<runtime::Frame::N_FRAME_REGS_DEFAULT>;
+
+/// Registers live before the instruction from registers live after it
+void UpdateLiveness(const Instr &instr, RegSet *live);
+
+/// Live registers at the start and at the end of every basic block, control flow graph should be built.
+/// Frames are destroyed on return, so nothing is live after ret and exit
+void ComputeLiveness(const Program &program, std::vector<RegSet> *block_in, std::vector<RegSet> *block_out);
+
+} // namespace evm::opt
+
+#endif // EVM_OPT_LIVENESS_H
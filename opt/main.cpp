@@ -0,0 +1,74 @@
+#include "common/logs.h"
+#include "assembler/asm2byte/asm2byte.h"
+#include "opt/optimizer.h"
+#include "opt/program.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace evm::opt {
+
+int Main(int argc, char *argv[])
+{
+    if (argc != 3) {
+        PrintErr("Usage: evm-opt <input.ea> <output.ea>");
+        return EXIT_FAILURE;
+    }
+
+    std::ifstream input(argv[1]);
+    if (!input) {
+        PrintErr("Cannot open file '", argv[1], "'");
+        return EXIT_FAILURE;
+    }
+
+    std::stringstream source;
+    source << input.rdbuf();
+
+    std::ostringstream optimized;
+    Program program;
+
+    if (program.Load(source.str())) {
+        size_t n_instrs = program.GetNumLiveInstrs();
+
+        Optimizer optimizer;
+        optimizer.Run(&program);
+        program.Print(optimized);
+
+        const auto &stats = optimizer.GetStats();
+        // Statistics are the report of the tool, they're printed in all builds unlike debug logs
+        std::fprintf(stderr,
+                     "Instructions: %zu -> %zu; folded: %zu, copies: %zu, dead: %zu, unreachable: %zu, "
+                     "threaded jumps: %zu, inlined calls: %zu\n",
+                     n_instrs, program.GetNumLiveInstrs(), stats.n_folded, stats.n_propagated_copies,
+                     stats.n_removed_dead, stats.n_removed_unreachable, stats.n_threaded_jumps, stats.n_inlined_calls);
+    } else {
+        PrintErr("Program cannot be optimized, it is copied as is");
+        optimized << source.str();
+    }
+
+    // Labels are resolved again by the assembler
+    file_format::File file;
+    asm2byte::AsmToByte asm2byte;
+    if (!asm2byte.ParseAsmString(optimized.str(), &file)) {
+        PrintErr("Optimized program of '", argv[1], "' is invalid");
+        return EXIT_FAILURE;
+    }
+
+    std::ofstream output(argv[2]);
+    if (!output) {
+        PrintErr("Cannot open file '", argv[2], "'");
+        return EXIT_FAILURE;
+    }
+    output << optimized.str();
+
+    return EXIT_SUCCESS;
+}
+
+} // namespace evm::opt
+
+int main(int argc, char *argv[])
+{
+    return evm::opt::Main(argc, argv);
+}
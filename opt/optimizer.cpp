@@ -0,0 +1,458 @@
+#include "opt/optimizer.h"
+#include "opt/inliner.h"
+#include "opt/liveness.h"
+#include "runtime/memory/frame.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace evm::opt {
+
+namespace {
+
+constexpr size_t N_REGS = runtime::Frame::N_FRAME_REGS_DEFAULT;
+
+struct Value {
+    enum class State : uint8_t {
+        UNDEF, // not reached yet
+        CONST,
+        UNKNOWN
+    };
+
+    State state {State::UNDEF};
+    int64_t bits {0};
+
+    bool operator==(const Value &other) const
+    {
+        return state == other.state && (state != State::CONST || bits == other.bits);
+    }
+};
+
+using RegValues = std::array<Value, N_REGS>;
+
+Value Merge(Value lhs, Value rhs)
+{
+    if (lhs.state == Value::State::UNDEF) {
+        return rhs;
+    }
+    if (rhs.state == Value::State::UNDEF || lhs == rhs) {
+        return lhs;
+    }
+    return {Value::State::UNKNOWN, 0};
+}
+
+double ToDouble(int64_t bits)
+{
+    double value = 0;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+int64_t FromDouble(double value)
+{
+    int64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+int64_t WrapAround(uint64_t value)
+{
+    return static_cast<int64_t>(value);
+}
+
+// Same computations as interpreter does, functions of libm are not folded: target may use another one
+std::optional<int64_t> Evaluate(const Instr &instr, const RegValues &regs)
+{
+    if (instr.opcode == Opcode::MOVIF) {
+        const Operand &imm = instr.operands[1];
+        return imm.kind == Operand::Kind::IMMEDIATE ? std::optional<int64_t>(imm.value) : std::nullopt;
+    }
+
+    std::vector<int> uses;
+    instr.GetUses(&uses);
+
+    int64_t args[2] = {0, 0};
+    if (uses.empty() || uses.size() > 2) {
+        return std::nullopt;
+    }
+    for (size_t i = 0; i < uses.size(); ++i) {
+        if (regs[uses[i]].state != Value::State::CONST) {
+            return std::nullopt;
+        }
+        args[i] = regs[uses[i]].bits;
+    }
+
+    auto [a, b] = args;
+    double fa = ToDouble(a);
+    double fb = ToDouble(b);
+
+    switch (instr.opcode) {
+        case Opcode::MOV:
+            return a;
+        case Opcode::ADD:
+            return WrapAround(static_cast<uint64_t>(a) + static_cast<uint64_t>(b));
+        case Opcode::SUB:
+            return WrapAround(static_cast<uint64_t>(a) - static_cast<uint64_t>(b));
+        case Opcode::MUL:
+            return WrapAround(static_cast<uint64_t>(a) * static_cast<uint64_t>(b));
+        case Opcode::DIV:
+        case Opcode::REM:
+            if (b == 0 || (a == std::numeric_limits<int64_t>::min() && b == -1)) {
+                return std::nullopt;
+            }
+            return instr.opcode == Opcode::DIV ? a / b : a % b;
+        case Opcode::AND:
+            return a & b;
+        case Opcode::OR:
+            return a | b;
+        case Opcode::XOR:
+            return a ^ b;
+        case Opcode::ADDF:
+            return FromDouble(fa + fb);
+        case Opcode::SUBF:
+            return FromDouble(fa - fb);
+        case Opcode::MULF:
+            return FromDouble(fa * fb);
+        case Opcode::DIVF:
+            return FromDouble(fa / fb);
+        case Opcode::SLTI:
+            return a < b;
+        case Opcode::SMEI:
+            return a >= b;
+        case Opcode::SLTF:
+            return fa < fb;
+        case Opcode::SMEF:
+            return fa >= fb;
+        case Opcode::EQI:
+            return a == b;
+        case Opcode::NEQI:
+            return a != b;
+        case Opcode::EQF:
+            return fa == fb;
+        case Opcode::NEQF:
+            return fa != fb;
+        case Opcode::CONVIF:
+            return FromDouble(static_cast<double>(a));
+        case Opcode::CONVFI:
+            // Conversion of values out of range is undefined
+            if (!(fa > static_cast<double>(std::numeric_limits<int64_t>::min()) &&
+                  fa < static_cast<double>(std::numeric_limits<int64_t>::max()))) {
+                return std::nullopt;
+            }
+            return static_cast<int64_t>(fa);
+        default:
+            return std::nullopt;
+    }
+}
+
+void Transfer(const Instr &instr, RegValues *regs)
+{
+    int def = instr.GetDef();
+    if (def < 0) {
+        return;
+    }
+
+    std::optional<int64_t> value = Evaluate(instr, *regs);
+    (*regs)[def] = value ? Value {Value::State::CONST, *value} : Value {Value::State::UNKNOWN, 0};
+}
+
+} // namespace
+
+void Optimizer::Run(Program *program)
+{
+    Inliner inliner(std::max(Inliner::MIN_GROWTH_BUDGET, program->GetNumLiveInstrs()));
+
+    for (size_t round = 0; round < MAX_ROUNDS; ++round) {
+        bool changed = false;
+
+        changed |= inliner.Run(program);
+        changed |= ThreadJumps(program);
+        changed |= RemoveUnreachableCode(program);
+        changed |= PropagateConstants(program);
+        changed |= PropagateCopies(program);
+        changed |= EliminateDeadCode(program);
+
+        if (!changed) {
+            break;
+        }
+    }
+
+    stats_.n_inlined_calls = inliner.GetNumInlinedCalls();
+}
+
+bool Optimizer::PropagateConstants(Program *program)
+{
+    program->BuildCfg();
+    const auto &blocks = program->GetBlocks();
+    auto &instrs = *program->GetInstrs();
+
+    RegValues unknown;
+    unknown.fill({Value::State::UNKNOWN, 0});
+
+    std::vector<RegValues> block_in(blocks.size());
+    std::vector<bool> in_worklist(blocks.size(), false);
+    std::vector<size_t> worklist;
+
+    for (size_t b = 0; b < blocks.size(); ++b) {
+        if (blocks[b].is_entry) {
+            block_in[b] = unknown;
+            worklist.push_back(b);
+            in_worklist[b] = true;
+        }
+    }
+
+    while (!worklist.empty()) {
+        size_t b = worklist.back();
+        worklist.pop_back();
+        in_worklist[b] = false;
+
+        RegValues regs = block_in[b];
+        for (size_t i = blocks[b].begin; i < blocks[b].end; ++i) {
+            if (!instrs[i].removed) {
+                Transfer(instrs[i], &regs);
+            }
+        }
+
+        for (size_t succ : blocks[b].succs) {
+            bool succ_changed = false;
+            for (size_t r = 0; r < N_REGS; ++r) {
+                Value merged = Merge(block_in[succ][r], regs[r]);
+                if (!(merged == block_in[succ][r])) {
+                    block_in[succ][r] = merged;
+                    succ_changed = true;
+                }
+            }
+
+            if (succ_changed && !in_worklist[succ]) {
+                worklist.push_back(succ);
+                in_worklist[succ] = true;
+            }
+        }
+    }
+
+    bool changed = false;
+
+    for (size_t b = 0; b < blocks.size(); ++b) {
+        RegValues regs = block_in[b];
+
+        for (size_t i = blocks[b].begin; i < blocks[b].end; ++i) {
+            Instr &instr = instrs[i];
+            if (instr.removed) {
+                continue;
+            }
+
+            if (instr.opcode == Opcode::JMP_IF_IMM && regs[instr.operands[0].value].state == Value::State::CONST) {
+                if (regs[instr.operands[0].value].bits != 0) {
+                    instr.opcode = Opcode::JMP_IMM;
+                    instr.operands.erase(instr.operands.begin());
+                } else {
+                    instr.removed = true;
+                }
+                ++stats_.n_folded;
+                changed = true;
+                continue;
+            }
+
+            Transfer(instr, &regs);
+
+            int def = instr.GetDef();
+            if (def >= 0 && instr.opcode != Opcode::MOVIF && instr.IsPure() &&
+                regs[def].state == Value::State::CONST) {
+                Operand rd = instr.operands[0];
+                Operand imm {Operand::Kind::IMMEDIATE, regs[def].bits, "", false};
+
+                instr.opcode = Opcode::MOVIF;
+                instr.operands = {rd, imm};
+                ++stats_.n_folded;
+                changed = true;
+            }
+        }
+    }
+
+    return changed;
+}
+
+bool Optimizer::PropagateCopies(Program *program)
+{
+    program->BuildCfg();
+    auto &instrs = *program->GetInstrs();
+
+    bool changed = false;
+    std::array<int, N_REGS> copy_of {};
+
+    for (const auto &block : program->GetBlocks()) {
+        copy_of.fill(-1);
+
+        for (size_t i = block.begin; i < block.end; ++i) {
+            Instr &instr = instrs[i];
+            if (instr.removed) {
+                continue;
+            }
+
+            for (auto &operand : instr.operands) {
+                if (operand.kind == Operand::Kind::REGISTER && !operand.is_def && copy_of[operand.value] >= 0) {
+                    operand.value = copy_of[operand.value];
+                    ++stats_.n_propagated_copies;
+                    changed = true;
+                }
+            }
+
+            int def = instr.GetDef();
+            if (def < 0) {
+                continue;
+            }
+
+            if (instr.opcode == Opcode::MOV && instr.operands[1].value == def) {
+                instr.removed = true;
+                ++stats_.n_removed_dead;
+                changed = true;
+                continue;
+            }
+
+            copy_of[def] = -1;
+            for (auto &source : copy_of) {
+                source = source == def ? -1 : source;
+            }
+
+            if (instr.opcode == Opcode::MOV) {
+                copy_of[def] = static_cast<int>(instr.operands[1].value);
+            }
+        }
+    }
+
+    return changed;
+}
+
+bool Optimizer::EliminateDeadCode(Program *program)
+{
+    program->BuildCfg();
+    const auto &blocks = program->GetBlocks();
+    auto &instrs = *program->GetInstrs();
+
+    std::vector<RegSet> block_in;
+    std::vector<RegSet> block_out;
+    ComputeLiveness(*program, &block_in, &block_out);
+
+    bool removed = false;
+
+    for (size_t b = 0; b < blocks.size(); ++b) {
+        RegSet live = block_out[b];
+
+        for (size_t i = blocks[b].end; i-- > blocks[b].begin;) {
+            Instr &instr = instrs[i];
+            if (instr.removed) {
+                continue;
+            }
+
+            // Object which is never read doesn't escape, so its allocation can't be observed
+            int def = instr.GetDef();
+            bool is_removable = instr.IsPure() || instr.opcode == Opcode::NEWOBJ;
+            if (def >= 0 && is_removable && !live.test(def)) {
+                instr.removed = true;
+                ++stats_.n_removed_dead;
+                removed = true;
+                continue;
+            }
+
+            UpdateLiveness(instr, &live);
+        }
+    }
+
+    return removed;
+}
+
+bool Optimizer::ThreadJumps(Program *program)
+{
+    auto &instrs = *program->GetInstrs();
+    bool changed = false;
+
+    for (size_t i = 0; i < instrs.size(); ++i) {
+        Instr &instr = instrs[i];
+        if (instr.removed || !instr.IsJump()) {
+            continue;
+        }
+
+        // Jump to unconditional jump goes directly to its target, bounded to not loop forever
+        std::string target = instr.GetJumpTarget();
+        for (size_t hop = 0; hop < MAX_ROUNDS; ++hop) {
+            size_t target_idx = program->GetLabelTarget(target);
+            if (target_idx == instrs.size() || instrs[target_idx].opcode != Opcode::JMP_IMM ||
+                instrs[target_idx].GetJumpTarget() == target) {
+                break;
+            }
+            target = instrs[target_idx].GetJumpTarget();
+        }
+
+        if (target != instr.GetJumpTarget()) {
+            instr.operands.back().text = target;
+            ++stats_.n_threaded_jumps;
+            changed = true;
+        }
+
+        // Jump to the next instruction does nothing
+        size_t next = i + 1;
+        while (next < instrs.size() && instrs[next].removed) {
+            ++next;
+        }
+        if (program->GetLabelTarget(target) == next) {
+            instr.removed = true;
+            ++stats_.n_threaded_jumps;
+            changed = true;
+        }
+    }
+
+    return changed;
+}
+
+bool Optimizer::RemoveUnreachableCode(Program *program)
+{
+    program->BuildCfg();
+    const auto &blocks = program->GetBlocks();
+    auto &instrs = *program->GetInstrs();
+
+    std::vector<bool> reachable(blocks.size(), false);
+    std::vector<size_t> worklist;
+
+    for (size_t b = 0; b < blocks.size(); ++b) {
+        if (blocks[b].is_entry) {
+            reachable[b] = true;
+            worklist.push_back(b);
+        }
+    }
+
+    while (!worklist.empty()) {
+        size_t b = worklist.back();
+        worklist.pop_back();
+
+        for (size_t succ : blocks[b].succs) {
+            if (!reachable[succ]) {
+                reachable[succ] = true;
+                worklist.push_back(succ);
+            }
+        }
+    }
+
+    bool changed = false;
+    for (size_t b = 0; b < blocks.size(); ++b) {
+        if (reachable[b]) {
+            continue;
+        }
+
+        for (size_t i = blocks[b].begin; i < blocks[b].end; ++i) {
+            if (!instrs[i].removed) {
+                instrs[i].removed = true;
+                ++stats_.n_removed_unreachable;
+                changed = true;
+            }
+        }
+    }
+
+    return changed;
+}
+
+} // namespace evm::opt
@@ -0,0 +1,55 @@
+#ifndef EVM_OPT_OPTIMIZER_H
+#define EVM_OPT_OPTIMIZER_H
+
+#include "common/macros.h"
+#include "opt/program.h"
+
+#include <cstddef>
+
+namespace evm::opt {
+
+/// Machine independent optimizations over control flow graph of a program, small functions are inlined first.
+/// Registers are local to a frame, so calls don't change registers of the caller,
+/// while all registers are unknown at the start of a function
+class Optimizer {
+public:
+    static constexpr size_t MAX_ROUNDS = 16;
+
+    struct Stats {
+        size_t n_folded {0};
+        size_t n_propagated_copies {0};
+        size_t n_removed_dead {0};
+        size_t n_removed_unreachable {0};
+        size_t n_threaded_jumps {0};
+        size_t n_inlined_calls {0};
+    };
+
+public:
+    NO_COPY_SEMANTIC(Optimizer);
+    NO_MOVE_SEMANTIC(Optimizer);
+
+    Optimizer() = default;
+    ~Optimizer() = default;
+
+    /// Run all passes until nothing changes
+    void Run(Program *program);
+
+    const Stats &GetStats() const
+    {
+        return stats_;
+    }
+
+private:
+    bool PropagateConstants(Program *program);
+    bool PropagateCopies(Program *program);
+    bool EliminateDeadCode(Program *program);
+    bool ThreadJumps(Program *program);
+    bool RemoveUnreachableCode(Program *program);
+
+private:
+    Stats stats_;
+};
+
+} // namespace evm::opt
+
+#endif // EVM_OPT_OPTIMIZER_H
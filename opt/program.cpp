@@ -0,0 +1,566 @@
+#include "common/logs.h"
+#include "common/opcode_to_str.h"
+#include "common/str_to_opcode.h"
+#include "common/utils/string_operations.h"
+#include "assembler/asm2byte/asm2byte.h"
+#include "assembler/asm2byte/lexer.h"
+#include "runtime/memory/frame.h"
+#include "opt/program.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <iterator>
+#include <limits>
+
+namespace evm::opt {
+
+namespace {
+
+// How an assembler token of instruction is interpreted
+enum class Role {
+    DEF,        // written register
+    USE,        // read register
+    VALUE,      // number or label
+    TARGET,     // jump target, relative offsets are not supported
+    SIZE,       // number
+    SYMBOL,     // class, field or type name
+    STRING,     // literal
+    USE_VARARGS // rest of tokens are read registers
+};
+
+// clang-format off
+bool GetRoles(Opcode opcode, std::vector<Role> *roles)
+{
+    switch (opcode) {
+        case Opcode::EXIT:
+        case Opcode::RET:
+            *roles = {};
+            return true;
+
+        case Opcode::ADD:
+        case Opcode::SUB:
+        case Opcode::MUL:
+        case Opcode::DIV:
+        case Opcode::REM:
+        case Opcode::AND:
+        case Opcode::OR:
+        case Opcode::XOR:
+        case Opcode::ADDF:
+        case Opcode::SUBF:
+        case Opcode::MULF:
+        case Opcode::DIVF:
+        case Opcode::SLTI:
+        case Opcode::SMEI:
+        case Opcode::SLTF:
+        case Opcode::SMEF:
+        case Opcode::EQI:
+        case Opcode::NEQI:
+        case Opcode::EQF:
+        case Opcode::NEQF:
+        case Opcode::POWER:
+        case Opcode::STRCONCAT:
+        case Opcode::STRCMP:
+        case Opcode::ARR_INDEX_OF:
+        case Opcode::LARR:
+            *roles = {Role::DEF, Role::USE, Role::USE};
+            return true;
+
+        case Opcode::ARR_ADD:
+        case Opcode::ARR_MUL:
+        case Opcode::STARR:
+            *roles = {Role::USE, Role::USE, Role::USE};
+            return true;
+
+        case Opcode::RACC:
+        case Opcode::PRINTI:
+        case Opcode::PRINTF:
+        case Opcode::PRINT_STR:
+        case Opcode::PRINT_STR_IMMUT:
+            *roles = {Role::USE};
+            return true;
+
+        case Opcode::MOV:
+        case Opcode::CPOBJ:
+        case Opcode::CPOBJ_DEEP:
+        case Opcode::CONVIF:
+        case Opcode::CONVFI:
+        case Opcode::ARR_SIZE:
+        case Opcode::ARR_SUM:
+        case Opcode::ARR_MIN:
+        case Opcode::ARR_MAX:
+        case Opcode::SIN:
+        case Opcode::COS:
+            *roles = {Role::DEF, Role::USE};
+            return true;
+
+        case Opcode::MOVIF:
+            *roles = {Role::DEF, Role::VALUE};
+            return true;
+
+        case Opcode::JMP_IF_IMM:
+            *roles = {Role::USE, Role::TARGET};
+            return true;
+
+        case Opcode::ARR_FILL:
+            *roles = {Role::USE, Role::USE};
+            return true;
+
+        case Opcode::ARR_COPY:
+            *roles = {Role::USE, Role::USE, Role::USE, Role::USE, Role::USE};
+            return true;
+
+        case Opcode::SCANI:
+        case Opcode::SCANF:
+        case Opcode::ACCR:
+            *roles = {Role::DEF};
+            return true;
+
+        case Opcode::JMP_IMM:
+            *roles = {Role::TARGET};
+            return true;
+
+        case Opcode::CALL:
+            *roles = {Role::USE, Role::USE_VARARGS};
+            return true;
+
+        case Opcode::NEWOBJ:
+            *roles = {Role::DEF, Role::SYMBOL};
+            return true;
+
+        case Opcode::OBJ_SET_FIELD:
+            *roles = {Role::USE, Role::SYMBOL, Role::USE};
+            return true;
+
+        case Opcode::OBJ_GET_FIELD:
+            *roles = {Role::DEF, Role::SYMBOL, Role::USE};
+            return true;
+
+        case Opcode::NEWARR_IMM:
+            *roles = {Role::DEF, Role::SYMBOL, Role::SIZE};
+            return true;
+
+        case Opcode::NEWARR:
+            *roles = {Role::DEF, Role::SYMBOL, Role::USE};
+            return true;
+
+        case Opcode::NEWSTR:
+        case Opcode::STR_IMMUT:
+            *roles = {Role::DEF, Role::STRING};
+            return true;
+
+        default:
+            // Dynamic jumps use code layout directly
+            return false;
+    }
+}
+// clang-format on
+
+bool ParseRegister(std::string_view token, Operand *operand)
+{
+    int64_t reg_idx = 0;
+    if (token.size() < 2 || token.front() != 'x' || !common::StrToNumber(token.substr(1), &reg_idx) ||
+        reg_idx < 0 || static_cast<size_t>(reg_idx) >= runtime::Frame::N_FRAME_REGS_DEFAULT) {
+        return false;
+    }
+
+    operand->kind = Operand::Kind::REGISTER;
+    operand->value = reg_idx;
+    return true;
+}
+
+bool ParseNumber(std::string_view token, Operand *operand)
+{
+    int64_t value = 0;
+    double double_value = 0;
+
+    if (common::StrToNumber(token, &value)) {
+        // Integer is stored as is
+    } else if (common::StrToNumber(token, &double_value)) {
+        std::memcpy(&value, &double_value, sizeof(value));
+    } else {
+        return false;
+    }
+
+    operand->kind = Operand::Kind::IMMEDIATE;
+    operand->value = value;
+    operand->text = token;
+    return true;
+}
+
+} // namespace
+
+int Instr::GetDef() const
+{
+    for (const auto &operand : operands) {
+        if (operand.kind == Operand::Kind::REGISTER && operand.is_def) {
+            return static_cast<int>(operand.value);
+        }
+    }
+    return -1;
+}
+
+void Instr::GetUses(std::vector<int> *uses) const
+{
+    uses->clear();
+    for (const auto &operand : operands) {
+        if (operand.kind == Operand::Kind::REGISTER && !operand.is_def) {
+            uses->push_back(static_cast<int>(operand.value));
+        }
+    }
+}
+
+bool Instr::IsPure() const
+{
+    switch (opcode) {
+        case Opcode::ADD:
+        case Opcode::SUB:
+        case Opcode::MUL:
+        case Opcode::AND:
+        case Opcode::OR:
+        case Opcode::XOR:
+        case Opcode::ADDF:
+        case Opcode::SUBF:
+        case Opcode::MULF:
+        case Opcode::DIVF:
+        case Opcode::SLTI:
+        case Opcode::SMEI:
+        case Opcode::SLTF:
+        case Opcode::SMEF:
+        case Opcode::EQI:
+        case Opcode::NEQI:
+        case Opcode::EQF:
+        case Opcode::NEQF:
+        case Opcode::POWER:
+        case Opcode::MOV:
+        case Opcode::MOVIF:
+        case Opcode::CONVIF:
+        case Opcode::CONVFI:
+        case Opcode::SIN:
+        case Opcode::COS:
+        case Opcode::STR_IMMUT:
+        case Opcode::ACCR:
+            return true;
+        default:
+            // Integer division may trap, others have side effects or allocate objects
+            return false;
+    }
+}
+
+bool Instr::IsTerminator() const
+{
+    return opcode == Opcode::EXIT || opcode == Opcode::RET || opcode == Opcode::JMP_IMM;
+}
+
+bool Instr::IsJump() const
+{
+    return opcode == Opcode::JMP_IMM || opcode == Opcode::JMP_IF_IMM;
+}
+
+const std::string &Instr::GetJumpTarget() const
+{
+    assert(IsJump());
+    return operands.back().text;
+}
+
+bool Program::Load(std::string_view source)
+{
+    file_format::File file;
+    asm2byte::AsmToByte asm2byte;
+    if (!asm2byte.ParseAsmString(source, &file)) {
+        PrintErr("Cannot assemble source");
+        return false;
+    }
+
+    const auto &assembled = file.GetCodeSection()->GetInstructions();
+    auto assembled_it = assembled.begin();
+
+    asm2byte::Lexer lexer(source);
+    asm2byte::LineInfo line;
+    std::vector<std::string_view> tokens;
+    bool in_class_definition = false;
+
+    labels_.assign(1, {});
+
+    while (lexer.NextLine(&line)) {
+        // Label
+        if (line[0].back() == ':') {
+            std::string label {line[0].substr(0, line[0].size() - 1)};
+            label_positions_.emplace(label, instrs_.size());
+            labels_.back().push_back(std::move(label));
+            continue;
+        }
+
+        tokens.clear();
+        for (size_t i = 0; i < line.size(); ++i) {
+            tokens.push_back(line[i]);
+        }
+
+        // Class definitions are kept as is
+        if (line[0] == ".class") {
+            class_lines_.push_back(in_class_definition ? ".class\n" : ".class " + std::string(line[1]));
+            in_class_definition = !in_class_definition;
+            continue;
+        }
+
+        if (in_class_definition) {
+            std::string field = "   ";
+            for (auto token : tokens) {
+                field += " ";
+                field += token;
+            }
+            class_lines_.push_back(field + ";");
+            continue;
+        }
+
+        if (assembled_it == assembled.end() || !LoadInstruction(*assembled_it, tokens)) {
+            PrintLogCat(OPT, "Instruction in line ", line.GetLineNumber(), " prevents optimization");
+            return false;
+        }
+
+        labels_.emplace_back();
+        ++assembled_it;
+    }
+
+    return assembled_it == assembled.end();
+}
+
+bool Program::LoadInstruction(const file_format::Instruction &assembled, const std::vector<std::string_view> &tokens)
+{
+    Instr instr;
+    instr.opcode = common::StringToOpcode(tokens[0]);
+
+    std::vector<Role> roles;
+    if (instr.opcode != assembled.GetOpcode() || !GetRoles(instr.opcode, &roles)) {
+        return false;
+    }
+
+    // Call without arguments returns past the next instruction, layout of code is significant then
+    if (instr.opcode == Opcode::CALL && assembled.GetBytesSize() == file_format::Instruction::MINIMAL_INSTR_SIZE) {
+        return false;
+    }
+
+    // Extra tokens are ignored by assembler
+    size_t n_operands = std::min(tokens.size() - 1, roles.size());
+    if (!roles.empty() && roles.back() == Role::USE_VARARGS) {
+        n_operands = std::min(tokens.size() - 1, roles.size() - 1 + runtime::Frame::N_PASSED_ARGS_DEFAULT);
+    }
+
+    for (size_t i = 1; i <= n_operands; ++i) {
+        Role role = roles[std::min(i - 1, roles.size() - 1)];
+        Operand operand;
+
+        switch (role) {
+            case Role::DEF:
+            case Role::USE:
+            case Role::USE_VARARGS:
+                if (!ParseRegister(tokens[i], &operand)) {
+                    return false;
+                }
+                operand.is_def = role == Role::DEF;
+                break;
+            case Role::VALUE:
+                if (!ParseNumber(tokens[i], &operand)) {
+                    operand.kind = Operand::Kind::LABEL;
+                    operand.text = tokens[i];
+                }
+                break;
+            case Role::TARGET:
+                if (ParseNumber(tokens[i], &operand)) {
+                    return false;
+                }
+                operand.kind = Operand::Kind::LABEL;
+                operand.text = tokens[i];
+                break;
+            case Role::SIZE:
+                if (!ParseNumber(tokens[i], &operand)) {
+                    return false;
+                }
+                break;
+            case Role::SYMBOL:
+                operand.kind = Operand::Kind::SYMBOL;
+                operand.text = tokens[i];
+                break;
+            case Role::STRING:
+                operand.kind = Operand::Kind::STRING;
+                operand.text = tokens[i];
+                break;
+        }
+
+        instr.operands.push_back(std::move(operand));
+    }
+
+    instrs_.push_back(std::move(instr));
+    return true;
+}
+
+void Program::Print(std::ostream &out) const
+{
+    for (const auto &class_line : class_lines_) {
+        out << class_line << "\n";
+    }
+
+    for (size_t i = 0; i <= instrs_.size(); ++i) {
+        for (const auto &label : labels_[i]) {
+            out << "\n" << label << ":\n";
+        }
+
+        if (i == instrs_.size() || instrs_[i].removed) {
+            continue;
+        }
+
+        out << "    " << common::OpcodeToString(instrs_[i].opcode);
+
+        const char *separator = " ";
+        for (const auto &operand : instrs_[i].operands) {
+            out << separator;
+            separator = ", ";
+
+            switch (operand.kind) {
+                case Operand::Kind::REGISTER:
+                    out << "x" << operand.value;
+                    break;
+                case Operand::Kind::IMMEDIATE:
+                    // Computed values are printed as integers: it keeps exact bits of doubles
+                    if (operand.text.empty()) {
+                        out << operand.value;
+                    } else {
+                        out << operand.text;
+                    }
+                    break;
+                case Operand::Kind::LABEL:
+                case Operand::Kind::SYMBOL:
+                    out << operand.text;
+                    break;
+                case Operand::Kind::STRING:
+                    out << "'" << operand.text << "'";
+                    break;
+            }
+        }
+
+        out << "\n";
+    }
+}
+
+size_t Program::GetNumLiveInstrs() const
+{
+    size_t n_live = 0;
+    for (const auto &instr : instrs_) {
+        n_live += instr.removed ? 0 : 1;
+    }
+    return n_live;
+}
+
+size_t Program::GetNextLive(size_t idx) const
+{
+    while (idx < instrs_.size() && instrs_[idx].removed) {
+        ++idx;
+    }
+    return idx;
+}
+
+size_t Program::GetLabelTarget(const std::string &label) const
+{
+    auto it = label_positions_.find(label);
+    assert(it != label_positions_.end());
+    return GetNextLive(it->second);
+}
+
+size_t Program::GetBlockOf(size_t instr_idx) const
+{
+    return instr_idx < instrs_.size() ? block_of_instr_[instr_idx] : NO_BLOCK;
+}
+
+std::string Program::CreateLabel(std::string_view prefix)
+{
+    std::string label;
+    do {
+        label = std::string(prefix) + "_" + std::to_string(n_created_labels_++);
+    } while (label_positions_.count(label) != 0);
+
+    return label;
+}
+
+void Program::ReplaceInstr(size_t idx, std::vector<Instr> instrs, std::vector<std::vector<std::string>> labels)
+{
+    assert(idx < instrs_.size() && !instrs.empty() && labels.size() == instrs.size() + 1);
+
+    labels.front().insert(labels.front().begin(), labels_[idx].begin(), labels_[idx].end());
+    labels_[idx + 1].insert(labels_[idx + 1].begin(), labels.back().begin(), labels.back().end());
+    labels.pop_back();
+
+    instrs_.erase(instrs_.begin() + idx);
+    instrs_.insert(instrs_.begin() + idx, std::make_move_iterator(instrs.begin()),
+                   std::make_move_iterator(instrs.end()));
+    labels_.erase(labels_.begin() + idx);
+    labels_.insert(labels_.begin() + idx, std::make_move_iterator(labels.begin()),
+                   std::make_move_iterator(labels.end()));
+
+    label_positions_.clear();
+    for (size_t i = 0; i < labels_.size(); ++i) {
+        for (const auto &label : labels_[i]) {
+            label_positions_.emplace(label, i);
+        }
+    }
+}
+
+void Program::BuildCfg()
+{
+    blocks_.clear();
+    block_of_instr_.assign(instrs_.size(), NO_BLOCK);
+
+    std::vector<bool> is_label_target(instrs_.size() + 1, false);
+    for (const auto &[label, position] : label_positions_) {
+        is_label_target[GetNextLive(position)] = true;
+    }
+
+    bool starts_block = true;
+    for (size_t i = GetNextLive(0); i < instrs_.size(); i = GetNextLive(i + 1)) {
+        if (starts_block || is_label_target[i]) {
+            blocks_.push_back({i, i, {}, {}, false});
+        }
+
+        blocks_.back().end = i + 1;
+        block_of_instr_[i] = blocks_.size() - 1;
+
+        starts_block = instrs_[i].IsTerminator() || instrs_[i].IsJump();
+    }
+
+    for (size_t b = 0; b < blocks_.size(); ++b) {
+        const Instr &last = instrs_[blocks_[b].end - 1];
+
+        if (last.IsJump()) {
+            size_t target_block = GetBlockOf(GetLabelTarget(last.GetJumpTarget()));
+            if (target_block != NO_BLOCK) {
+                blocks_[b].succs.push_back(target_block);
+            }
+        }
+
+        if (!last.IsTerminator() && b + 1 < blocks_.size()) {
+            blocks_[b].succs.push_back(b + 1);
+        }
+
+        for (size_t succ : blocks_[b].succs) {
+            blocks_[succ].preds.push_back(b);
+        }
+    }
+
+    if (blocks_.empty()) {
+        return;
+    }
+
+    // Functions are called through registers holding their addresses
+    blocks_[0].is_entry = true;
+    for (size_t i = GetNextLive(0); i < instrs_.size(); i = GetNextLive(i + 1)) {
+        for (const auto &operand : instrs_[i].operands) {
+            if (instrs_[i].opcode == Opcode::MOVIF && operand.kind == Operand::Kind::LABEL) {
+                size_t entry_block = GetBlockOf(GetLabelTarget(operand.text));
+                if (entry_block != NO_BLOCK) {
+                    blocks_[entry_block].is_entry = true;
+                }
+            }
+        }
+    }
+}
+
+} // namespace evm::opt
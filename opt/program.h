@@ -0,0 +1,138 @@
+#ifndef EVM_OPT_PROGRAM_H
+#define EVM_OPT_PROGRAM_H
+
+#include "common/macros.h"
+#include "file_format/file.h"
+#include "isa/opcodes.h"
+
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace evm::opt {
+
+struct Operand {
+    enum class Kind {
+        REGISTER,
+        IMMEDIATE,
+        LABEL,  // jump target or address of function
+        SYMBOL, // class, class field or array element type
+        STRING
+    };
+
+    Kind kind {Kind::REGISTER};
+    int64_t value {0}; // register index or immediate
+    std::string text;  // label, symbol or string literal, source text of immediate
+    bool is_def {false};
+};
+
+struct Instr {
+    Opcode opcode {Opcode::INVALID};
+    std::vector<Operand> operands;
+    bool removed {false};
+
+    // Index of the defined register or -1
+    int GetDef() const;
+    // Registers read by the instruction
+    void GetUses(std::vector<int> *uses) const;
+
+    // Instruction can be removed if its result is unused
+    bool IsPure() const;
+    // Control never reaches the next instruction
+    bool IsTerminator() const;
+    bool IsJump() const;
+
+    const std::string &GetJumpTarget() const;
+};
+
+struct BasicBlock {
+    size_t begin {0}; // indices of instructions in program, removed ones are skipped
+    size_t end {0};
+    std::vector<size_t> succs;
+    std::vector<size_t> preds;
+    // Function entry: registers are unknown at its start
+    bool is_entry {false};
+};
+
+/// Instructions of assembler program with symbolic operands: the program can be changed and printed
+/// back as assembler source, labels, classes and strings are resolved again by the assembler
+class Program {
+public:
+    static constexpr size_t NO_BLOCK = std::numeric_limits<size_t>::max();
+
+public:
+    NO_COPY_SEMANTIC(Program);
+    NO_MOVE_SEMANTIC(Program);
+
+    Program() = default;
+    ~Program() = default;
+
+    /// Source is assembled to check it and to find layout of code section.
+    /// Returns false if source is invalid or uses code layout directly (relative offsets, dynamic jumps),
+    /// such programs cannot be changed
+    bool Load(std::string_view source);
+
+    void Print(std::ostream &out) const;
+
+    std::vector<Instr> *GetInstrs()
+    {
+        return &instrs_;
+    }
+
+    const std::vector<Instr> *GetInstrs() const
+    {
+        return &instrs_;
+    }
+
+    size_t GetNumLiveInstrs() const;
+
+    /// Split live instructions into basic blocks, block 0 is the program entry
+    void BuildCfg();
+
+    const std::vector<BasicBlock> &GetBlocks() const
+    {
+        return blocks_;
+    }
+
+    /// Index of the first live instruction at or after the label, instrs_.size() if there is none
+    size_t GetLabelTarget(const std::string &label) const;
+
+    /// Block of live instruction, NO_BLOCK for the end of code
+    size_t GetBlockOf(size_t instr_idx) const;
+
+    bool HasLabels(size_t instr_idx) const
+    {
+        return !labels_[instr_idx].empty();
+    }
+
+    /// New label which differs from all labels of the program
+    std::string CreateLabel(std::string_view prefix);
+
+    /// Replace instruction with a sequence: labels[i] are placed before instrs[i], labels.back() after the last one.
+    /// Control flow graph should be built again
+    void ReplaceInstr(size_t idx, std::vector<Instr> instrs, std::vector<std::vector<std::string>> labels);
+
+private:
+    bool LoadInstruction(const file_format::Instruction &assembled, const std::vector<std::string_view> &tokens);
+
+    size_t GetNextLive(size_t idx) const;
+
+private:
+    std::vector<std::string> class_lines_;
+    std::vector<Instr> instrs_;
+    // labels_[i] are placed before instruction i, labels_[instrs_.size()] are at the end of code
+    std::vector<std::vector<std::string>> labels_;
+    std::unordered_map<std::string, size_t> label_positions_;
+    size_t n_created_labels_ {0};
+
+    std::vector<BasicBlock> blocks_;
+    std::vector<size_t> block_of_instr_;
+};
+
+} // namespace evm::opt
+
+#endif // EVM_OPT_PROGRAM_H
@@ -0,0 +1,72 @@
+#ifndef EVM_RUNTIME_INTERPRETER_CALL_STACK_H
+#define EVM_RUNTIME_INTERPRETER_CALL_STACK_H
+
+#include "common/macros.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace evm::runtime {
+
+/// Entry pcs of functions on the frames stack, published for signal handlers of profilers.
+/// Only the interpreter thread writes it: an entry is stored before the depth that makes it visible,
+/// so a handler interrupting the thread always reads a consistent stack.
+class PublishedCallStack {
+public:
+    // Deeper frames are counted, but their functions are not kept
+    static constexpr size_t MAX_DEPTH = 1024;
+
+    NO_COPY_SEMANTIC(PublishedCallStack);
+    NO_MOVE_SEMANTIC(PublishedCallStack);
+
+    PublishedCallStack() = default;
+    ~PublishedCallStack() = default;
+
+    void Push(size_t entry_pc)
+    {
+        size_t depth = depth_.load(std::memory_order_relaxed);
+        if (LIKELY(depth < MAX_DEPTH)) {
+            entry_pcs_[depth] = static_cast<uint32_t>(entry_pc);
+        }
+        std::atomic_signal_fence(std::memory_order_release);
+        depth_.store(depth + 1, std::memory_order_relaxed);
+    }
+
+    void Pop()
+    {
+        depth_.store(depth_.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+    }
+
+    void Clear()
+    {
+        depth_.store(0, std::memory_order_relaxed);
+    }
+
+    /// Async-signal-safe, copies entry pcs of the innermost kept frames from the outer one to the inner one
+    /// and returns the number of copied pcs
+    size_t Read(uint32_t *out, size_t max_depth) const
+    {
+        size_t depth = depth_.load(std::memory_order_relaxed);
+        std::atomic_signal_fence(std::memory_order_acquire);
+        size_t n_kept = depth < MAX_DEPTH ? depth : MAX_DEPTH;
+        size_t n_copied = n_kept < max_depth ? n_kept : max_depth;
+        for (size_t i = 0; i < n_copied; ++i) {
+            out[i] = entry_pcs_[n_kept - n_copied + i];
+        }
+        return n_copied;
+    }
+
+    size_t GetDepth() const
+    {
+        return depth_.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<size_t> depth_ {0};
+    uint32_t entry_pcs_[MAX_DEPTH] {};
+};
+
+} // namespace evm::runtime
+
+#endif // EVM_RUNTIME_INTERPRETER_CALL_STACK_H
@@ -4,6 +4,7 @@
 #include "common/logs.h"
 #include "common/macros.h"
 #include "runtime/interpreter/interpreter.h"
+#include "runtime/memory/object_cloner.h"
 #include "runtime/memory/types/array.h"
 #include "runtime/memory/types/string.h"
 #include "runtime/runtime.h"
@@ -11,6 +12,8 @@
 #include "runtime/memory/type.h"
 #include "runtime/memory/types/class.h"
 
+#include <cstring>
+
 namespace evm::runtime {
 
 ALWAYS_INLINE int64_t HandleCreateArrayObject(hword_t type, int32_t size)
@@ -32,19 +35,41 @@ ALWAYS_INLINE int64_t HandleGetArraySize(int64_t array_ptr)
     return array->GetLength();
 }
 
+ALWAYS_INLINE int64_t HandleLoadFromReferenceArray(types::Array *array, int64_t idx, bool *load_obj)
+{
+    auto *obj = array->GetReference(idx);
+    *load_obj = (obj != nullptr);
+
+    return reinterpret_cast<int64_t>(obj);
+}
+
 ALWAYS_INLINE int64_t HandleLoadFromArray(int64_t array_ptr, int64_t idx, bool *load_obj)
 {
     auto *array = reinterpret_cast<types::Array *>(array_ptr);
     assert(array != nullptr);
 
-    int64_t value = 0;
-    array->Get(&value, idx);
+    // Element kind is fixed in class word at array creation, primitive loads don't look at element type at all
+    if (LIKELY(!array->GetClassWord()->IsReferenceArray())) {
+        *load_obj = false;
+        return array->GetPrimitive(idx);
+    }
+
+    return HandleLoadFromReferenceArray(array, idx, load_obj);
+}
 
-    auto arr_type = array->GetClassWord()->GetArrayElementType();
-    bool is_primitive = !memory::IsReferenceType(arr_type);
-    *load_obj = (!is_primitive) && (value != 0);
+ALWAYS_INLINE void HandleStoreToReferenceArray(types::Array *array, int64_t array_idx, int64_t src_reg_value)
+{
+    auto *obj_ptr = reinterpret_cast<ObjectHeader *>(src_reg_value);
 
-    return value;
+    if (obj_ptr != nullptr) {
+        auto arr_mark_word = array->GetMarkWord();
+        if (obj_ptr->GetMarkWord().mark == 0 && arr_mark_word.mark == 1 && arr_mark_word.neighbour == 1) {
+            array->SetMarkWord({.mark = 1, .neighbour = 0});
+            runtime::Runtime::GetInstance()->GetGC()->AddGreyObject(array);
+        }
+    }
+
+    array->SetReference(obj_ptr, array_idx);
 }
 
 ALWAYS_INLINE void HandleStoreToArray(int64_t array_ptr, int64_t array_idx, int64_t src_reg_value)
@@ -52,31 +77,125 @@ ALWAYS_INLINE void HandleStoreToArray(int64_t array_ptr, int64_t array_idx, int6
     auto *array = reinterpret_cast<types::Array *>(array_ptr);
     assert(array != nullptr);
 
-    auto *gc = runtime::Runtime::GetInstance()->GetGC();
-    auto arr_type = array->GetClassWord()->GetArrayElementType();
+    PrintLogCat(OBJECTS, "array_ptr = ", (void *)array_ptr, ", idx = ", array_idx, ", src_reg_value = ", src_reg_value);
+
+    // Only reference arrays need GC write barrier
+    if (LIKELY(!array->GetClassWord()->IsReferenceArray())) {
+        array->SetPrimitive(src_reg_value, array_idx);
+        return;
+    }
+
+    HandleStoreToReferenceArray(array, array_idx, src_reg_value);
+}
+
+// Bulk array operations write a bunch of values at once, so instead of checking each stored object
+// a black reference array is just made grey again to be rescanned by GC
+ALWAYS_INLINE void HandleBulkStoreToReferenceArray(types::Array *array)
+{
     auto arr_mark_word = array->GetMarkWord();
+    if (arr_mark_word.mark == 1 && arr_mark_word.neighbour == 1) {
+        array->SetMarkWord({.mark = 1, .neighbour = 0});
+        runtime::Runtime::GetInstance()->GetGC()->AddGreyObject(array);
+    }
+}
 
-    if (memory::IsReferenceType(arr_type) && src_reg_value != 0) {
-        auto *obj_ptr = reinterpret_cast<ObjectHeader *>(src_reg_value);
-        if (obj_ptr->GetMarkWord().mark == 0 && arr_mark_word.mark == 1 && arr_mark_word.neighbour == 1) {
-            array->SetMarkWord({.mark = 1, .neighbour = 0});
-            gc->AddGreyObject(array);
+ALWAYS_INLINE void HandleArrayFill(int64_t array_ptr, int64_t value, bool is_obj)
+{
+    auto *array = reinterpret_cast<types::Array *>(array_ptr);
+    assert(array != nullptr);
+
+    if (array->GetClassWord()->IsReferenceArray() && value != 0) {
+        // GC dereferences every element of a reference array
+        if (UNLIKELY(!is_obj)) {
+            PrintErr("Reference array can't be filled with primitive value ", value);
+            UNREACHABLE();
         }
+        HandleBulkStoreToReferenceArray(array);
     }
 
-    PrintLog("array_ptr = ", (void *)array_ptr, ", idx = ", array_idx, ", src_reg_value = ", src_reg_value);
-    array->Set(src_reg_value, array_idx);
+    array->Fill(value);
 }
 
-ALWAYS_INLINE int64_t HandleCreateStringObject(int32_t string_offset)
+ALWAYS_INLINE void HandleArrayCopy(int64_t dst_ptr, int64_t dst_pos, int64_t src_ptr, int64_t src_pos, int64_t length)
 {
-    auto *runtime = Runtime::GetInstance();
+    auto *dst = reinterpret_cast<types::Array *>(dst_ptr);
+    auto *src = reinterpret_cast<types::Array *>(src_ptr);
+    assert(dst != nullptr);
+    assert(src != nullptr);
+
+    if (UNLIKELY(dst_pos < 0 || src_pos < 0 || length < 0)) {
+        PrintErr("Negative arguments of array copy: dst_pos = ", dst_pos, ", src_pos = ", src_pos,
+                 ", length = ", length);
+        UNREACHABLE();
+    }
+
+    if (dst->GetClassWord()->IsReferenceArray() && length != 0) {
+        HandleBulkStoreToReferenceArray(dst);
+    }
 
-    const std::string *string = runtime->GetStringFromCache(string_offset);
-    if (string == nullptr) {
-        string = runtime->CreateStringAndSetInCache(string_offset);
+    types::Array::CopyRange(dst, dst_pos, src, src_pos, length);
+}
+
+ALWAYS_INLINE int64_t HandleArraySum(int64_t array_ptr)
+{
+    return reinterpret_cast<types::Array *>(array_ptr)->Sum();
+}
+
+ALWAYS_INLINE int64_t HandleArrayMin(int64_t array_ptr)
+{
+    return reinterpret_cast<types::Array *>(array_ptr)->Min();
+}
+
+ALWAYS_INLINE int64_t HandleArrayMax(int64_t array_ptr)
+{
+    return reinterpret_cast<types::Array *>(array_ptr)->Max();
+}
+
+ALWAYS_INLINE void HandleArrayAdd(int64_t dst_ptr, int64_t lhs_ptr, int64_t rhs_ptr)
+{
+    types::Array::Add(reinterpret_cast<types::Array *>(dst_ptr), reinterpret_cast<types::Array *>(lhs_ptr),
+                      reinterpret_cast<types::Array *>(rhs_ptr));
+}
+
+ALWAYS_INLINE void HandleArrayMul(int64_t dst_ptr, int64_t lhs_ptr, int64_t rhs_ptr)
+{
+    types::Array::Mul(reinterpret_cast<types::Array *>(dst_ptr), reinterpret_cast<types::Array *>(lhs_ptr),
+                      reinterpret_cast<types::Array *>(rhs_ptr));
+}
+
+ALWAYS_INLINE int64_t HandleArrayIndexOf(int64_t array_ptr, int64_t value)
+{
+    return reinterpret_cast<types::Array *>(array_ptr)->IndexOf(value);
+}
+
+ALWAYS_INLINE int64_t HandleCloneObject(int64_t obj_ptr)
+{
+    auto *obj = reinterpret_cast<ObjectHeader *>(obj_ptr);
+    if (UNLIKELY(obj == nullptr)) {
+        PrintErr("Copy of null object");
+        UNREACHABLE();
     }
 
+    return reinterpret_cast<int64_t>(ObjectCloner::Clone(obj));
+}
+
+ALWAYS_INLINE int64_t HandleDeepCloneObject(int64_t obj_ptr)
+{
+    auto *obj = reinterpret_cast<ObjectHeader *>(obj_ptr);
+    if (UNLIKELY(obj == nullptr)) {
+        PrintErr("Copy of null object");
+        UNREACHABLE();
+    }
+
+    return reinterpret_cast<int64_t>(ObjectCloner::DeepClone(obj));
+}
+
+ALWAYS_INLINE int64_t HandleCreateStringObject(int32_t string_idx)
+{
+    auto *runtime = Runtime::GetInstance();
+
+    const Runtime::StringLiteral &literal = runtime->GetStringLiteral(static_cast<size_t>(string_idx));
+
     auto *class_description =
         runtime->GetClassManager()->GetDefaultClassDescription(ClassManager::DefaultClassDescr::STRING);
 
@@ -86,13 +205,13 @@ ALWAYS_INLINE int64_t HandleCreateStringObject(int32_t string_offset)
     }
     assert(class_description->IsStringObject());
 
-    // string->size + 1 because of \0 at the end of c_string
-    auto *string_obj = types::String::Create(reinterpret_cast<const uint8_t *>(string->c_str()), string->size() + 1);
+    auto *string_obj = types::String::CreateUninitialized(literal.length);
     if (UNLIKELY(string_obj == nullptr)) {
-        PrintErr("Error when creating object for string \"", string->c_str(), "\"");
+        PrintErr("Error when creating object for string \"", reinterpret_cast<const char *>(literal.data), "\"");
         UNREACHABLE();
     }
 
+    std::memcpy(string_obj->GetData(), literal.data, literal.length);
     string_obj->SetClassWord(class_description);
 
     return reinterpret_cast<int64_t>(string_obj);
@@ -140,7 +259,7 @@ ALWAYS_INLINE int64_t HandleCreateObject(file_format::File *file, int16_t class_
     class_obj->SetClassWord(class_description);
     class_obj->InitFields(asm_class);
 
-    PrintLog("obj_ptr = ", (long)class_obj, ", class_size = ", class_description->GetClassSize());
+    PrintLogCat(OBJECTS, "obj_ptr = ", (long)class_obj, ", class_size = ", class_description->GetClassSize());
     return reinterpret_cast<int64_t>(class_obj);
 }
 
@@ -176,7 +295,8 @@ ALWAYS_INLINE void HandleObjSetField(int16_t field_idx, int64_t reg, int64_t obj
         }
     }
 
-    PrintLog("obj_ptr = ", (long)cls, ", field_idx = ", field_idx, ", field_type = ", static_cast<int>(field_type));
+    PrintLogCat(OBJECTS, "obj_ptr = ", (long)cls, ", field_idx = ", field_idx,
+                ", field_type = ", static_cast<int>(field_type));
     cls->SetField(static_cast<size_t>(field_idx), reg);
 }
 
@@ -1,7 +1,11 @@
 #include "runtime/interpreter/interpreter.h"
 #include "common/constants.h"
+#include "common/perf_counters.h"
+#include "common/trace.h"
 #include "common/config.h"
 #include "runtime/interpreter/interpreter-inl.h"
+#include "runtime/interpreter/interpreter_macros.h"
+#include "runtime/jit/jit.h"
 #include "runtime/memory/reg.h"
 #include "runtime/memory/types/array.h"
 #include "file_format/file.h"
@@ -24,25 +28,7 @@ namespace evm::runtime {
 
 // clang-format off
 
-#define PRINT_INSTR(name) PrintLog(#name, ", pc = ", pc_)
-
-#define RD_I_FRAME_ASSIGN(frame, value) frame->GetReg(RD_IDX())->SetInt64(value)
-#define RD_F_FRAME_ASSIGN(frame, value) frame->GetReg(RD_IDX())->SetDouble(value)
-
-#define RS1_I_FRAME(frame) frame->GetReg(RS1_IDX())->GetInt64()
-#define RS1_F_FRAME(frame) frame->GetReg(RS1_IDX())->GetDouble()
-
-#define RS2_I_FRAME(frame) frame->GetReg(RS2_IDX())->GetInt64()
-#define RS2_F_FRAME(frame) frame->GetReg(RS2_IDX())->GetDouble()
-
-#define RS3_I_FRAME(frame) frame->GetReg(RS3_IDX())->GetInt64()
-#define RS3_F_FRAME(frame) frame->GetReg(RS3_IDX())->GetDouble()
-
-#define RD_MARK_REG_AS_ROOT(frame, is_obj) \
-    frame->MarkReg(RD_IDX(), is_obj)
-
-#define RS1_IS_MARKED_AS_ROOT(frame) \
-    frame->IsRegMarked(RS1_IDX())
+#define PRINT_INSTR(name) PrintLogCat(INTERPRETER, #name, ", pc = ", pc_)
 
 void Interpreter::Run(file_format::File *file, const byte_t *bytecode, size_t entrypoint)
 {
@@ -59,60 +45,30 @@ void Interpreter::Run(file_format::File *file, const byte_t *bytecode, size_t en
     frame_cur_ = &frames_.back();
 
     pc_ = entrypoint;
+    call_stack_.Clear();
+    call_stack_.Push(entrypoint);
 
-    #define CALL_REG1()             *frame_cur_->GetReg(ISA_CALL_GET_REG1(bytecode + pc_))
-    #define CALL_REG2()             *frame_cur_->GetReg(ISA_CALL_GET_REG2(bytecode + pc_))
-    #define CALL_REG3()             *frame_cur_->GetReg(ISA_CALL_GET_REG3(bytecode + pc_))
-    #define CALL_REG4()             *frame_cur_->GetReg(ISA_CALL_GET_REG4(bytecode + pc_))
-
-    #define RD_IDX()                ISA_GET_RD (bytecode + pc_)
-    #define RS1_IDX()               ISA_GET_RS1(bytecode + pc_)
-    #define RS2_IDX()               ISA_GET_RS2(bytecode + pc_)
-    #define RS3_IDX()               ISA_GET_RS3(bytecode + pc_)
-    #define IMM_I()                 ISA_GET_IMM(bytecode + pc_, int64_t)
-    #define IMM_F()                 ISA_GET_IMM(bytecode + pc_, double)
-    #define IMM_I32()               ISA_GET_IMM(bytecode + pc_, int32_t)
-
-    #define GET_ARRAY_SIZE()        frame_cur_->GetReg(ISA_GET_ARRAY_SIZE_RS(bytecode + pc_))->GetRaw()
-    #define GET_ARRAY_TYPE()        ISA_GET_ARRAY_TYPE(bytecode + pc_)
-    #define GET_OBJ_TYPE()          ISA_GET_OBJ_TYPE(bytecode + pc_)
-    #define GET_OBJ_FIELD_IDX()     ISA_GET_OBJ_TYPE(bytecode + pc_)
-    #define GET_OBJ_FIELD_TYPE()    ISA_GET_OBJ_FIELD_TYPE(bytecode + pc_)
-    #define GET_OBJ_RS()            frame_cur_->GetReg(ISA_GET_OBJ_RS(bytecode + pc_))->GetRaw()
-    #define GET_OBJ_OP_RS()         frame_cur_->GetReg(ISA_GET_OBJ_OP_RS(bytecode + pc_))->GetRaw()
-    #define OBJ_RS_OP_ASSIGN(value) frame_cur_->GetReg(ISA_GET_OBJ_OP_RS(bytecode + pc_))->SetInt64(value)
-
-    #define BYTECODE_OFFSET(offset) bytecode + offset
-
-    #define PC()             pc_
-    #define PC_ADD(value)    pc_ += value
-    #define PC_ASSIGN(value) pc_ =  value
-
-    #define RD_I_ASSIGN(value) RD_I_FRAME_ASSIGN(frame_cur_, value)
-    #define RD_F_ASSIGN(value) RD_F_FRAME_ASSIGN(frame_cur_, value)
-
-    #define RS1_I() RS1_I_FRAME(frame_cur_)
-    #define RS1_F() RS1_F_FRAME(frame_cur_)
-
-    #define RS2_I() RS2_I_FRAME(frame_cur_)
-    #define RS2_F() RS2_F_FRAME(frame_cur_)
-
-    #define RS3_I() RS3_I_FRAME(frame_cur_)
-    #define RS3_F() RS3_F_FRAME(frame_cur_)
-
-    #define PUT_ACCUM(reg)     accum_ = reg
-    #define PUT_I_ACCUM(value) accum_.SetInt64(value)
-    #define PUT_F_ACCUM(value) accum_.SetDouble(value)
+    if (jit_ != nullptr && !jit_->Init(file, bytecode, Runtime::GetInstance()->GetGC()->GetInstrsFrequency())) {
+        jit_.reset();
+    }
 
-    #define GET_ACCUM()   accum_
-    #define GET_I_ACCUM() accum_.GetInt64()
-    #define GET_F_ACCUM() accum_.GetDouble()
+    perf::ScopedPerfPhase perf_phase(perf::Phase::INTERPRETER);
+    if (engine_ == Engine::TAIL_CALL) {
+        RunTailCall(file, bytecode);
+        return;
+    }
 
-    #define MARK_RD_AS_ROOT(is_obj) \
-        RD_MARK_REG_AS_ROOT(frame_cur_, is_obj)
+    // Frame is entered by call or return: compiled code continues from there if it's hot
+    #define JIT_ENTRY()                              \
+        if (UNLIKELY(jit_ != nullptr)) {             \
+            pc_ = jit_->Enter(pc_, frame_cur_);      \
+        }
 
-    #define IS_RS1_MARKED_AS_ROOT() \
-        RS1_IS_MARKED_AS_ROOT(frame_cur_)
+    // Backward jump closes a loop: long-running loop continues in compiled code from its header
+    #define JIT_LOOP_ENTRY(offset)                            \
+        if ((offset) < 0 && UNLIKELY(jit_ != nullptr)) {      \
+            pc_ = jit_->EnterLoop(pc_, frame_cur_);           \
+        }
 
     #define CHECK_GC_INVOKE() \
         Runtime::GetInstance()->GetGC()->UpdateState();
@@ -127,6 +83,7 @@ void Interpreter::Run(file_format::File *file, const byte_t *bytecode, size_t en
     #define DEFINE_INSTR(instr, opcode, interpret)    \
     instr:                                            \
     {                                                 \
+        TRACE_EVENT(INSTRUCTION, Opcode::instr, pc_); \
         interpret;                                    \
         PRINT_INSTR(instr);                           \
         CHECK_GC_INVOKE();                            \
@@ -136,6 +93,27 @@ void Interpreter::Run(file_format::File *file, const byte_t *bytecode, size_t en
     #include "isa/isa.def"
 
     #undef DEFINE_INSTR
+    #undef JIT_LOOP_ENTRY
+    #undef JIT_ENTRY
+}
+
+Interpreter::Interpreter() = default;
+Interpreter::~Interpreter() = default;
+
+void Interpreter::EnableJit(size_t hotness_threshold)
+{
+    jit_ = std::make_unique<jit::Jit>(hotness_threshold, &accum_, &is_accum_root_);
+}
+
+void Interpreter::RunCompiled(file_format::File *file, size_t entrypoint, CompiledFunction entry)
+{
+    frames_.emplace_back(Frame(0, {}));
+    frame_cur_ = &frames_.back();
+
+    pc_ = entrypoint;
+
+    perf::ScopedPerfPhase perf_phase(perf::Phase::INTERPRETER);
+    entry(this, file);
 }
 
 const std::vector<Frame> &Interpreter::GetFramesStack() const
@@ -149,19 +127,29 @@ const Frame *Interpreter::GetCurrFrame() const
 }
 
 void Interpreter::MigrateToNewFrame(size_t new_pc, size_t restore_pc,
-                                    const std::array<Register, Frame::N_PASSED_ARGS_DEFAULT> &passed_args)
+                                    const std::array<Register, Frame::N_PASSED_ARGS_DEFAULT> &passed_args,
+                                    const std::array<bool, Frame::N_PASSED_ARGS_DEFAULT> &passed_roots)
 {
     frame_cur_->SetRestorePC(restore_pc);
     frames_.emplace_back(Frame(new_pc, passed_args));
     pc_ = new_pc;
     frame_cur_ = &frames_.back();
+    call_stack_.Push(new_pc);
+    TRACE_EVENT(CALL, 0, new_pc);
+
+    // Objects passed to callee keep their root bits: compiled code speculates on them
+    for (size_t i = 0; i < passed_roots.size(); ++i) {
+        frame_cur_->MarkReg(i, passed_roots[i]);
+    }
 }
 
 void Interpreter::ReturnToPrevFrame()
 {
     frames_.pop_back();
     frame_cur_ = &frames_.back();
+    call_stack_.Pop();
     pc_ = frame_cur_->GetRestorePC();
+    TRACE_EVENT(RET, 0, pc_);
 }
 
 void Interpreter::MarkAccum(bool is_root)
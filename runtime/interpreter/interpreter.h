@@ -3,27 +3,87 @@
 
 #include "common/macros.h"
 #include "common/constants.h"
+#include "runtime/interpreter/call_stack.h"
 #include "runtime/memory/frame.h"
 #include "runtime/memory/reg.h"
 
 #include <cstddef>
+#include <memory>
 #include <vector>
 
 namespace evm::file_format {
 class File;
 } // namespace evm::file_format
 
+namespace evm::runtime::jit {
+class Jit;
+} // namespace evm::runtime::jit
+
 namespace evm::runtime {
 
+class TailCallEngine;
+
 class Interpreter {
+public:
+    /// How instruction handlers pass control to each other
+    enum class Engine {
+        COMPUTED_GOTO, // single function, handlers are labels of one dispatch table
+        TAIL_CALL,     // handler per instruction, state is passed in arguments, see interpreter_tail_call.cpp
+    };
+
 public:
     NO_COPY_SEMANTIC(Interpreter);
     NO_MOVE_SEMANTIC(Interpreter);
 
-    Interpreter() = default;
-    ~Interpreter() = default;
+    Interpreter();
+    ~Interpreter();
 
     void Run(file_format::File *file, const byte_t *bytecode, size_t entrypoint);
+
+    /// Entry of ahead-of-time compiled code, returns true if program was finished with exit instruction
+    using CompiledFunction = bool (*)(Interpreter *interpreter, file_format::File *file);
+
+    /// Execute compiled code with the same frames stack as interpreted one, so GC sees the same roots
+    void RunCompiled(file_format::File *file, size_t entrypoint, CompiledFunction entry);
+
+    /// Hot code is compiled to machine code and executed on the same frames, see runtime/jit/jit.h
+    void EnableJit(size_t hotness_threshold);
+
+    void SetEngine(Engine engine)
+    {
+        engine_ = engine;
+    }
+
+    Engine GetEngine() const
+    {
+        return engine_;
+    }
+
+    const jit::Jit *GetJit() const
+    {
+        return jit_.get();
+    }
+
+    size_t GetPC() const
+    {
+        return pc_;
+    }
+
+    // Single instructions with semantics of isa/isa.def for ahead-of-time compiled code.
+    // Definitions are in interpreter_compiled-inl.h, only generated code is expected to include it.
+    // clang-format off
+    #define DEFINE_INSTR(instr, opcode, interpret) \
+        ALWAYS_INLINE void Exec##instr(file_format::File *file, const byte_t *bytecode, size_t pc);
+    #include "isa/isa.def"
+    #undef DEFINE_INSTR
+    // clang-format on
+
+    /// Functions of the frames stack, can be read from signal handlers
+    const PublishedCallStack &GetPublishedCallStack() const
+    {
+        return call_stack_;
+    }
+
     const Frame *GetCurrFrame() const;
     const std::vector<Frame> &GetFramesStack() const;
 
@@ -33,10 +93,18 @@ public:
     Register GetAccum() const;
 
     void MigrateToNewFrame(size_t new_pc, size_t restore_pc,
-                           const std::array<Register, Frame::N_PASSED_ARGS_DEFAULT> &passed_args);
+                           const std::array<Register, Frame::N_PASSED_ARGS_DEFAULT> &passed_args,
+                           const std::array<bool, Frame::N_PASSED_ARGS_DEFAULT> &passed_roots);
     void ReturnToPrevFrame();
 
 private:
+    friend class TailCallEngine;
+
+    void RunTailCall(file_format::File *file, const byte_t *bytecode);
+
+private:
+    Engine engine_ {Engine::COMPUTED_GOTO};
+
     std::vector<Frame> frames_;
 
     Frame *frame_cur_ {nullptr};
@@ -46,6 +114,10 @@ private:
 
     Register accum_;
     bool is_accum_root_ {false};
+
+    std::unique_ptr<jit::Jit> jit_;
+
+    PublishedCallStack call_stack_;
 };
 
 } // namespace evm::runtime
@@ -0,0 +1,61 @@
+#ifndef EVM_RUNTIME_INTERPRETER_COMPILED_INL_H
+#define EVM_RUNTIME_INTERPRETER_COMPILED_INL_H
+
+#include "runtime/interpreter/interpreter.h"
+#include "runtime/interpreter/interpreter-inl.h"
+#include "runtime/interpreter/interpreter_macros.h"
+#include "runtime/runtime.h"
+#include "file_format/file.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace evm::runtime {
+
+// Instruction bodies are the same as in interpreter loop, but every instruction is a separate
+// function: compiled code calls them with constant pc, so operands are folded by C++ compiler
+// if bytecode is a constant array too.
+
+// Instruction bodies use statement expressions to decode immediates
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#endif
+
+// clang-format off
+
+// Ahead-of-time compiled code doesn't tier up
+#define JIT_ENTRY()
+#define JIT_LOOP_ENTRY(offset)
+
+#define DEFINE_INSTR(instr, opcode, interpret)                                              \
+    ALWAYS_INLINE void Interpreter::Exec##instr([[maybe_unused]] file_format::File *file,   \
+                                                [[maybe_unused]] const byte_t *bytecode,    \
+                                                size_t pc)                                  \
+    {                                                                                       \
+        pc_ = pc;                                                                           \
+        interpret;                                                                          \
+    }
+
+#include "isa/isa.def"
+
+#undef DEFINE_INSTR
+#undef JIT_LOOP_ENTRY
+#undef JIT_ENTRY
+
+// clang-format on
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+
+/// Same as CHECK_GC_INVOKE of interpreter loop: keeps GC cadence of compiled code equal to interpreted one
+ALWAYS_INLINE void CompiledSafepoint()
+{
+    Runtime::GetInstance()->GetGC()->UpdateState();
+}
+
+} // namespace evm::runtime
+
+#endif // EVM_RUNTIME_INTERPRETER_COMPILED_INL_H
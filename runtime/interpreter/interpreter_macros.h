@@ -0,0 +1,102 @@
+#ifndef EVM_RUNTIME_INTERPRETER_MACROS_H
+#define EVM_RUNTIME_INTERPRETER_MACROS_H
+
+#include "isa/macros.h"
+
+// Operand accessors used by instruction bodies in isa/isa.def.
+// They expect `bytecode`, `pc_`, `frame_cur_` and `accum_` to be in scope: interpreter loop and
+// ahead-of-time compiled code (see interpreter_compiled-inl.h) provide them in the same way.
+
+// clang-format off
+
+#define RD_I_FRAME_ASSIGN(frame, value) frame->GetReg(RD_IDX())->SetInt64(value)
+#define RD_F_FRAME_ASSIGN(frame, value) frame->GetReg(RD_IDX())->SetDouble(value)
+
+#define RS1_I_FRAME(frame) frame->GetReg(RS1_IDX())->GetInt64()
+#define RS1_F_FRAME(frame) frame->GetReg(RS1_IDX())->GetDouble()
+
+#define RS2_I_FRAME(frame) frame->GetReg(RS2_IDX())->GetInt64()
+#define RS2_F_FRAME(frame) frame->GetReg(RS2_IDX())->GetDouble()
+
+#define RS3_I_FRAME(frame) frame->GetReg(RS3_IDX())->GetInt64()
+#define RS3_F_FRAME(frame) frame->GetReg(RS3_IDX())->GetDouble()
+
+#define RD_MARK_REG_AS_ROOT(frame, is_obj) \
+    frame->MarkReg(RD_IDX(), is_obj)
+
+#define RS1_IS_MARKED_AS_ROOT(frame) \
+    frame->IsRegMarked(RS1_IDX())
+
+#define RS2_IS_MARKED_AS_ROOT(frame) \
+    frame->IsRegMarked(RS2_IDX())
+
+#define CALL_REG1()             *frame_cur_->GetReg(ISA_CALL_GET_REG1(bytecode + pc_))
+#define CALL_REG2()             *frame_cur_->GetReg(ISA_CALL_GET_REG2(bytecode + pc_))
+#define CALL_REG3()             *frame_cur_->GetReg(ISA_CALL_GET_REG3(bytecode + pc_))
+#define CALL_REG4()             *frame_cur_->GetReg(ISA_CALL_GET_REG4(bytecode + pc_))
+
+#define CALL_REG1_IS_ROOT()     frame_cur_->IsRegMarked(ISA_CALL_GET_REG1(bytecode + pc_))
+#define CALL_REG2_IS_ROOT()     frame_cur_->IsRegMarked(ISA_CALL_GET_REG2(bytecode + pc_))
+#define CALL_REG3_IS_ROOT()     frame_cur_->IsRegMarked(ISA_CALL_GET_REG3(bytecode + pc_))
+#define CALL_REG4_IS_ROOT()     frame_cur_->IsRegMarked(ISA_CALL_GET_REG4(bytecode + pc_))
+
+// Additional register arguments are encoded in the same way as call arguments
+#define ARG1_I()                frame_cur_->GetReg(ISA_CALL_GET_REG1(bytecode + pc_))->GetInt64()
+#define ARG2_I()                frame_cur_->GetReg(ISA_CALL_GET_REG2(bytecode + pc_))->GetInt64()
+#define ARG3_I()                frame_cur_->GetReg(ISA_CALL_GET_REG3(bytecode + pc_))->GetInt64()
+
+#define RD_IDX()                ISA_GET_RD (bytecode + pc_)
+#define RS1_IDX()               ISA_GET_RS1(bytecode + pc_)
+#define RS2_IDX()               ISA_GET_RS2(bytecode + pc_)
+#define RS3_IDX()               ISA_GET_RS3(bytecode + pc_)
+#define IMM_I()                 ISA_GET_IMM(bytecode + pc_, int64_t)
+#define IMM_F()                 ISA_GET_IMM(bytecode + pc_, double)
+#define IMM_I32()               ISA_GET_IMM(bytecode + pc_, int32_t)
+
+#define GET_ARRAY_SIZE()        frame_cur_->GetReg(ISA_GET_ARRAY_SIZE_RS(bytecode + pc_))->GetRaw()
+#define GET_ARRAY_TYPE()        ISA_GET_ARRAY_TYPE(bytecode + pc_)
+#define GET_OBJ_TYPE()          ISA_GET_OBJ_TYPE(bytecode + pc_)
+#define GET_OBJ_FIELD_IDX()     ISA_GET_OBJ_TYPE(bytecode + pc_)
+#define GET_OBJ_FIELD_TYPE()    ISA_GET_OBJ_FIELD_TYPE(bytecode + pc_)
+#define GET_OBJ_RS()            frame_cur_->GetReg(ISA_GET_OBJ_RS(bytecode + pc_))->GetRaw()
+#define GET_OBJ_OP_RS()         frame_cur_->GetReg(ISA_GET_OBJ_OP_RS(bytecode + pc_))->GetRaw()
+#define OBJ_RS_OP_ASSIGN(value) frame_cur_->GetReg(ISA_GET_OBJ_OP_RS(bytecode + pc_))->SetInt64(value)
+
+#define BYTECODE_OFFSET(offset) bytecode + offset
+
+#define PC()             pc_
+#define PC_ADD(value)    pc_ += value
+#define PC_ASSIGN(value) pc_ =  value
+
+#define RD_I_ASSIGN(value) RD_I_FRAME_ASSIGN(frame_cur_, value)
+#define RD_F_ASSIGN(value) RD_F_FRAME_ASSIGN(frame_cur_, value)
+
+#define RS1_I() RS1_I_FRAME(frame_cur_)
+#define RS1_F() RS1_F_FRAME(frame_cur_)
+
+#define RS2_I() RS2_I_FRAME(frame_cur_)
+#define RS2_F() RS2_F_FRAME(frame_cur_)
+
+#define RS3_I() RS3_I_FRAME(frame_cur_)
+#define RS3_F() RS3_F_FRAME(frame_cur_)
+
+#define PUT_ACCUM(reg)     accum_ = reg
+#define PUT_I_ACCUM(value) accum_.SetInt64(value)
+#define PUT_F_ACCUM(value) accum_.SetDouble(value)
+
+#define GET_ACCUM()   accum_
+#define GET_I_ACCUM() accum_.GetInt64()
+#define GET_F_ACCUM() accum_.GetDouble()
+
+#define MARK_RD_AS_ROOT(is_obj) \
+    RD_MARK_REG_AS_ROOT(frame_cur_, is_obj)
+
+#define IS_RS1_MARKED_AS_ROOT() \
+    RS1_IS_MARKED_AS_ROOT(frame_cur_)
+
+#define IS_RS2_MARKED_AS_ROOT() \
+    RS2_IS_MARKED_AS_ROOT(frame_cur_)
+
+// clang-format on
+
+#endif // EVM_RUNTIME_INTERPRETER_MACROS_H
@@ -0,0 +1,205 @@
+#include "runtime/interpreter/interpreter.h"
+#include "common/constants.h"
+#include "common/trace.h"
+#include "common/config.h"
+#include "common/logs.h"
+#include "runtime/interpreter/interpreter-inl.h"
+#include "runtime/interpreter/interpreter_macros.h"
+#include "runtime/jit/jit.h"
+#include "runtime/memory/reg.h"
+#include "runtime/memory/types/array.h"
+#include "runtime/runtime.h"
+#include "file_format/file.h"
+#include "isa/macros.h"
+
+#include <cstring>
+#include <type_traits>
+#include <cmath>
+
+namespace evm::runtime {
+
+// Disable warning because operand accessors of isa/macros.h use statement expressions
+#if defined(__clang__)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wgnu-statement-expression"
+#elif defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#endif
+
+// Only Clang guarantees that a call in tail position doesn't grow the native stack. GCC does the same with
+// sibling call optimization, so it's enabled for handlers in every build type, including debug ones.
+#if defined(__clang__)
+#define MUSTTAIL [[clang::musttail]]
+#define TAIL_CALL_HANDLER
+#else
+#define MUSTTAIL
+#define TAIL_CALL_HANDLER __attribute__((optimize("O2")))
+#endif
+
+/// Interpreter where each instruction of isa/isa.def is a separate function which ends with a tail call
+/// of the handler of the next instruction. pc, current frame and accumulator are arguments of handlers,
+/// so the compiler keeps them in machine registers instead of fields of Interpreter.
+/// State is written back to Interpreter only when the runtime can observe it: GC steps, allocations, JIT entries
+/// and exit.
+class TailCallEngine {
+public:
+    using Handler = void (*)(const TailCallEngine *engine, const byte_t *bytecode, size_t pc_, Frame *frame_cur_,
+                             Register accum_, size_t gc_countdown);
+
+    TailCallEngine(Interpreter *interpreter, file_format::File *file, size_t gc_period)
+        : interpreter_(interpreter), file_(file), gc_period_(gc_period == 0 ? 1 : gc_period)
+    {
+    }
+
+    void Run(const byte_t *bytecode) const
+    {
+        Interpreter *interpreter = interpreter_;
+        DISPATCH_TABLE[bytecode[interpreter->pc_]](this, bytecode, interpreter->pc_, interpreter->frame_cur_,
+                                                   interpreter->accum_, gc_period_);
+    }
+
+private:
+    // clang-format off
+    #define DEFINE_INSTR(instr, opcode, interpret)                                                             \
+        static void Handle##instr(const TailCallEngine *engine, const byte_t *bytecode, size_t pc_,             \
+                                  Frame *frame_cur_, Register accum_, size_t gc_countdown);
+    #include "isa/isa.def"
+    #undef DEFINE_INSTR
+    // clang-format on
+
+    static const Handler DISPATCH_TABLE[];
+
+    Interpreter *interpreter_;
+    file_format::File *file_;
+    size_t gc_period_;
+};
+
+// clang-format off
+
+#define DEFINE_INSTR(instr, opcode, interpret) \
+    &TailCallEngine::Handle##instr,
+
+const TailCallEngine::Handler TailCallEngine::DISPATCH_TABLE[] = {
+    #include "isa/isa.def"
+};
+
+#undef DEFINE_INSTR
+
+// Log takes arguments by reference, pc is copied so that its address doesn't escape and prevent the tail call
+#define PRINT_INSTR(name) PrintLogCat(INTERPRETER, #name, ", pc = ", static_cast<size_t>(pc_))
+
+// Frames stack stays in Interpreter, handlers reload the registers it changes
+#define MigrateToNewFrame(...)                                                                      \
+    (interpreter->MigrateToNewFrame(__VA_ARGS__), pc_ = interpreter->pc_, frame_cur_ = interpreter->frame_cur_)
+
+#define ReturnToPrevFrame() \
+    (interpreter->ReturnToPrevFrame(), pc_ = interpreter->pc_, frame_cur_ = interpreter->frame_cur_)
+
+// Accumulator is accessed through temporaries: methods of Register aren't inlined into handlers in debug builds,
+// and taking address of the argument would prevent the tail call as well
+#undef PUT_I_ACCUM
+#undef PUT_F_ACCUM
+#undef GET_I_ACCUM
+#undef GET_F_ACCUM
+#define PUT_I_ACCUM(value) accum_ = Register(static_cast<int64_t>(value))
+#define PUT_F_ACCUM(value) accum_ = Register(static_cast<double>(value))
+#define GET_I_ACCUM()      Register(accum_).GetInt64()
+#define GET_F_ACCUM()      Register(accum_).GetDouble()
+
+#define MarkAccum(is_root) interpreter->MarkAccum(is_root)
+#define IsAccumMarked()    interpreter->IsAccumMarked()
+
+// Compiled code reads and writes accumulator of Interpreter
+#define JIT_ENTRY()                                            \
+    if (UNLIKELY(interpreter->jit_ != nullptr)) {              \
+        interpreter->accum_ = accum_;                          \
+        pc_ = interpreter->jit_->Enter(pc_, frame_cur_);       \
+        accum_ = interpreter->accum_;                          \
+    }
+
+#define JIT_LOOP_ENTRY(offset)                                             \
+    if ((offset) < 0 && UNLIKELY(interpreter->jit_ != nullptr)) {          \
+        interpreter->accum_ = accum_;                                      \
+        pc_ = interpreter->jit_->EnterLoop(pc_, frame_cur_);               \
+        accum_ = interpreter->accum_;                                      \
+    }
+
+// GC is told about executed instructions in batches of its period, it may mark the accumulator
+#define CHECK_GC_INVOKE()                                                              \
+    if (UNLIKELY(--gc_countdown == 0)) {                                               \
+        interpreter->accum_ = accum_;                                                  \
+        Runtime::GetInstance()->GetGC()->UpdateState(engine->gc_period_);              \
+        gc_countdown = engine->gc_period_;                                             \
+    }
+
+#define DISPATCH() \
+    MUSTTAIL return DISPATCH_TABLE[bytecode[pc_]](engine, bytecode, pc_, frame_cur_, accum_, gc_countdown)
+
+// Allocation profiler takes the site of an allocation from Interpreter
+static constexpr bool IsAllocating(Opcode opcode)
+{
+    switch (opcode) {
+        case Opcode::NEWARR_IMM:
+        case Opcode::NEWARR:
+        case Opcode::NEWSTR:
+        case Opcode::STRCONCAT:
+        case Opcode::NEWOBJ:
+        case Opcode::CPOBJ:
+        case Opcode::CPOBJ_DEEP:
+            return true;
+        default:
+            return false;
+    }
+}
+
+#define DEFINE_INSTR(instr, opcode, interpret)                                                                 \
+    TAIL_CALL_HANDLER void TailCallEngine::Handle##instr(const TailCallEngine *engine, const byte_t *bytecode,  \
+                                                         size_t pc_, Frame *frame_cur_, Register accum_,        \
+                                                         size_t gc_countdown)                                   \
+    {                                                                                                           \
+        [[maybe_unused]] Interpreter *interpreter = engine->interpreter_;                                       \
+        [[maybe_unused]] file_format::File *file = engine->file_;                                              \
+        if constexpr (Opcode::instr == Opcode::EXIT) {                                                          \
+            interpreter->pc_ = pc_;                                                                             \
+            interpreter->accum_ = accum_;                                                                       \
+            /* Unfinished batch is reported too, so GC counts all executed instructions */                     \
+            Runtime::GetInstance()->GetGC()->UpdateState(engine->gc_period_ - gc_countdown);                   \
+        }                                                                                                       \
+        if constexpr (IsAllocating(Opcode::instr)) {                                                            \
+            interpreter->pc_ = pc_;                                                                             \
+        }                                                                                                       \
+        TRACE_EVENT(INSTRUCTION, Opcode::instr, pc_);                                                           \
+        interpret;                                                                                              \
+        PRINT_INSTR(instr);                                                                                     \
+        CHECK_GC_INVOKE();                                                                                      \
+        DISPATCH();                                                                                             \
+    }
+
+#include "isa/isa.def"
+
+#undef DEFINE_INSTR
+#undef DISPATCH
+#undef CHECK_GC_INVOKE
+#undef JIT_LOOP_ENTRY
+#undef JIT_ENTRY
+#undef IsAccumMarked
+#undef MarkAccum
+#undef ReturnToPrevFrame
+#undef MigrateToNewFrame
+
+// clang-format on
+
+void Interpreter::RunTailCall(file_format::File *file, const byte_t *bytecode)
+{
+    TailCallEngine engine(this, file, Runtime::GetInstance()->GetGC()->GetInstrsFrequency());
+    engine.Run(bytecode);
+}
+
+#if defined(__clang__)
+#pragma clang diagnostic pop
+#elif defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+
+} // namespace evm::runtime
@@ -0,0 +1,457 @@
+#include "runtime/jit/assembler_x86_64.h"
+
+#include <limits>
+
+namespace evm::runtime::jit {
+
+namespace {
+
+constexpr uint8_t REX = 0x40;
+constexpr uint8_t REX_W = 0x08;
+constexpr uint8_t REX_R = 0x04;
+constexpr uint8_t REX_X = 0x02;
+constexpr uint8_t REX_B = 0x01;
+
+constexpr uint8_t PREFIX_66 = 0x66;
+constexpr uint8_t PREFIX_F2 = 0xf2;
+constexpr uint8_t TWO_BYTE_OPCODE = 0x0f;
+
+// Opcode extensions of group 1 instructions with immediate operand
+constexpr uint8_t ALU_ADD = 0;
+constexpr uint8_t ALU_OR = 1;
+constexpr uint8_t ALU_AND = 4;
+constexpr uint8_t ALU_SUB = 5;
+constexpr uint8_t ALU_XOR = 6;
+constexpr uint8_t ALU_CMP = 7;
+
+constexpr uint8_t R(Reg reg)
+{
+    return static_cast<uint8_t>(reg);
+}
+
+constexpr uint8_t X(XmmReg reg)
+{
+    return static_cast<uint8_t>(reg);
+}
+
+bool IsInt8(int64_t value)
+{
+    return value >= std::numeric_limits<int8_t>::min() && value <= std::numeric_limits<int8_t>::max();
+}
+
+bool IsInt32(int64_t value)
+{
+    return value >= std::numeric_limits<int32_t>::min() && value <= std::numeric_limits<int32_t>::max();
+}
+
+} // namespace
+
+Assembler::Label Assembler::CreateLabel()
+{
+    labels_.push_back(UNBOUND);
+    return labels_.size() - 1;
+}
+
+void Assembler::Bind(Label label)
+{
+    assert(labels_[label] == UNBOUND);
+    labels_[label] = code_.size();
+}
+
+size_t Assembler::GetLabelOffset(Label label) const
+{
+    return labels_[label];
+}
+
+bool Assembler::Finalize()
+{
+    for (const auto &fixup : fixups_) {
+        size_t target = labels_[fixup.label];
+        if (target == UNBOUND) {
+            return false;
+        }
+
+        auto displacement = static_cast<int32_t>(static_cast<int64_t>(target) -
+                                                 static_cast<int64_t>(fixup.position + sizeof(int32_t)));
+        for (size_t i = 0; i < sizeof(int32_t); ++i) {
+            code_[fixup.position + i] = static_cast<uint8_t>(static_cast<uint32_t>(displacement) >> (8 * i));
+        }
+    }
+    fixups_.clear();
+
+    return true;
+}
+
+void Assembler::Emit8(uint8_t value)
+{
+    code_.push_back(value);
+}
+
+void Assembler::Emit32(uint32_t value)
+{
+    for (size_t i = 0; i < sizeof(value); ++i) {
+        Emit8(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+void Assembler::Emit64(uint64_t value)
+{
+    for (size_t i = 0; i < sizeof(value); ++i) {
+        Emit8(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+void Assembler::EmitRex(bool wide, uint8_t reg, uint8_t index, uint8_t base, bool force)
+{
+    uint8_t rex = REX;
+    rex |= wide ? REX_W : 0;
+    rex |= (reg & 0x8) != 0 ? REX_R : 0;
+    rex |= (index & 0x8) != 0 ? REX_X : 0;
+    rex |= (base & 0x8) != 0 ? REX_B : 0;
+
+    if (rex != REX || force) {
+        Emit8(rex);
+    }
+}
+
+void Assembler::EmitModRm(uint8_t reg, uint8_t rm)
+{
+    Emit8(0xc0 | ((reg & 0x7) << 3) | (rm & 0x7));
+}
+
+void Assembler::EmitModRm(uint8_t reg, const Mem &mem)
+{
+    uint8_t base = R(mem.base) & 0x7;
+
+    // Base rbp/r13 without displacement means rip-relative or absolute addressing
+    uint8_t mod = 0x2;
+    if (mem.disp == 0 && base != R(Reg::RBP)) {
+        mod = 0x0;
+    } else if (IsInt8(mem.disp)) {
+        mod = 0x1;
+    }
+
+    // Base rsp/r12 is encoded only with SIB byte, index rsp means no index
+    if (mem.has_index || base == R(Reg::RSP)) {
+        uint8_t index = mem.has_index ? (R(mem.index) & 0x7) : R(Reg::RSP);
+        Emit8((mod << 6) | ((reg & 0x7) << 3) | R(Reg::RSP));
+        Emit8((mem.scale_log2 << 6) | (index << 3) | base);
+    } else {
+        Emit8((mod << 6) | ((reg & 0x7) << 3) | base);
+    }
+
+    if (mod == 0x1) {
+        Emit8(static_cast<uint8_t>(mem.disp));
+    } else if (mod == 0x2) {
+        Emit32(static_cast<uint32_t>(mem.disp));
+    }
+}
+
+void Assembler::EmitRR(uint8_t opcode, uint8_t reg, uint8_t rm)
+{
+    EmitRex(true, reg, 0, rm);
+    Emit8(opcode);
+    EmitModRm(reg, rm);
+}
+
+void Assembler::EmitRM(uint8_t opcode, uint8_t reg, const Mem &mem, bool wide)
+{
+    EmitRex(wide, reg, mem.has_index ? R(mem.index) : 0, R(mem.base));
+    Emit8(opcode);
+    EmitModRm(reg, mem);
+}
+
+void Assembler::EmitAluImm(uint8_t ext, Reg dst, int32_t imm)
+{
+    if (IsInt8(imm)) {
+        EmitRR(0x83, ext, R(dst));
+        Emit8(static_cast<uint8_t>(imm));
+    } else {
+        EmitRR(0x81, ext, R(dst));
+        Emit32(static_cast<uint32_t>(imm));
+    }
+}
+
+void Assembler::EmitSse(uint8_t prefix, uint8_t opcode, uint8_t reg, uint8_t rm, bool wide)
+{
+    // Mandatory prefix goes before REX
+    Emit8(prefix);
+    EmitRex(wide, reg, 0, rm);
+    Emit8(TWO_BYTE_OPCODE);
+    Emit8(opcode);
+    EmitModRm(reg, rm);
+}
+
+void Assembler::Mov(Reg dst, Reg src)
+{
+    EmitRR(0x89, R(src), R(dst));
+}
+
+void Assembler::Mov(Reg dst, int64_t imm)
+{
+    if (IsInt32(imm)) {
+        // Sign-extended 32-bit immediate
+        EmitRR(0xc7, 0, R(dst));
+        Emit32(static_cast<uint32_t>(imm));
+    } else if (imm > 0 && imm <= std::numeric_limits<uint32_t>::max()) {
+        // 32-bit move zeroes upper half of register
+        EmitRex(false, 0, 0, R(dst));
+        Emit8(0xb8 + (R(dst) & 0x7));
+        Emit32(static_cast<uint32_t>(imm));
+    } else {
+        EmitRex(true, 0, 0, R(dst));
+        Emit8(0xb8 + (R(dst) & 0x7));
+        Emit64(static_cast<uint64_t>(imm));
+    }
+}
+
+void Assembler::Mov(Reg dst, const Mem &src)
+{
+    EmitRM(0x8b, R(dst), src);
+}
+
+void Assembler::Mov(const Mem &dst, Reg src)
+{
+    EmitRM(0x89, R(src), dst);
+}
+
+void Assembler::Mov(const Mem &dst, int32_t imm)
+{
+    EmitRM(0xc7, 0, dst);
+    Emit32(static_cast<uint32_t>(imm));
+}
+
+void Assembler::Movb(const Mem &dst, Reg src)
+{
+    // Without REX registers 4-7 would be ah, ch, dh, bh
+    EmitRex(false, R(src), dst.has_index ? R(dst.index) : 0, R(dst.base), R(src) >= R(Reg::RSP));
+    Emit8(0x88);
+    EmitModRm(R(src), dst);
+}
+
+void Assembler::Movb(const Mem &dst, int8_t imm)
+{
+    EmitRM(0xc6, 0, dst, false);
+    Emit8(static_cast<uint8_t>(imm));
+}
+
+void Assembler::Movzxb(Reg dst, Reg src)
+{
+    EmitRex(true, R(dst), 0, R(src));
+    Emit8(TWO_BYTE_OPCODE);
+    Emit8(0xb6);
+    EmitModRm(R(dst), R(src));
+}
+
+void Assembler::Add(Reg dst, Reg src)
+{
+    EmitRR(0x01, R(src), R(dst));
+}
+
+void Assembler::Add(Reg dst, int32_t imm)
+{
+    EmitAluImm(ALU_ADD, dst, imm);
+}
+
+void Assembler::Sub(Reg dst, Reg src)
+{
+    EmitRR(0x29, R(src), R(dst));
+}
+
+void Assembler::Sub(Reg dst, int32_t imm)
+{
+    EmitAluImm(ALU_SUB, dst, imm);
+}
+
+void Assembler::Sub(const Mem &dst, int32_t imm)
+{
+    if (IsInt8(imm)) {
+        EmitRM(0x83, ALU_SUB, dst);
+        Emit8(static_cast<uint8_t>(imm));
+    } else {
+        EmitRM(0x81, ALU_SUB, dst);
+        Emit32(static_cast<uint32_t>(imm));
+    }
+}
+
+void Assembler::And(Reg dst, Reg src)
+{
+    EmitRR(0x21, R(src), R(dst));
+}
+
+void Assembler::And(Reg dst, int32_t imm)
+{
+    EmitAluImm(ALU_AND, dst, imm);
+}
+
+void Assembler::Or(Reg dst, Reg src)
+{
+    EmitRR(0x09, R(src), R(dst));
+}
+
+void Assembler::Or(Reg dst, int32_t imm)
+{
+    EmitAluImm(ALU_OR, dst, imm);
+}
+
+void Assembler::Xor(Reg dst, Reg src)
+{
+    EmitRR(0x31, R(src), R(dst));
+}
+
+void Assembler::Xor(Reg dst, int32_t imm)
+{
+    EmitAluImm(ALU_XOR, dst, imm);
+}
+
+void Assembler::Cmp(Reg lhs, Reg rhs)
+{
+    EmitRR(0x39, R(rhs), R(lhs));
+}
+
+void Assembler::Cmp(Reg lhs, int32_t imm)
+{
+    EmitAluImm(ALU_CMP, lhs, imm);
+}
+
+void Assembler::Cmpb(const Mem &lhs, int8_t imm)
+{
+    EmitRM(0x80, ALU_CMP, lhs, false);
+    Emit8(static_cast<uint8_t>(imm));
+}
+
+void Assembler::Test(Reg lhs, Reg rhs)
+{
+    EmitRR(0x85, R(rhs), R(lhs));
+}
+
+void Assembler::Imul(Reg dst, Reg src)
+{
+    EmitRex(true, R(dst), 0, R(src));
+    Emit8(TWO_BYTE_OPCODE);
+    Emit8(0xaf);
+    EmitModRm(R(dst), R(src));
+}
+
+void Assembler::Cqo()
+{
+    Emit8(REX | REX_W);
+    Emit8(0x99);
+}
+
+void Assembler::Idiv(Reg divisor)
+{
+    EmitRR(0xf7, 7, R(divisor));
+}
+
+void Assembler::Setcc(Cond cond, Reg dst)
+{
+    EmitRex(false, 0, 0, R(dst), R(dst) >= R(Reg::RSP));
+    Emit8(TWO_BYTE_OPCODE);
+    Emit8(0x90 + static_cast<uint8_t>(cond));
+    EmitModRm(0, R(dst));
+}
+
+void Assembler::Bts(const Mem &dst, uint8_t bit)
+{
+    EmitRex(true, 0, dst.has_index ? R(dst.index) : 0, R(dst.base));
+    Emit8(TWO_BYTE_OPCODE);
+    Emit8(0xba);
+    EmitModRm(5, dst);
+    Emit8(bit);
+}
+
+void Assembler::Btr(const Mem &dst, uint8_t bit)
+{
+    EmitRex(true, 0, dst.has_index ? R(dst.index) : 0, R(dst.base));
+    Emit8(TWO_BYTE_OPCODE);
+    Emit8(0xba);
+    EmitModRm(6, dst);
+    Emit8(bit);
+}
+
+void Assembler::Push(Reg reg)
+{
+    EmitRex(false, 0, 0, R(reg));
+    Emit8(0x50 + (R(reg) & 0x7));
+}
+
+void Assembler::Pop(Reg reg)
+{
+    EmitRex(false, 0, 0, R(reg));
+    Emit8(0x58 + (R(reg) & 0x7));
+}
+
+void Assembler::Call(Reg target)
+{
+    EmitRex(false, 0, 0, R(target));
+    Emit8(0xff);
+    EmitModRm(2, R(target));
+}
+
+void Assembler::Ret()
+{
+    Emit8(0xc3);
+}
+
+void Assembler::Jmp(Label label)
+{
+    Emit8(0xe9);
+    fixups_.push_back({code_.size(), label});
+    Emit32(0);
+}
+
+void Assembler::Jcc(Cond cond, Label label)
+{
+    Emit8(TWO_BYTE_OPCODE);
+    Emit8(0x80 + static_cast<uint8_t>(cond));
+    fixups_.push_back({code_.size(), label});
+    Emit32(0);
+}
+
+void Assembler::Movq(XmmReg dst, Reg src)
+{
+    EmitSse(PREFIX_66, 0x6e, X(dst), R(src), true);
+}
+
+void Assembler::Movq(Reg dst, XmmReg src)
+{
+    EmitSse(PREFIX_66, 0x7e, X(src), R(dst), true);
+}
+
+void Assembler::Addsd(XmmReg dst, XmmReg src)
+{
+    EmitSse(PREFIX_F2, 0x58, X(dst), X(src), false);
+}
+
+void Assembler::Subsd(XmmReg dst, XmmReg src)
+{
+    EmitSse(PREFIX_F2, 0x5c, X(dst), X(src), false);
+}
+
+void Assembler::Mulsd(XmmReg dst, XmmReg src)
+{
+    EmitSse(PREFIX_F2, 0x59, X(dst), X(src), false);
+}
+
+void Assembler::Divsd(XmmReg dst, XmmReg src)
+{
+    EmitSse(PREFIX_F2, 0x5e, X(dst), X(src), false);
+}
+
+void Assembler::Ucomisd(XmmReg lhs, XmmReg rhs)
+{
+    EmitSse(PREFIX_66, 0x2e, X(lhs), X(rhs), false);
+}
+
+void Assembler::Cvtsi2sd(XmmReg dst, Reg src)
+{
+    EmitSse(PREFIX_F2, 0x2a, X(dst), R(src), true);
+}
+
+void Assembler::Cvttsd2si(Reg dst, XmmReg src)
+{
+    EmitSse(PREFIX_F2, 0x2c, R(dst), X(src), true);
+}
+
+} // namespace evm::runtime::jit
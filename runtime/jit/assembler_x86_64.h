@@ -0,0 +1,159 @@
+#ifndef EVM_RUNTIME_JIT_ASSEMBLER_X86_64_H
+#define EVM_RUNTIME_JIT_ASSEMBLER_X86_64_H
+
+#include "common/macros.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace evm::runtime::jit {
+
+// clang-format off
+enum class Reg : uint8_t {
+    RAX = 0, RCX = 1, RDX = 2,  RBX = 3,  RSP = 4,  RBP = 5,  RSI = 6,  RDI = 7,
+    R8  = 8, R9  = 9, R10 = 10, R11 = 11, R12 = 12, R13 = 13, R14 = 14, R15 = 15
+};
+
+enum class XmmReg : uint8_t {
+    XMM0 = 0, XMM1 = 1
+};
+
+/// Condition codes in the order of their encoding
+enum class Cond : uint8_t {
+    O = 0, NO, B, AE, E, NE, BE, A, S, NS, P, NP, L, GE, LE, G
+};
+// clang-format on
+
+static inline Cond InvertCond(Cond cond)
+{
+    return static_cast<Cond>(static_cast<uint8_t>(cond) ^ 1U);
+}
+
+/// Memory operand: [base + index * (1 << scale_log2) + disp]
+struct Mem {
+    Mem(Reg mem_base, int32_t mem_disp) : base(mem_base), disp(mem_disp) {}
+    Mem(Reg mem_base, Reg mem_index, uint8_t mem_scale_log2, int32_t mem_disp)
+        : base(mem_base), index(mem_index), has_index(true), scale_log2(mem_scale_log2), disp(mem_disp)
+    {
+        assert(mem_index != Reg::RSP);
+    }
+
+    Reg base;
+    Reg index {Reg::RAX};
+    bool has_index {false};
+    uint8_t scale_log2 {0};
+    int32_t disp {0};
+};
+
+/// Encoder of the x86-64 instructions used by JIT compiled code. All operations are 64-bit except byte ones,
+/// jumps to labels always have 32-bit displacement and are patched in Finalize()
+class Assembler {
+public:
+    using Label = size_t;
+
+public:
+    NO_COPY_SEMANTIC(Assembler);
+    NO_MOVE_SEMANTIC(Assembler);
+
+    Assembler() = default;
+    ~Assembler() = default;
+
+    Label CreateLabel();
+    void Bind(Label label);
+    size_t GetLabelOffset(Label label) const;
+
+    /// Resolves jumps to labels, returns false if some used label is not bound
+    bool Finalize();
+
+    const std::vector<uint8_t> &GetCode() const
+    {
+        return code_;
+    }
+
+    size_t GetSize() const
+    {
+        return code_.size();
+    }
+
+    void Mov(Reg dst, Reg src);
+    void Mov(Reg dst, int64_t imm);
+    void Mov(Reg dst, const Mem &src);
+    void Mov(const Mem &dst, Reg src);
+    void Mov(const Mem &dst, int32_t imm);
+    void Movb(const Mem &dst, Reg src);
+    void Movb(const Mem &dst, int8_t imm);
+    void Movzxb(Reg dst, Reg src);
+
+    void Add(Reg dst, Reg src);
+    void Add(Reg dst, int32_t imm);
+    void Sub(Reg dst, Reg src);
+    void Sub(Reg dst, int32_t imm);
+    void Sub(const Mem &dst, int32_t imm);
+    void And(Reg dst, Reg src);
+    void And(Reg dst, int32_t imm);
+    void Or(Reg dst, Reg src);
+    void Or(Reg dst, int32_t imm);
+    void Xor(Reg dst, Reg src);
+    void Xor(Reg dst, int32_t imm);
+    void Cmp(Reg lhs, Reg rhs);
+    void Cmp(Reg lhs, int32_t imm);
+    void Cmpb(const Mem &lhs, int8_t imm);
+    void Test(Reg lhs, Reg rhs);
+    void Imul(Reg dst, Reg src);
+    void Cqo();
+    void Idiv(Reg divisor);
+    void Setcc(Cond cond, Reg dst);
+
+    void Bts(const Mem &dst, uint8_t bit);
+    void Btr(const Mem &dst, uint8_t bit);
+
+    void Push(Reg reg);
+    void Pop(Reg reg);
+    void Call(Reg target);
+    void Ret();
+    void Jmp(Label label);
+    void Jcc(Cond cond, Label label);
+
+    void Movq(XmmReg dst, Reg src);
+    void Movq(Reg dst, XmmReg src);
+    void Addsd(XmmReg dst, XmmReg src);
+    void Subsd(XmmReg dst, XmmReg src);
+    void Mulsd(XmmReg dst, XmmReg src);
+    void Divsd(XmmReg dst, XmmReg src);
+    void Ucomisd(XmmReg lhs, XmmReg rhs);
+    void Cvtsi2sd(XmmReg dst, Reg src);
+    void Cvttsd2si(Reg dst, XmmReg src);
+
+private:
+    static constexpr size_t UNBOUND = static_cast<size_t>(-1);
+
+    struct Fixup {
+        size_t position; // of 32-bit displacement
+        Label label;
+    };
+
+    void Emit8(uint8_t value);
+    void Emit32(uint32_t value);
+    void Emit64(uint64_t value);
+
+    void EmitRex(bool wide, uint8_t reg, uint8_t index, uint8_t base, bool force = false);
+    void EmitModRm(uint8_t reg, uint8_t rm);
+    void EmitModRm(uint8_t reg, const Mem &mem);
+
+    // reg field is either a register or an opcode extension
+    void EmitRR(uint8_t opcode, uint8_t reg, uint8_t rm);
+    void EmitRM(uint8_t opcode, uint8_t reg, const Mem &mem, bool wide = true);
+    void EmitAluImm(uint8_t ext, Reg dst, int32_t imm);
+    void EmitSse(uint8_t prefix, uint8_t opcode, uint8_t reg, uint8_t rm, bool wide);
+
+private:
+    std::vector<uint8_t> code_;
+    std::vector<size_t> labels_;
+    std::vector<Fixup> fixups_;
+};
+
+} // namespace evm::runtime::jit
+
+#endif // EVM_RUNTIME_JIT_ASSEMBLER_X86_64_H
@@ -0,0 +1,77 @@
+#include "common/logs.h"
+#include "runtime/jit/code_cache.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace evm::runtime::jit {
+
+namespace {
+
+// Functions are aligned as by C++ compilers
+constexpr size_t CODE_ALIGNMENT = 16;
+
+size_t AlignUp(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+CodeCache::~CodeCache()
+{
+    for (const auto &chunk : chunks_) {
+        if (munmap(chunk.memory, chunk.size) == -1) {
+            PrintErr("Errors in munmap of code cache, errno = ", errno);
+        }
+    }
+}
+
+bool CodeCache::AllocateChunk(size_t min_size)
+{
+    size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t size = AlignUp(std::max(min_size, CHUNK_SIZE), page_size);
+
+    void *memory = mmap(nullptr, size, PROT_READ | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        PrintErr("Failed to mmap code cache, errno = ", errno);
+        return false;
+    }
+
+    chunks_.push_back({static_cast<uint8_t *>(memory), size, 0});
+    return true;
+}
+
+const uint8_t *CodeCache::Install(const std::vector<uint8_t> &code)
+{
+    if (chunks_.empty() || chunks_.back().size - chunks_.back().used < code.size()) {
+        if (!AllocateChunk(code.size())) {
+            return nullptr;
+        }
+    }
+
+    Chunk &chunk = chunks_.back();
+    uint8_t *dst = chunk.memory + chunk.used;
+
+    // Compiled code is never executed while new code is installed
+    if (mprotect(chunk.memory, chunk.size, PROT_READ | PROT_WRITE) == -1) {
+        PrintErr("Failed to make code cache writable, errno = ", errno);
+        return nullptr;
+    }
+    std::memcpy(dst, code.data(), code.size());
+    if (mprotect(chunk.memory, chunk.size, PROT_READ | PROT_EXEC) == -1) {
+        PrintErr("Failed to make code cache executable, errno = ", errno);
+        return nullptr;
+    }
+
+    chunk.used = std::min(chunk.size, AlignUp(chunk.used + code.size(), CODE_ALIGNMENT));
+    used_size_ += code.size();
+
+    return dst;
+}
+
+} // namespace evm::runtime::jit
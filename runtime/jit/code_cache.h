@@ -0,0 +1,49 @@
+#ifndef EVM_RUNTIME_JIT_CODE_CACHE_H
+#define EVM_RUNTIME_JIT_CODE_CACHE_H
+
+#include "common/macros.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace evm::runtime::jit {
+
+/// Executable memory for compiled code. Code is copied to writable pages which are made executable
+/// right after that, so memory is never writable and executable at the same time
+class CodeCache {
+public:
+    static constexpr size_t CHUNK_SIZE = 256 * 1024;
+
+public:
+    NO_COPY_SEMANTIC(CodeCache);
+    NO_MOVE_SEMANTIC(CodeCache);
+
+    CodeCache() = default;
+    ~CodeCache();
+
+    /// Returns address of installed code or nullptr if memory cannot be allocated
+    const uint8_t *Install(const std::vector<uint8_t> &code);
+
+    size_t GetUsedSize() const
+    {
+        return used_size_;
+    }
+
+private:
+    struct Chunk {
+        uint8_t *memory {nullptr};
+        size_t size {0};
+        size_t used {0};
+    };
+
+    bool AllocateChunk(size_t min_size);
+
+private:
+    std::vector<Chunk> chunks_;
+    size_t used_size_ {0};
+};
+
+} // namespace evm::runtime::jit
+
+#endif // EVM_RUNTIME_JIT_CODE_CACHE_H
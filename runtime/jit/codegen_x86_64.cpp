@@ -0,0 +1,738 @@
+#include "runtime/jit/codegen_x86_64.h"
+#include "runtime/jit/runtime_helpers.h"
+#include "runtime/memory/class_description.h"
+#include "runtime/memory/frame.h"
+#include "runtime/memory/object_header.h"
+#include "runtime/memory/types/array.h"
+#include "runtime/memory/types/class.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace evm::runtime::jit {
+
+namespace {
+
+constexpr std::array<Reg, 3> ARG_REGS = {Reg::RDI, Reg::RSI, Reg::RDX};
+constexpr std::array<Reg, 6> CALLEE_SAVED_REGS = {Reg::RBX, Reg::RBP, Reg::R12, Reg::R13, Reg::R14, Reg::R15};
+
+// Fixed registers of compiled code
+constexpr Reg CONTEXT_REG = Reg::RBX;
+constexpr Reg FRAME_REG = Reg::RBP;
+
+constexpr int32_t ELEMENT_SIZE_LOG2 = 3;
+
+bool IsCompare(IrOpcode opcode)
+{
+    switch (opcode) {
+        case IrOpcode::CMP_LT:
+        case IrOpcode::CMP_GE:
+        case IrOpcode::CMP_EQ:
+        case IrOpcode::CMP_NE:
+        case IrOpcode::CMPF_LT:
+        case IrOpcode::CMPF_GE:
+        case IrOpcode::CMPF_EQ:
+        case IrOpcode::CMPF_NE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+Cond GetIntCond(IrOpcode opcode)
+{
+    switch (opcode) {
+        case IrOpcode::CMP_LT:
+            return Cond::L;
+        case IrOpcode::CMP_GE:
+            return Cond::GE;
+        case IrOpcode::CMP_EQ:
+            return Cond::E;
+        case IrOpcode::CMP_NE:
+            return Cond::NE;
+        default:
+            UNREACHABLE();
+    }
+}
+
+// Sets flags for compare of integers or doubles and returns condition which is true if result is 1.
+// Not used for float equality.
+Cond EmitCompareFlags(Assembler *masm, IrOpcode opcode, bool is_imm, int32_t imm)
+{
+    switch (opcode) {
+        case IrOpcode::CMPF_LT:
+            // lhs < rhs is rhs > lhs, which is false for unordered operands
+            masm->Movq(XmmReg::XMM0, Reg::RAX);
+            masm->Movq(XmmReg::XMM1, Reg::RDX);
+            masm->Ucomisd(XmmReg::XMM1, XmmReg::XMM0);
+            return Cond::A;
+        case IrOpcode::CMPF_GE:
+            masm->Movq(XmmReg::XMM0, Reg::RAX);
+            masm->Movq(XmmReg::XMM1, Reg::RDX);
+            masm->Ucomisd(XmmReg::XMM0, XmmReg::XMM1);
+            return Cond::AE;
+        default:
+            is_imm ? masm->Cmp(Reg::RAX, imm) : masm->Cmp(Reg::RAX, Reg::RDX);
+            return GetIntCond(opcode);
+    }
+}
+
+} // namespace
+
+Mem CodegenX86_64::GetFrameReg(uint8_t reg)
+{
+    return Mem(FRAME_REG, static_cast<int32_t>(Frame::GetRegsOffset() + reg * sizeof(Register)));
+}
+
+Mem CodegenX86_64::GetFrameRootWord(uint8_t reg)
+{
+    return Mem(FRAME_REG, static_cast<int32_t>(Frame::GetObjectBitMaskOffset() + (reg / 64) * sizeof(uint64_t)));
+}
+
+bool CodegenX86_64::IsImm32(const Inst *value) const
+{
+    return regalloc_.GetLocation(value).kind == Location::Kind::CONST && value->imm >= INT32_MIN &&
+           value->imm <= INT32_MAX;
+}
+
+void CodegenX86_64::LoadValue(Reg dst, const Inst *value)
+{
+    const Location &location = regalloc_.GetLocation(value);
+    switch (location.kind) {
+        case Location::Kind::CONST:
+            asm_.Mov(dst, value->imm);
+            break;
+        case Location::Kind::REG:
+            if (location.reg != dst) {
+                asm_.Mov(dst, location.reg);
+            }
+            break;
+        case Location::Kind::STACK:
+            asm_.Mov(dst, GetSpillSlot(location.slot));
+            break;
+        default:
+            UNREACHABLE();
+    }
+}
+
+void CodegenX86_64::StoreResult(const Inst *inst, Reg src)
+{
+    const Location &location = regalloc_.GetLocation(inst);
+    if (location.kind == Location::Kind::REG && location.reg != src) {
+        asm_.Mov(location.reg, src);
+    } else if (location.kind == Location::Kind::STACK) {
+        asm_.Mov(GetSpillSlot(location.slot), src);
+    }
+}
+
+bool CodegenX86_64::Run()
+{
+    int64_t frame_size = SAVE_AREA_SIZE + static_cast<int64_t>(regalloc_.GetNumSpillSlots()) * 8;
+    // Stack is aligned by 16 at calls: return address and callee-saved registers take 7 words
+    if (frame_size % 16 == 0) {
+        frame_size += 8;
+    }
+    if (frame_size > INT32_MAX) {
+        return false;
+    }
+    frame_size_ = static_cast<int32_t>(frame_size);
+
+    use_counts_.assign(graph_.GetNumInsts(), 0);
+    const auto &rpo = graph_.GetRpo();
+    for (const BasicBlock *block : rpo) {
+        for (const Inst *inst : block->insts) {
+            for (const Inst *input : inst->inputs) {
+                ++use_counts_[input->id];
+            }
+            if (inst->state != nullptr) {
+                for (const auto &[reg, value] : inst->state->regs) {
+                    ++use_counts_[value->id];
+                }
+            }
+        }
+    }
+
+    block_labels_.clear();
+    for (size_t i = 0; i < graph_.GetBlocks().size(); ++i) {
+        block_labels_.push_back(asm_.CreateLabel());
+    }
+    epilogue_ = asm_.CreateLabel();
+
+    for (size_t i = 0; i < rpo.size(); ++i) {
+        const BasicBlock *block = rpo[i];
+        const BasicBlock *next_block = i + 1 < rpo.size() ? rpo[i + 1] : nullptr;
+
+        asm_.Bind(block_labels_[block->id]);
+        if (block->is_entry) {
+            entry_offsets_[block] = asm_.GetSize();
+            EmitPrologue();
+        }
+        for (const Inst *inst : block->insts) {
+            EmitInst(inst, next_block);
+        }
+    }
+
+    // Slow paths are out of line
+    for (const Stub &stub : guard_stubs_) {
+        // Deoptimization: the frame gets the state of the interpreter before the failed instruction
+        asm_.Bind(stub.label);
+        EmitWriteBack(*stub.inst->state);
+        asm_.Movb(Mem(CONTEXT_REG, static_cast<int32_t>(JitContext::GetIsDeoptimizedOffset())), static_cast<int8_t>(1));
+        asm_.Mov(Reg::RAX, static_cast<int64_t>(stub.inst->state->pc));
+        asm_.Jmp(epilogue_);
+    }
+    for (const Stub &stub : safepoint_stubs_) {
+        asm_.Bind(stub.label);
+        // GC finds roots in the frame
+        EmitWriteBack(*stub.inst->state);
+        EmitHelperCall(reinterpret_cast<const void *>(&JitSafepoint), {}, nullptr);
+        asm_.Jmp(stub.return_label);
+    }
+
+    asm_.Bind(epilogue_);
+    EmitEpilogue();
+
+    return asm_.Finalize();
+}
+
+void CodegenX86_64::EmitPrologue()
+{
+    for (Reg reg : CALLEE_SAVED_REGS) {
+        asm_.Push(reg);
+    }
+    asm_.Sub(Reg::RSP, frame_size_);
+    asm_.Mov(CONTEXT_REG, ARG_REGS[0]);
+    asm_.Mov(FRAME_REG, ARG_REGS[1]);
+}
+
+void CodegenX86_64::EmitEpilogue()
+{
+    asm_.Add(Reg::RSP, frame_size_);
+    for (auto it = CALLEE_SAVED_REGS.rbegin(); it != CALLEE_SAVED_REGS.rend(); ++it) {
+        asm_.Pop(*it);
+    }
+    asm_.Ret();
+}
+
+void CodegenX86_64::EmitWriteBack(const FrameState &state)
+{
+    for (const auto &[reg, value] : state.regs) {
+        LoadValue(Reg::RAX, value);
+        asm_.Mov(GetFrameReg(reg), Reg::RAX);
+
+        Mem root_word = GetFrameRootWord(reg);
+        auto bit = static_cast<uint8_t>(reg % 64);
+        switch (value->kind) {
+            case ValueKind::REFERENCE:
+                asm_.Bts(root_word, bit);
+                break;
+            case ValueKind::NULLABLE_REFERENCE: {
+                Assembler::Label null_label = asm_.CreateLabel();
+                Assembler::Label done_label = asm_.CreateLabel();
+                asm_.Test(Reg::RAX, Reg::RAX);
+                asm_.Jcc(Cond::E, null_label);
+                asm_.Bts(root_word, bit);
+                asm_.Jmp(done_label);
+                asm_.Bind(null_label);
+                asm_.Btr(root_word, bit);
+                asm_.Bind(done_label);
+                break;
+            }
+            default:
+                asm_.Btr(root_word, bit);
+                break;
+        }
+    }
+}
+
+void CodegenX86_64::EmitHelperCall(const void *helper, const std::vector<HelperArg> &args, const Inst *result)
+{
+    const auto &saved_regs = RegisterAllocator::CALLER_SAVED_REGS;
+    for (size_t i = 0; i < saved_regs.size(); ++i) {
+        asm_.Mov(Mem(Reg::RSP, static_cast<int32_t>(i * 8)), saved_regs[i]);
+    }
+
+    assert(args.size() <= ARG_REGS.size());
+    for (size_t i = 0; i < args.size(); ++i) {
+        const HelperArg &arg = args[i];
+        if (arg.value == nullptr) {
+            asm_.Mov(ARG_REGS[i], arg.imm);
+            continue;
+        }
+
+        // Argument registers are caller-saved, so previous arguments may overwrite the source
+        const Location &location = regalloc_.GetLocation(arg.value);
+        auto saved = std::find(saved_regs.begin(), saved_regs.end(), location.reg);
+        if (location.kind == Location::Kind::REG && saved != saved_regs.end()) {
+            asm_.Mov(ARG_REGS[i], Mem(Reg::RSP, static_cast<int32_t>((saved - saved_regs.begin()) * 8)));
+        } else {
+            LoadValue(ARG_REGS[i], arg.value);
+        }
+    }
+    if (args.empty()) {
+        // Only the safepoint helper, it takes the context
+        asm_.Mov(ARG_REGS[0], CONTEXT_REG);
+    }
+
+    asm_.Mov(Reg::RAX, static_cast<int64_t>(reinterpret_cast<uintptr_t>(helper)));
+    asm_.Call(Reg::RAX);
+
+    for (size_t i = 0; i < saved_regs.size(); ++i) {
+        asm_.Mov(saved_regs[i], Mem(Reg::RSP, static_cast<int32_t>(i * 8)));
+    }
+    if (result != nullptr) {
+        StoreResult(result, Reg::RAX);
+    }
+}
+
+void CodegenX86_64::EmitPhiMoves(const BasicBlock *from, const BasicBlock *to)
+{
+    struct Move {
+        Location dst;
+        Location src;
+    };
+
+    size_t pred_idx = to->GetPredIndex(from);
+    std::vector<Move> moves;
+    std::vector<std::pair<Location, const Inst *>> const_moves;
+    for (const Inst *phi : to->insts) {
+        if (phi->opcode != IrOpcode::PHI) {
+            break;
+        }
+        const Location &dst = regalloc_.GetLocation(phi);
+        if (dst.kind == Location::Kind::NONE) {
+            continue;
+        }
+        const Inst *input = phi->inputs[pred_idx];
+        const Location &src = regalloc_.GetLocation(input);
+        if (src.kind == Location::Kind::CONST) {
+            const_moves.emplace_back(dst, input);
+        } else if (!(src == dst)) {
+            moves.push_back({dst, src});
+        }
+    }
+
+    auto emit_move = [this](const Location &dst, const Location &src) {
+        Reg tmp = dst.kind == Location::Kind::REG ? dst.reg : Reg::RAX;
+        if (src.kind == Location::Kind::REG) {
+            tmp = src.reg;
+        } else {
+            asm_.Mov(tmp, GetSpillSlot(src.slot));
+        }
+        if (dst.kind == Location::Kind::REG) {
+            if (dst.reg != tmp) {
+                asm_.Mov(dst.reg, tmp);
+            }
+        } else {
+            asm_.Mov(GetSpillSlot(dst.slot), tmp);
+        }
+    };
+
+    // Phis are parallel copies: a move is emitted when its destination is not read by other moves,
+    // cycles are broken with the scratch register
+    while (!moves.empty()) {
+        auto ready = std::find_if(moves.begin(), moves.end(), [&moves](const Move &move) {
+            return std::none_of(moves.begin(), moves.end(),
+                                [&move](const Move &other) { return other.src == move.dst; });
+        });
+        if (ready != moves.end()) {
+            emit_move(ready->dst, ready->src);
+            moves.erase(ready);
+            continue;
+        }
+
+        Location blocked = moves.front().dst;
+        Location scratch {Location::Kind::REG, Reg::R11, 0};
+        emit_move(scratch, blocked);
+        for (Move &move : moves) {
+            if (move.src == blocked) {
+                move.src = scratch;
+            }
+        }
+    }
+
+    for (const auto &[dst, value] : const_moves) {
+        if (dst.kind == Location::Kind::REG) {
+            asm_.Mov(dst.reg, value->imm);
+        } else {
+            asm_.Mov(Reg::RAX, value->imm);
+            asm_.Mov(GetSpillSlot(dst.slot), Reg::RAX);
+        }
+    }
+}
+
+bool CodegenX86_64::IsFusedCompare(const Inst *inst) const
+{
+    // Unordered result of float equality needs two flags, so such compares are materialized
+    if (!IsCompare(inst->opcode) || inst->opcode == IrOpcode::CMPF_EQ || inst->opcode == IrOpcode::CMPF_NE ||
+        use_counts_[inst->id] != 1) {
+        return false;
+    }
+
+    // Compare is emitted right before the branch, values of its inputs must not be overwritten till there
+    const auto &insts = inst->block->insts;
+    auto it = std::find(insts.begin(), insts.end(), inst);
+    for (++it; it != insts.end(); ++it) {
+        if ((*it)->opcode == IrOpcode::BRANCH) {
+            return (*it)->inputs[0] == inst;
+        }
+        if ((*it)->HasResult()) {
+            return false;
+        }
+    }
+    return false;
+}
+
+Assembler::Label CodegenX86_64::CreateGuardStub(const Inst *inst)
+{
+    Assembler::Label label = asm_.CreateLabel();
+    guard_stubs_.push_back({label, 0, inst});
+    return label;
+}
+
+void CodegenX86_64::EmitBinary(const Inst *inst)
+{
+    const Inst *lhs = inst->inputs[0];
+    const Inst *rhs = inst->inputs[1];
+    const Location &location = regalloc_.GetLocation(inst);
+    const Location &rhs_location = regalloc_.GetLocation(rhs);
+
+    // Result is computed in place unless it would overwrite the right operand
+    Reg dst = location.kind == Location::Kind::REG ? location.reg : Reg::RAX;
+    if (rhs_location.kind == Location::Kind::REG && rhs_location.reg == dst) {
+        dst = Reg::RAX;
+    }
+    LoadValue(dst, lhs);
+
+    bool is_imm = IsImm32(rhs) && inst->opcode != IrOpcode::MUL;
+    auto imm = static_cast<int32_t>(rhs->imm);
+    Reg src = Reg::RDX;
+    if (rhs_location.kind == Location::Kind::REG) {
+        src = rhs_location.reg;
+    } else if (!is_imm) {
+        LoadValue(Reg::RDX, rhs);
+    }
+
+    switch (inst->opcode) {
+        case IrOpcode::ADD:
+            is_imm ? asm_.Add(dst, imm) : asm_.Add(dst, src);
+            break;
+        case IrOpcode::SUB:
+            is_imm ? asm_.Sub(dst, imm) : asm_.Sub(dst, src);
+            break;
+        case IrOpcode::AND:
+            is_imm ? asm_.And(dst, imm) : asm_.And(dst, src);
+            break;
+        case IrOpcode::OR:
+            is_imm ? asm_.Or(dst, imm) : asm_.Or(dst, src);
+            break;
+        case IrOpcode::XOR:
+            is_imm ? asm_.Xor(dst, imm) : asm_.Xor(dst, src);
+            break;
+        case IrOpcode::MUL:
+            asm_.Imul(dst, src);
+            break;
+        default:
+            UNREACHABLE();
+    }
+    StoreResult(inst, dst);
+}
+
+void CodegenX86_64::EmitDivision(const Inst *inst)
+{
+    LoadValue(Reg::R11, inst->inputs[1]);
+    LoadValue(Reg::RAX, inst->inputs[0]);
+    asm_.Cqo();
+    asm_.Idiv(Reg::R11);
+    StoreResult(inst, inst->opcode == IrOpcode::DIV ? Reg::RAX : Reg::RDX);
+}
+
+void CodegenX86_64::EmitFloatBinary(const Inst *inst)
+{
+    LoadValue(Reg::RAX, inst->inputs[0]);
+    asm_.Movq(XmmReg::XMM0, Reg::RAX);
+    LoadValue(Reg::RAX, inst->inputs[1]);
+    asm_.Movq(XmmReg::XMM1, Reg::RAX);
+
+    switch (inst->opcode) {
+        case IrOpcode::ADDF:
+            asm_.Addsd(XmmReg::XMM0, XmmReg::XMM1);
+            break;
+        case IrOpcode::SUBF:
+            asm_.Subsd(XmmReg::XMM0, XmmReg::XMM1);
+            break;
+        case IrOpcode::MULF:
+            asm_.Mulsd(XmmReg::XMM0, XmmReg::XMM1);
+            break;
+        case IrOpcode::DIVF:
+            asm_.Divsd(XmmReg::XMM0, XmmReg::XMM1);
+            break;
+        default:
+            UNREACHABLE();
+    }
+    asm_.Movq(Reg::RAX, XmmReg::XMM0);
+    StoreResult(inst, Reg::RAX);
+}
+
+void CodegenX86_64::EmitCompare(const Inst *inst)
+{
+    const Inst *rhs = inst->inputs[1];
+    bool is_float = inst->opcode == IrOpcode::CMPF_LT || inst->opcode == IrOpcode::CMPF_GE ||
+                    inst->opcode == IrOpcode::CMPF_EQ || inst->opcode == IrOpcode::CMPF_NE;
+    bool is_imm = !is_float && IsImm32(rhs);
+
+    LoadValue(Reg::RAX, inst->inputs[0]);
+    if (!is_imm) {
+        LoadValue(Reg::RDX, rhs);
+    }
+
+    if (inst->opcode == IrOpcode::CMPF_EQ || inst->opcode == IrOpcode::CMPF_NE) {
+        bool is_eq = inst->opcode == IrOpcode::CMPF_EQ;
+        asm_.Movq(XmmReg::XMM0, Reg::RAX);
+        asm_.Movq(XmmReg::XMM1, Reg::RDX);
+        asm_.Ucomisd(XmmReg::XMM0, XmmReg::XMM1);
+        // Parity flag is set for unordered operands
+        asm_.Setcc(is_eq ? Cond::E : Cond::NE, Reg::RAX);
+        asm_.Setcc(is_eq ? Cond::NP : Cond::P, Reg::RDX);
+        asm_.Movzxb(Reg::RAX, Reg::RAX);
+        asm_.Movzxb(Reg::RDX, Reg::RDX);
+        is_eq ? asm_.And(Reg::RAX, Reg::RDX) : asm_.Or(Reg::RAX, Reg::RDX);
+        StoreResult(inst, Reg::RAX);
+        return;
+    }
+
+    Cond cond = EmitCompareFlags(&asm_, inst->opcode, is_imm, static_cast<int32_t>(rhs->imm));
+    asm_.Setcc(cond, Reg::RAX);
+    asm_.Movzxb(Reg::RAX, Reg::RAX);
+    StoreResult(inst, Reg::RAX);
+}
+
+void CodegenX86_64::EmitBranch(const Inst *inst, const BasicBlock *next_block)
+{
+    const BasicBlock *block = inst->block;
+    const Inst *cond_value = inst->inputs[0];
+    // Critical edges are split, so successors of branch have no phis
+    assert(block->succs[0]->preds.size() == 1 && block->succs[1]->preds.size() == 1);
+
+    Cond cond = Cond::NE;
+    if (IsFusedCompare(cond_value)) {
+        bool is_imm = cond_value->opcode != IrOpcode::CMPF_LT && cond_value->opcode != IrOpcode::CMPF_GE &&
+                      IsImm32(cond_value->inputs[1]);
+        LoadValue(Reg::RAX, cond_value->inputs[0]);
+        if (!is_imm) {
+            LoadValue(Reg::RDX, cond_value->inputs[1]);
+        }
+        cond = EmitCompareFlags(&asm_, cond_value->opcode, is_imm, static_cast<int32_t>(cond_value->inputs[1]->imm));
+    } else {
+        LoadValue(Reg::RAX, cond_value);
+        asm_.Test(Reg::RAX, Reg::RAX);
+    }
+
+    const BasicBlock *true_succ = block->succs[0];
+    const BasicBlock *false_succ = block->succs[1];
+    if (true_succ == next_block) {
+        asm_.Jcc(InvertCond(cond), block_labels_[false_succ->id]);
+        return;
+    }
+    asm_.Jcc(cond, block_labels_[true_succ->id]);
+    if (false_succ != next_block) {
+        asm_.Jmp(block_labels_[false_succ->id]);
+    }
+}
+
+void CodegenX86_64::EmitStoreAccum(const Inst *inst)
+{
+    const Inst *value = inst->inputs[0];
+    LoadValue(Reg::RDX, value);
+    asm_.Mov(Reg::RAX, Mem(CONTEXT_REG, static_cast<int32_t>(JitContext::GetAccumOffset())));
+    asm_.Mov(Mem(Reg::RAX, 0), Reg::RDX);
+
+    asm_.Mov(Reg::RAX, Mem(CONTEXT_REG, static_cast<int32_t>(JitContext::GetAccumRootOffset())));
+    switch (value->kind) {
+        case ValueKind::REFERENCE:
+            asm_.Movb(Mem(Reg::RAX, 0), static_cast<int8_t>(1));
+            break;
+        case ValueKind::NULLABLE_REFERENCE:
+            asm_.Test(Reg::RDX, Reg::RDX);
+            asm_.Setcc(Cond::NE, Reg::RDX);
+            asm_.Movb(Mem(Reg::RAX, 0), Reg::RDX);
+            break;
+        default:
+            asm_.Movb(Mem(Reg::RAX, 0), static_cast<int8_t>(0));
+            break;
+    }
+}
+
+void CodegenX86_64::EmitInst(const Inst *inst, const BasicBlock *next_block)
+{
+    constexpr auto ARRAY_DATA = static_cast<int32_t>(types::Array::GetDataOffset());
+    constexpr auto FIELDS_DATA = static_cast<int32_t>(types::Class::GetDataOffset());
+
+    switch (inst->opcode) {
+        case IrOpcode::PARAM:
+            asm_.Mov(Reg::RAX, GetFrameReg(static_cast<uint8_t>(inst->imm)));
+            StoreResult(inst, Reg::RAX);
+            break;
+        case IrOpcode::CONST:
+        case IrOpcode::PHI:
+            // Constants are rematerialized at uses, phis are moved to by predecessors
+            break;
+        case IrOpcode::ADD:
+        case IrOpcode::SUB:
+        case IrOpcode::MUL:
+        case IrOpcode::AND:
+        case IrOpcode::OR:
+        case IrOpcode::XOR:
+            EmitBinary(inst);
+            break;
+        case IrOpcode::DIV:
+        case IrOpcode::REM:
+            EmitDivision(inst);
+            break;
+        case IrOpcode::ADDF:
+        case IrOpcode::SUBF:
+        case IrOpcode::MULF:
+        case IrOpcode::DIVF:
+            EmitFloatBinary(inst);
+            break;
+        case IrOpcode::CMP_LT:
+        case IrOpcode::CMP_GE:
+        case IrOpcode::CMP_EQ:
+        case IrOpcode::CMP_NE:
+        case IrOpcode::CMPF_LT:
+        case IrOpcode::CMPF_GE:
+        case IrOpcode::CMPF_EQ:
+        case IrOpcode::CMPF_NE:
+            if (!IsFusedCompare(inst)) {
+                EmitCompare(inst);
+            }
+            break;
+        case IrOpcode::CONVIF:
+            LoadValue(Reg::RAX, inst->inputs[0]);
+            asm_.Cvtsi2sd(XmmReg::XMM0, Reg::RAX);
+            asm_.Movq(Reg::RAX, XmmReg::XMM0);
+            StoreResult(inst, Reg::RAX);
+            break;
+        case IrOpcode::CONVFI:
+            LoadValue(Reg::RAX, inst->inputs[0]);
+            asm_.Movq(XmmReg::XMM0, Reg::RAX);
+            asm_.Cvttsd2si(Reg::RAX, XmmReg::XMM0);
+            StoreResult(inst, Reg::RAX);
+            break;
+        case IrOpcode::UNROOT:
+            LoadValue(Reg::RAX, inst->inputs[0]);
+            StoreResult(inst, Reg::RAX);
+            break;
+        case IrOpcode::LOAD_ACCUM:
+            asm_.Mov(Reg::RAX, Mem(CONTEXT_REG, static_cast<int32_t>(JitContext::GetAccumOffset())));
+            asm_.Mov(Reg::RAX, Mem(Reg::RAX, 0));
+            StoreResult(inst, Reg::RAX);
+            break;
+        case IrOpcode::STORE_ACCUM:
+            EmitStoreAccum(inst);
+            break;
+        case IrOpcode::CHECK_ACCUM_ROOT:
+            asm_.Mov(Reg::RAX, Mem(CONTEXT_REG, static_cast<int32_t>(JitContext::GetAccumRootOffset())));
+            asm_.Cmpb(Mem(Reg::RAX, 0), static_cast<int8_t>(inst->imm));
+            asm_.Jcc(Cond::NE, CreateGuardStub(inst));
+            break;
+        case IrOpcode::NEW_ARRAY:
+            EmitHelperCall(reinterpret_cast<const void *>(&JitNewArray), {{nullptr, inst->imm}, {inst->inputs[0], 0}},
+                           inst);
+            break;
+        case IrOpcode::NEW_OBJECT:
+            EmitHelperCall(reinterpret_cast<const void *>(&JitNewObject),
+                           {{nullptr, reinterpret_cast<int64_t>(inst->aux)},
+                            {nullptr, reinterpret_cast<int64_t>(inst->aux_class)}},
+                           inst);
+            break;
+        case IrOpcode::ARR_LEN:
+            LoadValue(Reg::RAX, inst->inputs[0]);
+            asm_.Mov(Reg::RAX, Mem(Reg::RAX, static_cast<int32_t>(types::Array::GetLengthOffset())));
+            StoreResult(inst, Reg::RAX);
+            break;
+        case IrOpcode::CHECK_ARRAY: {
+            Assembler::Label stub = CreateGuardStub(inst);
+            LoadValue(Reg::RAX, inst->inputs[0]);
+            asm_.Test(Reg::RAX, Reg::RAX);
+            asm_.Jcc(Cond::E, stub);
+            asm_.Mov(Reg::R11, Mem(Reg::RAX, static_cast<int32_t>(ObjectHeader::GetClassWordOffset())));
+            asm_.Cmpb(Mem(Reg::R11, static_cast<int32_t>(ClassDescription::GetArrayElementKindOffset())),
+                      static_cast<int8_t>(inst->imm));
+            asm_.Jcc(Cond::NE, stub);
+            break;
+        }
+        case IrOpcode::BOUNDS_CHECK:
+            // Unsigned compare also catches negative index
+            LoadValue(Reg::RAX, inst->inputs[0]);
+            LoadValue(Reg::RDX, inst->inputs[1]);
+            asm_.Cmp(Reg::RAX, Reg::RDX);
+            asm_.Jcc(Cond::AE, CreateGuardStub(inst));
+            break;
+        case IrOpcode::LOAD_ELEM:
+            LoadValue(Reg::RAX, inst->inputs[0]);
+            LoadValue(Reg::RDX, inst->inputs[1]);
+            asm_.Mov(Reg::RAX, Mem(Reg::RAX, Reg::RDX, ELEMENT_SIZE_LOG2, ARRAY_DATA));
+            StoreResult(inst, Reg::RAX);
+            break;
+        case IrOpcode::STORE_ELEM:
+            LoadValue(Reg::RAX, inst->inputs[0]);
+            LoadValue(Reg::RDX, inst->inputs[1]);
+            LoadValue(Reg::R11, inst->inputs[2]);
+            asm_.Mov(Mem(Reg::RAX, Reg::RDX, ELEMENT_SIZE_LOG2, ARRAY_DATA), Reg::R11);
+            break;
+        case IrOpcode::STORE_REF_ELEM:
+            EmitHelperCall(reinterpret_cast<const void *>(&JitStoreReference),
+                           {{inst->inputs[0], 0}, {inst->inputs[1], 0}, {inst->inputs[2], 0}}, nullptr);
+            break;
+        case IrOpcode::GET_FIELD:
+            LoadValue(Reg::RAX, inst->inputs[0]);
+            asm_.Mov(Reg::RAX, Mem(Reg::RAX, FIELDS_DATA + static_cast<int32_t>(inst->imm) * 8));
+            StoreResult(inst, Reg::RAX);
+            break;
+        case IrOpcode::SET_FIELD:
+            LoadValue(Reg::RAX, inst->inputs[0]);
+            LoadValue(Reg::RDX, inst->inputs[1]);
+            asm_.Mov(Mem(Reg::RAX, FIELDS_DATA + static_cast<int32_t>(inst->imm) * 8), Reg::RDX);
+            break;
+        case IrOpcode::SET_REF_FIELD:
+            EmitHelperCall(reinterpret_cast<const void *>(&JitSetReferenceField),
+                           {{inst->inputs[0], 0}, {nullptr, inst->imm}, {inst->inputs[1], 0}}, nullptr);
+            break;
+        case IrOpcode::PRINTI:
+            EmitHelperCall(reinterpret_cast<const void *>(&JitPrintInt), {{inst->inputs[0], 0}}, nullptr);
+            break;
+        case IrOpcode::PRINTF:
+            EmitHelperCall(reinterpret_cast<const void *>(&JitPrintDouble), {{inst->inputs[0], 0}}, nullptr);
+            break;
+        case IrOpcode::SAFEPOINT: {
+            Stub stub {asm_.CreateLabel(), asm_.CreateLabel(), inst};
+            asm_.Sub(Mem(CONTEXT_REG, static_cast<int32_t>(JitContext::GetGcCountdownOffset())),
+                     static_cast<int32_t>(inst->imm));
+            asm_.Jcc(Cond::LE, stub.label);
+            asm_.Bind(stub.return_label);
+            safepoint_stubs_.push_back(stub);
+            break;
+        }
+        case IrOpcode::JUMP: {
+            const BasicBlock *succ = inst->block->succs[0];
+            EmitPhiMoves(inst->block, succ);
+            if (succ != next_block) {
+                asm_.Jmp(block_labels_[succ->id]);
+            }
+            break;
+        }
+        case IrOpcode::BRANCH:
+            EmitBranch(inst, next_block);
+            break;
+        case IrOpcode::EXIT:
+            EmitWriteBack(*inst->state);
+            asm_.Mov(Reg::RAX, static_cast<int64_t>(inst->state->pc));
+            asm_.Jmp(epilogue_);
+            break;
+        default:
+            UNREACHABLE();
+    }
+}
+
+} // namespace evm::runtime::jit
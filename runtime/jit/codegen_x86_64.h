@@ -0,0 +1,97 @@
+#ifndef EVM_RUNTIME_JIT_CODEGEN_X86_64_H
+#define EVM_RUNTIME_JIT_CODEGEN_X86_64_H
+
+#include "common/macros.h"
+#include "runtime/jit/assembler_x86_64.h"
+#include "runtime/jit/ir.h"
+#include "runtime/jit/register_allocator.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace evm::runtime::jit {
+
+/// Emits machine code for allocated graph. Each entry block gets its own prologue, the code is called as
+///     size_t entry(JitContext *ctx, Frame *frame)
+/// and returns pc from which interpreter continues. Context and frame are kept in rbx and rbp.
+class CodegenX86_64 {
+public:
+    NO_COPY_SEMANTIC(CodegenX86_64);
+    NO_MOVE_SEMANTIC(CodegenX86_64);
+
+    CodegenX86_64(const Graph &graph, const RegisterAllocator &regalloc) : graph_(graph), regalloc_(regalloc) {}
+    ~CodegenX86_64() = default;
+
+    bool Run();
+
+    const std::vector<uint8_t> &GetCode() const
+    {
+        return asm_.GetCode();
+    }
+
+    size_t GetEntryOffset(const BasicBlock *entry) const
+    {
+        return entry_offsets_.at(entry);
+    }
+
+private:
+    // Caller-saved allocatable registers are stored there around calls of runtime helpers
+    static constexpr int32_t SAVE_AREA_SIZE = RegisterAllocator::CALLER_SAVED_REGS.size() * 8;
+
+    struct HelperArg {
+        const Inst *value {nullptr}; // immediate is passed if value is null
+        int64_t imm {0};
+    };
+
+    struct Stub {
+        Assembler::Label label;
+        Assembler::Label return_label; // only for safepoints
+        const Inst *inst;
+    };
+
+    Mem GetSpillSlot(uint32_t slot) const
+    {
+        return Mem(Reg::RSP, SAVE_AREA_SIZE + static_cast<int32_t>(slot) * 8);
+    }
+    static Mem GetFrameReg(uint8_t reg);
+    static Mem GetFrameRootWord(uint8_t reg);
+
+    void LoadValue(Reg dst, const Inst *value);
+    void StoreResult(const Inst *inst, Reg src);
+    bool IsImm32(const Inst *value) const;
+
+    void EmitPrologue();
+    void EmitEpilogue();
+    void EmitWriteBack(const FrameState &state);
+    void EmitHelperCall(const void *helper, const std::vector<HelperArg> &args, const Inst *result);
+    void EmitPhiMoves(const BasicBlock *from, const BasicBlock *to);
+
+    void EmitInst(const Inst *inst, const BasicBlock *next_block);
+    void EmitBinary(const Inst *inst);
+    void EmitDivision(const Inst *inst);
+    void EmitFloatBinary(const Inst *inst);
+    void EmitCompare(const Inst *inst);
+    void EmitBranch(const Inst *inst, const BasicBlock *next_block);
+    void EmitStoreAccum(const Inst *inst);
+    Assembler::Label CreateGuardStub(const Inst *inst);
+    bool IsFusedCompare(const Inst *inst) const;
+
+private:
+    const Graph &graph_;
+    const RegisterAllocator &regalloc_;
+    Assembler asm_;
+
+    int32_t frame_size_ {0};
+    std::vector<Assembler::Label> block_labels_; // by block id
+    Assembler::Label epilogue_ {0};
+    std::vector<Stub> guard_stubs_;
+    std::vector<Stub> safepoint_stubs_;
+    std::vector<uint32_t> use_counts_; // by instruction id
+    std::unordered_map<const BasicBlock *, size_t> entry_offsets_;
+};
+
+} // namespace evm::runtime::jit
+
+#endif // EVM_RUNTIME_JIT_CODEGEN_X86_64_H
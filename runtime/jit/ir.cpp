@@ -0,0 +1,373 @@
+#include "runtime/jit/ir.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace evm::runtime::jit {
+
+const char *GetIrOpcodeName(IrOpcode opcode)
+{
+    switch (opcode) {
+#define IR_OPCODE_CASE(name) \
+    case IrOpcode::name:     \
+        return #name;
+        IR_OPCODE_LIST(IR_OPCODE_CASE)
+#undef IR_OPCODE_CASE
+    }
+
+    UNREACHABLE();
+    return "";
+}
+
+ValueKind MergeValueKinds(ValueKind lhs, ValueKind rhs)
+{
+    if (lhs == ValueKind::UNKNOWN || lhs == rhs) {
+        return rhs;
+    }
+    if (rhs == ValueKind::UNKNOWN) {
+        return lhs;
+    }
+    if (lhs == ValueKind::PRIMITIVE || rhs == ValueKind::PRIMITIVE || lhs == ValueKind::CONFLICT ||
+        rhs == ValueKind::CONFLICT) {
+        return ValueKind::CONFLICT;
+    }
+
+    // Non-null and nullable references
+    return ValueKind::NULLABLE_REFERENCE;
+}
+
+bool Inst::HasResult() const
+{
+    switch (opcode) {
+        case IrOpcode::STORE_ACCUM:
+        case IrOpcode::CHECK_ACCUM_ROOT:
+        case IrOpcode::CHECK_ARRAY:
+        case IrOpcode::BOUNDS_CHECK:
+        case IrOpcode::STORE_ELEM:
+        case IrOpcode::STORE_REF_ELEM:
+        case IrOpcode::SET_FIELD:
+        case IrOpcode::SET_REF_FIELD:
+        case IrOpcode::PRINTI:
+        case IrOpcode::PRINTF:
+        case IrOpcode::SAFEPOINT:
+        case IrOpcode::JUMP:
+        case IrOpcode::BRANCH:
+        case IrOpcode::EXIT:
+            return false;
+        default:
+            return true;
+    }
+}
+
+bool Inst::IsTerminator() const
+{
+    return opcode == IrOpcode::JUMP || opcode == IrOpcode::BRANCH || opcode == IrOpcode::EXIT;
+}
+
+bool Inst::IsGuard() const
+{
+    return opcode == IrOpcode::CHECK_ACCUM_ROOT || opcode == IrOpcode::CHECK_ARRAY ||
+           opcode == IrOpcode::BOUNDS_CHECK;
+}
+
+bool Inst::IsCall() const
+{
+    switch (opcode) {
+        case IrOpcode::NEW_ARRAY:
+        case IrOpcode::NEW_OBJECT:
+        case IrOpcode::STORE_REF_ELEM:
+        case IrOpcode::SET_REF_FIELD:
+        case IrOpcode::PRINTI:
+        case IrOpcode::PRINTF:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool Inst::IsPure() const
+{
+    switch (opcode) {
+        case IrOpcode::PARAM:
+        case IrOpcode::CONST:
+        case IrOpcode::PHI:
+        case IrOpcode::ADD:
+        case IrOpcode::SUB:
+        case IrOpcode::MUL:
+        case IrOpcode::AND:
+        case IrOpcode::OR:
+        case IrOpcode::XOR:
+        case IrOpcode::ADDF:
+        case IrOpcode::SUBF:
+        case IrOpcode::MULF:
+        case IrOpcode::DIVF:
+        case IrOpcode::CMP_LT:
+        case IrOpcode::CMP_GE:
+        case IrOpcode::CMP_EQ:
+        case IrOpcode::CMP_NE:
+        case IrOpcode::CMPF_LT:
+        case IrOpcode::CMPF_GE:
+        case IrOpcode::CMPF_EQ:
+        case IrOpcode::CMPF_NE:
+        case IrOpcode::CONVIF:
+        case IrOpcode::CONVFI:
+        case IrOpcode::UNROOT:
+            return true;
+        default:
+            return false;
+    }
+}
+
+size_t BasicBlock::GetPredIndex(const BasicBlock *pred) const
+{
+    auto it = std::find(preds.begin(), preds.end(), pred);
+    assert(it != preds.end());
+    return static_cast<size_t>(it - preds.begin());
+}
+
+void BasicBlock::InsertBeforeTerminator(Inst *inst)
+{
+    inst->block = this;
+    if (GetTerminator() != nullptr) {
+        insts.insert(insts.end() - 1, inst);
+    } else {
+        insts.push_back(inst);
+    }
+}
+
+BasicBlock *Graph::CreateBlock(size_t pc)
+{
+    blocks_.push_back(std::make_unique<BasicBlock>(static_cast<uint32_t>(blocks_.size())));
+    blocks_.back()->pc = pc;
+    return blocks_.back().get();
+}
+
+Inst *Graph::CreateInst(IrOpcode opcode)
+{
+    insts_.push_back(std::make_unique<Inst>(opcode, static_cast<uint32_t>(insts_.size())));
+    return insts_.back().get();
+}
+
+void Graph::AddEdge(BasicBlock *from, BasicBlock *to)
+{
+    from->succs.push_back(to);
+    to->preds.push_back(from);
+}
+
+BasicBlock *Graph::SplitEdge(BasicBlock *from, BasicBlock *to)
+{
+    BasicBlock *middle = CreateBlock(to->pc);
+
+    *std::find(from->succs.begin(), from->succs.end(), to) = middle;
+    *std::find(to->preds.begin(), to->preds.end(), from) = middle;
+    middle->preds.push_back(from);
+    middle->succs.push_back(to);
+
+    Inst *jump = CreateInst(IrOpcode::JUMP);
+    jump->block = middle;
+    middle->insts.push_back(jump);
+
+    return middle;
+}
+
+void Graph::ComputeRpo()
+{
+    std::vector<bool> visited(blocks_.size(), false);
+    std::vector<BasicBlock *> post_order;
+
+    // Iterative DFS: block and index of the next successor to visit
+    std::vector<std::pair<BasicBlock *, size_t>> stack;
+    for (BasicBlock *entry : entries_) {
+        if (visited[entry->id]) {
+            continue;
+        }
+        visited[entry->id] = true;
+        stack.emplace_back(entry, 0);
+
+        while (!stack.empty()) {
+            auto &[block, next_succ] = stack.back();
+            if (next_succ < block->succs.size()) {
+                BasicBlock *succ = block->succs[next_succ++];
+                if (!visited[succ->id]) {
+                    visited[succ->id] = true;
+                    stack.emplace_back(succ, 0);
+                }
+                continue;
+            }
+            post_order.push_back(block);
+            stack.pop_back();
+        }
+    }
+
+    rpo_.assign(post_order.rbegin(), post_order.rend());
+    for (size_t i = 0; i < rpo_.size(); ++i) {
+        rpo_[i]->rpo = static_cast<uint32_t>(i);
+    }
+}
+
+// Cooper, Harvey, Kennedy "A Simple, Fast Dominance Algorithm"
+void Graph::ComputeDominators()
+{
+    ComputeRpo();
+
+    std::vector<bool> processed(blocks_.size(), false);
+    for (BasicBlock *block : rpo_) {
+        block->idom = nullptr;
+    }
+    for (BasicBlock *entry : entries_) {
+        processed[entry->id] = true;
+    }
+
+    // Null is the virtual root which dominates everything
+    auto intersect = [](BasicBlock *lhs, BasicBlock *rhs) {
+        while (lhs != rhs) {
+            if (lhs == nullptr || rhs == nullptr) {
+                return static_cast<BasicBlock *>(nullptr);
+            }
+            if (lhs->rpo > rhs->rpo) {
+                lhs = lhs->idom;
+            } else {
+                rhs = rhs->idom;
+            }
+        }
+        return lhs;
+    };
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (BasicBlock *block : rpo_) {
+            if (block->is_entry) {
+                continue;
+            }
+
+            BasicBlock *new_idom = nullptr;
+            bool found = false;
+            for (BasicBlock *pred : block->preds) {
+                if (!processed[pred->id]) {
+                    continue;
+                }
+                new_idom = found ? intersect(pred, new_idom) : pred;
+                found = true;
+            }
+
+            if (!processed[block->id] || block->idom != new_idom) {
+                block->idom = new_idom;
+                processed[block->id] = true;
+                changed = true;
+            }
+        }
+    }
+}
+
+bool Graph::Dominates(const BasicBlock *dominator, const BasicBlock *block) const
+{
+    for (const BasicBlock *it = block; it != nullptr; it = it->idom) {
+        if (it == dominator) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Graph::ApplyReplacements()
+{
+    auto resolve = [](Inst *inst) {
+        while (inst->replacement != nullptr) {
+            inst = inst->replacement;
+        }
+        return inst;
+    };
+    // Frame already has the value which was loaded from it
+    auto is_frame_value = [](const std::pair<uint8_t, Inst *> &reg_value) {
+        return reg_value.second->opcode == IrOpcode::PARAM && reg_value.second->imm == reg_value.first;
+    };
+
+    for (const auto &block : blocks_) {
+        auto &insts = block->insts;
+        insts.erase(std::remove_if(insts.begin(), insts.end(),
+                                   [](const Inst *inst) { return inst->replacement != nullptr; }),
+                    insts.end());
+
+        for (Inst *inst : insts) {
+            for (Inst *&input : inst->inputs) {
+                input = resolve(input);
+            }
+            if (inst->state != nullptr) {
+                auto &regs = inst->state->regs;
+                for (auto &reg_value : regs) {
+                    reg_value.second = resolve(reg_value.second);
+                }
+                regs.erase(std::remove_if(regs.begin(), regs.end(), is_frame_value), regs.end());
+            }
+        }
+        for (auto &reg_value : block->entry_regs) {
+            reg_value.second = resolve(reg_value.second);
+        }
+    }
+}
+
+namespace {
+
+void DumpValue(std::ostream &out, const Inst *inst)
+{
+    if (inst->opcode == IrOpcode::CONST) {
+        out << inst->imm;
+    } else {
+        out << "v" << inst->id;
+    }
+}
+
+} // namespace
+
+void Graph::Dump(std::ostream &out) const
+{
+    for (const auto &block : blocks_) {
+        if (block->insts.empty()) {
+            continue;
+        }
+
+        out << "B" << block->id;
+        if (block->pc != BasicBlock::NO_PC) {
+            out << " (pc " << block->pc << ")";
+        }
+        if (block->is_entry) {
+            out << " entry";
+        }
+        out << " preds:";
+        for (const BasicBlock *pred : block->preds) {
+            out << " B" << pred->id;
+        }
+        out << " succs:";
+        for (const BasicBlock *succ : block->succs) {
+            out << " B" << succ->id;
+        }
+        out << "\n";
+
+        for (const Inst *inst : block->insts) {
+            out << "    ";
+            if (inst->HasResult()) {
+                out << "v" << inst->id << " = ";
+            }
+            out << GetIrOpcodeName(inst->opcode);
+            if (inst->opcode == IrOpcode::PARAM || inst->opcode == IrOpcode::CONST || inst->imm != 0) {
+                out << " #" << inst->imm;
+            }
+            for (const Inst *input : inst->inputs) {
+                out << " ";
+                DumpValue(out, input);
+            }
+            if (inst->state != nullptr) {
+                out << " [pc " << inst->state->pc << ":";
+                for (const auto &[reg, value] : inst->state->regs) {
+                    out << " x" << static_cast<int>(reg) << "=";
+                    DumpValue(out, value);
+                }
+                out << "]";
+            }
+            out << "\n";
+        }
+    }
+}
+
+} // namespace evm::runtime::jit
@@ -0,0 +1,194 @@
+#ifndef EVM_RUNTIME_JIT_IR_H
+#define EVM_RUNTIME_JIT_IR_H
+
+#include "common/macros.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+namespace evm::runtime::jit {
+
+// clang-format off
+#define IR_OPCODE_LIST(V)                                                                  \
+    V(PARAM)            /* register of the frame at entry, imm = register */               \
+    V(CONST)            /* imm = value */                                                  \
+    V(PHI)                                                                                 \
+    V(ADD) V(SUB) V(MUL) V(DIV) V(REM) V(AND) V(OR) V(XOR)                                 \
+    V(ADDF) V(SUBF) V(MULF) V(DIVF)                                                        \
+    V(CMP_LT) V(CMP_GE) V(CMP_EQ) V(CMP_NE)                                                \
+    V(CMPF_LT) V(CMPF_GE) V(CMPF_EQ) V(CMPF_NE)                                            \
+    V(CONVIF) V(CONVFI)                                                                    \
+    V(UNROOT)           /* same value which is not a GC root anymore */                    \
+    V(LOAD_ACCUM)                                                                          \
+    V(STORE_ACCUM)                                                                         \
+    V(CHECK_ACCUM_ROOT) /* guard: root flag of accumulator is imm */                       \
+    V(NEW_ARRAY)        /* imm = element type, input = size */                             \
+    V(NEW_OBJECT)       /* aux = class description, aux_class = class of file */           \
+    V(ARR_LEN)                                                                             \
+    V(CHECK_ARRAY)      /* guard: array is not null and its element kind is imm */         \
+    V(BOUNDS_CHECK)     /* guard: index < length */                                        \
+    V(LOAD_ELEM)                                                                           \
+    V(STORE_ELEM)                                                                          \
+    V(STORE_REF_ELEM)   /* store to reference array with write barrier */                  \
+    V(GET_FIELD)        /* imm = field index */                                            \
+    V(SET_FIELD)                                                                           \
+    V(SET_REF_FIELD)    /* set of reference field with write barrier */                    \
+    V(PRINTI) V(PRINTF)                                                                    \
+    V(SAFEPOINT)        /* imm = number of instructions since the previous one */          \
+    V(JUMP)                                                                                \
+    V(BRANCH)           /* successor 0 if input is not zero, successor 1 otherwise */      \
+    V(EXIT)             /* continue in interpreter from pc of frame state */
+// clang-format on
+
+enum class IrOpcode : uint8_t {
+#define DEFINE_IR_OPCODE(name) name,
+    IR_OPCODE_LIST(DEFINE_IR_OPCODE)
+#undef DEFINE_IR_OPCODE
+};
+
+const char *GetIrOpcodeName(IrOpcode opcode);
+
+// clang-format off
+/// How root bit of a frame register holding the value is derived: it's the only type information
+/// compiled code needs, all values are 64-bit raw register values
+enum class ValueKind : uint8_t {
+    UNKNOWN,            // not inferred yet
+    PRIMITIVE,          // root bit is cleared
+    REFERENCE,          // root bit is set, value is never null
+    NULLABLE_REFERENCE, // root bit is set if value is not null
+    CONFLICT,           // different on different paths, value can't be written back to frame
+};
+// clang-format on
+
+ValueKind MergeValueKinds(ValueKind lhs, ValueKind rhs);
+
+struct BasicBlock;
+struct Inst;
+
+using RegValues = std::vector<std::pair<uint8_t, Inst *>>;
+
+/// Frame registers at pc: guards and exits write them back to the frame before continuing in interpreter
+struct FrameState {
+    size_t pc {0};
+    RegValues regs;
+};
+
+struct Inst {
+    Inst(IrOpcode inst_opcode, uint32_t inst_id) : opcode(inst_opcode), id(inst_id) {}
+
+    bool HasResult() const;
+    bool IsTerminator() const;
+    bool IsGuard() const;
+    bool IsCall() const;
+    // Without side effects and can't fault, so it can be moved or removed
+    bool IsPure() const;
+
+    IrOpcode opcode;
+    uint32_t id;
+    BasicBlock *block {nullptr};
+    std::vector<Inst *> inputs;
+    int64_t imm {0};
+    ValueKind kind {ValueKind::UNKNOWN};
+    std::unique_ptr<FrameState> state;
+    const void *aux {nullptr};
+    const void *aux_class {nullptr};
+    size_t pc {0}; // of bytecode instruction
+
+    Inst *replacement {nullptr}; // set when the instruction is redundant, see Graph::ApplyReplacements()
+};
+
+struct BasicBlock {
+    static constexpr size_t NO_PC = static_cast<size_t>(-1);
+
+    explicit BasicBlock(uint32_t block_id) : id(block_id) {}
+
+    Inst *GetTerminator() const
+    {
+        return insts.empty() || !insts.back()->IsTerminator() ? nullptr : insts.back();
+    }
+
+    size_t GetPredIndex(const BasicBlock *pred) const;
+    void InsertBeforeTerminator(Inst *inst);
+
+    uint32_t id;
+    size_t pc {NO_PC}; // of the first bytecode instruction
+    bool is_entry {false};
+    std::vector<Inst *> insts; // phis go first
+    std::vector<BasicBlock *> preds;
+    std::vector<BasicBlock *> succs;
+
+    // Loop headers keep values of live registers at the block start: frame state of hoisted guards
+    RegValues entry_regs;
+
+    // Analyses
+    uint32_t rpo {0};
+    BasicBlock *idom {nullptr};
+};
+
+/// SSA graph of compiled region: several entries (function entry, return points from calls and loop headers)
+/// load registers from the frame, exits store them back
+class Graph {
+public:
+    NO_COPY_SEMANTIC(Graph);
+    NO_MOVE_SEMANTIC(Graph);
+
+    Graph() = default;
+    ~Graph() = default;
+
+    BasicBlock *CreateBlock(size_t pc = BasicBlock::NO_PC);
+    Inst *CreateInst(IrOpcode opcode);
+
+    void AddEdge(BasicBlock *from, BasicBlock *to);
+    // Block between from and to, phis of to keep the order of inputs
+    BasicBlock *SplitEdge(BasicBlock *from, BasicBlock *to);
+
+    void AddEntry(BasicBlock *entry)
+    {
+        entries_.push_back(entry);
+    }
+
+    const std::vector<BasicBlock *> &GetEntries() const
+    {
+        return entries_;
+    }
+
+    const std::vector<std::unique_ptr<BasicBlock>> &GetBlocks() const
+    {
+        return blocks_;
+    }
+
+    size_t GetNumInsts() const
+    {
+        return insts_.size();
+    }
+
+    /// Reverse post order from all entries, unreachable blocks are not included
+    void ComputeRpo();
+    const std::vector<BasicBlock *> &GetRpo() const
+    {
+        return rpo_;
+    }
+
+    /// Entries are dominated only by virtual root, their idom is null
+    void ComputeDominators();
+    bool Dominates(const BasicBlock *dominator, const BasicBlock *block) const;
+
+    /// Removes instructions with replacement and redirects their uses, including frame states
+    void ApplyReplacements();
+
+    void Dump(std::ostream &out) const;
+
+private:
+    std::vector<std::unique_ptr<BasicBlock>> blocks_;
+    std::vector<std::unique_ptr<Inst>> insts_;
+    std::vector<BasicBlock *> entries_;
+    std::vector<BasicBlock *> rpo_;
+};
+
+} // namespace evm::runtime::jit
+
+#endif // EVM_RUNTIME_JIT_IR_H
@@ -0,0 +1,1007 @@
+#include "runtime/jit/ir_builder.h"
+#include "file_format/file.h"
+#include "runtime/memory/object_header.h"
+#include "runtime/memory/type.h"
+#include "runtime/runtime.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <queue>
+
+namespace evm::runtime::jit {
+
+/* static */
+bool IrBuilder::IsCompiled(Opcode opcode)
+{
+    switch (opcode) {
+        case Opcode::ADD:
+        case Opcode::SUB:
+        case Opcode::MUL:
+        case Opcode::DIV:
+        case Opcode::REM:
+        case Opcode::ADDF:
+        case Opcode::SUBF:
+        case Opcode::MULF:
+        case Opcode::DIVF:
+        case Opcode::AND:
+        case Opcode::OR:
+        case Opcode::XOR:
+        case Opcode::MOV:
+        case Opcode::MOVIF:
+        case Opcode::SLTI:
+        case Opcode::SMEI:
+        case Opcode::SLTF:
+        case Opcode::SMEF:
+        case Opcode::EQI:
+        case Opcode::NEQI:
+        case Opcode::EQF:
+        case Opcode::NEQF:
+        case Opcode::CONVIF:
+        case Opcode::CONVFI:
+        case Opcode::PRINTI:
+        case Opcode::PRINTF:
+        case Opcode::JMP_IMM:
+        case Opcode::JMP_IF_IMM:
+        case Opcode::ACCR:
+        case Opcode::RACC:
+        case Opcode::NEWARR_IMM:
+        case Opcode::NEWARR:
+        case Opcode::ARR_SIZE:
+        case Opcode::LARR:
+        case Opcode::STARR:
+        case Opcode::NEWOBJ:
+        case Opcode::OBJ_GET_FIELD:
+        case Opcode::OBJ_SET_FIELD:
+            return true;
+        default:
+            return false;
+    }
+}
+
+hword_t IrBuilder::GetHword(size_t pc) const
+{
+    hword_t value = 0;
+    std::memcpy(&value, bytecode_ + pc + 2, sizeof(value));
+    return value;
+}
+
+int32_t IrBuilder::GetImm32(size_t pc) const
+{
+    int32_t imm = 0;
+    std::memcpy(&imm, bytecode_ + pc + ISA_INSTR_SIZE, sizeof(imm));
+    return imm;
+}
+
+int64_t IrBuilder::GetImm64(size_t pc) const
+{
+    int64_t imm = 0;
+    std::memcpy(&imm, bytecode_ + pc + ISA_INSTR_SIZE, sizeof(imm));
+    return imm;
+}
+
+const BytecodeInstr *IrBuilder::GetInstr(size_t pc) const
+{
+    auto it = instrs_.find(pc);
+    return it == instrs_.end() ? nullptr : &it->second;
+}
+
+void IrBuilder::GetSuccessors(size_t pc, std::vector<size_t> *succs) const
+{
+    const BytecodeInstr *instr = GetInstr(pc);
+    assert(instr != nullptr);
+
+    switch (instr->opcode) {
+        case Opcode::EXIT:
+        case Opcode::RET:
+        case Opcode::JMP:
+        case Opcode::JMP_REL:
+            return;
+        case Opcode::JMP_IMM:
+            succs->push_back(pc + GetImm32(pc));
+            return;
+        case Opcode::JMP_IF_IMM:
+            succs->push_back(pc + GetImm32(pc));
+            succs->push_back(pc + instr->size);
+            return;
+        case Opcode::CALL:
+            // Callee returns to pc + 8, which is the next instruction only if arguments are encoded
+            if (instr->size == 0x8) {
+                succs->push_back(pc + instr->size);
+            }
+            return;
+        default:
+            succs->push_back(pc + instr->size);
+            return;
+    }
+}
+
+IrBuilder::InstrRegs IrBuilder::GetInstrRegs(size_t pc) const
+{
+    const BytecodeInstr *instr = GetInstr(pc);
+    assert(instr != nullptr);
+
+    InstrRegs regs;
+    uint8_t rd = GetByte(pc, 1);
+    uint8_t rs1 = GetByte(pc, 2);
+    uint8_t rs2 = GetByte(pc, 3);
+
+    switch (instr->opcode) {
+        case Opcode::ADD:
+        case Opcode::SUB:
+        case Opcode::MUL:
+        case Opcode::DIV:
+        case Opcode::REM:
+        case Opcode::ADDF:
+        case Opcode::SUBF:
+        case Opcode::MULF:
+        case Opcode::DIVF:
+        case Opcode::AND:
+        case Opcode::OR:
+        case Opcode::XOR:
+        case Opcode::SLTI:
+        case Opcode::SMEI:
+        case Opcode::SLTF:
+        case Opcode::SMEF:
+        case Opcode::EQI:
+        case Opcode::NEQI:
+        case Opcode::EQF:
+        case Opcode::NEQF:
+        case Opcode::POWER:
+        case Opcode::STRCONCAT:
+        case Opcode::STRCMP:
+        case Opcode::LARR:
+        case Opcode::ARR_INDEX_OF:
+            regs.uses.set(rs1);
+            regs.uses.set(rs2);
+            regs.def = rd;
+            break;
+        case Opcode::MOV:
+        case Opcode::CONVIF:
+        case Opcode::CONVFI:
+        case Opcode::SIN:
+        case Opcode::COS:
+        case Opcode::ARR_SIZE:
+        case Opcode::CPOBJ:
+        case Opcode::CPOBJ_DEEP:
+        case Opcode::ARR_SUM:
+        case Opcode::ARR_MIN:
+        case Opcode::ARR_MAX:
+            regs.uses.set(rs1);
+            regs.def = rd;
+            break;
+        case Opcode::MOVIF:
+        case Opcode::SCANI:
+        case Opcode::SCANF:
+        case Opcode::ACCR:
+        case Opcode::NEWARR_IMM:
+        case Opcode::STR_IMMUT:
+        case Opcode::NEWSTR:
+        case Opcode::NEWOBJ:
+            regs.def = rd;
+            break;
+        case Opcode::NEWARR:
+            regs.uses.set(ISA_GET_ARRAY_SIZE_RS(bytecode_ + pc));
+            regs.def = rd;
+            break;
+        case Opcode::PRINTI:
+        case Opcode::PRINTF:
+        case Opcode::PRINT_STR:
+        case Opcode::PRINT_STR_IMMUT:
+        case Opcode::RACC:
+        case Opcode::JMP_IF_IMM:
+            regs.uses.set(rs1);
+            break;
+        case Opcode::STARR:
+        case Opcode::ARR_ADD:
+        case Opcode::ARR_MUL:
+            regs.uses.set(rs1);
+            regs.uses.set(rs2);
+            regs.uses.set(rd);
+            break;
+        case Opcode::ARR_FILL:
+            regs.uses.set(rs1);
+            regs.uses.set(rs2);
+            break;
+        case Opcode::ARR_COPY:
+            regs.uses.set(rs1);
+            regs.uses.set(rs2);
+            regs.uses.set(ISA_CALL_GET_REG1(bytecode_ + pc));
+            regs.uses.set(ISA_CALL_GET_REG2(bytecode_ + pc));
+            regs.uses.set(ISA_CALL_GET_REG3(bytecode_ + pc));
+            break;
+        case Opcode::OBJ_GET_FIELD:
+            regs.uses.set(ISA_GET_OBJ_RS(bytecode_ + pc));
+            regs.def = rd;
+            break;
+        case Opcode::OBJ_SET_FIELD:
+            // Value register loses its root bit
+            regs.uses.set(ISA_GET_OBJ_RS(bytecode_ + pc));
+            regs.uses.set(rd);
+            regs.def = rd;
+            break;
+        case Opcode::JMP_IMM:
+        case Opcode::RET:
+            break;
+        case Opcode::EXIT:
+            // Registers of the main frame stay observable after the program ends
+            regs.all_live = true;
+            break;
+        case Opcode::CALL:
+            regs.uses.set(rs1);
+            if (instr->size == 0x8) {
+                regs.uses.set(ISA_CALL_GET_REG1(bytecode_ + pc));
+                regs.uses.set(ISA_CALL_GET_REG2(bytecode_ + pc));
+                regs.uses.set(ISA_CALL_GET_REG3(bytecode_ + pc));
+                regs.uses.set(ISA_CALL_GET_REG4(bytecode_ + pc));
+            } else {
+                regs.all_live = true;
+            }
+            break;
+        default:
+            // Dynamic jumps and unknown instructions
+            regs.all_live = true;
+            break;
+    }
+
+    return regs;
+}
+
+bool IrBuilder::CollectBody(size_t entry_pc)
+{
+    std::set<size_t> visited {entry_pc};
+    std::queue<size_t> worklist;
+    worklist.push(entry_pc);
+
+    std::vector<size_t> succs;
+    while (!worklist.empty()) {
+        size_t pc = worklist.front();
+        worklist.pop();
+
+        succs.clear();
+        GetSuccessors(pc, &succs);
+        for (size_t succ : succs) {
+            if (GetInstr(succ) != nullptr && visited.insert(succ).second) {
+                worklist.push(succ);
+            }
+        }
+
+        if (visited.size() > MAX_FUNCTION_SIZE) {
+            PrintLogCat(JIT, "JIT: function is too big, pc = ", entry_pc);
+            return false;
+        }
+    }
+
+    body_.assign(visited.begin(), visited.end());
+    for (size_t i = 0; i < body_.size(); ++i) {
+        body_idx_[body_[i]] = i;
+    }
+
+    return true;
+}
+
+void IrBuilder::ComputeLiveness()
+{
+    size_t n_instrs = body_.size();
+
+    std::vector<InstrRegs> instr_regs(n_instrs);
+    std::vector<std::vector<size_t>> succ_idxs(n_instrs);
+    std::vector<size_t> succs;
+    for (size_t i = 0; i < n_instrs; ++i) {
+        instr_regs[i] = GetInstrRegs(body_[i]);
+
+        succs.clear();
+        GetSuccessors(body_[i], &succs);
+        for (size_t succ : succs) {
+            if (auto it = body_idx_.find(succ); it != body_idx_.end()) {
+                succ_idxs[i].push_back(it->second);
+            }
+        }
+    }
+
+    live_in_.assign(n_instrs, RegSet {});
+
+    // Backward jumps are rare, so iterating in reverse order converges in a few passes
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t i = n_instrs; i-- > 0;) {
+            const InstrRegs &regs = instr_regs[i];
+
+            RegSet live;
+            if (regs.all_live) {
+                live.set();
+            } else {
+                for (size_t succ : succ_idxs[i]) {
+                    live |= live_in_[succ];
+                }
+                if (regs.def >= 0) {
+                    live.reset(static_cast<size_t>(regs.def));
+                }
+                live |= regs.uses;
+            }
+
+            if (live != live_in_[i]) {
+                live_in_[i] = live;
+                changed = true;
+            }
+        }
+    }
+}
+
+const RegSet &IrBuilder::GetLiveIn(size_t pc) const
+{
+    return live_in_[body_idx_.at(pc)];
+}
+
+RegSet IrBuilder::GetLiveOut(size_t pc) const
+{
+    RegSet live;
+    if (GetInstrRegs(pc).all_live) {
+        live.set();
+        return live;
+    }
+
+    std::vector<size_t> succs;
+    GetSuccessors(pc, &succs);
+    for (size_t succ : succs) {
+        if (auto it = body_idx_.find(succ); it != body_idx_.end()) {
+            live |= live_in_[it->second];
+        }
+    }
+    return live;
+}
+
+size_t IrBuilder::CountInstrs(size_t from_pc, size_t to_pc) const
+{
+    if (from_pc > to_pc) {
+        std::swap(from_pc, to_pc);
+    }
+    auto begin = std::lower_bound(body_.begin(), body_.end(), from_pc);
+    auto end = std::upper_bound(body_.begin(), body_.end(), to_pc);
+    return std::max<size_t>(1, static_cast<size_t>(end - begin));
+}
+
+bool IrBuilder::CollectRegion(size_t entry_pc)
+{
+    region_.insert(entry_pc);
+    entry_pcs_.push_back(entry_pc);
+    leaders_.insert(entry_pc);
+
+    std::queue<size_t> worklist;
+    worklist.push(entry_pc);
+
+    size_t n_compiled = 0;
+    std::vector<size_t> succs;
+    while (!worklist.empty()) {
+        size_t pc = worklist.front();
+        worklist.pop();
+
+        const BytecodeInstr *instr = GetInstr(pc);
+        if (!IsCompiled(instr->opcode)) {
+            // Interpreter executes the call, then compiled code continues from the return point
+            size_t return_pc = pc + instr->size;
+            if (instr->opcode == Opcode::CALL && instr->size == 0x8 && GetInstr(return_pc) != nullptr) {
+                if (std::find(entry_pcs_.begin(), entry_pcs_.end(), return_pc) == entry_pcs_.end()) {
+                    entry_pcs_.push_back(return_pc);
+                }
+                leaders_.insert(return_pc);
+                if (region_.insert(return_pc).second) {
+                    worklist.push(return_pc);
+                }
+            }
+            continue;
+        }
+
+        if (++n_compiled > MAX_REGION_SIZE) {
+            PrintLogCat(JIT, "JIT: region is too big, pc = ", entry_pc);
+            return false;
+        }
+
+        InstrRegs regs = GetInstrRegs(pc);
+        if (regs.def >= 0) {
+            written_.set(static_cast<size_t>(regs.def));
+        }
+
+        succs.clear();
+        GetSuccessors(pc, &succs);
+        for (size_t succ : succs) {
+            if (GetInstr(succ) == nullptr) {
+                PrintLogCat(JIT, "JIT: control flow leaves code section, pc = ", pc);
+                return false;
+            }
+            if (instr->opcode == Opcode::JMP_IMM || instr->opcode == Opcode::JMP_IF_IMM) {
+                leaders_.insert(succ);
+            }
+            if (region_.insert(succ).second) {
+                worklist.push(succ);
+            }
+        }
+    }
+
+    return true;
+}
+
+void IrBuilder::CreateBlocks()
+{
+    for (size_t leader : leaders_) {
+        RegionBlock &region_block = region_blocks_[leader];
+        region_block.block = graph_->CreateBlock(leader);
+
+        size_t pc = leader;
+        while (true) {
+            region_block.pcs.push_back(pc);
+
+            const BytecodeInstr *instr = GetInstr(pc);
+            if (!IsCompiled(instr->opcode) || instr->opcode == Opcode::JMP_IMM ||
+                instr->opcode == Opcode::JMP_IF_IMM) {
+                break;
+            }
+
+            pc += instr->size;
+            if (leaders_.count(pc) != 0) {
+                break;
+            }
+        }
+    }
+
+    for (auto &[leader, region_block] : region_blocks_) {
+        size_t last_pc = region_block.pcs.back();
+        const BytecodeInstr *instr = GetInstr(last_pc);
+        if (!IsCompiled(instr->opcode)) {
+            continue;
+        }
+
+        std::vector<size_t> succs;
+        GetSuccessors(last_pc, &succs);
+        if (succs.size() == 2 && succs[0] == succs[1]) {
+            succs.pop_back();
+        }
+        for (size_t succ : succs) {
+            graph_->AddEdge(region_block.block, region_blocks_.at(succ).block);
+        }
+    }
+
+    for (size_t entry_pc : entry_pcs_) {
+        BasicBlock *entry = graph_->CreateBlock(entry_pc);
+        entry->is_entry = true;
+        graph_->AddEntry(entry);
+        graph_->AddEdge(entry, region_blocks_.at(entry_pc).block);
+        Append(entry, IrOpcode::JUMP);
+    }
+}
+
+Inst *IrBuilder::Append(BasicBlock *block, IrOpcode opcode, std::vector<Inst *> inputs, int64_t imm)
+{
+    Inst *inst = graph_->CreateInst(opcode);
+    inst->inputs = std::move(inputs);
+    inst->imm = imm;
+    inst->block = block;
+    block->insts.push_back(inst);
+    return inst;
+}
+
+Inst *IrBuilder::AppendConst(BasicBlock *block, int64_t value)
+{
+    Inst *inst = Append(block, IrOpcode::CONST, {}, value);
+    inst->kind = ValueKind::PRIMITIVE;
+    return inst;
+}
+
+void IrBuilder::WriteVariable(uint8_t reg, BasicBlock *block, Inst *value)
+{
+    current_defs_[block->id][reg] = value;
+}
+
+Inst *IrBuilder::ReadVariable(uint8_t reg, BasicBlock *block)
+{
+    if (Inst *value = current_defs_[block->id][reg]; value != nullptr) {
+        return value;
+    }
+    return ReadVariableRecursive(reg, block);
+}
+
+Inst *IrBuilder::ReadVariableRecursive(uint8_t reg, BasicBlock *block)
+{
+    Inst *value = nullptr;
+    if (block->is_entry) {
+        // Register is loaded from the frame when compiled code is entered
+        value = graph_->CreateInst(IrOpcode::PARAM);
+        value->imm = reg;
+        block->InsertBeforeTerminator(value);
+        if (block->pc == entry_pc_) {
+            value->kind = frame_->IsRegMarked(reg) ? ValueKind::REFERENCE : ValueKind::PRIMITIVE;
+        } else {
+            resume_params_.push_back(value);
+        }
+    } else if (!sealed_[block->id]) {
+        value = CreatePhi(reg, block);
+        incomplete_phis_[block].emplace_back(reg, value);
+    } else if (block->preds.size() == 1) {
+        value = ReadVariable(reg, block->preds[0]);
+    } else {
+        // Phi breaks cycles of the recursion
+        value = CreatePhi(reg, block);
+        WriteVariable(reg, block, value);
+        AddPhiOperands(reg, value);
+    }
+
+    WriteVariable(reg, block, value);
+    return value;
+}
+
+Inst *IrBuilder::CreatePhi(uint8_t reg, BasicBlock *block)
+{
+    Inst *phi = graph_->CreateInst(IrOpcode::PHI);
+    phi->imm = reg;
+    phi->block = block;
+
+    auto first_non_phi = std::find_if(block->insts.begin(), block->insts.end(),
+                                      [](const Inst *inst) { return inst->opcode != IrOpcode::PHI; });
+    block->insts.insert(first_non_phi, phi);
+    return phi;
+}
+
+void IrBuilder::AddPhiOperands(uint8_t reg, Inst *phi)
+{
+    for (BasicBlock *pred : phi->block->preds) {
+        phi->inputs.push_back(ReadVariable(reg, pred));
+    }
+}
+
+void IrBuilder::SealBlock(BasicBlock *block)
+{
+    sealed_[block->id] = true;
+
+    auto it = incomplete_phis_.find(block);
+    if (it == incomplete_phis_.end()) {
+        return;
+    }
+    for (auto &[reg, phi] : it->second) {
+        AddPhiOperands(reg, phi);
+    }
+    incomplete_phis_.erase(it);
+}
+
+std::unique_ptr<FrameState> IrBuilder::CreateState(size_t pc, const RegSet &live, BasicBlock *block)
+{
+    auto state = std::make_unique<FrameState>();
+    state->pc = pc;
+
+    // Registers which are not written by compiled code still have their values in the frame
+    RegSet regs = live & written_;
+    for (size_t reg = 0; reg < regs.size(); ++reg) {
+        if (regs.test(reg)) {
+            state->regs.emplace_back(static_cast<uint8_t>(reg), ReadVariable(static_cast<uint8_t>(reg), block));
+        }
+    }
+    return state;
+}
+
+ArrayElementKind IrBuilder::SpeculateArrayKind(const Inst *array, uint8_t reg) const
+{
+    if (array->opcode == IrOpcode::NEW_ARRAY) {
+        auto type = static_cast<memory::Type>(array->imm);
+        bool is_primitive = type == memory::Type::INT || type == memory::Type::DOUBLE;
+        return is_primitive ? ArrayElementKind::PRIMITIVE : ArrayElementKind::REFERENCE;
+    }
+
+    // Array which is in the register at the moment of compilation
+    if (frame_->IsRegMarked(reg)) {
+        auto *obj = reinterpret_cast<const ObjectHeader *>(frame_->GetReg(reg)->GetRaw());
+        if (obj->GetClassWord()->IsArrayObject()) {
+            return obj->GetClassWord()->GetArrayElementKind();
+        }
+    }
+
+    return ArrayElementKind::PRIMITIVE;
+}
+
+void IrBuilder::EmitBinary(size_t pc, BasicBlock *block, IrOpcode opcode)
+{
+    Inst *lhs = ReadVariable(GetByte(pc, 2), block);
+    Inst *rhs = ReadVariable(GetByte(pc, 3), block);
+    Inst *inst = Append(block, opcode, {lhs, rhs});
+    inst->kind = ValueKind::PRIMITIVE;
+    WriteVariable(GetByte(pc, 1), block, inst);
+}
+
+void IrBuilder::EmitArrayAccess(size_t pc, BasicBlock *block, bool is_store)
+{
+    uint8_t array_reg = GetByte(pc, 2);
+    Inst *array = ReadVariable(array_reg, block);
+    Inst *idx = ReadVariable(GetByte(pc, 3), block);
+
+    ArrayElementKind element_kind = SpeculateArrayKind(array, array_reg);
+
+    // Guards are before any effect of the instruction, so interpreter just executes it again
+    Inst *check = Append(block, IrOpcode::CHECK_ARRAY, {array}, static_cast<int64_t>(element_kind));
+    check->state = CreateState(pc, GetLiveIn(pc), block);
+    Inst *length = Append(block, IrOpcode::ARR_LEN, {array});
+    length->kind = ValueKind::PRIMITIVE;
+    Inst *bounds_check = Append(block, IrOpcode::BOUNDS_CHECK, {idx, length});
+    bounds_check->state = CreateState(pc, GetLiveIn(pc), block);
+
+    bool is_reference = element_kind == ArrayElementKind::REFERENCE;
+    if (is_store) {
+        Inst *value = ReadVariable(GetByte(pc, 1), block);
+        Append(block, is_reference ? IrOpcode::STORE_REF_ELEM : IrOpcode::STORE_ELEM, {array, idx, value});
+    } else {
+        Inst *load = Append(block, IrOpcode::LOAD_ELEM, {array, idx});
+        load->kind = is_reference ? ValueKind::NULLABLE_REFERENCE : ValueKind::PRIMITIVE;
+        WriteVariable(GetByte(pc, 1), block, load);
+    }
+}
+
+void IrBuilder::EmitInstr(size_t pc, BasicBlock *block)
+{
+    const BytecodeInstr *instr = GetInstr(pc);
+    uint8_t rd = GetByte(pc, 1);
+    uint8_t rs1 = GetByte(pc, 2);
+
+    auto emit_unary = [this, block, rd, rs1](IrOpcode opcode) {
+        Inst *inst = Append(block, opcode, {ReadVariable(rs1, block)});
+        inst->kind = ValueKind::PRIMITIVE;
+        WriteVariable(rd, block, inst);
+    };
+
+    switch (instr->opcode) {
+        // clang-format off
+        case Opcode::ADD:   EmitBinary(pc, block, IrOpcode::ADD);     break;
+        case Opcode::SUB:   EmitBinary(pc, block, IrOpcode::SUB);     break;
+        case Opcode::MUL:   EmitBinary(pc, block, IrOpcode::MUL);     break;
+        case Opcode::DIV:   EmitBinary(pc, block, IrOpcode::DIV);     break;
+        case Opcode::REM:   EmitBinary(pc, block, IrOpcode::REM);     break;
+        case Opcode::ADDF:  EmitBinary(pc, block, IrOpcode::ADDF);    break;
+        case Opcode::SUBF:  EmitBinary(pc, block, IrOpcode::SUBF);    break;
+        case Opcode::MULF:  EmitBinary(pc, block, IrOpcode::MULF);    break;
+        case Opcode::DIVF:  EmitBinary(pc, block, IrOpcode::DIVF);    break;
+        case Opcode::AND:   EmitBinary(pc, block, IrOpcode::AND);     break;
+        case Opcode::OR:    EmitBinary(pc, block, IrOpcode::OR);      break;
+        case Opcode::XOR:   EmitBinary(pc, block, IrOpcode::XOR);     break;
+        case Opcode::SLTI:  EmitBinary(pc, block, IrOpcode::CMP_LT);  break;
+        case Opcode::SMEI:  EmitBinary(pc, block, IrOpcode::CMP_GE);  break;
+        case Opcode::EQI:   EmitBinary(pc, block, IrOpcode::CMP_EQ);  break;
+        case Opcode::NEQI:  EmitBinary(pc, block, IrOpcode::CMP_NE);  break;
+        case Opcode::SLTF:  EmitBinary(pc, block, IrOpcode::CMPF_LT); break;
+        case Opcode::SMEF:  EmitBinary(pc, block, IrOpcode::CMPF_GE); break;
+        case Opcode::EQF:   EmitBinary(pc, block, IrOpcode::CMPF_EQ); break;
+        case Opcode::NEQF:  EmitBinary(pc, block, IrOpcode::CMPF_NE); break;
+        case Opcode::CONVIF: emit_unary(IrOpcode::CONVIF);            break;
+        case Opcode::CONVFI: emit_unary(IrOpcode::CONVFI);            break;
+        // clang-format on
+        case Opcode::MOV:
+            // Root bit is copied together with the value
+            WriteVariable(rd, block, ReadVariable(rs1, block));
+            break;
+        case Opcode::MOVIF:
+            WriteVariable(rd, block, AppendConst(block, GetImm64(pc)));
+            break;
+        case Opcode::PRINTI:
+            Append(block, IrOpcode::PRINTI, {ReadVariable(rs1, block)});
+            break;
+        case Opcode::PRINTF:
+            Append(block, IrOpcode::PRINTF, {ReadVariable(rs1, block)});
+            break;
+        case Opcode::ACCR: {
+            Inst *check = Append(block, IrOpcode::CHECK_ACCUM_ROOT, {}, is_accum_root_ ? 1 : 0);
+            check->state = CreateState(pc, GetLiveIn(pc), block);
+            Inst *load = Append(block, IrOpcode::LOAD_ACCUM);
+            load->kind = is_accum_root_ ? ValueKind::REFERENCE : ValueKind::PRIMITIVE;
+            WriteVariable(rd, block, load);
+            break;
+        }
+        case Opcode::RACC:
+            Append(block, IrOpcode::STORE_ACCUM, {ReadVariable(rs1, block)});
+            break;
+        case Opcode::NEWARR_IMM:
+        case Opcode::NEWARR: {
+            Inst *size = instr->opcode == Opcode::NEWARR_IMM
+                             ? AppendConst(block, GetImm32(pc))
+                             : ReadVariable(ISA_GET_ARRAY_SIZE_RS(bytecode_ + pc), block);
+            auto type = static_cast<memory::Type>(GetHword(pc));
+            Inst *array = Append(block, IrOpcode::NEW_ARRAY, {size}, static_cast<int64_t>(type));
+            array->kind = ValueKind::REFERENCE;
+            WriteVariable(rd, block, array);
+            break;
+        }
+        case Opcode::ARR_SIZE:
+            emit_unary(IrOpcode::ARR_LEN);
+            break;
+        case Opcode::LARR:
+            EmitArrayAccess(pc, block, false);
+            break;
+        case Opcode::STARR:
+            EmitArrayAccess(pc, block, true);
+            break;
+        case Opcode::NEWOBJ: {
+            // Class description is resolved at compile time instead of on each allocation
+            auto *class_manager = Runtime::GetInstance()->GetClassManager();
+            auto &asm_class = (*file_->GetHeader()->GetClassSection()->GetInstances())[GetHword(pc)];
+            ClassDescription *class_description = class_manager->GetClassDescriptionFromCache(asm_class.GetName());
+            if (class_description == nullptr) {
+                class_description = class_manager->CreateClassDescription(asm_class);
+            }
+
+            Inst *obj = Append(block, IrOpcode::NEW_OBJECT);
+            obj->aux = class_description;
+            obj->aux_class = &asm_class;
+            obj->kind = ValueKind::REFERENCE;
+            WriteVariable(rd, block, obj);
+            break;
+        }
+        case Opcode::OBJ_GET_FIELD: {
+            auto field_type = static_cast<memory::Type>(static_cast<int8_t>(ISA_GET_OBJ_FIELD_TYPE(bytecode_ + pc)));
+            Inst *obj = ReadVariable(ISA_GET_OBJ_RS(bytecode_ + pc), block);
+            Inst *field = Append(block, IrOpcode::GET_FIELD, {obj}, GetHword(pc));
+
+            // Same as Field::IsPrimitive(): user classes are not references for root bits
+            bool is_reference = field_type == memory::Type::CLASS_OBJECT ||
+                                field_type == memory::Type::STRING_OBJECT || field_type == memory::Type::ARRAY_OBJECT;
+            field->kind = is_reference ? ValueKind::NULLABLE_REFERENCE : ValueKind::PRIMITIVE;
+            WriteVariable(rd, block, field);
+            break;
+        }
+        case Opcode::OBJ_SET_FIELD: {
+            auto field_type = static_cast<memory::Type>(static_cast<int8_t>(ISA_GET_OBJ_FIELD_TYPE(bytecode_ + pc)));
+            Inst *obj = ReadVariable(ISA_GET_OBJ_RS(bytecode_ + pc), block);
+            Inst *value = ReadVariable(rd, block);
+
+            // Stores of references need write barrier of the incremental GC
+            bool is_primitive = field_type == memory::Type::INT || field_type == memory::Type::DOUBLE;
+            Append(block, is_primitive ? IrOpcode::SET_FIELD : IrOpcode::SET_REF_FIELD, {obj, value}, GetHword(pc));
+
+            Inst *unrooted = Append(block, IrOpcode::UNROOT, {value});
+            unrooted->kind = ValueKind::PRIMITIVE;
+            WriteVariable(rd, block, unrooted);
+            break;
+        }
+        default:
+            UNREACHABLE();
+    }
+}
+
+void IrBuilder::FillBlock(const RegionBlock &region_block)
+{
+    BasicBlock *block = region_block.block;
+    size_t last_pc = region_block.pcs.back();
+    const BytecodeInstr *last = GetInstr(last_pc);
+
+    for (size_t pc : region_block.pcs) {
+        if (pc != last_pc || (IsCompiled(last->opcode) && last->opcode != Opcode::JMP_IMM &&
+                              last->opcode != Opcode::JMP_IF_IMM)) {
+            EmitInstr(pc, block);
+        }
+    }
+
+    if (!IsCompiled(last->opcode)) {
+        Inst *exit = Append(block, IrOpcode::EXIT);
+        exit->state = CreateState(last_pc, GetLiveIn(last_pc), block);
+        if (last->opcode == Opcode::CALL) {
+            call_exits_[last_pc + last->size] = exit;
+        }
+        return;
+    }
+
+    // Backward edges let GC run from compiled loops
+    size_t n_instrs = 0;
+    for (BasicBlock *succ : block->succs) {
+        if (succ->rpo <= block->rpo) {
+            n_instrs = std::max(n_instrs, CountInstrs(succ->pc, last_pc));
+        }
+    }
+    if (n_instrs != 0) {
+        Inst *safepoint = Append(block, IrOpcode::SAFEPOINT, {}, static_cast<int64_t>(n_instrs));
+        safepoint->state = CreateState(last_pc, GetLiveOut(last_pc), block);
+    }
+
+    if (last->opcode == Opcode::JMP_IF_IMM && block->succs.size() == 2) {
+        Append(block, IrOpcode::BRANCH, {ReadVariable(GetByte(last_pc, 2), block)});
+    } else {
+        Append(block, IrOpcode::JUMP);
+    }
+}
+
+void IrBuilder::RemoveTrivialPhis()
+{
+    auto resolve = [](Inst *inst) {
+        while (inst->replacement != nullptr) {
+            inst = inst->replacement;
+        }
+        return inst;
+    };
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (BasicBlock *block : graph_->GetRpo()) {
+            for (Inst *phi : block->insts) {
+                if (phi->opcode != IrOpcode::PHI) {
+                    break;
+                }
+                if (phi->replacement != nullptr) {
+                    continue;
+                }
+
+                Inst *same = nullptr;
+                bool is_trivial = true;
+                for (Inst *input : phi->inputs) {
+                    Inst *value = resolve(input);
+                    if (value == phi || value == same) {
+                        continue;
+                    }
+                    if (same != nullptr) {
+                        is_trivial = false;
+                        break;
+                    }
+                    same = value;
+                }
+
+                if (is_trivial && same != nullptr) {
+                    phi->replacement = same;
+                    changed = true;
+                }
+            }
+        }
+    }
+}
+
+bool IrBuilder::InferKinds()
+{
+    std::unordered_map<const Inst *, Inst *> resume_sources;
+    for (Inst *param : resume_params_) {
+        auto it = call_exits_.find(param->block->pc);
+        if (it == call_exits_.end()) {
+            continue;
+        }
+        for (const auto &[reg, value] : it->second->state->regs) {
+            if (reg == param->imm) {
+                resume_sources[param] = value;
+            }
+        }
+    }
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (BasicBlock *block : graph_->GetRpo()) {
+            for (Inst *inst : block->insts) {
+                ValueKind kind = inst->kind;
+                if (inst->opcode == IrOpcode::PHI) {
+                    kind = ValueKind::UNKNOWN;
+                    for (const Inst *input : inst->inputs) {
+                        kind = MergeValueKinds(kind, input->kind);
+                    }
+                } else if (inst->opcode == IrOpcode::PARAM && block->pc != entry_pc_) {
+                    // After the call register has the value written back by the exit to the call,
+                    // registers not written by compiled code are expected to be the same as at compilation
+                    auto it = resume_sources.find(inst);
+                    if (it != resume_sources.end()) {
+                        kind = it->second->kind;
+                    } else {
+                        kind = frame_->IsRegMarked(inst->imm) ? ValueKind::REFERENCE : ValueKind::PRIMITIVE;
+                    }
+                }
+
+                if (kind != inst->kind) {
+                    inst->kind = kind;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    for (BasicBlock *block : graph_->GetRpo()) {
+        for (Inst *inst : block->insts) {
+            if (inst->kind == ValueKind::UNKNOWN) {
+                inst->kind = ValueKind::PRIMITIVE;
+            }
+        }
+    }
+
+    // Root bit of a value with different kinds on different paths cannot be restored
+    for (BasicBlock *block : graph_->GetRpo()) {
+        for (Inst *inst : block->insts) {
+            if (inst->opcode == IrOpcode::STORE_ACCUM && inst->inputs[0]->kind == ValueKind::CONFLICT) {
+                return false;
+            }
+            if (inst->state == nullptr) {
+                continue;
+            }
+            for (const auto &[reg, value] : inst->state->regs) {
+                if (value->kind == ValueKind::CONFLICT) {
+                    PrintLogCat(JIT, "JIT: register x", static_cast<int>(reg), " has different kinds, pc = ",
+                                inst->state->pc);
+                    return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+bool IrBuilder::Build(size_t entry_pc, const Frame &frame, bool is_accum_root)
+{
+    frame_ = &frame;
+    is_accum_root_ = is_accum_root;
+    entry_pc_ = entry_pc;
+
+    if (GetInstr(entry_pc) == nullptr || !CollectBody(entry_pc)) {
+        return false;
+    }
+    ComputeLiveness();
+
+    if (!CollectRegion(entry_pc)) {
+        return false;
+    }
+    CreateBlocks();
+    graph_->ComputeRpo();
+
+    size_t n_blocks = graph_->GetBlocks().size();
+    current_defs_.assign(n_blocks, {});
+    filled_.assign(n_blocks, false);
+    sealed_.assign(n_blocks, false);
+
+    auto preds_filled = [this](const BasicBlock *block) {
+        return std::all_of(block->preds.begin(), block->preds.end(),
+                           [this](const BasicBlock *pred) { return IsFilled(pred); });
+    };
+
+    for (BasicBlock *entry : graph_->GetEntries()) {
+        filled_[entry->id] = true;
+        sealed_[entry->id] = true;
+    }
+
+    for (BasicBlock *block : graph_->GetRpo()) {
+        if (block->is_entry) {
+            continue;
+        }
+        if (!sealed_[block->id] && preds_filled(block)) {
+            SealBlock(block);
+        }
+
+        // Values of registers at loop headers are frame state for guards hoisted out of the loop
+        bool is_loop_header = std::any_of(block->preds.begin(), block->preds.end(),
+                                          [block](const BasicBlock *pred) { return pred->rpo >= block->rpo; });
+        if (is_loop_header) {
+            RegSet regs = GetLiveIn(block->pc) & written_;
+            for (size_t reg = 0; reg < regs.size(); ++reg) {
+                if (regs.test(reg)) {
+                    auto reg_idx = static_cast<uint8_t>(reg);
+                    block->entry_regs.emplace_back(reg_idx, ReadVariable(reg_idx, block));
+                }
+            }
+        }
+
+        FillBlock(region_blocks_.at(block->pc));
+        filled_[block->id] = true;
+
+        for (BasicBlock *succ : block->succs) {
+            if (!sealed_[succ->id] && preds_filled(succ)) {
+                SealBlock(succ);
+            }
+        }
+    }
+    assert(incomplete_phis_.empty());
+
+    RemoveTrivialPhis();
+    graph_->ApplyReplacements();
+    if (!InferKinds()) {
+        return false;
+    }
+
+    // Values known to be primitive don't need to be unrooted
+    for (BasicBlock *block : graph_->GetRpo()) {
+        for (Inst *inst : block->insts) {
+            if (inst->opcode == IrOpcode::UNROOT && inst->inputs[0]->kind == ValueKind::PRIMITIVE) {
+                inst->replacement = inst->inputs[0];
+            }
+        }
+    }
+    graph_->ApplyReplacements();
+
+    return true;
+}
+
+} // namespace evm::runtime::jit
@@ -0,0 +1,150 @@
+#ifndef EVM_RUNTIME_JIT_IR_BUILDER_H
+#define EVM_RUNTIME_JIT_IR_BUILDER_H
+
+#include "common/constants.h"
+#include "common/macros.h"
+#include "isa/opcodes.h"
+#include "runtime/jit/ir.h"
+#include "runtime/memory/class_description.h"
+#include "runtime/memory/frame.h"
+
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+namespace evm::file_format {
+class File;
+} // namespace evm::file_format
+
+namespace evm::runtime::jit {
+
+struct BytecodeInstr {
+    Opcode opcode {Opcode::INVALID};
+    size_t size {0};
+};
+
+/// Instructions of the code section by their pc
+using BytecodeMap = std::unordered_map<size_t, BytecodeInstr>;
+
+using RegSet = std::bitset<Frame::N_FRAME_REGS_DEFAULT>;
+
+/// Builds SSA graph of the region of code reachable from a hot pc without leaving compiled code.
+/// Instructions which are not compiled (calls, returns, strings, ...) end the region with exits to interpreter,
+/// code after calls becomes an additional entry which is used when callee returns.
+class IrBuilder {
+public:
+    // Limits of analyzed code: bigger functions are left to interpreter
+    static constexpr size_t MAX_FUNCTION_SIZE = 8192;
+    static constexpr size_t MAX_REGION_SIZE = 2048;
+
+public:
+    NO_COPY_SEMANTIC(IrBuilder);
+    NO_MOVE_SEMANTIC(IrBuilder);
+
+    IrBuilder(Graph *graph, const BytecodeMap &instrs, const byte_t *bytecode, file_format::File *file)
+        : graph_(graph), instrs_(instrs), bytecode_(bytecode), file_(file)
+    {
+    }
+    ~IrBuilder() = default;
+
+    /// Root bits of the frame and of the accumulator at the moment of compilation are the type feedback:
+    /// compiled code is specialized for them and checks them on entry or with guards
+    bool Build(size_t entry_pc, const Frame &frame, bool is_accum_root);
+
+    static bool IsCompiled(Opcode opcode);
+
+private:
+    struct InstrRegs {
+        RegSet uses;
+        int def {-1};
+        bool all_live {false}; // control flow is dynamic or leaves the function, so any register can be read
+    };
+
+    struct RegionBlock {
+        std::vector<size_t> pcs;
+        BasicBlock *block {nullptr};
+    };
+
+    uint8_t GetByte(size_t pc, size_t idx) const
+    {
+        return bytecode_[pc + idx];
+    }
+    hword_t GetHword(size_t pc) const;
+    int32_t GetImm32(size_t pc) const;
+    int64_t GetImm64(size_t pc) const;
+
+    const BytecodeInstr *GetInstr(size_t pc) const;
+    void GetSuccessors(size_t pc, std::vector<size_t> *succs) const;
+    InstrRegs GetInstrRegs(size_t pc) const;
+
+    bool CollectBody(size_t entry_pc);
+    void ComputeLiveness();
+    const RegSet &GetLiveIn(size_t pc) const;
+    RegSet GetLiveOut(size_t pc) const;
+    size_t CountInstrs(size_t from_pc, size_t to_pc) const;
+
+    bool CollectRegion(size_t entry_pc);
+    void CreateBlocks();
+
+    // SSA construction: Braun et al. "Simple and Efficient Construction of Static Single Assignment Form"
+    void WriteVariable(uint8_t reg, BasicBlock *block, Inst *value);
+    Inst *ReadVariable(uint8_t reg, BasicBlock *block);
+    Inst *ReadVariableRecursive(uint8_t reg, BasicBlock *block);
+    void AddPhiOperands(uint8_t reg, Inst *phi);
+    Inst *CreatePhi(uint8_t reg, BasicBlock *block);
+    void SealBlock(BasicBlock *block);
+    bool IsFilled(const BasicBlock *block) const
+    {
+        return filled_[block->id];
+    }
+
+    Inst *Append(BasicBlock *block, IrOpcode opcode, std::vector<Inst *> inputs = {}, int64_t imm = 0);
+    Inst *AppendConst(BasicBlock *block, int64_t value);
+    std::unique_ptr<FrameState> CreateState(size_t pc, const RegSet &live, BasicBlock *block);
+
+    void FillBlock(const RegionBlock &region_block);
+    void EmitInstr(size_t pc, BasicBlock *block);
+    void EmitBinary(size_t pc, BasicBlock *block, IrOpcode opcode);
+    void EmitArrayAccess(size_t pc, BasicBlock *block, bool is_store);
+    ArrayElementKind SpeculateArrayKind(const Inst *array, uint8_t reg) const;
+
+    void RemoveTrivialPhis();
+    bool InferKinds();
+
+private:
+    Graph *graph_;
+    const BytecodeMap &instrs_;
+    const byte_t *bytecode_;
+    file_format::File *file_;
+
+    const Frame *frame_ {nullptr};
+    bool is_accum_root_ {false};
+    size_t entry_pc_ {0};
+
+    // Instructions of the function reachable from the entry, sorted by pc
+    std::vector<size_t> body_;
+    std::unordered_map<size_t, size_t> body_idx_;
+    std::vector<RegSet> live_in_;
+
+    std::set<size_t> region_;
+    std::vector<size_t> entry_pcs_;
+    std::set<size_t> leaders_;
+    std::map<size_t, RegionBlock> region_blocks_;
+    RegSet written_;
+
+    std::vector<std::array<Inst *, Frame::N_FRAME_REGS_DEFAULT>> current_defs_;
+    std::vector<bool> filled_;
+    std::vector<bool> sealed_;
+    std::unordered_map<BasicBlock *, std::vector<std::pair<uint8_t, Inst *>>> incomplete_phis_;
+
+    std::unordered_map<size_t, Inst *> call_exits_; // by pc of return from the call
+    std::vector<Inst *> resume_params_;
+};
+
+} // namespace evm::runtime::jit
+
+#endif // EVM_RUNTIME_JIT_IR_BUILDER_H
@@ -0,0 +1,176 @@
+#include "common/logs.h"
+#include "common/perf_counters.h"
+#include "common/trace.h"
+#include "runtime/jit/codegen_x86_64.h"
+#include "runtime/jit/jit.h"
+#include "runtime/jit/optimizations.h"
+#include "runtime/jit/register_allocator.h"
+#include "file_format/file.h"
+
+#include <cstring>
+
+namespace evm::runtime::jit {
+
+namespace {
+
+// Root bit of the register is the same as compiled code expects
+bool IsParamValid(ValueKind kind, const Frame &frame, uint8_t reg)
+{
+    bool is_root = frame.IsRegMarked(reg);
+    switch (kind) {
+        case ValueKind::PRIMITIVE:
+            return !is_root;
+        case ValueKind::REFERENCE:
+            return is_root;
+        default:
+            return is_root == (frame.GetReg(reg)->GetRaw() != 0);
+    }
+}
+
+} // namespace
+
+Jit::Jit(size_t hotness_threshold, Register *accum, bool *accum_root)
+    : hotness_threshold_(hotness_threshold == 0 ? 1 : hotness_threshold)
+{
+    context_.accum = accum;
+    context_.accum_root = accum_root;
+}
+
+bool Jit::Init(file_format::File *file, const byte_t *bytecode, size_t gc_period)
+{
+#if !defined(__x86_64__)
+    PrintErr("JIT compiler supports only x86-64");
+    return false;
+#endif
+
+    // Compiled code sets root bits with bit instructions on the words of the bitset
+    Frame frame(0, {});
+    frame.MarkReg(70);
+    uint64_t words[Frame::N_FRAME_REGS_DEFAULT / 64];
+    std::memcpy(words, reinterpret_cast<const uint8_t *>(&frame) + Frame::GetObjectBitMaskOffset(), sizeof(words));
+    if (words[0] != 0 || words[1] != (uint64_t {1} << 6)) {
+        PrintErr("Unsupported layout of frame root bits");
+        return false;
+    }
+
+    file_ = file;
+    bytecode_ = bytecode;
+    context_.gc_period = static_cast<int64_t>(gc_period);
+    context_.gc_countdown = context_.gc_period;
+
+    auto *code_section = file->GetCodeSection();
+    for (const auto &instr : code_section->GetInstructions()) {
+        instrs_[code_section->GetOffset() + instr.GetOffset()] = {instr.GetOpcode(), instr.GetBytesSize()};
+    }
+    return true;
+}
+
+size_t Jit::CountAndCompile(size_t pc, Frame *frame, size_t *n_entries)
+{
+    // Code is compiled once, failed regions are left to interpreter
+    if (++counters_[pc] != hotness_threshold_) {
+        return pc;
+    }
+    if (!Compile(pc, *frame)) {
+        ++stats_.n_failed;
+        return pc;
+    }
+    ++stats_.n_compiled;
+
+    auto it = entries_.find(pc);
+    return it == entries_.end() ? pc : Run(it->second, pc, frame, n_entries);
+}
+
+size_t Jit::Run(const Entry &entry, size_t pc, Frame *frame, size_t *n_entries)
+{
+    for (const auto &[reg, kind] : entry.params) {
+        if (!IsParamValid(kind, *frame, reg)) {
+            return pc;
+        }
+    }
+
+    ++*n_entries;
+    size_t next_pc = entry.code(&context_, frame);
+    if (UNLIKELY(context_.is_deoptimized)) {
+        return Deoptimize(entry, next_pc);
+    }
+    return next_pc;
+}
+
+size_t Jit::Deoptimize(const Entry &entry, size_t pc)
+{
+    // Frame already has the state of interpreter at pc, only speculation of compiled code is revised
+    context_.is_deoptimized = false;
+    ++stats_.n_deopts;
+
+    Region &region = regions_[entry.region];
+    if (region.is_valid && ++region.n_deopts >= MAX_DEOPTS) {
+        Invalidate(&region);
+    }
+    return pc;
+}
+
+void Jit::Invalidate(Region *region)
+{
+    PrintLogCat(JIT, "JIT: region at pc = ", region->pc, " is deoptimized too often");
+    region->is_valid = false;
+    ++stats_.n_invalidated;
+
+    for (size_t entry_pc : region->entry_pcs) {
+        auto it = entries_.find(entry_pc);
+        if (it != entries_.end() && &regions_[it->second.region] == region) {
+            entries_.erase(it);
+        }
+    }
+    // Region gets hot again with the values it failed on and is compiled for them,
+    // old machine code stays in the code cache
+    if (++n_recompilations_[region->pc] <= MAX_RECOMPILATIONS) {
+        counters_[region->pc] = 0;
+    }
+}
+
+bool Jit::Compile(size_t pc, const Frame &frame)
+{
+    trace::ScopedTrace trace_scope(trace::EventKind::JIT_BEGIN, trace::EventKind::JIT_END, 0,
+                                   static_cast<uint32_t>(pc));
+    perf::ScopedPerfPhase perf_phase(perf::Phase::JIT);
+    Graph graph;
+    IrBuilder builder(&graph, instrs_, bytecode_, file_);
+    if (!builder.Build(pc, frame, *context_.accum_root)) {
+        PrintLogCat(JIT, "JIT: region at pc = ", pc, " is not compiled");
+        return false;
+    }
+    RunOptimizations(&graph);
+
+    RegisterAllocator regalloc(graph);
+    regalloc.Run();
+
+    CodegenX86_64 codegen(graph, regalloc);
+    if (!codegen.Run()) {
+        return false;
+    }
+    const uint8_t *code = code_cache_.Install(codegen.GetCode());
+    if (code == nullptr) {
+        return false;
+    }
+    PrintLogCat(JIT, "JIT: compiled region at pc = ", pc, ", code size = ", codegen.GetCode().size());
+
+    Region &region = regions_.emplace_back();
+    region.pc = pc;
+    for (const BasicBlock *entry_block : graph.GetEntries()) {
+        Entry entry;
+        entry.code = reinterpret_cast<EntryFunction>(code + codegen.GetEntryOffset(entry_block));
+        entry.region = regions_.size() - 1;
+        region.entry_pcs.push_back(entry_block->pc);
+        for (const Inst *inst : entry_block->insts) {
+            if (inst->opcode == IrOpcode::PARAM) {
+                entry.params.emplace_back(static_cast<uint8_t>(inst->imm), inst->kind);
+            }
+        }
+        // Code compiled earlier for the same pc is kept
+        entries_.emplace(entry_block->pc, std::move(entry));
+    }
+    return true;
+}
+
+} // namespace evm::runtime::jit
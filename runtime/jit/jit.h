@@ -0,0 +1,124 @@
+#ifndef EVM_RUNTIME_JIT_JIT_H
+#define EVM_RUNTIME_JIT_JIT_H
+
+#include "common/constants.h"
+#include "common/macros.h"
+#include "runtime/jit/code_cache.h"
+#include "runtime/jit/ir.h"
+#include "runtime/jit/ir_builder.h"
+#include "runtime/jit/runtime_helpers.h"
+#include "runtime/memory/frame.h"
+#include "runtime/memory/reg.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace evm::file_format {
+class File;
+} // namespace evm::file_format
+
+namespace evm::runtime::jit {
+
+/// Optimizing tier of the interpreter. Code which starts at a pc entered often enough (function entries,
+/// return points from calls and headers of loops) is compiled to machine code specialized for root bits
+/// of the frame at that moment. Compiled code works on the same frame and returns to interpreter at instructions
+/// it doesn't compile.
+class Jit {
+public:
+    static constexpr size_t DEFAULT_HOTNESS_THRESHOLD = 1000;
+    // Code which deoptimizes this many times is discarded and compiled again for the current frame
+    static constexpr size_t MAX_DEOPTS = 16;
+    // After this many recompilations the region is left to interpreter
+    static constexpr size_t MAX_RECOMPILATIONS = 3;
+
+    struct Stats {
+        size_t n_compiled {0}; // regions
+        size_t n_failed {0};
+        size_t n_entries {0};     // executions of compiled code after calls and returns
+        size_t n_osr_entries {0}; // executions of compiled code from loop headers
+        size_t n_deopts {0};      // returns to interpreter from failed guards
+        size_t n_invalidated {0}; // regions discarded because of deoptimizations
+    };
+
+public:
+    NO_COPY_SEMANTIC(Jit);
+    NO_MOVE_SEMANTIC(Jit);
+
+    Jit(size_t hotness_threshold, Register *accum, bool *accum_root);
+    ~Jit() = default;
+
+    /// Returns false if compiled code can't run on this machine
+    bool Init(file_format::File *file, const byte_t *bytecode, size_t gc_period);
+
+    /// Called when interpreter continues at pc in a new frame or after return to the frame.
+    /// Runs compiled code if there is one and returns pc from which interpreter continues.
+    size_t Enter(size_t pc, Frame *frame)
+    {
+        return Enter(pc, frame, &stats_.n_entries);
+    }
+
+    /// Called when interpreter jumps back to pc. Loop which runs long enough is compiled from its header
+    /// and continues in compiled code with registers of the current frame (on-stack replacement).
+    size_t EnterLoop(size_t pc, Frame *frame)
+    {
+        return Enter(pc, frame, &stats_.n_osr_entries);
+    }
+
+    const Stats &GetStats() const
+    {
+        return stats_;
+    }
+
+private:
+    using EntryFunction = size_t (*)(JitContext *ctx, Frame *frame);
+
+    struct Entry {
+        EntryFunction code {nullptr};
+        std::vector<std::pair<uint8_t, ValueKind>> params; // root bits compiled code is specialized for
+        size_t region {0};
+    };
+
+    struct Region {
+        size_t pc {0}; // pc the region is compiled from
+        std::vector<size_t> entry_pcs;
+        size_t n_deopts {0};
+        bool is_valid {true};
+    };
+
+    size_t Enter(size_t pc, Frame *frame, size_t *n_entries)
+    {
+        if (auto it = entries_.find(pc); it != entries_.end()) {
+            return Run(it->second, pc, frame, n_entries);
+        }
+        return CountAndCompile(pc, frame, n_entries);
+    }
+
+    size_t CountAndCompile(size_t pc, Frame *frame, size_t *n_entries);
+    size_t Run(const Entry &entry, size_t pc, Frame *frame, size_t *n_entries);
+    size_t Deoptimize(const Entry &entry, size_t pc);
+    void Invalidate(Region *region);
+    bool Compile(size_t pc, const Frame &frame);
+
+private:
+    size_t hotness_threshold_;
+    JitContext context_;
+
+    file_format::File *file_ {nullptr};
+    const byte_t *bytecode_ {nullptr};
+    BytecodeMap instrs_;
+
+    CodeCache code_cache_;
+    std::unordered_map<size_t, size_t> counters_;
+    std::unordered_map<size_t, Entry> entries_;
+    std::vector<Region> regions_;
+    std::unordered_map<size_t, size_t> n_recompilations_;
+
+    Stats stats_;
+};
+
+} // namespace evm::runtime::jit
+
+#endif // EVM_RUNTIME_JIT_JIT_H
@@ -0,0 +1,533 @@
+#include "runtime/jit/optimizations.h"
+#include "file_format/class_section.h"
+
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <map>
+#include <tuple>
+
+namespace evm::runtime::jit {
+
+std::vector<Loop> FindLoops(const Graph &graph)
+{
+    size_t n_blocks = graph.GetBlocks().size();
+    std::vector<Loop> loops;
+    std::map<BasicBlock *, size_t> loop_by_header;
+
+    for (BasicBlock *header : graph.GetRpo()) {
+        for (BasicBlock *pred : header->preds) {
+            if (!graph.Dominates(header, pred)) {
+                continue;
+            }
+
+            auto [it, inserted] = loop_by_header.emplace(header, loops.size());
+            if (inserted) {
+                loops.emplace_back();
+                loops.back().header = header;
+                loops.back().blocks.assign(n_blocks, false);
+                loops.back().blocks[header->id] = true;
+            }
+            Loop &loop = loops[it->second];
+            loop.latches.push_back(pred);
+
+            // Blocks from which the latch is reached without passing the header
+            std::vector<BasicBlock *> worklist {pred};
+            while (!worklist.empty()) {
+                BasicBlock *block = worklist.back();
+                worklist.pop_back();
+                if (loop.blocks[block->id]) {
+                    continue;
+                }
+                loop.blocks[block->id] = true;
+                worklist.insert(worklist.end(), block->preds.begin(), block->preds.end());
+            }
+        }
+    }
+
+    for (Loop &loop : loops) {
+        for (BasicBlock *pred : loop.header->preds) {
+            if (loop.Contains(pred)) {
+                continue;
+            }
+            if (loop.preheader != nullptr) {
+                loop.preheader = nullptr;
+                break;
+            }
+            loop.preheader = pred;
+        }
+        if (loop.preheader != nullptr && loop.preheader->succs.size() != 1) {
+            loop.preheader = nullptr;
+        }
+
+        for (const Loop &outer : loops) {
+            if (&outer != &loop && outer.Contains(loop.header)) {
+                loop.depth++;
+            }
+        }
+    }
+
+    return loops;
+}
+
+void SplitCriticalEdges(Graph *graph)
+{
+    // Blocks are added while iterating
+    size_t n_blocks = graph->GetBlocks().size();
+    for (size_t i = 0; i < n_blocks; ++i) {
+        BasicBlock *block = graph->GetBlocks()[i].get();
+        if (block->succs.size() < 2) {
+            continue;
+        }
+
+        std::vector<BasicBlock *> succs = block->succs;
+        for (BasicBlock *succ : succs) {
+            if (succ->preds.size() > 1) {
+                graph->SplitEdge(block, succ);
+            }
+        }
+    }
+}
+
+void FoldArrayLength(Graph *graph)
+{
+    for (BasicBlock *block : graph->GetRpo()) {
+        for (Inst *inst : block->insts) {
+            if (inst->opcode != IrOpcode::ARR_LEN || inst->inputs[0]->opcode != IrOpcode::NEW_ARRAY) {
+                continue;
+            }
+
+            const Inst *size = inst->inputs[0]->inputs[0];
+            if (size->opcode == IrOpcode::CONST && size->imm >= 0 && size->imm <= INT32_MAX) {
+                inst->opcode = IrOpcode::CONST;
+                inst->imm = size->imm;
+                inst->inputs.clear();
+            }
+        }
+    }
+}
+
+namespace {
+
+bool IsInvariant(const Loop &loop, const Inst *inst)
+{
+    return std::all_of(inst->inputs.begin(), inst->inputs.end(),
+                       [&loop](const Inst *input) { return !loop.Contains(input->block); });
+}
+
+// Array is checked for null by allocation or by a guard before the block ends
+bool IsCheckedArray(const Inst *array, const BasicBlock *block)
+{
+    if (array->opcode == IrOpcode::NEW_ARRAY) {
+        return true;
+    }
+    for (const BasicBlock *dom = block; dom != nullptr; dom = dom->idom) {
+        for (const Inst *inst : dom->insts) {
+            if (inst->opcode == IrOpcode::CHECK_ARRAY && inst->inputs[0] == array) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Frame state at the start of loop header as it's seen from the preheader
+std::unique_ptr<FrameState> CreatePreheaderState(const Loop &loop)
+{
+    auto state = std::make_unique<FrameState>();
+    state->pc = loop.header->pc;
+
+    size_t pred_idx = loop.header->GetPredIndex(loop.preheader);
+    for (auto [reg, value] : loop.header->entry_regs) {
+        if (value->opcode == IrOpcode::PHI && value->block == loop.header) {
+            value = value->inputs[pred_idx];
+        }
+        if (value->opcode == IrOpcode::PARAM && value->imm == reg) {
+            continue;
+        }
+        state->regs.emplace_back(reg, value);
+    }
+    return state;
+}
+
+void MoveToBlock(Inst *inst, BasicBlock *block)
+{
+    auto &insts = inst->block->insts;
+    insts.erase(std::find(insts.begin(), insts.end(), inst));
+    block->InsertBeforeTerminator(inst);
+}
+
+} // namespace
+
+void HoistLoopInvariants(Graph *graph, const std::vector<Loop> &loops)
+{
+    std::vector<const Loop *> order;
+    for (const Loop &loop : loops) {
+        if (loop.preheader != nullptr) {
+            order.push_back(&loop);
+        }
+    }
+    // Inner loops first, so invariants of several loops are moved out step by step
+    std::stable_sort(order.begin(), order.end(),
+                     [](const Loop *lhs, const Loop *rhs) { return lhs->depth > rhs->depth; });
+
+    for (const Loop *loop : order) {
+        for (BasicBlock *block : graph->GetRpo()) {
+            if (!loop->Contains(block)) {
+                continue;
+            }
+
+            std::vector<Inst *> insts = block->insts;
+            for (Inst *inst : insts) {
+                if (inst->opcode == IrOpcode::PHI || inst->opcode == IrOpcode::PARAM || !IsInvariant(*loop, inst)) {
+                    continue;
+                }
+
+                if (inst->IsPure()) {
+                    MoveToBlock(inst, loop->preheader);
+                } else if (inst->opcode == IrOpcode::CHECK_ARRAY) {
+                    inst->state = CreatePreheaderState(*loop);
+                    MoveToBlock(inst, loop->preheader);
+                } else if (inst->opcode == IrOpcode::ARR_LEN &&
+                           IsCheckedArray(inst->inputs[0], loop->preheader)) {
+                    MoveToBlock(inst, loop->preheader);
+                }
+            }
+        }
+    }
+}
+
+void EliminateCommonSubexpressions(Graph *graph)
+{
+    using Key = std::tuple<IrOpcode, int64_t, std::vector<uint32_t>>;
+    std::map<Key, std::vector<Inst *>> available;
+
+    for (BasicBlock *block : graph->GetRpo()) {
+        for (Inst *inst : block->insts) {
+            bool is_candidate = inst->IsPure() || inst->opcode == IrOpcode::ARR_LEN ||
+                                inst->opcode == IrOpcode::CHECK_ARRAY || inst->opcode == IrOpcode::BOUNDS_CHECK;
+            if (!is_candidate || inst->opcode == IrOpcode::PHI || inst->opcode == IrOpcode::PARAM) {
+                continue;
+            }
+
+            std::vector<uint32_t> input_ids;
+            for (const Inst *input : inst->inputs) {
+                input_ids.push_back(input->id);
+            }
+            auto &same = available[Key {inst->opcode, inst->imm, std::move(input_ids)}];
+
+            // Blocks are visited in reverse post order, so the same instruction in this block is before
+            auto dominating = std::find_if(same.begin(), same.end(), [graph, block](const Inst *other) {
+                return graph->Dominates(other->block, block);
+            });
+            if (dominating != same.end()) {
+                inst->replacement = *dominating;
+            } else {
+                same.push_back(inst);
+            }
+        }
+    }
+
+    graph->ApplyReplacements();
+}
+
+namespace {
+
+// Phi of loop header which starts from non-negative constant and is incremented by one on each back edge
+bool IsCountingUp(const Loop &loop, const Inst *phi)
+{
+    size_t preheader_idx = loop.header->GetPredIndex(loop.preheader);
+    for (size_t i = 0; i < phi->inputs.size(); ++i) {
+        const Inst *input = phi->inputs[i];
+        if (i == preheader_idx) {
+            if (input->opcode != IrOpcode::CONST || input->imm < 0) {
+                return false;
+            }
+            continue;
+        }
+
+        if (input->opcode != IrOpcode::ADD) {
+            return false;
+        }
+        const Inst *lhs = input->inputs[0];
+        const Inst *rhs = input->inputs[1];
+        if (rhs == phi) {
+            std::swap(lhs, rhs);
+        }
+        if (lhs != phi || rhs->opcode != IrOpcode::CONST || rhs->imm != 1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Value of upper bound is the same as the length of array
+bool IsSameLength(const Inst *bound, const Inst *length)
+{
+    if (bound == length) {
+        return true;
+    }
+    if (bound->opcode == IrOpcode::ARR_LEN && length->opcode == IrOpcode::ARR_LEN) {
+        return bound->inputs[0] == length->inputs[0];
+    }
+    return bound->opcode == IrOpcode::CONST && length->opcode == IrOpcode::CONST && bound->imm <= length->imm;
+}
+
+} // namespace
+
+void EliminateBoundsChecks(Graph *graph, const std::vector<Loop> &loops)
+{
+    std::vector<bool> is_redundant(graph->GetNumInsts(), false);
+
+    for (const Loop &loop : loops) {
+        if (loop.preheader == nullptr) {
+            continue;
+        }
+
+        // Branches which leave the loop when induction variable reaches the bound: i < n or !(i >= n)
+        for (BasicBlock *cond_block : graph->GetRpo()) {
+            Inst *branch = cond_block->GetTerminator();
+            if (!loop.Contains(cond_block) || branch == nullptr || branch->opcode != IrOpcode::BRANCH) {
+                continue;
+            }
+            const Inst *cmp = branch->inputs[0];
+            if (cmp->opcode != IrOpcode::CMP_LT && cmp->opcode != IrOpcode::CMP_GE) {
+                continue;
+            }
+            BasicBlock *inside = cond_block->succs[cmp->opcode == IrOpcode::CMP_LT ? 0 : 1];
+            BasicBlock *outside = cond_block->succs[cmp->opcode == IrOpcode::CMP_LT ? 1 : 0];
+
+            const Inst *induction = cmp->inputs[0];
+            const Inst *bound = cmp->inputs[1];
+            bool is_loop_exit = loop.Contains(inside) && !loop.Contains(outside) && inside->preds.size() == 1;
+            bool is_checked_each_iteration = std::all_of(
+                loop.latches.begin(), loop.latches.end(),
+                [graph, cond_block](const BasicBlock *latch) { return graph->Dominates(cond_block, latch); });
+            if (!is_loop_exit || !is_checked_each_iteration || induction->opcode != IrOpcode::PHI ||
+                induction->block != loop.header || loop.Contains(bound->block) || !IsCountingUp(loop, induction)) {
+                continue;
+            }
+
+            // 0 <= i < n in all blocks dominated by the successor inside the loop
+            for (BasicBlock *block : graph->GetRpo()) {
+                if (!graph->Dominates(inside, block)) {
+                    continue;
+                }
+                for (Inst *inst : block->insts) {
+                    if (inst->opcode == IrOpcode::BOUNDS_CHECK && inst->inputs[0] == induction &&
+                        IsSameLength(bound, inst->inputs[1])) {
+                        is_redundant[inst->id] = true;
+                    }
+                }
+            }
+        }
+    }
+
+    // Guards have no users, so they are just removed
+    for (BasicBlock *block : graph->GetRpo()) {
+        auto &insts = block->insts;
+        insts.erase(std::remove_if(insts.begin(), insts.end(),
+                                   [&is_redundant](const Inst *inst) { return is_redundant[inst->id]; }),
+                    insts.end());
+    }
+}
+
+namespace {
+
+bool IsFieldAccess(const Inst *inst)
+{
+    return inst->opcode == IrOpcode::GET_FIELD || inst->opcode == IrOpcode::SET_FIELD ||
+           inst->opcode == IrOpcode::SET_REF_FIELD;
+}
+
+// Nested objects and arrays are allocated together with the object, other fields start with zero
+bool IsAllocatedField(const Inst *alloc, int64_t field_idx)
+{
+    auto *asm_class = static_cast<file_format::Class *>(const_cast<void *>(alloc->aux_class));
+    const auto &field = (*asm_class->GetInstances())[static_cast<size_t>(field_idx)];
+    return field.IsClassObject() || field.IsArrayObject();
+}
+
+// Value read from the field gets the same root bit as interpreter gives to the loaded field
+bool IsSameRootBit(const Inst *load, const Inst *value)
+{
+    if (value->opcode == IrOpcode::CONST && value->imm == 0) {
+        return true;
+    }
+    if (load->kind == ValueKind::PRIMITIVE) {
+        return value->kind == ValueKind::PRIMITIVE;
+    }
+    return value->kind == ValueKind::REFERENCE || value->kind == ValueKind::NULLABLE_REFERENCE;
+}
+
+// Field values of not escaped objects are tracked through the block. Returns false if one more object escapes,
+// instructions are changed only if all tracked objects stay not escaped.
+bool ReplaceFields(BasicBlock *block, std::vector<bool> *escapes, bool apply)
+{
+    std::map<std::pair<const Inst *, int64_t>, Inst *> fields;
+    std::vector<bool> is_removed(escapes->size(), false);
+
+    auto is_tracked = [escapes](const Inst *inst) {
+        return inst->opcode == IrOpcode::NEW_OBJECT && !(*escapes)[inst->id];
+    };
+    auto resolve = [](Inst *inst) {
+        while (inst->replacement != nullptr) {
+            inst = inst->replacement;
+        }
+        return inst;
+    };
+
+    for (Inst *inst : block->insts) {
+        if (is_tracked(inst)) {
+            is_removed[inst->id] = true;
+            continue;
+        }
+        if (!IsFieldAccess(inst) || !is_tracked(inst->inputs[0])) {
+            continue;
+        }
+
+        Inst *alloc = inst->inputs[0];
+        if (inst->opcode != IrOpcode::GET_FIELD) {
+            fields[{alloc, inst->imm}] = resolve(inst->inputs[1]);
+            is_removed[inst->id] = true;
+            continue;
+        }
+
+        auto it = fields.find({alloc, inst->imm});
+        if (it == fields.end()) {
+            if (IsAllocatedField(alloc, inst->imm)) {
+                (*escapes)[alloc->id] = true;
+                return false;
+            }
+            if (apply) {
+                inst->opcode = IrOpcode::CONST;
+                inst->imm = 0;
+                inst->inputs.clear();
+                inst->kind = ValueKind::PRIMITIVE;
+            }
+            continue;
+        }
+        if (!IsSameRootBit(inst, it->second)) {
+            (*escapes)[alloc->id] = true;
+            return false;
+        }
+        if (apply) {
+            inst->replacement = it->second;
+        }
+    }
+
+    if (apply) {
+        auto &insts = block->insts;
+        insts.erase(std::remove_if(insts.begin(), insts.end(),
+                                   [&is_removed](const Inst *inst) { return is_removed[inst->id]; }),
+                    insts.end());
+    }
+    return true;
+}
+
+} // namespace
+
+void ReplaceNotEscapedObjects(Graph *graph)
+{
+    // Object escapes if it's used by anything but accesses to its fields in the same block,
+    // including frame states: interpreter would need the object itself
+    std::vector<bool> escapes(graph->GetNumInsts(), false);
+    bool has_candidates = false;
+    for (BasicBlock *block : graph->GetRpo()) {
+        for (Inst *inst : block->insts) {
+            has_candidates |= inst->opcode == IrOpcode::NEW_OBJECT;
+            for (size_t i = 0; i < inst->inputs.size(); ++i) {
+                const Inst *input = inst->inputs[i];
+                bool is_own_field_access = i == 0 && IsFieldAccess(inst) && input->block == block;
+                if (input->opcode == IrOpcode::NEW_OBJECT && !is_own_field_access) {
+                    escapes[input->id] = true;
+                }
+            }
+            if (inst->state != nullptr) {
+                for (const auto &[reg, value] : inst->state->regs) {
+                    if (value->opcode == IrOpcode::NEW_OBJECT) {
+                        escapes[value->id] = true;
+                    }
+                }
+            }
+        }
+    }
+    if (!has_candidates) {
+        return;
+    }
+
+    for (BasicBlock *block : graph->GetRpo()) {
+        // Object which fails checks of field values escapes, then the block is checked again without it
+        bool is_checked = false;
+        while (!is_checked) {
+            is_checked = ReplaceFields(block, &escapes, false);
+        }
+        ReplaceFields(block, &escapes, true);
+    }
+    graph->ApplyReplacements();
+}
+
+void EliminateDeadCode(Graph *graph)
+{
+    std::vector<bool> is_live(graph->GetNumInsts(), false);
+    std::vector<Inst *> worklist;
+
+    auto mark = [&is_live, &worklist](Inst *inst) {
+        if (!is_live[inst->id]) {
+            is_live[inst->id] = true;
+            worklist.push_back(inst);
+        }
+    };
+
+    for (BasicBlock *block : graph->GetRpo()) {
+        for (Inst *inst : block->insts) {
+            bool is_removable = inst->IsPure() || inst->opcode == IrOpcode::ARR_LEN ||
+                                inst->opcode == IrOpcode::LOAD_ELEM || inst->opcode == IrOpcode::GET_FIELD ||
+                                inst->opcode == IrOpcode::LOAD_ACCUM;
+            if (!is_removable) {
+                mark(inst);
+            }
+        }
+    }
+
+    while (!worklist.empty()) {
+        Inst *inst = worklist.back();
+        worklist.pop_back();
+        for (Inst *input : inst->inputs) {
+            mark(input);
+        }
+        if (inst->state != nullptr) {
+            for (const auto &[reg, value] : inst->state->regs) {
+                mark(value);
+            }
+        }
+    }
+
+    for (BasicBlock *block : graph->GetRpo()) {
+        auto &insts = block->insts;
+        insts.erase(std::remove_if(insts.begin(), insts.end(),
+                                   [&is_live](const Inst *inst) { return !is_live[inst->id]; }),
+                    insts.end());
+    }
+}
+
+void RunOptimizations(Graph *graph)
+{
+    SplitCriticalEdges(graph);
+    graph->ComputeDominators();
+    std::vector<Loop> loops = FindLoops(*graph);
+
+    FoldArrayLength(graph);
+    HoistLoopInvariants(graph, loops);
+    EliminateCommonSubexpressions(graph);
+    EliminateBoundsChecks(graph, loops);
+
+    // Values at loop headers were needed only for hoisted guards
+    for (const auto &block : graph->GetBlocks()) {
+        block->entry_regs.clear();
+    }
+    ReplaceNotEscapedObjects(graph);
+    EliminateDeadCode(graph);
+}
+
+} // namespace evm::runtime::jit
@@ -0,0 +1,56 @@
+#ifndef EVM_RUNTIME_JIT_OPTIMIZATIONS_H
+#define EVM_RUNTIME_JIT_OPTIMIZATIONS_H
+
+#include "runtime/jit/ir.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace evm::runtime::jit {
+
+/// Natural loop: header dominates all blocks of the loop and back edges come from latches
+struct Loop {
+    bool Contains(const BasicBlock *block) const
+    {
+        return blocks[block->id];
+    }
+
+    BasicBlock *header {nullptr};
+    BasicBlock *preheader {nullptr}; // the only predecessor outside the loop, null if there are several
+    std::vector<BasicBlock *> latches;
+    std::vector<bool> blocks; // by block id
+    size_t depth {1};         // nested loops have bigger depth
+};
+
+/// Dominators must be computed
+std::vector<Loop> FindLoops(const Graph &graph);
+
+/// Edge from block with several successors to block with several predecessors gets a block in between,
+/// so code can be placed on any edge
+void SplitCriticalEdges(Graph *graph);
+
+/// Length of array allocated with constant size is constant
+void FoldArrayLength(Graph *graph);
+
+/// Pure instructions and array checks with loop invariant inputs are moved to preheaders.
+/// Failed hoisted check exits to interpreter at the loop header.
+void HoistLoopInvariants(Graph *graph, const std::vector<Loop> &loops);
+
+/// Instructions and guards which are dominated by the same ones are removed
+void EliminateCommonSubexpressions(Graph *graph);
+
+/// Bounds checks of induction variables are removed if loop condition already checks them
+void EliminateBoundsChecks(Graph *graph, const std::vector<Loop> &loops);
+
+/// Objects which are used only by accesses to their fields in the block where they are allocated
+/// are not allocated: fields become SSA values
+void ReplaceNotEscapedObjects(Graph *graph);
+
+void EliminateDeadCode(Graph *graph);
+
+/// All passes in the order they depend on each other
+void RunOptimizations(Graph *graph);
+
+} // namespace evm::runtime::jit
+
+#endif // EVM_RUNTIME_JIT_OPTIMIZATIONS_H
@@ -0,0 +1,267 @@
+#include "runtime/jit/register_allocator.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace evm::runtime::jit {
+
+namespace {
+
+class BitVector {
+public:
+    explicit BitVector(size_t size = 0) : words_((size + BITS - 1) / BITS, 0) {}
+
+    bool Test(size_t idx) const
+    {
+        return (words_[idx / BITS] >> (idx % BITS)) & 1U;
+    }
+
+    void Set(size_t idx)
+    {
+        words_[idx / BITS] |= uint64_t {1} << (idx % BITS);
+    }
+
+    void Reset(size_t idx)
+    {
+        words_[idx / BITS] &= ~(uint64_t {1} << (idx % BITS));
+    }
+
+    // Returns true if the set is changed
+    bool Unite(const BitVector &other)
+    {
+        bool changed = false;
+        for (size_t i = 0; i < words_.size(); ++i) {
+            uint64_t word = words_[i] | other.words_[i];
+            changed |= word != words_[i];
+            words_[i] = word;
+        }
+        return changed;
+    }
+
+private:
+    static constexpr size_t BITS = 64;
+
+    std::vector<uint64_t> words_;
+};
+
+} // namespace
+
+void RegisterAllocator::Run()
+{
+    NumberInstructions();
+    BuildIntervals();
+    AllocateRegisters();
+}
+
+void RegisterAllocator::NumberInstructions()
+{
+    positions_.assign(graph_.GetNumInsts(), 0);
+    block_starts_.assign(graph_.GetBlocks().size(), 0);
+    block_ends_.assign(graph_.GetBlocks().size(), 0);
+
+    size_t idx = 0;
+    for (const BasicBlock *block : graph_.GetRpo()) {
+        assert(!block->insts.empty());
+        block_starts_[block->id] = 2 * idx;
+        for (const Inst *inst : block->insts) {
+            positions_[inst->id] = 2 * idx++;
+        }
+        block_ends_[block->id] = 2 * idx - 1;
+    }
+}
+
+void RegisterAllocator::BuildIntervals()
+{
+    size_t n_insts = graph_.GetNumInsts();
+    size_t n_blocks = graph_.GetBlocks().size();
+
+    std::vector<BitVector> uses(n_blocks, BitVector(n_insts));
+    std::vector<BitVector> defs(n_blocks, BitVector(n_insts));
+    std::vector<BitVector> phi_uses(n_blocks, BitVector(n_insts)); // by predecessor
+    std::vector<BitVector> live_in(n_blocks, BitVector(n_insts));
+    std::vector<BitVector> live_out(n_blocks, BitVector(n_insts));
+
+    auto for_each_use = [](const Inst *inst, auto &&visitor) {
+        for (const Inst *input : inst->inputs) {
+            visitor(input);
+        }
+        if (inst->state != nullptr) {
+            for (const auto &[reg, value] : inst->state->regs) {
+                visitor(value);
+            }
+        }
+    };
+
+    for (const BasicBlock *block : graph_.GetRpo()) {
+        for (const Inst *inst : block->insts) {
+            if (inst->opcode == IrOpcode::PHI) {
+                for (size_t i = 0; i < inst->inputs.size(); ++i) {
+                    if (IsAllocated(inst->inputs[i])) {
+                        phi_uses[block->preds[i]->id].Set(inst->inputs[i]->id);
+                    }
+                }
+            } else {
+                for_each_use(inst, [&uses, &defs, block](const Inst *input) {
+                    if (IsAllocated(input) && !defs[block->id].Test(input->id)) {
+                        uses[block->id].Set(input->id);
+                    }
+                });
+            }
+            if (IsAllocated(inst)) {
+                defs[block->id].Set(inst->id);
+            }
+        }
+    }
+
+    const auto &rpo = graph_.GetRpo();
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (auto it = rpo.rbegin(); it != rpo.rend(); ++it) {
+            const BasicBlock *block = *it;
+
+            BitVector out = phi_uses[block->id];
+            for (const BasicBlock *succ : block->succs) {
+                out.Unite(live_in[succ->id]);
+            }
+
+            BitVector in = uses[block->id];
+            for (size_t id = 0; id < n_insts; ++id) {
+                if (out.Test(id) && !defs[block->id].Test(id)) {
+                    in.Set(id);
+                }
+            }
+
+            changed |= live_out[block->id].Unite(out);
+            changed |= live_in[block->id].Unite(in);
+        }
+    }
+
+    // Hull of definition, uses and blocks where the value is live
+    std::vector<Interval> by_id(n_insts);
+    std::vector<bool> has_interval(n_insts, false);
+    auto extend = [&by_id, &has_interval](Inst *inst, size_t from, size_t to) {
+        Interval &interval = by_id[inst->id];
+        if (!has_interval[inst->id]) {
+            interval = {inst, from, to};
+            has_interval[inst->id] = true;
+            return;
+        }
+        interval.start = std::min(interval.start, from);
+        interval.end = std::max(interval.end, to);
+    };
+
+    for (const BasicBlock *block : rpo) {
+        for (Inst *inst : block->insts) {
+            if (inst->opcode == IrOpcode::PHI) {
+                for (size_t i = 0; i < inst->inputs.size(); ++i) {
+                    if (IsAllocated(inst->inputs[i])) {
+                        size_t pred_end = block_ends_[block->preds[i]->id];
+                        extend(inst->inputs[i], pred_end, pred_end);
+                    }
+                }
+            } else {
+                size_t use_pos = positions_[inst->id];
+                for_each_use(inst, [&extend, use_pos](const Inst *input) {
+                    if (IsAllocated(input)) {
+                        extend(const_cast<Inst *>(input), use_pos, use_pos);
+                    }
+                });
+            }
+        }
+    }
+
+    for (const BasicBlock *block : rpo) {
+        for (Inst *inst : block->insts) {
+            if (!IsAllocated(inst) || !has_interval[inst->id]) {
+                continue;
+            }
+            size_t def_pos = inst->opcode == IrOpcode::PHI ? block_starts_[block->id] : positions_[inst->id] + 1;
+            extend(inst, def_pos, def_pos);
+        }
+    }
+
+    for (const BasicBlock *block : rpo) {
+        for (size_t id = 0; id < n_insts; ++id) {
+            if (!has_interval[id]) {
+                continue;
+            }
+            if (live_in[block->id].Test(id)) {
+                extend(by_id[id].inst, block_starts_[block->id], block_starts_[block->id]);
+            }
+            if (live_out[block->id].Test(id)) {
+                extend(by_id[id].inst, block_ends_[block->id], block_ends_[block->id]);
+            }
+        }
+    }
+
+    intervals_.clear();
+    for (size_t id = 0; id < n_insts; ++id) {
+        if (has_interval[id]) {
+            intervals_.push_back(by_id[id]);
+        }
+    }
+}
+
+void RegisterAllocator::AllocateRegisters()
+{
+    locations_.assign(graph_.GetNumInsts(), Location {});
+    n_spill_slots_ = 0;
+
+    for (const BasicBlock *block : graph_.GetRpo()) {
+        for (const Inst *inst : block->insts) {
+            if (inst->opcode == IrOpcode::CONST) {
+                locations_[inst->id].kind = Location::Kind::CONST;
+            }
+        }
+    }
+
+    std::sort(intervals_.begin(), intervals_.end(), [](const Interval &lhs, const Interval &rhs) {
+        return lhs.start < rhs.start || (lhs.start == rhs.start && lhs.inst->id < rhs.inst->id);
+    });
+
+    auto spill = [this](const Interval &interval) {
+        Location &location = locations_[interval.inst->id];
+        location.kind = Location::Kind::STACK;
+        location.slot = static_cast<uint32_t>(n_spill_slots_++);
+    };
+
+    std::array<bool, ALLOCATABLE_REGS.size()> is_free {};
+    is_free.fill(true);
+    std::vector<std::pair<const Interval *, size_t>> active; // with index of register
+
+    for (const Interval &interval : intervals_) {
+        auto expired = std::remove_if(active.begin(), active.end(), [&is_free, &interval](const auto &entry) {
+            if (entry.first->end < interval.start) {
+                is_free[entry.second] = true;
+                return true;
+            }
+            return false;
+        });
+        active.erase(expired, active.end());
+
+        auto free_reg = std::find(is_free.begin(), is_free.end(), true);
+        if (free_reg != is_free.end()) {
+            auto reg_idx = static_cast<size_t>(free_reg - is_free.begin());
+            *free_reg = false;
+            locations_[interval.inst->id] = {Location::Kind::REG, ALLOCATABLE_REGS[reg_idx], 0};
+            active.emplace_back(&interval, reg_idx);
+            continue;
+        }
+
+        // Value which is live for the longest time goes to the stack
+        auto victim = std::max_element(active.begin(), active.end(), [](const auto &lhs, const auto &rhs) {
+            return lhs.first->end < rhs.first->end;
+        });
+        if (victim->first->end > interval.end) {
+            size_t reg_idx = victim->second;
+            spill(*victim->first);
+            locations_[interval.inst->id] = {Location::Kind::REG, ALLOCATABLE_REGS[reg_idx], 0};
+            *victim = {&interval, reg_idx};
+        } else {
+            spill(interval);
+        }
+    }
+}
+
+} // namespace evm::runtime::jit
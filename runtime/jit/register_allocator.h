@@ -0,0 +1,99 @@
+#ifndef EVM_RUNTIME_JIT_REGISTER_ALLOCATOR_H
+#define EVM_RUNTIME_JIT_REGISTER_ALLOCATOR_H
+
+#include "common/macros.h"
+#include "runtime/jit/assembler_x86_64.h"
+#include "runtime/jit/ir.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace evm::runtime::jit {
+
+struct Location {
+    enum class Kind : uint8_t {
+        NONE,  // value has no users
+        REG,
+        STACK, // spill slot
+        CONST, // rematerialized at each use
+    };
+
+    bool operator==(const Location &other) const
+    {
+        return kind == other.kind && (kind != Kind::REG || reg == other.reg) &&
+               (kind != Kind::STACK || slot == other.slot);
+    }
+
+    Kind kind {Kind::NONE};
+    Reg reg {Reg::RAX};
+    uint32_t slot {0};
+};
+
+/// Linear scan over blocks in reverse post order (Poletto, Sarkar "Linear Scan Register Allocation").
+/// Live interval of a value is the hull of all its live ranges, so each value has a single location
+/// in the whole compiled code, spilled values live on the stack.
+class RegisterAllocator {
+public:
+    // clang-format off
+    static constexpr std::array<Reg, 10> ALLOCATABLE_REGS = {
+        Reg::R12, Reg::R13, Reg::R14, Reg::R15, Reg::RCX, Reg::RSI, Reg::RDI, Reg::R8, Reg::R9, Reg::R10
+    };
+    /// Allocatable registers which are not preserved by calls of runtime helpers
+    static constexpr std::array<Reg, 6> CALLER_SAVED_REGS = {
+        Reg::RCX, Reg::RSI, Reg::RDI, Reg::R8, Reg::R9, Reg::R10
+    };
+    // clang-format on
+
+public:
+    NO_COPY_SEMANTIC(RegisterAllocator);
+    NO_MOVE_SEMANTIC(RegisterAllocator);
+
+    explicit RegisterAllocator(const Graph &graph) : graph_(graph) {}
+    ~RegisterAllocator() = default;
+
+    void Run();
+
+    const Location &GetLocation(const Inst *inst) const
+    {
+        return locations_[inst->id];
+    }
+
+    size_t GetNumSpillSlots() const
+    {
+        return n_spill_slots_;
+    }
+
+private:
+    struct Interval {
+        Inst *inst {nullptr};
+        size_t start {0};
+        size_t end {0};
+    };
+
+    static bool IsAllocated(const Inst *inst)
+    {
+        return inst->HasResult() && inst->opcode != IrOpcode::CONST;
+    }
+
+    void NumberInstructions();
+    void BuildIntervals();
+    void AllocateRegisters();
+
+private:
+    const Graph &graph_;
+
+    // Instruction i uses its inputs at 2 * i and defines its value at 2 * i + 1
+    std::vector<size_t> positions_;    // by instruction id
+    std::vector<size_t> block_starts_; // by block id
+    std::vector<size_t> block_ends_;
+
+    std::vector<Interval> intervals_;
+    std::vector<Location> locations_;
+    size_t n_spill_slots_ {0};
+};
+
+} // namespace evm::runtime::jit
+
+#endif // EVM_RUNTIME_JIT_REGISTER_ALLOCATOR_H
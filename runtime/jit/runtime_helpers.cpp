@@ -0,0 +1,64 @@
+#include "runtime/jit/runtime_helpers.h"
+#include "common/utils/bitops.h"
+#include "runtime/interpreter/interpreter-inl.h"
+#include "runtime/memory/class_description.h"
+#include "runtime/memory/types/array.h"
+#include "runtime/memory/types/class.h"
+#include "runtime/runtime.h"
+
+#include <cstdio>
+
+namespace evm::runtime::jit {
+
+int64_t JitNewArray(int64_t type, int64_t size)
+{
+    return HandleCreateArrayObject(static_cast<hword_t>(type), static_cast<int32_t>(size));
+}
+
+int64_t JitNewObject(const void *class_description, void *asm_class)
+{
+    // Same as HandleCreateObject(), but class description is found at compile time
+    auto *heap_manager = Runtime::GetInstance()->GetHeapManager();
+    auto *descr = const_cast<ClassDescription *>(static_cast<const ClassDescription *>(class_description));
+    auto *cls = static_cast<file_format::Class *>(asm_class);
+
+    auto *class_obj =
+        static_cast<types::Class *>(heap_manager->AllocateObject(sizeof(ObjectHeader) + descr->GetClassSize()));
+    if (class_obj == nullptr) {
+        PrintErr("Cannot create class object for \"", cls->GetName(), "\"");
+        UNREACHABLE();
+    }
+
+    class_obj->SetClassWord(descr);
+    class_obj->InitFields(*cls);
+    return reinterpret_cast<int64_t>(class_obj);
+}
+
+void JitStoreReference(int64_t array, int64_t idx, int64_t value)
+{
+    HandleStoreToReferenceArray(reinterpret_cast<types::Array *>(array), idx, value);
+}
+
+void JitSetReferenceField(int64_t obj, int64_t field_idx, int64_t value)
+{
+    HandleObjSetField(static_cast<int16_t>(field_idx), value, obj);
+}
+
+void JitPrintInt(int64_t value)
+{
+    printf("%ld\n", value);
+}
+
+void JitPrintDouble(int64_t value)
+{
+    printf("%lf\n", bitops::BitCast<double>(value));
+}
+
+void JitSafepoint(JitContext *ctx)
+{
+    auto n_instrs = static_cast<size_t>(ctx->gc_period - ctx->gc_countdown);
+    ctx->gc_countdown = ctx->gc_period;
+    Runtime::GetInstance()->GetGC()->UpdateState(n_instrs);
+}
+
+} // namespace evm::runtime::jit
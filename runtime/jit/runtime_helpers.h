@@ -0,0 +1,56 @@
+#ifndef EVM_RUNTIME_JIT_RUNTIME_HELPERS_H
+#define EVM_RUNTIME_JIT_RUNTIME_HELPERS_H
+
+#include "common/macros.h"
+#include "runtime/memory/reg.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace evm::runtime::jit {
+
+/// State shared by compiled code and runtime, its address is kept in a fixed register of compiled code
+struct JitContext {
+    int64_t gc_countdown {0}; // instructions until the next call of GC
+    int64_t gc_period {0};
+    Register *accum {nullptr};
+    bool *accum_root {nullptr};
+    bool is_deoptimized {false}; // set by failed guards, runtime clears it
+
+    static constexpr uint32_t GetIsDeoptimizedOffset()
+    {
+        return MEMBER_OFFSET(JitContext, is_deoptimized);
+    }
+
+    static constexpr uint32_t GetGcCountdownOffset()
+    {
+        return MEMBER_OFFSET(JitContext, gc_countdown);
+    }
+
+    static constexpr uint32_t GetAccumOffset()
+    {
+        return MEMBER_OFFSET(JitContext, accum);
+    }
+
+    static constexpr uint32_t GetAccumRootOffset()
+    {
+        return MEMBER_OFFSET(JitContext, accum_root);
+    }
+};
+
+// Slow paths of compiled code: they have the same semantics as the handlers of interpreter.
+// All values are passed as raw 64-bit register values.
+
+int64_t JitNewArray(int64_t type, int64_t size);
+int64_t JitNewObject(const void *class_description, void *asm_class);
+void JitStoreReference(int64_t array, int64_t idx, int64_t value);
+void JitSetReferenceField(int64_t obj, int64_t field_idx, int64_t value);
+void JitPrintInt(int64_t value);
+void JitPrintDouble(int64_t value);
+
+/// Compiled code counts executed instructions on back edges and passes them to GC in batches
+void JitSafepoint(JitContext *ctx);
+
+} // namespace evm::runtime::jit
+
+#endif // EVM_RUNTIME_JIT_RUNTIME_HELPERS_H
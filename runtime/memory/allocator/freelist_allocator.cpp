@@ -1,5 +1,6 @@
 #include "common/logs.h"
 #include "runtime/memory/allocator/freelist_allocator.h"
+#include <algorithm>
 #include <cstdio>
 
 namespace evm::runtime {
@@ -14,8 +15,7 @@ void *FreelistAllocator::Alloc(size_t size)
     Node *prev_node = nullptr;
     Node *found_memory_node = FindFirstFit(size, &prev_node);
     if (found_memory_node == nullptr) {
-        PrintErr("Allocation failed: no fitting blocks for size ", size);
-        return nullptr;
+        return nullptr; // heap manager grows the heap or reports the failure
     }
 
     uint64_t remainder_block_size = found_memory_node->block_size_ - size;
@@ -58,7 +58,7 @@ void FreelistAllocator::Dealloc(void *ptr)
     node->block_size_ = block_size;
     node->next_ = nullptr;
 
-    PrintLog("Dealloc ", block_size, " ptr ", (long)ptr);
+    PrintLogCat(MEMORY, "Dealloc ", block_size, " ptr ", (long)ptr);
 
     if (tail_node_ == nullptr) {
         // It means that all memory was allocated
@@ -72,6 +72,77 @@ void FreelistAllocator::Dealloc(void *ptr)
     used_memory_size_ -= (node->block_size_ + sizeof(AllocationHeader));
 }
 
+FreeListStats FreelistAllocator::GetFreeListStats() const
+{
+    FreeListStats stats;
+    for (const Node *node = head_node_; node != nullptr; node = node->next_) {
+        ++stats.n_free_blocks;
+        stats.free_bytes += node->block_size_;
+        stats.largest_free_block = std::max(stats.largest_free_block, node->block_size_);
+    }
+    return stats;
+}
+
+void FreelistAllocator::AddFreeRange(const FreeRange &range)
+{
+    auto *node = reinterpret_cast<Node *>(range.start);
+    node->block_size_ = range.size - sizeof(AllocationHeader);
+    node->next_ = head_node_;
+    head_node_ = node;
+    if (tail_node_ == nullptr) {
+        tail_node_ = node;
+    }
+    heap_capacity_ += range.size;
+}
+
+void FreelistAllocator::RemoveFreeRanges(const std::vector<FreeRange> &ranges)
+{
+    Node *node = head_node_;
+    head_node_ = nullptr;
+    tail_node_ = nullptr;
+
+    // List is rebuilt in the same order from pieces of blocks out of the ranges
+    while (node != nullptr) {
+        Node *next_node = node->next_;
+        auto *piece = reinterpret_cast<uint8_t *>(node);
+        uint8_t *block_end = piece + sizeof(AllocationHeader) + node->block_size_;
+
+        auto range = std::upper_bound(ranges.begin(), ranges.end(), piece, [](uint8_t *ptr, const FreeRange &r) {
+            return ptr < r.start + r.size;
+        });
+        for (; range != ranges.end() && range->start < block_end; ++range) {
+            if (range->start > piece) {
+                AppendNode(piece, range->start - piece);
+            }
+            piece = std::max(piece, range->start + range->size);
+        }
+        if (piece < block_end) {
+            AppendNode(piece, block_end - piece);
+        }
+        node = next_node;
+    }
+
+    for (const FreeRange &range : ranges) {
+        heap_capacity_ -= range.size;
+    }
+}
+
+void FreelistAllocator::AppendNode(uint8_t *start, size_t size)
+{
+    if (size < sizeof(Node)) {
+        return;
+    }
+    auto *node = reinterpret_cast<Node *>(start);
+    node->block_size_ = size - sizeof(AllocationHeader);
+    node->next_ = nullptr;
+    if (tail_node_ == nullptr) {
+        head_node_ = node;
+    } else {
+        tail_node_->next_ = node;
+    }
+    tail_node_ = node;
+}
+
 Node *FreelistAllocator::FindFirstFit(size_t size, Node **previous_node)
 {
     assert(head_node_ != nullptr);
@@ -5,6 +5,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 namespace evm::runtime {
 
@@ -17,6 +18,19 @@ struct Node {
     size_t block_size_ {0};
 };
 
+/// Free blocks of the allocator, blocks aren't coalesced so the list gets fragmented
+struct FreeListStats {
+    size_t n_free_blocks {0};
+    size_t free_bytes {0}; // without headers of blocks
+    size_t largest_free_block {0};
+};
+
+/// Memory [start, start + size) of the heap
+struct FreeRange {
+    uint8_t *start {nullptr};
+    size_t size {0};
+};
+
 class FreelistAllocator final : public AllocatorBase {
 public:
     NO_COPY_SEMANTIC(FreelistAllocator);
@@ -47,6 +61,24 @@ public:
         return used_memory_size_;
     }
 
+    /// Walks the whole free list
+    FreeListStats GetFreeListStats() const;
+
+    /// Memory out of the heap becomes one free block, it's taken by allocations before the rest of the list
+    void AddFreeRange(const FreeRange &range);
+
+    /// Cuts ranges out of free blocks, ranges are sorted by address and must not overlap allocated blocks.
+    /// Walks the whole free list, pieces of blocks too small to be nodes are lost
+    void RemoveFreeRanges(const std::vector<FreeRange> &ranges);
+
+    /// Size of the block allocated for ptr, may be bigger than the requested one
+    static size_t GetBlockSize(const void *ptr)
+    {
+        return reinterpret_cast<const AllocationHeader *>(static_cast<const uint8_t *>(ptr) -
+                                                          sizeof(AllocationHeader))
+            ->block_size;
+    }
+
 private:
     Node *FindFirstFit(size_t size, Node **previous_node);
 
@@ -54,6 +86,8 @@ private:
 
     void InsertNode(Node *prev_node, Node *new_node);
 
+    void AppendNode(uint8_t *start, size_t size);
+
 private:
     uint8_t *heap_ {nullptr};
     size_t heap_capacity_ {0};
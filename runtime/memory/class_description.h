@@ -8,6 +8,16 @@
 
 namespace evm::runtime {
 
+// clang-format off
+/// Storage kind of array elements: chosen once when array class description is created,
+/// so array accessors don't need to resolve the element type on each access
+enum class ArrayElementKind : uint8_t {
+    NONE      = 0, // not an array
+    PRIMITIVE = 1, // int or double, both are stored as raw 64-bit register values
+    REFERENCE = 2,
+};
+// clang-format on
+
 class ClassDescription {
 public:
     NO_MOVE_SEMANTIC(ClassDescription);
@@ -36,6 +46,11 @@ public:
         element_type_ = array_element_type;
     }
 
+    void SetArrayElementKind(ArrayElementKind array_element_kind)
+    {
+        element_kind_ = array_element_kind;
+    }
+
     bool IsStringObject() const
     {
         return object_type_ == memory::Type::STRING_OBJECT;
@@ -56,6 +71,21 @@ public:
         return element_type_;
     }
 
+    ArrayElementKind GetArrayElementKind() const
+    {
+        return element_kind_;
+    }
+
+    bool IsReferenceArray() const
+    {
+        return element_kind_ == ArrayElementKind::REFERENCE;
+    }
+
+    static constexpr uint32_t GetArrayElementKindOffset()
+    {
+        return MEMBER_OFFSET(ClassDescription, element_kind_);
+    }
+
     size_t GetFieldsNum() const
     {
         return fields_num_;
@@ -68,7 +98,8 @@ public:
 
     const Field &GetField(size_t field_idx)
     {
-        PrintLog("fields_num = ", fields_num_, ", fields_ptr = ", (long)fields_, ", field_idx = ", field_idx);
+        PrintLogCat(OBJECTS, "fields_num = ", fields_num_, ", fields_ptr = ", (long)fields_,
+                    ", field_idx = ", field_idx);
         assert(field_idx < fields_num_);
         return fields_[field_idx];
     }
@@ -80,6 +111,7 @@ private:
     // element_type_ used only for array
     // if array consists from primitive types then in element_type_ will be write this type
     memory::Type element_type_ {memory::Type::INVALID};
+    ArrayElementKind element_kind_ {ArrayElementKind::NONE};
 
     memory::Type object_type_ {memory::Type::INVALID};
 };
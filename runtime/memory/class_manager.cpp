@@ -2,6 +2,7 @@
 #include "runtime/memory/field.h"
 #include "runtime/memory/class_manager.h"
 #include "runtime/memory/class_description.h"
+#include "runtime/memory/type.h"
 #include "file_format/class_section.h"
 
 #include <cassert>
@@ -16,6 +17,32 @@ ClassDescription *ClassManager::GetClassDescriptionFromCache(const std::string &
     return nullptr;
 }
 
+const std::string *ClassManager::GetClassName(const ClassDescription *class_descr) const
+{
+    for (const auto &[name, descr] : class_description_cache_) {
+        if (descr == class_descr) {
+            return &name;
+        }
+    }
+    return nullptr;
+}
+
+std::string ClassManager::GetDisplayName(const ClassDescription *class_descr) const
+{
+    if (class_descr == nullptr) {
+        return "<unknown>";
+    }
+    if (class_descr->IsStringObject()) {
+        return "str";
+    }
+    if (class_descr->IsArrayObject()) {
+        bool is_primitive = class_descr->GetArrayElementKind() == ArrayElementKind::PRIMITIVE;
+        return (is_primitive ? memory::GetStringFromType(class_descr->GetArrayElementType()) : "obj") + "[]";
+    }
+    const std::string *name = GetClassName(class_descr);
+    return name != nullptr ? *name : "<unknown>";
+}
+
 ClassDescription *ClassManager::CreateClassDescription(file_format::Class &asm_class)
 {
     auto *heap_manager = Runtime::GetInstance()->GetHeapManager();
@@ -46,8 +73,8 @@ std::pair<Field *, size_t> ClassManager::CreateFields(file_format::Class &asm_cl
         auto [relative_offset, size] = asm_class.GetRuntimeOffsetOfInstance(current_asm_field.GetName());
         auto type = current_asm_field.GetType();
 
-        PrintLog("relative_offset =  = ", relative_offset, "field_size = ", size,
-                 ", type = ", static_cast<int16_t>(type));
+        PrintLogCat(OBJECTS, "relative_offset =  = ", relative_offset, "field_size = ", size,
+                    ", type = ", static_cast<int16_t>(type));
 
         new (&runtime_fields[idx]) Field(type, size, relative_offset);
     }
@@ -73,15 +100,18 @@ void ClassManager::CreateDefaultClassDescription(DefaultClassDescr default_class
         case DefaultClassDescr::INT_ARRAY:
             class_descr->SetObjectType(memory::Type::ARRAY_OBJECT);
             class_descr->SetArrayElementType(memory::Type::INT);
+            class_descr->SetArrayElementKind(ArrayElementKind::PRIMITIVE);
             break;
 
         case DefaultClassDescr::DOUBLE_ARRAY:
             class_descr->SetObjectType(memory::Type::ARRAY_OBJECT);
             class_descr->SetArrayElementType(memory::Type::DOUBLE);
+            class_descr->SetArrayElementKind(ArrayElementKind::PRIMITIVE);
             break;
 
         case DefaultClassDescr::OBJECT_ARRAY:
             class_descr->SetObjectType(memory::Type::ARRAY_OBJECT);
+            class_descr->SetArrayElementKind(ArrayElementKind::REFERENCE);
             break;
 
         case DefaultClassDescr::STRING:
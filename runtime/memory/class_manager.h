@@ -33,6 +33,12 @@ public:
     ClassDescription *GetClassDescriptionFromCache(const std::string &class_name);
     ClassDescription *CreateClassDescription(file_format::Class &asm_class);
 
+    /// Name of a user-defined class, nullptr for descriptions which aren't created from the class section
+    const std::string *GetClassName(const ClassDescription *class_descr) const;
+
+    /// Name of any class for reports: user-defined classes, "str", and arrays as "int[]", "double[]", "obj[]"
+    std::string GetDisplayName(const ClassDescription *class_descr) const;
+
     void InitDefaultClassDescriptions();
 
     ClassDescription *GetDefaultClassDescription(DefaultClassDescr default_class_descr_type)
@@ -5,6 +5,7 @@
 #include "runtime/memory/reg.h"
 
 #include <array>
+#include <cassert>
 #include <cstddef>
 #include <bitset>
 
@@ -24,17 +25,48 @@ public:
 
     ~Frame() = default;
 
-    Register *GetReg(size_t reg_idx);
-    const Register *GetReg(size_t reg_idx) const;
+    // Register accessors are inline: they are used by every instruction of interpreted and compiled code
+
+    Register *GetReg(size_t reg_idx)
+    {
+        assert(reg_idx < regs_.size());
+        return &regs_[reg_idx];
+    }
+
+    const Register *GetReg(size_t reg_idx) const
+    {
+        assert(reg_idx < regs_.size());
+        return &regs_[reg_idx];
+    }
 
     size_t GetRestorePC() const;
     void SetRestorePC(size_t pc);
 
-    bool IsRegMarked(size_t reg_idx) const;
-    void MarkReg(size_t reg_idx, bool is_root = true);
+    bool IsRegMarked(size_t reg_idx) const
+    {
+        assert(reg_idx < regs_.size());
+        return obj_regs_indicators_[reg_idx];
+    }
+
+    void MarkReg(size_t reg_idx, bool is_root = true)
+    {
+        assert(reg_idx < regs_.size());
+        obj_regs_indicators_.set(reg_idx, is_root);
+    }
 
     const std::bitset<N_FRAME_REGS_DEFAULT> &GetObjectBitMask() const;
 
+    // Layout of the frame for JIT compiled code, which accesses registers and root bits directly
+    static constexpr uint32_t GetRegsOffset()
+    {
+        return MEMBER_OFFSET(Frame, regs_);
+    }
+
+    static constexpr uint32_t GetObjectBitMaskOffset()
+    {
+        return MEMBER_OFFSET(Frame, obj_regs_indicators_);
+    }
+
 private:
     std::array<Register, N_FRAME_REGS_DEFAULT> regs_;
     std::bitset<N_FRAME_REGS_DEFAULT> obj_regs_indicators_;
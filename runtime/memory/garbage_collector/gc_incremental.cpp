@@ -1,13 +1,18 @@
 #include "common/logs.h"
+#include "common/perf_counters.h"
+#include "common/trace.h"
 #include "runtime/memory/garbage_collector/gc_incremental.h"
 #include "runtime/memory/frame.h"
 #include "runtime/memory/types/array.h"
 #include "runtime/runtime.h"
 #include "runtime/memory/type.h"
 #include "runtime/memory/types/class.h"
+#include "runtime/profiler/allocation_profiler.h"
 
-#include <vector>
+#include <algorithm>
 #include <bitset>
+#include <chrono>
+#include <vector>
 
 namespace evm::runtime {
 
@@ -37,6 +42,8 @@ void GarbageCollectorIncremental::MarkRootAccum()
 
 void GarbageCollectorIncremental::MarkRoots()
 {
+    trace::ScopedTrace trace_scope(trace::EventKind::GC_BEGIN, trace::EventKind::GC_END,
+                                   static_cast<uint8_t>(trace::GcPhase::ROOTS));
     auto interpreter = runtime::Runtime::GetInstance()->GetInterpreter();
 
     const std::vector<Frame> &frames = interpreter->GetFramesStack();
@@ -49,6 +56,9 @@ void GarbageCollectorIncremental::MarkRoots()
 
 void GarbageCollectorIncremental::MarkStep()
 {
+    trace::ScopedTrace trace_scope(trace::EventKind::GC_BEGIN, trace::EventKind::GC_END,
+                                   static_cast<uint8_t>(trace::GcPhase::MARK));
+    perf::ScopedPerfPhase perf_phase(perf::Phase::GC_MARK);
     MarkRoots();
 
     if (n_completed_marks_ == 0) { // first mark in sweep-phase should only mark roots
@@ -105,18 +115,15 @@ void GarbageCollectorIncremental::VisitNeighbours(ObjectHeader *obj)
         }
         case memory::Type::ARRAY_OBJECT: {
             types::Array *array = reinterpret_cast<types::Array *>(obj);
-            memory::Type array_type = class_word->GetArrayElementType();
             size_t length = array->GetLength();
 
-            if (memory::IsReferenceType(array_type)) {
+            if (class_word->IsReferenceArray()) {
                 for (size_t i = 0; i < length; ++i) {
-                    int64_t obj_ptr_val = 0;
-                    array->Get(&obj_ptr_val, i);
-                    if (obj_ptr_val == 0) {
+                    ObjectHeader *obj_ptr = array->GetReference(i);
+                    if (obj_ptr == nullptr) {
                         continue;
                     }
 
-                    ObjectHeader *obj_ptr = reinterpret_cast<ObjectHeader *>(obj_ptr_val);
                     if (obj_ptr->GetMarkWord().mark == 0) {                // white object
                         obj_ptr->SetMarkWord({.mark = 1, .neighbour = 0}); // make object grey
                         grey_objects_.push(obj_ptr);
@@ -134,6 +141,9 @@ void GarbageCollectorIncremental::VisitNeighbours(ObjectHeader *obj)
 
 void GarbageCollectorIncremental::MarkFinalize()
 {
+    trace::ScopedTrace trace_scope(trace::EventKind::GC_BEGIN, trace::EventKind::GC_END,
+                                   static_cast<uint8_t>(trace::GcPhase::MARK_FINALIZE));
+    perf::ScopedPerfPhase perf_phase(perf::Phase::GC_MARK);
     while (!grey_objects_.empty()) {
         ObjectHeader *grey_obj = grey_objects_.front();
 
@@ -148,6 +158,9 @@ void GarbageCollectorIncremental::MarkFinalize()
 
 void GarbageCollectorIncremental::Sweep()
 {
+    trace::ScopedTrace trace_scope(trace::EventKind::GC_BEGIN, trace::EventKind::GC_END,
+                                   static_cast<uint8_t>(trace::GcPhase::SWEEP));
+    perf::ScopedPerfPhase perf_phase(perf::Phase::GC_SWEEP);
     auto runtime = runtime::Runtime::GetInstance();
     auto heap_manager = runtime->GetHeapManager();
     auto objects_list = heap_manager->GetObjectsList();
@@ -157,12 +170,17 @@ void GarbageCollectorIncremental::Sweep()
             obj->SetMarkWord({.mark = 0});
         } else {
             heap_manager->DeallocateObject(obj);
-            PrintLog(long(obj->GetClassWord()->GetObjectType()));
+            PrintLogCat(MEMORY, long(obj->GetClassWord()->GetObjectType()));
         }
     }
+    heap_manager->ResizeAfterSweep();
 
     n_completed_sweeps_++;
 
+    if (UNLIKELY(heap_manager->GetAllocationProfiler() != nullptr)) {
+        heap_manager->GetAllocationProfiler()->RecordGcCycle();
+    }
+
     return;
 }
 
@@ -189,12 +207,48 @@ void GarbageCollectorIncremental::UpdateState()
 {
     instrs_counter_++;
     if (UNLIKELY((instrs_counter_ % n_instr_frequency_) == 0)) {
-        MarkStep();
+        RunStep();
+    }
+}
+
+void GarbageCollectorIncremental::UpdateState(size_t n_instrs)
+{
+    while (n_instrs > 0) {
+        size_t until_mark = n_instr_frequency_ - instrs_counter_ % n_instr_frequency_;
+        if (n_instrs < until_mark) {
+            instrs_counter_ += n_instrs;
+            return;
+        }
+
+        n_instrs -= until_mark;
+        instrs_counter_ += until_mark;
+        RunStep();
     }
+}
 
-    if (UNLIKELY(instrs_counter_ == (n_instr_frequency_ * N_MARKS_SWEEP_PERIOD_RATIO))) {
+void GarbageCollectorIncremental::RequestCollection()
+{
+    // Counter is moved to the end of the period, so the step of the next instruction marks and sweeps
+    size_t period = n_instr_frequency_ * N_MARKS_SWEEP_PERIOD_RATIO;
+    if (instrs_counter_ + 1 < period) {
+        n_skipped_instrs_ += period - 1 - instrs_counter_;
+        instrs_counter_ = period - 1;
+    }
+}
+
+void GarbageCollectorIncremental::RunStep()
+{
+    auto begin = std::chrono::steady_clock::now();
+    MarkStep();
+    if (instrs_counter_ == (n_instr_frequency_ * N_MARKS_SWEEP_PERIOD_RATIO)) {
         CleanMemory();
     }
+    auto pause = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin);
+
+    auto pause_ns = static_cast<uint64_t>(pause.count());
+    n_pauses_++;
+    pause_ns_ += pause_ns;
+    max_pause_ns_ = std::max(max_pause_ns_, pause_ns);
 }
 
 void GarbageCollectorIncremental::CleanMemory()
@@ -203,10 +257,39 @@ void GarbageCollectorIncremental::CleanMemory()
         MarkFinalize();
     }
 
+    if (UNLIKELY(census_callback_)) {
+        census_callback_(HeapCensus::Take(*Runtime::GetInstance()->GetHeapManager(), n_completed_sweeps_));
+    }
     Sweep();
 
     n_completed_marks_ = 0;
+    n_counted_instrs_ += instrs_counter_;
     instrs_counter_ = 0;
 }
 
+HeapCensus GarbageCollectorIncremental::TakeHeapCensus()
+{
+    // Roots are marked again in case the current cycle hasn't reached them yet
+    MarkRoots();
+    MarkFinalize();
+    HeapCensus census = HeapCensus::Take(*Runtime::GetInstance()->GetHeapManager(), n_completed_sweeps_);
+    Sweep();
+
+    n_completed_marks_ = 0;
+    n_counted_instrs_ += instrs_counter_;
+    instrs_counter_ = 0;
+    return census;
+}
+
+GarbageCollectorIncremental::Stats GarbageCollectorIncremental::GetStats() const
+{
+    Stats stats;
+    stats.n_instrs = n_counted_instrs_ + instrs_counter_ - n_skipped_instrs_;
+    stats.n_cycles = n_completed_sweeps_;
+    stats.n_pauses = n_pauses_;
+    stats.pause_ns = pause_ns_;
+    stats.max_pause_ns = max_pause_ns_;
+    return stats;
+}
+
 } // namespace evm::runtime
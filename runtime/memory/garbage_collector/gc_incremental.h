@@ -4,8 +4,10 @@
 #include "runtime/memory/garbage_collector/gc_base.h"
 #include "runtime/memory/object_header.h"
 #include "runtime/memory/frame.h"
+#include "runtime/profiler/heap_census.h"
 
 #include <fstream>
+#include <functional>
 #include <queue>
 
 namespace evm::runtime {
@@ -17,6 +19,15 @@ public:
     static constexpr size_t N_MARKS_SWEEP_PERIOD_RATIO = 30;
     static constexpr size_t N_HANDLING_GREY_OBJECTS = 10; // per MarkStep()
 
+    /// Totals since creation of the collector. Pause is a step of GC taken between two instructions
+    struct Stats {
+        size_t n_instrs {0}; // executed instructions reported by interpreter and compiled code
+        size_t n_cycles {0};
+        size_t n_pauses {0};
+        uint64_t pause_ns {0};
+        uint64_t max_pause_ns {0};
+    };
+
 public:
     NO_COPY_SEMANTIC(GarbageCollectorIncremental);
     NO_MOVE_SEMANTIC(GarbageCollectorIncremental);
@@ -25,14 +36,34 @@ public:
     ~GarbageCollectorIncremental() {}
 
     void UpdateState();
+    /// Same as n_instrs calls of UpdateState(), used by compiled code which counts instructions in batches
+    void UpdateState(size_t n_instrs);
     void CleanMemory();
 
+    /// Cycle is finished by the next step, e.g. when the heap is full. Heap can't be collected in allocations:
+    /// objects under construction aren't reachable from roots yet
+    void RequestCollection();
+
     bool SetInstrsFrequency(size_t n_instr_frequency);
     size_t GetInstrsFrequency() const;
 
     void AddGreyObject(ObjectHeader *obj);
 
+    /// Callback gets census of the heap in each cycle between marking and sweep, empty one disables censuses
+    void SetHeapCensusCallback(std::function<void(const HeapCensus &)> callback)
+    {
+        census_callback_ = std::move(callback);
+    }
+
+    /// Collects garbage at once and returns census of the heap after marking
+    HeapCensus TakeHeapCensus();
+
+    Stats GetStats() const;
+
 private:
+    // Mark step with sweep at the end of the period, timed as one pause
+    void RunStep();
+
     void MarkRootAccum();
     void MarkRootsOfFrame(const Frame &frame);
     void MarkRoots();
@@ -50,8 +81,16 @@ private:
     size_t n_completed_marks_ {0}; // cleaned up after each sweep
     size_t n_completed_sweeps_ {0};
 
+    size_t n_counted_instrs_ {0}; // instructions of the periods before the current one
+    size_t n_skipped_instrs_ {0}; // added to counters by requested collections, not executed
+    size_t n_pauses_ {0};
+    uint64_t pause_ns_ {0};
+    uint64_t max_pause_ns_ {0};
+
     std::queue<ObjectHeader *> grey_objects_;
 
+    std::function<void(const HeapCensus &)> census_callback_;
+
 #ifdef GC_INCREMENTAL_DEBUG_ON
     std::ofstream dump_file_;
 #endif // GC_INCREMENTAL_DEBUG_ON
@@ -58,6 +58,7 @@ void GarbageCollectorSTW::Sweep()
             heap_manager->DeallocateObject(obj);
         }
     }
+    heap_manager->ResizeAfterSweep();
 
     n_completed_sweeps_++;
 
@@ -120,10 +121,10 @@ void GarbageCollectorSTW::MarkObjectRecursive(ObjectHeader *obj)
         }
         case memory::Type::ARRAY_OBJECT: {
             types::Array *array = reinterpret_cast<types::Array *>(obj);
-            memory::Type array_type = class_word->GetArrayElementType();
             size_t length = array->GetLength();
 
 #ifdef GC_STW_DEBUG_ON
+            memory::Type array_type = class_word->GetArrayElementType();
             size_t array_type_size = GetSizeOfType(array_type);
 
             dump_file_ << "\tsubgraph cluster_arr_" << long(obj) << " {" << std::endl
@@ -140,12 +141,11 @@ void GarbageCollectorSTW::MarkObjectRecursive(ObjectHeader *obj)
             dump_file_ << "\t}\n" << std::endl;
 #endif // GC_STW_DEBUG_ON
 
-            if (memory::IsReferenceType(array_type)) {
+            if (class_word->IsReferenceArray()) {
                 for (size_t i = 0; i < length; ++i) {
-                    int64_t obj_ptr = 0;
-                    array->Get(&obj_ptr, i);
-                    if (obj_ptr != 0) {
-                        MarkObjectRecursive(reinterpret_cast<ObjectHeader *>(obj_ptr));
+                    ObjectHeader *obj_ptr = array->GetReference(i);
+                    if (obj_ptr != nullptr) {
+                        MarkObjectRecursive(obj_ptr);
 
 #ifdef GC_STW_DEBUG_ON
                         dump_file_ << "\tel_" << long(reinterpret_cast<uint8_t *>(array) + i * array_type_size)
@@ -1,40 +1,63 @@
 #include "common/logs.h"
+#include "common/trace.h"
 #include "runtime/memory/heap_manager.h"
 #include "runtime/memory/allocator/freelist_allocator.h"
 #include "runtime/memory/allocator/bump_allocator.h"
 #include "runtime/memory/object_header.h"
+#include "runtime/profiler/allocation_profiler.h"
+#include "runtime/runtime.h"
 
+#include <algorithm>
 #include <sys/mman.h>
 #include <unordered_set>
 
 namespace evm::runtime {
 
-HeapManager::HeapManager(size_t size) : heap_size_(size)
+HeapManager::HeapManager(size_t min_heap_size, size_t max_heap_size)
 {
-    heap_ =
-        static_cast<uint8_t *>(mmap(nullptr, heap_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
-    if (heap_ == nullptr) {
-        PrintErr("Failed to mmap heap, errno = ", errno);
+    auto round_up = [](size_t size) { return (size + CHUNK_SIZE - 1) / CHUNK_SIZE * CHUNK_SIZE; };
+    min_heap_size_ = std::max(round_up(min_heap_size), CHUNK_SIZE);
+    max_heap_size_ = std::max(round_up(max_heap_size), min_heap_size_);
+
+    // Reserved address space takes neither memory nor swap till it's committed
+    void *heap = mmap(nullptr, max_heap_size_, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (heap == MAP_FAILED) {
+        PrintErr("Failed to reserve heap of ", max_heap_size_, " bytes, errno = ", errno);
+        return;
+    }
+    heap_ = static_cast<uint8_t *>(heap);
+    if (mprotect(heap_, min_heap_size_, PROT_READ | PROT_WRITE) != 0) {
+        PrintErr("Failed to commit heap, errno = ", errno);
         return;
     }
 
-    object_allocator_ = std::make_unique<FreelistAllocator>(heap_, heap_size_);
+    size_t n_chunks = max_heap_size_ / CHUNK_SIZE;
+    chunk_states_.assign(n_chunks, ChunkState::RESERVED);
+    std::fill_n(chunk_states_.begin(), min_heap_size_ / CHUNK_SIZE, ChunkState::COMMITTED);
+    chunk_used_bytes_.assign(n_chunks, 0);
+    committed_size_ = min_heap_size_;
+
+    object_allocator_ = std::make_unique<FreelistAllocator>(heap_, committed_size_);
 
-    internal_heap_ = static_cast<uint8_t *>(
-        mmap(nullptr, heap_size_ / 4, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
-    if (internal_heap_ == nullptr) {
+    void *internal_heap =
+        mmap(nullptr, INTERNAL_HEAP_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (internal_heap == MAP_FAILED) {
         PrintErr("Failed to mmap internal heap, errno = ", errno);
         return;
     }
-    internal_allocator_ = std::make_unique<BumpAllocator>(internal_heap_, heap_size_ / 4);
+    internal_heap_ = static_cast<uint8_t *>(internal_heap);
+    internal_allocator_ = std::make_unique<BumpAllocator>(internal_heap_, INTERNAL_HEAP_SIZE);
 }
 
 HeapManager::~HeapManager()
 {
-    int success = munmap(heap_, heap_size_);
-    if (success == -1) {
+    if (heap_ != nullptr && munmap(heap_, max_heap_size_) == -1) {
         PrintErr("Errors in munmap, errno = ", errno);
     }
+    // Runtime may be created again in the same process, e.g. by benchmarks
+    if (internal_heap_ != nullptr && munmap(internal_heap_, INTERNAL_HEAP_SIZE) == -1) {
+        PrintErr("Errors in munmap of internal heap, errno = ", errno);
+    }
 }
 
 const std::unordered_set<ObjectHeader *> &HeapManager::GetObjectsList() const
@@ -45,17 +68,37 @@ const std::unordered_set<ObjectHeader *> &HeapManager::GetObjectsList() const
 void *HeapManager::AllocateObject(size_t size)
 {
     auto *alloc_obj = reinterpret_cast<ObjectHeader *>(object_allocator_->Alloc(size));
+    if (UNLIKELY(alloc_obj == nullptr)) {
+        // Heap grows only by this allocation till the requested collection frees memory
+        RequestCollection();
+        size_t n_chunks = (size + sizeof(AllocationHeader) + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        if (Grow(n_chunks)) {
+            alloc_obj = reinterpret_cast<ObjectHeader *>(object_allocator_->Alloc(size));
+        }
+    }
     if (!alloc_obj) {
         PrintErr("Failed to allocate for size ", size);
         return nullptr;
     }
 
     objects_.insert({alloc_obj});
+    UpdateChunksUsage(alloc_obj, true);
+    n_allocated_bytes_ += size;
+    n_allocated_objects_++;
+    trace::Tracer::RecordAllocation(size);
+    if (UNLIKELY(alloc_profiler_ != nullptr)) {
+        alloc_profiler_->RecordAllocation(alloc_obj, size);
+    }
     return alloc_obj;
 }
 
 void HeapManager::DeallocateObject(void *obj_ptr)
 {
+    // Class word is read before the allocator reuses the memory
+    if (UNLIKELY(alloc_profiler_ != nullptr)) {
+        alloc_profiler_->RecordFree(static_cast<ObjectHeader *>(obj_ptr));
+    }
+    UpdateChunksUsage(static_cast<ObjectHeader *>(obj_ptr), false);
     object_allocator_->Dealloc(obj_ptr);
     auto found_iter = objects_.find(reinterpret_cast<ObjectHeader *>(obj_ptr));
     if (found_iter != objects_.end()) {
@@ -63,6 +106,142 @@ void HeapManager::DeallocateObject(void *obj_ptr)
     }
 }
 
+void HeapManager::UpdateChunksUsage(const ObjectHeader *obj, bool is_allocated)
+{
+    const uint8_t *block = reinterpret_cast<const uint8_t *>(obj) - sizeof(AllocationHeader);
+    auto begin = static_cast<size_t>(block - heap_);
+    size_t end = begin + sizeof(AllocationHeader) + GetObjectSize(obj);
+    for (size_t chunk = begin / CHUNK_SIZE; chunk * CHUNK_SIZE < end; ++chunk) {
+        size_t n_bytes = std::min(end, (chunk + 1) * CHUNK_SIZE) - std::max(begin, chunk * CHUNK_SIZE);
+        if (is_allocated) {
+            chunk_used_bytes_[chunk] += n_bytes;
+        } else {
+            chunk_used_bytes_[chunk] -= n_bytes;
+        }
+    }
+}
+
+size_t HeapManager::FindUncommittedChunks(size_t n_chunks) const
+{
+    size_t first = 0;
+    size_t n_found = 0;
+    for (size_t chunk = 0; chunk < chunk_states_.size(); ++chunk) {
+        if (chunk_states_[chunk] == ChunkState::COMMITTED) {
+            n_found = 0;
+            continue;
+        }
+        if (n_found == 0) {
+            first = chunk;
+        }
+        if (++n_found == n_chunks) {
+            return first;
+        }
+    }
+    return chunk_states_.size();
+}
+
+void HeapManager::RequestCollection()
+{
+    if (is_collection_requested_) {
+        return;
+    }
+    // Heap is filled before GC is created only by loading of the program, it grows then
+    auto *gc = Runtime::GetInstance()->GetGC();
+    if (gc != nullptr) {
+        is_collection_requested_ = true;
+        gc->RequestCollection();
+    }
+}
+
+bool HeapManager::Grow(size_t n_chunks)
+{
+    if (committed_size_ + n_chunks * CHUNK_SIZE > max_heap_size_) {
+        return false;
+    }
+    size_t first = FindUncommittedChunks(n_chunks);
+    if (first == chunk_states_.size()) {
+        return false;
+    }
+
+    for (size_t chunk = first; chunk < first + n_chunks; ++chunk) {
+        // Released chunks stay accessible
+        if (chunk_states_[chunk] == ChunkState::RESERVED &&
+            mprotect(heap_ + chunk * CHUNK_SIZE, CHUNK_SIZE, PROT_READ | PROT_WRITE) != 0) {
+            PrintErr("Failed to commit heap chunk, errno = ", errno);
+            return false;
+        }
+    }
+    std::fill_n(chunk_states_.begin() + static_cast<ptrdiff_t>(first), n_chunks, ChunkState::COMMITTED);
+    committed_size_ += n_chunks * CHUNK_SIZE;
+    GetObjectAllocator()->AddFreeRange({heap_ + first * CHUNK_SIZE, n_chunks * CHUNK_SIZE});
+
+    PrintLogCat(MEMORY, "Heap grew to ", committed_size_, " bytes");
+    return true;
+}
+
+void HeapManager::ResizeAfterSweep()
+{
+    size_t used_size = GetUsedMemorySize();
+
+    // Live objects barely fit the heap, it grows at once instead of a collection per allocated chunk
+    if (is_collection_requested_) {
+        is_collection_requested_ = false;
+        if (4 * used_size > 3 * committed_size_) {
+            size_t n_chunks = std::max<size_t>(committed_size_ / CHUNK_SIZE / GROWTH_DIVISOR, 1);
+            for (size_t i = 0; i < n_chunks && Grow(1); ++i) {
+            }
+            return;
+        }
+    }
+
+    ReleaseFreeChunks(used_size);
+}
+
+void HeapManager::ReleaseFreeChunks(size_t used_size)
+{
+    // Heap shrinks only when less than half of it is used and keeps twice the used memory,
+    // so that it isn't grown back by the next allocations
+    if (committed_size_ <= min_heap_size_ || 2 * used_size >= committed_size_) {
+        return;
+    }
+    size_t target_size = std::max(min_heap_size_, 2 * used_size);
+
+    // Chunks at the end of the reservation go first, the heap grows from its beginning
+    std::vector<FreeRange> ranges;
+    size_t committed_size = committed_size_;
+    for (size_t chunk = chunk_states_.size(); chunk-- > 0 && committed_size >= target_size + CHUNK_SIZE;) {
+        if (chunk_states_[chunk] == ChunkState::COMMITTED && chunk_used_bytes_[chunk] == 0) {
+            ranges.push_back({heap_ + chunk * CHUNK_SIZE, CHUNK_SIZE});
+            committed_size -= CHUNK_SIZE;
+        }
+    }
+    if (ranges.empty()) {
+        return;
+    }
+    std::reverse(ranges.begin(), ranges.end());
+    GetObjectAllocator()->RemoveFreeRanges(ranges);
+
+    for (const FreeRange &range : ranges) {
+        if (madvise(range.start, range.size, MADV_DONTNEED) != 0) {
+            PrintErr("Failed to release heap chunk, errno = ", errno);
+        }
+        chunk_states_[static_cast<size_t>(range.start - heap_) / CHUNK_SIZE] = ChunkState::RELEASED;
+    }
+    committed_size_ = committed_size;
+
+    PrintLogCat(MEMORY, "Heap shrank to ", committed_size_, " bytes");
+}
+
+size_t HeapManager::GetUsedMemorySize() const
+{
+    return GetObjectAllocator()->GetUsedMemorySize();
+}
+
+FreeListStats HeapManager::GetFreeListStats() const
+{
+    return GetObjectAllocator()->GetFreeListStats();
+}
+
 void *HeapManager::AllocateInternalObject(size_t size)
 {
     return internal_allocator_->Alloc(size);
@@ -1,14 +1,18 @@
 #ifndef RUNTIME_MEMORY_HEAP_MANAGER_H
 #define RUNTIME_MEMORY_HEAP_MANAGER_H
 
+#include "common/constants.h"
 #include "runtime/memory/allocator/allocator.h"
+#include "runtime/memory/allocator/freelist_allocator.h"
 #include "runtime/memory/object_header.h"
 
 #include <cstddef>
 #include <memory>
 #include <unordered_set>
+#include <vector>
 
 namespace evm::runtime {
+class AllocationProfiler;
 class Frame;
 } // namespace evm::runtime
 
@@ -19,9 +23,24 @@ public:
     NO_COPY_SEMANTIC(HeapManager);
     NO_MOVE_SEMANTIC(HeapManager);
 
-    explicit HeapManager(size_t heap_size);
+    /// Heap is committed and returned to the OS by chunks
+    static constexpr size_t CHUNK_SIZE = MBYTE_SIZE;
+    /// Internal heap holds classes and their fields, its pages are touched only when they're used
+    static constexpr size_t INTERNAL_HEAP_SIZE = 8 * MBYTE_SIZE;
+    /// Heap which is still more than 3/4 full after a collection grows by 1 / GROWTH_DIVISOR of its size
+    static constexpr size_t GROWTH_DIVISOR = 8;
+
+    /// Address space of max_heap_size is reserved at once, min_heap_size of it is committed up front.
+    /// Heap grows when an object doesn't fit and never gets smaller than min_heap_size
+    HeapManager(size_t min_heap_size, size_t max_heap_size);
     ~HeapManager();
 
+    /// False if memory of the heap couldn't be reserved or committed
+    bool IsInitialized() const
+    {
+        return object_allocator_ != nullptr && internal_allocator_ != nullptr;
+    }
+
     const std::unordered_set<ObjectHeader *> &GetObjectsList() const;
 
     void *AllocateObject(size_t size);
@@ -29,18 +48,108 @@ public:
 
     void *AllocateInternalObject(size_t size);
 
+    /// Committed memory of the heap
+    size_t GetHeapSize() const
+    {
+        return committed_size_;
+    }
+
+    size_t GetMinHeapSize() const
+    {
+        return min_heap_size_;
+    }
+
+    size_t GetMaxHeapSize() const
+    {
+        return max_heap_size_;
+    }
+
+    /// Called by GC after sweep: grows the heap which stays full after a collection requested by allocations,
+    /// returns free chunks to the OS when most of the heap is free
+    void ResizeAfterSweep();
+
+    /// Memory of allocated objects with headers of their blocks
+    size_t GetUsedMemorySize() const;
+
+    /// Requested sizes of all objects allocated since creation of the heap
+    size_t GetAllocatedBytes() const
+    {
+        return n_allocated_bytes_;
+    }
+
+    size_t GetAllocatedObjectsCount() const
+    {
+        return n_allocated_objects_;
+    }
+
+    FreeListStats GetFreeListStats() const;
+
+    /// Heap memory taken by the object
+    static size_t GetObjectSize(const ObjectHeader *obj)
+    {
+        return FreelistAllocator::GetBlockSize(obj);
+    }
+
+    /// Allocations and frees of objects are reported to the profiler, nullptr disables it
+    void SetAllocationProfiler(AllocationProfiler *profiler)
+    {
+        alloc_profiler_ = profiler;
+    }
+
+    AllocationProfiler *GetAllocationProfiler() const
+    {
+        return alloc_profiler_;
+    }
+
     // TODO: implement AllocateFrame function
     Frame *AllocateFrame();
 
 private:
-    size_t heap_size_ {0};
+    enum class ChunkState : uint8_t {
+        RESERVED,  // never committed, not accessible
+        COMMITTED, // part of the free list or of objects
+        RELEASED,  // accessible, but its pages are given back to the OS till they're touched
+    };
+
+    FreelistAllocator *GetObjectAllocator() const
+    {
+        return static_cast<FreelistAllocator *>(object_allocator_.get());
+    }
+
+    // First of n_chunks consecutive chunks which aren't committed, number of chunks if there are none
+    size_t FindUncommittedChunks(size_t n_chunks) const;
+
+    // Commits n_chunks consecutive chunks, returns false if the heap can't grow
+    bool Grow(size_t n_chunks);
+
+    void ReleaseFreeChunks(size_t used_size);
+
+    // Garbage is collected at the next GC step: objects under construction aren't reachable from roots yet
+    void RequestCollection();
+
+    // Object block counts in every chunk it touches
+    void UpdateChunksUsage(const ObjectHeader *obj, bool is_allocated);
+
+private:
+    size_t min_heap_size_ {0};
+    size_t max_heap_size_ {0};
+    size_t committed_size_ {0};
+    bool is_collection_requested_ {false};
     uint8_t *heap_ {nullptr};
     uint8_t *internal_heap_ {nullptr};
 
+    std::vector<ChunkState> chunk_states_;
+    std::vector<size_t> chunk_used_bytes_;
+
     std::unique_ptr<AllocatorBase> object_allocator_;
     std::unique_ptr<AllocatorBase> internal_allocator_;
 
     std::unordered_set<ObjectHeader *> objects_;
+
+    size_t n_allocated_bytes_ {0};
+    size_t n_allocated_objects_ {0};
+
+    AllocationProfiler *alloc_profiler_ {nullptr};
 };
 
 } // namespace evm::runtime
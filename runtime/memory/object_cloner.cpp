@@ -0,0 +1,134 @@
+#include "common/logs.h"
+#include "runtime/memory/object_cloner.h"
+#include "runtime/memory/types/array.h"
+#include "runtime/memory/types/class.h"
+#include "runtime/memory/types/string.h"
+#include "runtime/runtime.h"
+
+#include <cassert>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+namespace evm::runtime {
+
+/* static */
+size_t ObjectCloner::GetObjectSize(const ObjectHeader *obj)
+{
+    const auto *class_word = obj->GetClassWord();
+
+    switch (class_word->GetObjectType()) {
+        case memory::Type::CLASS_OBJECT:
+            return types::Class::GetDataOffset() + class_word->GetClassSize();
+
+        case memory::Type::STRING_OBJECT:
+            return types::String::GetDataOffset() + reinterpret_cast<const types::String *>(obj)->GetLength();
+
+        case memory::Type::ARRAY_OBJECT:
+            // All element types take up 8 bytes
+            return types::Array::GetDataOffset() +
+                   reinterpret_cast<const types::Array *>(obj)->GetLength() * sizeof(int64_t);
+
+        default:
+            PrintErr("Unsupported type of object [", static_cast<int>(class_word->GetObjectType()), "]");
+            UNREACHABLE();
+    }
+
+    return 0;
+}
+
+/* static */
+ObjectHeader *ObjectCloner::Clone(ObjectHeader *obj)
+{
+    assert(obj != nullptr);
+
+    size_t size = GetObjectSize(obj);
+
+    auto *clone = static_cast<ObjectHeader *>(Runtime::GetInstance()->GetHeapManager()->AllocateObject(size));
+    if (UNLIKELY(clone == nullptr)) {
+        PrintErr("Error when cloning object of size ", size);
+        UNREACHABLE();
+    }
+
+    // Class word and length of strings are copied along with the payload,
+    // the clone is a new object for GC, so it starts white
+    std::memcpy(static_cast<void *>(clone), obj, size);
+    clone->SetMarkWord({});
+
+    return clone;
+}
+
+/* static */
+template <typename Visitor>
+void ObjectCloner::VisitReferences(ObjectHeader *obj, Visitor visitor)
+{
+    auto *class_word = obj->GetClassWord();
+
+    switch (class_word->GetObjectType()) {
+        case memory::Type::CLASS_OBJECT: {
+            auto *data = reinterpret_cast<uint8_t *>(obj) + types::Class::GetDataOffset();
+            for (size_t i = 0, size = class_word->GetFieldsNum(); i < size; ++i) {
+                const Field &field = class_word->GetField(i);
+                if (!field.IsPrimitive()) {
+                    visitor(reinterpret_cast<ObjectHeader **>(data + field.GetOffset()));
+                }
+            }
+            return;
+        }
+        case memory::Type::ARRAY_OBJECT: {
+            if (!class_word->IsReferenceArray()) {
+                return;
+            }
+
+            auto *data = reinterpret_cast<uint8_t *>(obj) + types::Array::GetDataOffset();
+            auto *elements = reinterpret_cast<ObjectHeader **>(data);
+            for (size_t i = 0, size = reinterpret_cast<types::Array *>(obj)->GetLength(); i < size; ++i) {
+                visitor(&elements[i]);
+            }
+            return;
+        }
+        default:
+            // Strings have no references
+            return;
+    }
+}
+
+/* static */
+ObjectHeader *ObjectCloner::DeepClone(ObjectHeader *obj)
+{
+    assert(obj != nullptr);
+
+    // Forwarding table from original objects to their clones: every object is cloned once,
+    // so shared references stay shared and cycles terminate
+    std::unordered_map<ObjectHeader *, ObjectHeader *> forwarding;
+    // Clones whose reference slots still point to the original objects
+    std::vector<ObjectHeader *> worklist;
+
+    auto *root = Clone(obj);
+    forwarding.insert({obj, root});
+    worklist.push_back(root);
+
+    while (!worklist.empty()) {
+        auto *clone = worklist.back();
+        worklist.pop_back();
+
+        VisitReferences(clone, [&forwarding, &worklist](ObjectHeader **slot) {
+            ObjectHeader *original = *slot;
+            if (original == nullptr) {
+                return;
+            }
+
+            auto [it, inserted] = forwarding.insert({original, nullptr});
+            if (inserted) {
+                it->second = Clone(original);
+                worklist.push_back(it->second);
+            }
+
+            *slot = it->second;
+        });
+    }
+
+    return root;
+}
+
+} // namespace evm::runtime
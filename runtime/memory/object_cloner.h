@@ -0,0 +1,36 @@
+#ifndef EVM_RUNTIME_MEMORY_OBJECT_CLONER_H
+#define EVM_RUNTIME_MEMORY_OBJECT_CLONER_H
+
+#include "common/macros.h"
+#include "runtime/memory/object_header.h"
+
+#include <cstddef>
+
+namespace evm::runtime {
+
+class ObjectCloner {
+public:
+    NO_COPY_SEMANTIC(ObjectCloner);
+    NO_MOVE_SEMANTIC(ObjectCloner);
+
+    ObjectCloner() = delete;
+    ~ObjectCloner() = delete;
+
+    /// Copy of the object payload: referenced objects are shared between the original and the clone
+    static ObjectHeader *Clone(ObjectHeader *obj);
+
+    /// Copy of the whole object graph reachable from obj.
+    /// Shared and cyclic references are preserved: each reachable object is copied exactly once.
+    static ObjectHeader *DeepClone(ObjectHeader *obj);
+
+    /// Full size of the object in heap: header and payload
+    static size_t GetObjectSize(const ObjectHeader *obj);
+
+private:
+    template <typename Visitor>
+    static void VisitReferences(ObjectHeader *obj, Visitor visitor);
+};
+
+} // namespace evm::runtime
+
+#endif // EVM_RUNTIME_MEMORY_OBJECT_CLONER_H
@@ -40,6 +40,11 @@ public:
         return class_word_;
     }
 
+    static constexpr uint32_t GetClassWordOffset()
+    {
+        return MEMBER_OFFSET(ObjectHeader, class_word_);
+    }
+
 private:
     MarkWord mark_word_;
     ClassDescription *class_word_ {nullptr};
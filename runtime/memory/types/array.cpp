@@ -1,5 +1,7 @@
 #include "common/logs.h"
+#include "common/utils/bitops.h"
 #include "runtime/memory/types/array.h"
+#include "runtime/memory/types/array_kernels.h"
 #include "runtime/memory/type.h"
 #include "runtime/runtime.h"
 
@@ -12,7 +14,7 @@ Array *Array::Create(memory::Type array_type, size_t length)
 {
     auto *runtime = Runtime::GetInstance();
 
-    PrintLog("Array_type = ", static_cast<int>(array_type));
+    PrintLogCat(OBJECTS, "Array_type = ", static_cast<int>(array_type));
 
     size_t elem_size = memory::GetSizeOfType(array_type);
     size_t array_size = Array::GetDataOffset() + length * elem_size;
@@ -72,45 +74,179 @@ ClassManager::DefaultClassDescr Array::GetDefaultClassDescrFromType(memory::Type
     return ClassManager::DefaultClassDescr::INVALID;
 }
 
-void Array::ValidateAddressingInArray(size_t idx) const
+void Array::ReportInvalidIndex(size_t idx) const
 {
-    if (idx >= length_) {
-        PrintErr("Get by invalid idx = ", idx, " in array of length ", length_);
+    PrintErr("Get by invalid idx = ", idx, " in array of length ", length_);
+    UNREACHABLE();
+}
+
+void Array::Set(int64_t value, size_t idx)
+{
+    // All element types take up 8 bytes, so only kind of array is validated
+    if (UNLIKELY(GetClassWord()->GetArrayElementKind() == ArrayElementKind::NONE)) {
+        PrintErr("Array element kind is NONE in array object header");
         UNREACHABLE();
     }
+
+    ValidateAddressingInArray(idx);
+    GetElements<int64_t>()[idx] = value;
 }
 
-void Array::Set(int64_t value, size_t idx)
+void Array::Get(int64_t *value, size_t idx) const
 {
+    if (UNLIKELY(GetClassWord()->GetArrayElementKind() == ArrayElementKind::NONE)) {
+        PrintErr("Array element kind is NONE in array object header");
+        UNREACHABLE();
+    }
+
     ValidateAddressingInArray(idx);
+    *value = GetElements<int64_t>()[idx];
+}
 
+void Array::ValidateRangeInArray(size_t pos, size_t length) const
+{
+    if (pos > length_ || length > length_ - pos) {
+        PrintErr("Invalid range [", pos, ", ", pos + length, ") in array of length ", length_);
+        UNREACHABLE();
+    }
+}
+
+memory::Type Array::GetValidatedElementType() const
+{
     auto array_type = GetClassWord()->GetArrayElementType();
     if (UNLIKELY(array_type == memory::Type::INVALID)) {
         PrintErr("Array type is INVALID in array object header");
         UNREACHABLE();
     }
+    return array_type;
+}
 
-    size_t elem_size = memory::GetSizeOfType(array_type);
+memory::Type Array::GetValidatedNumericElementType() const
+{
+    auto array_type = GetValidatedElementType();
+    if (UNLIKELY(array_type != memory::Type::INT && array_type != memory::Type::DOUBLE)) {
+        PrintErr("Operation is supported only for int and double arrays, not for \"",
+                 GetStringFromType(array_type).c_str(), "\"");
+        UNREACHABLE();
+    }
+    return array_type;
+}
 
-    uint8_t *data = reinterpret_cast<uint8_t *>(this) + Array::GetDataOffset();
+void Array::Fill(int64_t value)
+{
+    GetValidatedElementType();
 
-    std::memcpy(data + idx * elem_size, &value, elem_size * sizeof(uint8_t));
+    // All element types take up 8 bytes
+    int64_t *elements = GetElements<int64_t>();
+    for (size_t i = 0; i < length_; ++i) {
+        elements[i] = value;
+    }
 }
 
-void Array::Get(int64_t *value, size_t idx) const
+/* static */
+void Array::CopyRange(Array *dst, size_t dst_pos, const Array *src, size_t src_pos, size_t length)
 {
-    ValidateAddressingInArray(idx);
+    assert(dst != nullptr);
+    assert(src != nullptr);
+
+    auto dst_type = dst->GetValidatedElementType();
+    auto src_type = src->GetValidatedElementType();
+    if (UNLIKELY(memory::IsReferenceType(dst_type) != memory::IsReferenceType(src_type) ||
+                 (memory::IsPrimitiveType(dst_type) && dst_type != src_type))) {
+        PrintErr("Copy between arrays of different types: \"", GetStringFromType(src_type).c_str(), "\" to \"",
+                 GetStringFromType(dst_type).c_str(), "\"");
+        UNREACHABLE();
+    }
 
-    auto array_type = GetClassWord()->GetArrayElementType();
-    if (UNLIKELY(array_type == memory::Type::INVALID)) {
-        PrintErr("Array type is INVALID in array object header");
+    dst->ValidateRangeInArray(dst_pos, length);
+    src->ValidateRangeInArray(src_pos, length);
+
+    size_t elem_size = memory::GetSizeOfType(dst_type);
+    // Ranges may overlap if dst and src are the same array
+    std::memmove(dst->data_ + dst_pos * elem_size, src->data_ + src_pos * elem_size, length * elem_size);
+}
+
+int64_t Array::Sum() const
+{
+    if (GetValidatedNumericElementType() == memory::Type::INT) {
+        return kernels::SumInt64(GetElements<int64_t>(), length_);
+    }
+    return bitops::BitCast<int64_t>(kernels::SumDouble(GetElements<double>(), length_));
+}
+
+int64_t Array::Min() const
+{
+    if (GetValidatedNumericElementType() == memory::Type::INT) {
+        return kernels::MinInt64(GetElements<int64_t>(), length_);
+    }
+    return bitops::BitCast<int64_t>(kernels::MinDouble(GetElements<double>(), length_));
+}
+
+int64_t Array::Max() const
+{
+    if (GetValidatedNumericElementType() == memory::Type::INT) {
+        return kernels::MaxInt64(GetElements<int64_t>(), length_);
+    }
+    return bitops::BitCast<int64_t>(kernels::MaxDouble(GetElements<double>(), length_));
+}
+
+/* static */
+void Array::Add(Array *dst, const Array *lhs, const Array *rhs)
+{
+    assert(dst != nullptr && lhs != nullptr && rhs != nullptr);
+
+    auto type = dst->GetValidatedNumericElementType();
+    if (UNLIKELY(lhs->GetValidatedNumericElementType() != type || rhs->GetValidatedNumericElementType() != type)) {
+        PrintErr("Element-wise addition of arrays with different types");
         UNREACHABLE();
     }
 
-    size_t elem_size = memory::GetSizeOfType(array_type);
-    const uint8_t *data = reinterpret_cast<const uint8_t *>(this) + Array::GetDataOffset();
+    size_t length = dst->GetLength();
+    if (UNLIKELY(lhs->GetLength() != length || rhs->GetLength() != length)) {
+        PrintErr("Element-wise addition of arrays with different lengths");
+        UNREACHABLE();
+    }
+
+    if (type == memory::Type::INT) {
+        kernels::AddInt64(dst->GetElements<int64_t>(), lhs->GetElements<int64_t>(), rhs->GetElements<int64_t>(),
+                          length);
+    } else {
+        kernels::AddDouble(dst->GetElements<double>(), lhs->GetElements<double>(), rhs->GetElements<double>(), length);
+    }
+}
+
+/* static */
+void Array::Mul(Array *dst, const Array *lhs, const Array *rhs)
+{
+    assert(dst != nullptr && lhs != nullptr && rhs != nullptr);
+
+    auto type = dst->GetValidatedNumericElementType();
+    if (UNLIKELY(lhs->GetValidatedNumericElementType() != type || rhs->GetValidatedNumericElementType() != type)) {
+        PrintErr("Element-wise multiplication of arrays with different types");
+        UNREACHABLE();
+    }
 
-    std::memcpy(value, data + idx * elem_size, elem_size * sizeof(uint8_t));
+    size_t length = dst->GetLength();
+    if (UNLIKELY(lhs->GetLength() != length || rhs->GetLength() != length)) {
+        PrintErr("Element-wise multiplication of arrays with different lengths");
+        UNREACHABLE();
+    }
+
+    if (type == memory::Type::INT) {
+        kernels::MulInt64(dst->GetElements<int64_t>(), lhs->GetElements<int64_t>(), rhs->GetElements<int64_t>(),
+                          length);
+    } else {
+        kernels::MulDouble(dst->GetElements<double>(), lhs->GetElements<double>(), rhs->GetElements<double>(), length);
+    }
+}
+
+int64_t Array::IndexOf(int64_t value) const
+{
+    // Reference arrays are searched by pointer equality
+    if (GetValidatedElementType() == memory::Type::DOUBLE) {
+        return kernels::IndexOfDouble(GetElements<double>(), length_, bitops::BitCast<double>(value));
+    }
+    return kernels::IndexOfInt64(GetElements<int64_t>(), length_, value);
 }
 
 } // namespace evm::runtime::types
@@ -6,6 +6,7 @@
 #include "runtime/memory/object_header.h"
 #include "runtime/memory/class_manager.h"
 
+#include <cassert>
 #include <cstddef>
 #include <cstring>
 
@@ -22,6 +23,55 @@ public:
 
     void Get(int64_t *value, size_t idx) const;
 
+    // Accessors specialized by element kind which is fixed at Array::Create time.
+    // Caller is responsible for checking the kind, so access is a bounds check and a single load/store.
+
+    int64_t GetPrimitive(size_t idx) const
+    {
+        assert(GetClassWord()->GetArrayElementKind() == ArrayElementKind::PRIMITIVE);
+        ValidateAddressingInArray(idx);
+        return GetElements<int64_t>()[idx];
+    }
+
+    void SetPrimitive(int64_t value, size_t idx)
+    {
+        assert(GetClassWord()->GetArrayElementKind() == ArrayElementKind::PRIMITIVE);
+        ValidateAddressingInArray(idx);
+        GetElements<int64_t>()[idx] = value;
+    }
+
+    ObjectHeader *GetReference(size_t idx) const
+    {
+        assert(GetClassWord()->IsReferenceArray());
+        ValidateAddressingInArray(idx);
+        return GetElements<ObjectHeader *>()[idx];
+    }
+
+    void SetReference(ObjectHeader *value, size_t idx)
+    {
+        assert(GetClassWord()->IsReferenceArray());
+        ValidateAddressingInArray(idx);
+        GetElements<ObjectHeader *>()[idx] = value;
+    }
+
+    // Bulk operations, implemented with SIMD kernels where it is possible.
+    // Values are raw register values: int64_t for int/reference arrays, bit-casted double for double arrays.
+
+    void Fill(int64_t value);
+    static void CopyRange(Array *dst, size_t dst_pos, const Array *src, size_t src_pos, size_t length);
+
+    // Reductions are supported only for int and double arrays, empty array gives zero
+    int64_t Sum() const;
+    int64_t Min() const;
+    int64_t Max() const;
+
+    // Element-wise operations: dst[i] = lhs[i] op rhs[i], all arrays must have the same type and length
+    static void Add(Array *dst, const Array *lhs, const Array *rhs);
+    static void Mul(Array *dst, const Array *lhs, const Array *rhs);
+
+    /// Index of the first element equal to value or -1
+    int64_t IndexOf(int64_t value) const;
+
     void SetLength(uint32_t length)
     {
         length_ = length;
@@ -37,12 +87,39 @@ public:
         return MEMBER_OFFSET(Array, data_);
     }
 
+    static constexpr uint32_t GetLengthOffset()
+    {
+        return MEMBER_OFFSET(Array, length_);
+    }
+
 private:
     Array() = default;
     ~Array() = default;
 
     static ClassManager::DefaultClassDescr GetDefaultClassDescrFromType(memory::Type array_type);
-    void ValidateAddressingInArray(size_t idx) const;
+    void ValidateAddressingInArray(size_t idx) const
+    {
+        if (UNLIKELY(idx >= length_)) {
+            ReportInvalidIndex(idx);
+        }
+    }
+
+    void ReportInvalidIndex(size_t idx) const;
+    void ValidateRangeInArray(size_t pos, size_t length) const;
+    memory::Type GetValidatedElementType() const;
+    memory::Type GetValidatedNumericElementType() const;
+
+    template <typename T>
+    T *GetElements()
+    {
+        return reinterpret_cast<T *>(data_);
+    }
+
+    template <typename T>
+    const T *GetElements() const
+    {
+        return reinterpret_cast<const T *>(data_);
+    }
 
 private:
     size_t length_ {0};
@@ -0,0 +1,459 @@
+#include "runtime/memory/types/array_kernels.h"
+#include "common/utils/cpu_features.h"
+
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace evm::runtime::types::kernels {
+
+// ================================ Scalar kernels =================================
+
+namespace scalar {
+
+// Integer arithmetic is performed on unsigned values to have defined wrap-around on overflow
+
+static int64_t SumInt64(const int64_t *data, size_t length)
+{
+    uint64_t sum = 0;
+    for (size_t i = 0; i < length; ++i) {
+        sum += static_cast<uint64_t>(data[i]);
+    }
+    return static_cast<int64_t>(sum);
+}
+
+static double SumDouble(const double *data, size_t length)
+{
+    double sum = 0.0;
+    for (size_t i = 0; i < length; ++i) {
+        sum += data[i];
+    }
+    return sum;
+}
+
+template <typename T, typename Compare>
+static T Reduce(const T *data, size_t length, Compare replace)
+{
+    if (length == 0) {
+        return T {0};
+    }
+
+    T result = data[0];
+    for (size_t i = 1; i < length; ++i) {
+        if (replace(data[i], result)) {
+            result = data[i];
+        }
+    }
+    return result;
+}
+
+static int64_t MinInt64(const int64_t *data, size_t length)
+{
+    return Reduce(data, length, [](int64_t value, int64_t current) { return value < current; });
+}
+
+static int64_t MaxInt64(const int64_t *data, size_t length)
+{
+    return Reduce(data, length, [](int64_t value, int64_t current) { return value > current; });
+}
+
+static double MinDouble(const double *data, size_t length)
+{
+    return Reduce(data, length, [](double value, double current) { return value < current; });
+}
+
+static double MaxDouble(const double *data, size_t length)
+{
+    return Reduce(data, length, [](double value, double current) { return value > current; });
+}
+
+static void AddInt64(int64_t *dst, const int64_t *lhs, const int64_t *rhs, size_t length)
+{
+    for (size_t i = 0; i < length; ++i) {
+        dst[i] = static_cast<int64_t>(static_cast<uint64_t>(lhs[i]) + static_cast<uint64_t>(rhs[i]));
+    }
+}
+
+static void MulInt64(int64_t *dst, const int64_t *lhs, const int64_t *rhs, size_t length)
+{
+    for (size_t i = 0; i < length; ++i) {
+        dst[i] = static_cast<int64_t>(static_cast<uint64_t>(lhs[i]) * static_cast<uint64_t>(rhs[i]));
+    }
+}
+
+static void AddDouble(double *dst, const double *lhs, const double *rhs, size_t length)
+{
+    for (size_t i = 0; i < length; ++i) {
+        dst[i] = lhs[i] + rhs[i];
+    }
+}
+
+static void MulDouble(double *dst, const double *lhs, const double *rhs, size_t length)
+{
+    for (size_t i = 0; i < length; ++i) {
+        dst[i] = lhs[i] * rhs[i];
+    }
+}
+
+template <typename T>
+static ssize_t IndexOf(const T *data, size_t length, T value)
+{
+    for (size_t i = 0; i < length; ++i) {
+        if (data[i] == value) {
+            return static_cast<ssize_t>(i);
+        }
+    }
+    return -1;
+}
+
+static ssize_t IndexOfInt64(const int64_t *data, size_t length, int64_t value)
+{
+    return IndexOf(data, length, value);
+}
+
+static ssize_t IndexOfDouble(const double *data, size_t length, double value)
+{
+    return IndexOf(data, length, value);
+}
+
+} // namespace scalar
+
+// ================================= AVX2 kernels ==================================
+
+#if defined(__x86_64__)
+
+namespace avx2 {
+
+#define AVX2_KERNEL __attribute__((target("avx2")))
+
+static constexpr size_t N_LANES = 4; // 64-bit elements per 256-bit register
+
+AVX2_KERNEL static int64_t SumInt64(const int64_t *data, size_t length)
+{
+    __m256i acc0 = _mm256_setzero_si256();
+    __m256i acc1 = _mm256_setzero_si256();
+
+    size_t i = 0;
+    for (; i + 2 * N_LANES <= length; i += 2 * N_LANES) {
+        acc0 = _mm256_add_epi64(acc0, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i)));
+        acc1 = _mm256_add_epi64(acc1, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i + N_LANES)));
+    }
+
+    alignas(32) int64_t lanes[N_LANES];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), _mm256_add_epi64(acc0, acc1));
+
+    uint64_t sum = 0;
+    for (size_t lane = 0; lane < N_LANES; ++lane) {
+        sum += static_cast<uint64_t>(lanes[lane]);
+    }
+
+    return static_cast<int64_t>(sum + static_cast<uint64_t>(scalar::SumInt64(data + i, length - i)));
+}
+
+AVX2_KERNEL static double SumDouble(const double *data, size_t length)
+{
+    __m256d acc0 = _mm256_setzero_pd();
+    __m256d acc1 = _mm256_setzero_pd();
+
+    size_t i = 0;
+    for (; i + 2 * N_LANES <= length; i += 2 * N_LANES) {
+        acc0 = _mm256_add_pd(acc0, _mm256_loadu_pd(data + i));
+        acc1 = _mm256_add_pd(acc1, _mm256_loadu_pd(data + i + N_LANES));
+    }
+
+    alignas(32) double lanes[N_LANES];
+    _mm256_store_pd(lanes, _mm256_add_pd(acc0, acc1));
+
+    double sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    return sum + scalar::SumDouble(data + i, length - i);
+}
+
+template <bool IS_MIN>
+AVX2_KERNEL static int64_t ReduceInt64(const int64_t *data, size_t length)
+{
+    if (length < N_LANES) {
+        return IS_MIN ? scalar::MinInt64(data, length) : scalar::MaxInt64(data, length);
+    }
+
+    __m256i acc = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data));
+
+    size_t i = N_LANES;
+    for (; i + N_LANES <= length; i += N_LANES) {
+        __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+        // Lanes where new value should replace accumulated one
+        __m256i replace = IS_MIN ? _mm256_cmpgt_epi64(acc, values) : _mm256_cmpgt_epi64(values, acc);
+        acc = _mm256_blendv_epi8(acc, values, replace);
+    }
+
+    alignas(32) int64_t lanes[N_LANES + N_LANES - 1];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), acc);
+
+    size_t n_tail = length - i;
+    std::memcpy(lanes + N_LANES, data + i, n_tail * sizeof(int64_t));
+
+    return IS_MIN ? scalar::MinInt64(lanes, N_LANES + n_tail) : scalar::MaxInt64(lanes, N_LANES + n_tail);
+}
+
+template <bool IS_MIN>
+AVX2_KERNEL static double ReduceDouble(const double *data, size_t length)
+{
+    if (length < N_LANES) {
+        return IS_MIN ? scalar::MinDouble(data, length) : scalar::MaxDouble(data, length);
+    }
+
+    __m256d acc = _mm256_loadu_pd(data);
+
+    size_t i = N_LANES;
+    for (; i + N_LANES <= length; i += N_LANES) {
+        __m256d values = _mm256_loadu_pd(data + i);
+        acc = IS_MIN ? _mm256_min_pd(values, acc) : _mm256_max_pd(values, acc);
+    }
+
+    alignas(32) double lanes[N_LANES + N_LANES - 1];
+    _mm256_store_pd(lanes, acc);
+
+    size_t n_tail = length - i;
+    std::memcpy(lanes + N_LANES, data + i, n_tail * sizeof(double));
+
+    return IS_MIN ? scalar::MinDouble(lanes, N_LANES + n_tail) : scalar::MaxDouble(lanes, N_LANES + n_tail);
+}
+
+AVX2_KERNEL static int64_t MinInt64(const int64_t *data, size_t length)
+{
+    return ReduceInt64<true>(data, length);
+}
+
+AVX2_KERNEL static int64_t MaxInt64(const int64_t *data, size_t length)
+{
+    return ReduceInt64<false>(data, length);
+}
+
+AVX2_KERNEL static double MinDouble(const double *data, size_t length)
+{
+    return ReduceDouble<true>(data, length);
+}
+
+AVX2_KERNEL static double MaxDouble(const double *data, size_t length)
+{
+    return ReduceDouble<false>(data, length);
+}
+
+AVX2_KERNEL static void AddInt64(int64_t *dst, const int64_t *lhs, const int64_t *rhs, size_t length)
+{
+    size_t i = 0;
+    for (; i + N_LANES <= length; i += N_LANES) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(lhs + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(rhs + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), _mm256_add_epi64(a, b));
+    }
+
+    scalar::AddInt64(dst + i, lhs + i, rhs + i, length - i);
+}
+
+// AVX2 has no 64-bit multiplication: it is composed from 32x32->64 bit ones (low 64 bits of result only)
+AVX2_KERNEL static __m256i MulLoInt64(__m256i a, __m256i b)
+{
+    __m256i a_hi = _mm256_srli_epi64(a, 32);
+    __m256i b_hi = _mm256_srli_epi64(b, 32);
+
+    __m256i lo_lo = _mm256_mul_epu32(a, b);
+    __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(a, b_hi), _mm256_mul_epu32(a_hi, b));
+
+    return _mm256_add_epi64(lo_lo, _mm256_slli_epi64(cross, 32));
+}
+
+AVX2_KERNEL static void MulInt64(int64_t *dst, const int64_t *lhs, const int64_t *rhs, size_t length)
+{
+    size_t i = 0;
+    for (; i + N_LANES <= length; i += N_LANES) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(lhs + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(rhs + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), MulLoInt64(a, b));
+    }
+
+    scalar::MulInt64(dst + i, lhs + i, rhs + i, length - i);
+}
+
+AVX2_KERNEL static void AddDouble(double *dst, const double *lhs, const double *rhs, size_t length)
+{
+    size_t i = 0;
+    for (; i + N_LANES <= length; i += N_LANES) {
+        _mm256_storeu_pd(dst + i, _mm256_add_pd(_mm256_loadu_pd(lhs + i), _mm256_loadu_pd(rhs + i)));
+    }
+
+    scalar::AddDouble(dst + i, lhs + i, rhs + i, length - i);
+}
+
+AVX2_KERNEL static void MulDouble(double *dst, const double *lhs, const double *rhs, size_t length)
+{
+    size_t i = 0;
+    for (; i + N_LANES <= length; i += N_LANES) {
+        _mm256_storeu_pd(dst + i, _mm256_mul_pd(_mm256_loadu_pd(lhs + i), _mm256_loadu_pd(rhs + i)));
+    }
+
+    scalar::MulDouble(dst + i, lhs + i, rhs + i, length - i);
+}
+
+AVX2_KERNEL static ssize_t IndexOfInt64(const int64_t *data, size_t length, int64_t value)
+{
+    __m256i target = _mm256_set1_epi64x(value);
+
+    size_t i = 0;
+    for (; i + N_LANES <= length; i += N_LANES) {
+        __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+        int mask = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(values, target)));
+        if (mask != 0) {
+            return static_cast<ssize_t>(i + __builtin_ctz(mask));
+        }
+    }
+
+    ssize_t tail_idx = scalar::IndexOfInt64(data + i, length - i, value);
+    return tail_idx < 0 ? -1 : static_cast<ssize_t>(i) + tail_idx;
+}
+
+AVX2_KERNEL static ssize_t IndexOfDouble(const double *data, size_t length, double value)
+{
+    __m256d target = _mm256_set1_pd(value);
+
+    size_t i = 0;
+    for (; i + N_LANES <= length; i += N_LANES) {
+        int mask = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(data + i), target, _CMP_EQ_OQ));
+        if (mask != 0) {
+            return static_cast<ssize_t>(i + __builtin_ctz(mask));
+        }
+    }
+
+    ssize_t tail_idx = scalar::IndexOfDouble(data + i, length - i, value);
+    return tail_idx < 0 ? -1 : static_cast<ssize_t>(i) + tail_idx;
+}
+
+#undef AVX2_KERNEL
+
+} // namespace avx2
+
+#endif // __x86_64__
+
+// ================================ Kernels dispatch ===============================
+
+struct KernelTable {
+    int64_t (*sum_int64)(const int64_t *, size_t);
+    double (*sum_double)(const double *, size_t);
+
+    int64_t (*min_int64)(const int64_t *, size_t);
+    int64_t (*max_int64)(const int64_t *, size_t);
+    double (*min_double)(const double *, size_t);
+    double (*max_double)(const double *, size_t);
+
+    void (*add_int64)(int64_t *, const int64_t *, const int64_t *, size_t);
+    void (*mul_int64)(int64_t *, const int64_t *, const int64_t *, size_t);
+    void (*add_double)(double *, const double *, const double *, size_t);
+    void (*mul_double)(double *, const double *, const double *, size_t);
+
+    ssize_t (*index_of_int64)(const int64_t *, size_t, int64_t);
+    ssize_t (*index_of_double)(const double *, size_t, double);
+
+    bool is_avx2;
+};
+
+// clang-format off
+#define KERNEL_TABLE(ns, is_avx2) \
+    KernelTable {                 \
+        ns::SumInt64,             \
+        ns::SumDouble,            \
+        ns::MinInt64,             \
+        ns::MaxInt64,             \
+        ns::MinDouble,            \
+        ns::MaxDouble,            \
+        ns::AddInt64,             \
+        ns::MulInt64,             \
+        ns::AddDouble,            \
+        ns::MulDouble,            \
+        ns::IndexOfInt64,         \
+        ns::IndexOfDouble,        \
+        is_avx2                   \
+    }
+// clang-format on
+
+static KernelTable SelectKernels()
+{
+#if defined(__x86_64__)
+    if (common::GetCpuFeatures().avx2) {
+        return KERNEL_TABLE(avx2, true);
+    }
+#endif
+    return KERNEL_TABLE(scalar, false);
+}
+
+#undef KERNEL_TABLE
+
+// Selected once during static initialization
+static const KernelTable KERNELS = SelectKernels();
+
+int64_t SumInt64(const int64_t *data, size_t length)
+{
+    return KERNELS.sum_int64(data, length);
+}
+
+double SumDouble(const double *data, size_t length)
+{
+    return KERNELS.sum_double(data, length);
+}
+
+int64_t MinInt64(const int64_t *data, size_t length)
+{
+    return KERNELS.min_int64(data, length);
+}
+
+int64_t MaxInt64(const int64_t *data, size_t length)
+{
+    return KERNELS.max_int64(data, length);
+}
+
+double MinDouble(const double *data, size_t length)
+{
+    return KERNELS.min_double(data, length);
+}
+
+double MaxDouble(const double *data, size_t length)
+{
+    return KERNELS.max_double(data, length);
+}
+
+void AddInt64(int64_t *dst, const int64_t *lhs, const int64_t *rhs, size_t length)
+{
+    KERNELS.add_int64(dst, lhs, rhs, length);
+}
+
+void MulInt64(int64_t *dst, const int64_t *lhs, const int64_t *rhs, size_t length)
+{
+    KERNELS.mul_int64(dst, lhs, rhs, length);
+}
+
+void AddDouble(double *dst, const double *lhs, const double *rhs, size_t length)
+{
+    KERNELS.add_double(dst, lhs, rhs, length);
+}
+
+void MulDouble(double *dst, const double *lhs, const double *rhs, size_t length)
+{
+    KERNELS.mul_double(dst, lhs, rhs, length);
+}
+
+ssize_t IndexOfInt64(const int64_t *data, size_t length, int64_t value)
+{
+    return KERNELS.index_of_int64(data, length, value);
+}
+
+ssize_t IndexOfDouble(const double *data, size_t length, double value)
+{
+    return KERNELS.index_of_double(data, length, value);
+}
+
+bool IsAvx2KernelsSelected()
+{
+    return KERNELS.is_avx2;
+}
+
+} // namespace evm::runtime::types::kernels
@@ -0,0 +1,35 @@
+#ifndef EVM_MEMORY_OBJECTS_ARRAY_KERNELS_H
+#define EVM_MEMORY_OBJECTS_ARRAY_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <sys/types.h>
+
+namespace evm::runtime::types::kernels {
+
+// Bulk operations over raw array data. Every kernel has a scalar and an AVX2 implementation,
+// the latter is selected once at startup if CPU supports it.
+// Floating point reductions may sum elements in a different order depending on selected implementation.
+
+int64_t SumInt64(const int64_t *data, size_t length);
+double SumDouble(const double *data, size_t length);
+
+int64_t MinInt64(const int64_t *data, size_t length);
+int64_t MaxInt64(const int64_t *data, size_t length);
+double MinDouble(const double *data, size_t length);
+double MaxDouble(const double *data, size_t length);
+
+void AddInt64(int64_t *dst, const int64_t *lhs, const int64_t *rhs, size_t length);
+void MulInt64(int64_t *dst, const int64_t *lhs, const int64_t *rhs, size_t length);
+void AddDouble(double *dst, const double *lhs, const double *rhs, size_t length);
+void MulDouble(double *dst, const double *lhs, const double *rhs, size_t length);
+
+/// Return index of first element equal to value, -1 if there is no such element
+ssize_t IndexOfInt64(const int64_t *data, size_t length, int64_t value);
+ssize_t IndexOfDouble(const double *data, size_t length, double value);
+
+bool IsAvx2KernelsSelected();
+
+} // namespace evm::runtime::types::kernels
+
+#endif // EVM_MEMORY_OBJECTS_ARRAY_KERNELS_H
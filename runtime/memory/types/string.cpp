@@ -1,8 +1,8 @@
 #include "common/logs.h"
-#include "common/utils/crc32.h"
 #include "runtime/runtime.h"
 #include "runtime/memory/types/string.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 
@@ -22,7 +22,6 @@ String *String::Create(const uint8_t *data, size_t length)
     }
 
     string->SetLength(length);
-    string->SetHash(String::CalculateStringHash(data, length));
 
     std::memcpy(reinterpret_cast<uint8_t *>(string) + String::GetDataOffset(), data, length);
 
@@ -30,24 +29,32 @@ String *String::Create(const uint8_t *data, size_t length)
 }
 
 /* static */
-uint32_t String::CalculateStringHash(const uint8_t *data, size_t length)
+String *String::CreateUninitialized(size_t length)
 {
-    return common::Crc32(data, length);
+    size_t string_size = String::GetDataOffset() + length * sizeof(uint8_t);
+    auto *string = static_cast<String *>(Runtime::GetInstance()->GetHeapManager()->AllocateObject(string_size));
+
+    if (string == nullptr) {
+        PrintErr("Can't create string");
+        return nullptr;
+    }
+
+    string->SetLength(length);
+
+    return string;
 }
 
 /* static */
 int String::CompareStrings(String *str1, String *str2)
 {
-    if (str1->GetHash() != str2->GetHash()) {
-        return false;
-    }
-
-    if (str1->GetLength() != str1->GetLength()) {
-        return false;
+    // Result orders strings, so their data is compared even when lengths differ
+    size_t length1 = str1->GetLength();
+    size_t length2 = str2->GetLength();
+    int result = std::memcmp(str1->GetData(), str2->GetData(), std::min(length1, length2));
+    if (result != 0) {
+        return result;
     }
-
-    return std::strcmp(reinterpret_cast<const char *>(str1->GetData()),
-                       reinterpret_cast<const char *>(str2->GetData()));
+    return length1 < length2 ? -1 : static_cast<int>(length1 > length2);
 }
 
 /* static */
@@ -56,22 +63,20 @@ String *String::ConcatStrings(String *lhs_string, String *rhs_string)
     assert(lhs_string != nullptr);
     assert(rhs_string != nullptr);
 
-    size_t lhs_length = lhs_string->GetLength();
+    // Length of string includes terminating \0, so it is skipped for lhs string
+    size_t lhs_length = lhs_string->IsEmpty() ? 0 : lhs_string->GetLength() - 1;
     size_t rhs_length = rhs_string->GetLength();
     size_t concat_length = lhs_length + rhs_length;
 
-    uint8_t *concat_data = new uint8_t[concat_length];
-
-    std::memcpy(concat_data, lhs_string->GetData(), lhs_length);
-    std::memcpy(concat_data + lhs_length, rhs_string->GetData(), rhs_length);
-
-    auto *concat_string_obj = String::Create(concat_data, concat_length);
+    // Data is copied straight into the new object
+    auto *concat_string_obj = String::CreateUninitialized(concat_length);
     if (UNLIKELY(concat_string_obj == nullptr)) {
         PrintErr("String concatenation failed");
         UNREACHABLE();
     }
 
-    delete[] concat_data;
+    std::memcpy(concat_string_obj->GetData(), lhs_string->GetData(), lhs_length);
+    std::memcpy(concat_string_obj->GetData() + lhs_length, rhs_string->GetData(), rhs_length);
 
     auto *class_description =
         Runtime::GetInstance()->GetClassManager()->GetDefaultClassDescription(ClassManager::DefaultClassDescr::STRING);
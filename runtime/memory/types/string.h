@@ -14,7 +14,8 @@ public:
 
     static String *Create(const uint8_t *data, size_t length);
 
-    static uint32_t CalculateStringHash(const uint8_t *data, size_t length);
+    /// Allocate string object of the given length, data should be filled by caller
+    static String *CreateUninitialized(size_t length);
 
     static int CompareStrings(String *str1, String *str2);
 
@@ -35,16 +36,6 @@ public:
         return MEMBER_OFFSET(String, data_);
     }
 
-    void SetHash(uint32_t hash)
-    {
-        hash_ = hash;
-    }
-
-    uint32_t GetHash() const
-    {
-        return hash_;
-    }
-
     void SetLength(uint32_t length)
     {
         length_ = length;
@@ -66,7 +57,6 @@ private:
 
 private:
     size_t length_ {0};
-    uint32_t hash_ {0};
     // Used a zero-length array to have a convenient offset for string data
     // and conveniently get a pointer to string data.
     __extension__ uint8_t data_[0];
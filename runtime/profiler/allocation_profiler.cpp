@@ -0,0 +1,101 @@
+#include "runtime/profiler/allocation_profiler.h"
+#include "runtime/interpreter/interpreter.h"
+#include "runtime/memory/class_description.h"
+#include "runtime/memory/object_header.h"
+#include "runtime/runtime.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace evm::runtime {
+
+AllocationProfiler::AllocationProfiler(const Interpreter *interpreter, size_t sample_interval)
+    : interpreter_(interpreter),
+      sample_interval_(sample_interval == 0 ? 1 : sample_interval),
+      bytes_until_sample_(sample_interval_)
+{
+}
+
+void AllocationProfiler::RecordSample(ObjectHeader *obj, size_t size)
+{
+    bytes_until_sample_ = sample_interval_;
+
+    // Allocation smaller than the interval is sampled once per about interval / size such allocations
+    Sample sample;
+    sample.pc = static_cast<uint32_t>(interpreter_->GetPC());
+    sample.n_bytes = std::max(size, sample_interval_);
+    sample.n_objects = size == 0 ? 1 : std::max<size_t>(sample_interval_ / size, 1);
+    live_samples_[obj] = sample;
+}
+
+void AllocationProfiler::RecordFree(ObjectHeader *obj)
+{
+    auto it = live_samples_.find(obj);
+    if (it == live_samples_.end()) {
+        return;
+    }
+    AddSample(&freed_sites_, obj->GetClassWord(), it->second, false);
+    live_samples_.erase(it);
+}
+
+void AllocationProfiler::RecordGcCycle()
+{
+    for (auto &[obj, sample] : live_samples_) {
+        ++sample.n_survived_gcs;
+    }
+}
+
+/* static */
+void AllocationProfiler::AddSample(std::map<SiteKey, Site> *sites, const ClassDescription *class_descr,
+                                   const Sample &sample, bool is_live)
+{
+    Site &site = (*sites)[{sample.pc, class_descr}];
+    site.pc = sample.pc;
+    site.class_descr = class_descr;
+    site.n_bytes += sample.n_bytes;
+    site.n_objects += sample.n_objects;
+    if (sample.n_survived_gcs != 0) {
+        site.n_survived_bytes += sample.n_bytes;
+        site.n_survived_objects += sample.n_objects;
+    }
+    if (is_live) {
+        site.n_live_bytes += sample.n_bytes;
+    }
+}
+
+std::vector<AllocationProfiler::Site> AllocationProfiler::GetSites() const
+{
+    std::map<SiteKey, Site> sites = freed_sites_;
+    for (const auto &[obj, sample] : live_samples_) {
+        AddSample(&sites, obj->GetClassWord(), sample, true);
+    }
+
+    std::vector<Site> sorted;
+    sorted.reserve(sites.size());
+    for (const auto &[key, site] : sites) {
+        sorted.push_back(site);
+    }
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     [](const Site &lhs, const Site &rhs) { return lhs.n_bytes > rhs.n_bytes; });
+    return sorted;
+}
+
+bool AllocationProfiler::WriteReport(const char *path, const std::function<std::string(uint32_t pc)> &pc_name) const
+{
+    FILE *file = std::fopen(path, "w");
+    if (file == nullptr) {
+        return false;
+    }
+    const ClassManager *class_manager = Runtime::GetInstance()->GetClassManager();
+    std::fprintf(file, "# Estimated allocations, an allocation is sampled every %zu bytes\n", sample_interval_);
+    std::fprintf(file, "# %12s %10s %14s %16s %12s  %-16s %s\n", "bytes", "objects", "survived_bytes",
+                 "survived_objects", "live_bytes", "class", "site");
+    for (const Site &site : GetSites()) {
+        std::fprintf(file, "  %12zu %10zu %14zu %16zu %12zu  %-16s %s (pc 0x%x)\n", site.n_bytes, site.n_objects,
+                     site.n_survived_bytes, site.n_survived_objects, site.n_live_bytes,
+                     class_manager->GetDisplayName(site.class_descr).c_str(), pc_name(site.pc).c_str(), site.pc);
+    }
+    return std::fclose(file) == 0;
+}
+
+} // namespace evm::runtime
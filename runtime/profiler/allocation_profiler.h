@@ -0,0 +1,103 @@
+#ifndef EVM_RUNTIME_PROFILER_ALLOCATION_PROFILER_H
+#define EVM_RUNTIME_PROFILER_ALLOCATION_PROFILER_H
+
+#include "common/constants.h"
+#include "common/macros.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace evm::runtime {
+
+class ClassDescription;
+class Interpreter;
+class ObjectHeader;
+
+/// Finds instructions which allocate the most and how long their objects live: site of a sampled allocation
+/// is pc of the interpreter, compiled code is seen as the instruction where it was entered.
+/// An allocation is sampled each time sample_interval bytes are allocated since the previous sample,
+/// sampled object stands for sample_interval bytes (or for its own size if it's bigger),
+/// so sites are estimated without bias towards big objects. Interval of 1 byte records every allocation.
+class AllocationProfiler {
+public:
+    static constexpr size_t DEFAULT_SAMPLE_INTERVAL = 4 * KBYTE_SIZE;
+
+    /// Estimated allocations of objects of a class by an instruction
+    struct Site {
+        uint32_t pc {0};
+        const ClassDescription *class_descr {nullptr};
+        size_t n_bytes {0};
+        size_t n_objects {0};
+        // Objects which were alive after at least one sweep of GC
+        size_t n_survived_bytes {0};
+        size_t n_survived_objects {0};
+        // Objects which weren't freed till the report
+        size_t n_live_bytes {0};
+    };
+
+    NO_COPY_SEMANTIC(AllocationProfiler);
+    NO_MOVE_SEMANTIC(AllocationProfiler);
+
+    explicit AllocationProfiler(const Interpreter *interpreter, size_t sample_interval = DEFAULT_SAMPLE_INTERVAL);
+    ~AllocationProfiler() = default;
+
+    /// Called by HeapManager for each object
+    ALWAYS_INLINE void RecordAllocation(ObjectHeader *obj, size_t size)
+    {
+        if (LIKELY(size < bytes_until_sample_)) {
+            bytes_until_sample_ -= size;
+            return;
+        }
+        RecordSample(obj, size);
+    }
+
+    void RecordFree(ObjectHeader *obj);
+
+    /// Called by GC after sweep: every sampled object which is still tracked has survived it
+    void RecordGcCycle();
+
+    size_t GetSampleInterval() const
+    {
+        return sample_interval_;
+    }
+
+    /// Sites sorted by allocated bytes, objects which are alive now are counted as live ones
+    std::vector<Site> GetSites() const;
+
+    /// Writes sites as a table, pc_name names allocating instructions
+    bool WriteReport(const char *path, const std::function<std::string(uint32_t pc)> &pc_name) const;
+
+private:
+    struct Sample {
+        uint32_t pc {0};
+        uint32_t n_survived_gcs {0};
+        size_t n_bytes {0};
+        size_t n_objects {0};
+    };
+
+    using SiteKey = std::pair<uint32_t, const ClassDescription *>;
+
+    void RecordSample(ObjectHeader *obj, size_t size);
+
+    static void AddSample(std::map<SiteKey, Site> *sites, const ClassDescription *class_descr, const Sample &sample,
+                          bool is_live);
+
+private:
+    const Interpreter *interpreter_;
+    size_t sample_interval_;
+    size_t bytes_until_sample_;
+
+    std::unordered_map<ObjectHeader *, Sample> live_samples_;
+    // Sites of freed samples: class of an object is known only after allocation, so samples are folded later
+    std::map<SiteKey, Site> freed_sites_;
+};
+
+} // namespace evm::runtime
+
+#endif // EVM_RUNTIME_PROFILER_ALLOCATION_PROFILER_H
@@ -0,0 +1,94 @@
+#include "runtime/profiler/heap_census.h"
+#include "runtime/memory/class_description.h"
+#include "runtime/memory/class_manager.h"
+#include "runtime/memory/heap_manager.h"
+#include "runtime/memory/object_header.h"
+#include "runtime/memory/types/array.h"
+#include "runtime/memory/types/string.h"
+
+#include <algorithm>
+#include <bit>
+#include <unordered_map>
+
+namespace evm::runtime {
+
+/* static */
+HeapCensus HeapCensus::Take(const HeapManager &heap_manager, size_t gc_cycle)
+{
+    HeapCensus census;
+    census.gc_cycle = gc_cycle;
+
+    std::unordered_map<const ClassDescription *, ClassStats> classes;
+    for (const ObjectHeader *obj : heap_manager.GetObjectsList()) {
+        size_t size = HeapManager::GetObjectSize(obj);
+        if (obj->GetMarkWord().mark == 0) {
+            ++census.n_garbage_objects;
+            census.n_garbage_bytes += size;
+            continue;
+        }
+        ++census.n_live_objects;
+        census.n_live_bytes += size;
+
+        const ClassDescription *class_descr = obj->GetClassWord();
+        ClassStats &stats = classes[class_descr];
+        stats.class_descr = class_descr;
+        ++stats.n_objects;
+        stats.n_bytes += size;
+
+        if (class_descr->IsArrayObject()) {
+            size_t bucket = std::bit_width(static_cast<const types::Array *>(obj)->GetLength());
+            if (bucket >= census.array_lengths.size()) {
+                census.array_lengths.resize(bucket + 1);
+            }
+            ++census.array_lengths[bucket];
+        } else if (class_descr->IsStringObject()) {
+            ++census.n_strings;
+            census.n_string_bytes += size;
+            census.n_string_chars += static_cast<const types::String *>(obj)->GetLength();
+        }
+    }
+
+    for (const auto &[class_descr, stats] : classes) {
+        census.classes.push_back(stats);
+    }
+    std::sort(census.classes.begin(), census.classes.end(), [](const ClassStats &lhs, const ClassStats &rhs) {
+        return lhs.n_bytes != rhs.n_bytes ? lhs.n_bytes > rhs.n_bytes : lhs.n_objects > rhs.n_objects;
+    });
+
+    census.heap_size = heap_manager.GetHeapSize();
+    census.used_bytes = heap_manager.GetUsedMemorySize();
+    census.free_list = heap_manager.GetFreeListStats();
+    return census;
+}
+
+void HeapCensus::Print(FILE *file, const ClassManager &class_manager) const
+{
+    std::fprintf(file, "# Heap census of GC cycle %zu\n", gc_cycle);
+    std::fprintf(file, "live: %zu objects, %zu bytes\n", n_live_objects, n_live_bytes);
+    std::fprintf(file, "garbage: %zu objects, %zu bytes\n", n_garbage_objects, n_garbage_bytes);
+    std::fprintf(file, "heap: %zu bytes, %zu used\n", heap_size, used_bytes);
+    std::fprintf(file, "free list: %zu bytes in %zu blocks, largest block %zu bytes, fragmentation %.3f\n",
+                 free_list.free_bytes, free_list.n_free_blocks, free_list.largest_free_block, GetFragmentation());
+    std::fprintf(file, "strings: %zu objects, %zu bytes, %zu chars\n", n_strings, n_string_bytes, n_string_chars);
+
+    std::fprintf(file, "# %12s %10s  %s\n", "bytes", "objects", "class");
+    for (const ClassStats &stats : classes) {
+        std::fprintf(file, "  %12zu %10zu  %s\n", stats.n_bytes, stats.n_objects,
+                     class_manager.GetDisplayName(stats.class_descr).c_str());
+    }
+
+    std::fprintf(file, "# %12s %10s\n", "array length", "arrays");
+    for (size_t bucket = 0; bucket < array_lengths.size(); ++bucket) {
+        if (array_lengths[bucket] == 0) {
+            continue;
+        }
+        if (bucket == 0) {
+            std::fprintf(file, "  %12s %10zu\n", "0", array_lengths[bucket]);
+        } else {
+            size_t from = size_t {1} << (bucket - 1);
+            std::fprintf(file, "  %5zu..%-5zu %10zu\n", from, 2 * from - 1, array_lengths[bucket]);
+        }
+    }
+}
+
+} // namespace evm::runtime
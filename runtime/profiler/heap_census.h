@@ -0,0 +1,63 @@
+#ifndef EVM_RUNTIME_PROFILER_HEAP_CENSUS_H
+#define EVM_RUNTIME_PROFILER_HEAP_CENSUS_H
+
+#include "runtime/memory/allocator/freelist_allocator.h"
+
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+namespace evm::runtime {
+
+class ClassDescription;
+class ClassManager;
+class HeapManager;
+
+/// Contents of the heap between marking and sweep of GC: marked objects are the live ones
+struct HeapCensus {
+    struct ClassStats {
+        const ClassDescription *class_descr {nullptr};
+        size_t n_objects {0};
+        size_t n_bytes {0};
+    };
+
+    size_t gc_cycle {0};
+
+    size_t n_live_objects {0};
+    size_t n_live_bytes {0};
+    // Unmarked objects which are freed by the sweep
+    size_t n_garbage_objects {0};
+    size_t n_garbage_bytes {0};
+
+    // Live objects of each class sorted by bytes, sizes are the ones of heap blocks
+    std::vector<ClassStats> classes;
+
+    // Live arrays by length: bucket 0 counts empty arrays, bucket k counts lengths in [2^(k-1), 2^k)
+    std::vector<size_t> array_lengths;
+
+    size_t n_strings {0};
+    size_t n_string_bytes {0};
+    size_t n_string_chars {0};
+
+    size_t heap_size {0};
+    size_t used_bytes {0};
+    FreeListStats free_list;
+
+    /// Part of free memory which can't be taken by a single allocation
+    double GetFragmentation() const
+    {
+        if (free_list.free_bytes == 0) {
+            return 0;
+        }
+        return 1.0 - static_cast<double>(free_list.largest_free_block) / static_cast<double>(free_list.free_bytes);
+    }
+
+    /// Walks all objects of the heap, must be called when marking is finished
+    static HeapCensus Take(const HeapManager &heap_manager, size_t gc_cycle);
+
+    void Print(FILE *file, const ClassManager &class_manager) const;
+};
+
+} // namespace evm::runtime
+
+#endif // EVM_RUNTIME_PROFILER_HEAP_CENSUS_H
@@ -0,0 +1,129 @@
+#include "runtime/profiler/sampling_profiler.h"
+#include "common/logs.h"
+
+#include <cstdio>
+#include <sys/time.h>
+
+namespace evm::runtime {
+
+std::atomic<SamplingProfiler *> SamplingProfiler::active_ {nullptr};
+
+SamplingProfiler::SamplingProfiler(size_t max_samples)
+    : samples_(max_samples * SAMPLE_SIZE), max_samples_(max_samples)
+{
+}
+
+SamplingProfiler::~SamplingProfiler()
+{
+    Stop();
+}
+
+bool SamplingProfiler::Start(const PublishedCallStack *call_stack, size_t period_us)
+{
+    SamplingProfiler *expected = nullptr;
+    if (!active_.compare_exchange_strong(expected, this)) {
+        PrintErr("Sampling profiler is already started");
+        return false;
+    }
+    call_stack_ = call_stack;
+    n_samples_.store(0, std::memory_order_relaxed);
+    n_dropped_.store(0, std::memory_order_relaxed);
+
+    // Interrupted system calls are restarted, the profiled program shouldn't see the signal
+    struct sigaction action {};
+    action.sa_handler = HandleSignal;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGPROF, &action, &old_action_);
+
+    period_us = period_us == 0 ? 1 : period_us;
+    itimerval timer {};
+    timer.it_interval.tv_sec = static_cast<time_t>(period_us / 1000000);
+    timer.it_interval.tv_usec = static_cast<suseconds_t>(period_us % 1000000);
+    timer.it_value = timer.it_interval;
+    if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+        PrintErr("Cannot start profiling timer");
+        sigaction(SIGPROF, &old_action_, nullptr);
+        active_.store(nullptr);
+        return false;
+    }
+    return true;
+}
+
+void SamplingProfiler::Stop()
+{
+    if (active_.load() != this) {
+        return;
+    }
+    itimerval timer {};
+    setitimer(ITIMER_PROF, &timer, nullptr);
+    // Handler of a tick which is already pending finds no active profiler
+    active_.store(nullptr);
+    sigaction(SIGPROF, &old_action_, nullptr);
+}
+
+/* static */
+void SamplingProfiler::HandleSignal([[maybe_unused]] int signal)
+{
+    SamplingProfiler *profiler = active_.load(std::memory_order_acquire);
+    if (profiler != nullptr) {
+        profiler->TakeSample();
+    }
+}
+
+void SamplingProfiler::TakeSample()
+{
+    // Handler only copies pcs: no allocations and no locks
+    size_t idx = n_samples_.load(std::memory_order_relaxed);
+    if (UNLIKELY(idx == max_samples_)) {
+        n_dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    size_t depth = call_stack_->GetDepth();
+    if (depth == 0) {
+        return;
+    }
+
+    uint32_t *sample = &samples_[idx * SAMPLE_SIZE];
+    sample[0] = static_cast<uint32_t>(depth);
+    call_stack_->Read(sample + 1, MAX_SAMPLE_DEPTH);
+    n_samples_.store(idx + 1, std::memory_order_release);
+}
+
+std::map<std::string, size_t> SamplingProfiler::FoldStacks(
+    const std::function<std::string(uint32_t pc)> &pc_name) const
+{
+    std::map<std::string, size_t> stacks;
+    size_t n_samples = GetSamplesCount();
+    for (size_t i = 0; i < n_samples; ++i) {
+        const uint32_t *sample = &samples_[i * SAMPLE_SIZE];
+        size_t depth = sample[0];
+        size_t n_frames = depth < MAX_SAMPLE_DEPTH ? depth : MAX_SAMPLE_DEPTH;
+        n_frames = n_frames < PublishedCallStack::MAX_DEPTH ? n_frames : PublishedCallStack::MAX_DEPTH;
+
+        std::string stack = n_frames < depth ? TRUNCATED_FRAME : "";
+        for (size_t frame = 0; frame < n_frames; ++frame) {
+            if (!stack.empty()) {
+                stack += ';';
+            }
+            stack += pc_name(sample[1 + frame]);
+        }
+        ++stacks[stack];
+    }
+    return stacks;
+}
+
+bool SamplingProfiler::WriteFoldedStacks(const char *path,
+                                         const std::function<std::string(uint32_t pc)> &pc_name) const
+{
+    FILE *file = std::fopen(path, "w");
+    if (file == nullptr) {
+        return false;
+    }
+    for (const auto &[stack, count] : FoldStacks(pc_name)) {
+        std::fprintf(file, "%s %zu\n", stack.c_str(), count);
+    }
+    return std::fclose(file) == 0;
+}
+
+} // namespace evm::runtime
@@ -0,0 +1,77 @@
+#ifndef EVM_RUNTIME_PROFILER_SAMPLING_PROFILER_H
+#define EVM_RUNTIME_PROFILER_SAMPLING_PROFILER_H
+
+#include "common/macros.h"
+#include "runtime/interpreter/call_stack.h"
+
+#include <atomic>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace evm::runtime {
+
+/// Statistical profiler of bytecode: SIGPROF of a CPU-time timer copies the published call stack
+/// of the interpreter into a preallocated buffer, samples are symbolized only after Stop().
+/// Result is written as folded stacks ("main;outer;inner count" lines) which flamegraph tools take as input.
+/// Only one profiler can be started at a time, since the signal and the timer are process-wide.
+class SamplingProfiler {
+public:
+    static constexpr size_t DEFAULT_MAX_SAMPLES = 1U << 14;
+    static constexpr size_t DEFAULT_PERIOD_US = 1000;
+    // Deeper stacks are cut from the outer side and get TRUNCATED_FRAME instead
+    static constexpr size_t MAX_SAMPLE_DEPTH = 64;
+    static constexpr const char *TRUNCATED_FRAME = "[truncated]";
+
+    NO_COPY_SEMANTIC(SamplingProfiler);
+    NO_MOVE_SEMANTIC(SamplingProfiler);
+
+    explicit SamplingProfiler(size_t max_samples = DEFAULT_MAX_SAMPLES);
+    ~SamplingProfiler();
+
+    /// Samples call_stack every period_us microseconds of CPU time consumed by the process
+    bool Start(const PublishedCallStack *call_stack, size_t period_us = DEFAULT_PERIOD_US);
+    void Stop();
+
+    /// Number of kept samples, ticks without bytecode on the stack aren't sampled
+    size_t GetSamplesCount() const
+    {
+        return n_samples_.load(std::memory_order_acquire);
+    }
+
+    /// Number of ticks after the buffer got full
+    size_t GetDroppedCount() const
+    {
+        return n_dropped_.load(std::memory_order_relaxed);
+    }
+
+    /// Counts samples of each stack, frames are named by pc_name and separated with ';'
+    std::map<std::string, size_t> FoldStacks(const std::function<std::string(uint32_t pc)> &pc_name) const;
+
+    bool WriteFoldedStacks(const char *path, const std::function<std::string(uint32_t pc)> &pc_name) const;
+
+private:
+    // Sample is a record of the total depth and MAX_SAMPLE_DEPTH entry pcs
+    static constexpr size_t SAMPLE_SIZE = MAX_SAMPLE_DEPTH + 1;
+
+    static void HandleSignal(int signal);
+    void TakeSample();
+
+private:
+    static std::atomic<SamplingProfiler *> active_;
+
+    const PublishedCallStack *call_stack_ {nullptr};
+    std::vector<uint32_t> samples_;
+    size_t max_samples_;
+    std::atomic<size_t> n_samples_ {0};
+    std::atomic<size_t> n_dropped_ {0};
+    struct sigaction old_action_ {};
+};
+
+} // namespace evm::runtime
+
+#endif // EVM_RUNTIME_PROFILER_SAMPLING_PROFILER_H
@@ -2,13 +2,16 @@
 #include "runtime/runtime.h"
 #include "file_format/file.h"
 #include "runtime/memory/garbage_collector/gc_incremental.h"
+#include "runtime/memory/types/string.h"
+
+#include <cstring>
 
 namespace evm::runtime {
 
 Runtime *Runtime::instance_ = nullptr;
 
 /* static */
-bool Runtime::Create()
+bool Runtime::Create(size_t min_heap_size, size_t max_heap_size)
 {
     if (instance_ != nullptr) {
         PrintErr("Runtime already exists");
@@ -21,7 +24,11 @@ bool Runtime::Create()
         return false;
     }
 
-    instance_->InitializeRuntime();
+    if (!instance_->InitializeRuntime(min_heap_size, max_heap_size)) {
+        delete instance_;
+        instance_ = nullptr;
+        return false;
+    }
 
     return true;
 }
@@ -39,13 +46,34 @@ bool Runtime::Destroy()
     return true;
 }
 
-void Runtime::InitializeRuntime()
+bool Runtime::InitializeRuntime(size_t min_heap_size, size_t max_heap_size)
 {
-    heap_manager_ = std::make_unique<HeapManager>(DEFAULT_HEAP_SIZE);
+    heap_manager_ = std::make_unique<HeapManager>(min_heap_size, max_heap_size);
+    if (!heap_manager_->IsInitialized()) {
+        PrintErr("Failed to create heap of ", min_heap_size, " to ", max_heap_size, " bytes");
+        return false;
+    }
     interpreter_ = std::make_unique<Interpreter>();
 
     class_manager_.InitDefaultClassDescriptions();
     gc_ = std::make_unique<GarbageCollectorIncremental>();
+    return true;
+}
+
+void Runtime::EnableJit(size_t hotness_threshold)
+{
+    interpreter_->EnableJit(hotness_threshold);
+}
+
+void Runtime::EnableAllocationProfiler(size_t sample_interval)
+{
+    alloc_profiler_ = std::make_unique<AllocationProfiler>(interpreter_.get(), sample_interval);
+    heap_manager_->SetAllocationProfiler(alloc_profiler_.get());
+}
+
+void Runtime::SetInterpreterEngine(Interpreter::Engine engine)
+{
+    interpreter_->SetEngine(engine);
 }
 
 void Runtime::Execute(file_format::File *file)
@@ -54,28 +82,45 @@ void Runtime::Execute(file_format::File *file)
 
     file_ = file;
     file->EmitBytecode(&bytecode_);
+    LoadStringLiterals(file);
 
     size_t entrypoint = file->GetCodeSection()->GetOffset();
     interpreter_->Run(file, bytecode_.data(), entrypoint);
 }
 
-const std::string *Runtime::GetStringFromCache(uint32_t string_offset)
+bool Runtime::ExecuteCompiled(file_format::File *file, const byte_t *bytecode, size_t bytecode_size,
+                              Interpreter::CompiledFunction entry)
 {
-    if (auto find = string_cache_.find(string_offset); find != string_cache_.end()) {
-        return &(find->second);
+    assert(file != nullptr);
+
+    file_ = file;
+    file->EmitBytecode(&bytecode_);
+
+    // Compiled code reads operands from its own copy of bytecode, while runtime uses emitted one for strings
+    if (bytecode_.size() != bytecode_size || std::memcmp(bytecode_.data(), bytecode, bytecode_size) != 0) {
+        PrintErr("Bytecode of the file differs from the compiled one");
+        return false;
     }
-    return nullptr;
-}
+    LoadStringLiterals(file);
 
-const std::string *Runtime::CreateStringAndSetInCache(uint32_t string_offset)
-{
-    // Strings in bytecode are null-terminated.
-    std::string str(reinterpret_cast<char *>(bytecode_.data()) + string_offset);
+    size_t entrypoint = file->GetCodeSection()->GetOffset();
+    interpreter_->RunCompiled(file, entrypoint, entry);
 
-    auto pair = string_cache_.insert({string_offset, std::move(str)});
-    auto iter = pair.first;
+    return true;
+}
 
-    return &(iter->second);
+void Runtime::LoadStringLiterals(file_format::File *file)
+{
+    // Created strings are copies of the literals: lengths are calculated once for all of them
+    auto *string_pool = file->GetHeader()->GetStringPool();
+    string_literals_.clear();
+    string_literals_.reserve(string_pool->GetInstancesCount());
+    for (size_t i = 0, count = string_pool->GetInstancesCount(); i < count; ++i) {
+        StringLiteral literal;
+        literal.data = bytecode_.data() + string_pool->GetInstanceOffset(i);
+        literal.length = string_pool->GetInstance(i).size() + 1;
+        string_literals_.push_back(literal);
+    }
 }
 
 } // namespace evm::runtime
@@ -6,10 +6,11 @@
 #include "runtime/memory/heap_manager.h"
 #include "runtime/interpreter/interpreter.h"
 #include "runtime/memory/class_manager.h"
+#include "runtime/profiler/allocation_profiler.h"
 
+#include <cassert>
+#include <cstdint>
 #include <vector>
-#include <string>
-#include <unordered_map>
 
 namespace evm::file_format {
 class File;
@@ -19,13 +20,15 @@ namespace evm::runtime {
 
 class Runtime {
 public:
-    size_t DEFAULT_HEAP_SIZE = 32 * MBYTE_SIZE;
+    static constexpr size_t DEFAULT_MIN_HEAP_SIZE = 32 * MBYTE_SIZE;
+    static constexpr size_t DEFAULT_MAX_HEAP_SIZE = 4 * GBYTE_SIZE;
 
 public:
     NO_COPY_SEMANTIC(Runtime);
     NO_MOVE_SEMANTIC(Runtime);
 
-    static bool Create();
+    /// Heap starts with min_heap_size committed and grows up to max_heap_size, see HeapManager
+    static bool Create(size_t min_heap_size = DEFAULT_MIN_HEAP_SIZE, size_t max_heap_size = DEFAULT_MAX_HEAP_SIZE);
     static bool Destroy();
 
     static Runtime *GetInstance()
@@ -68,10 +71,38 @@ public:
         return gc_.get();
     }
 
+    /// Compile hot code of executed programs, threshold is the number of entries to a pc before compilation
+    void EnableJit(size_t hotness_threshold);
+
+    /// Sample allocations of objects till the runtime is destroyed, see AllocationProfiler
+    void EnableAllocationProfiler(size_t sample_interval);
+
+    const AllocationProfiler *GetAllocationProfiler() const
+    {
+        return alloc_profiler_.get();
+    }
+
+    /// Dispatch of interpreted instructions, computed goto is the default one
+    void SetInterpreterEngine(Interpreter::Engine engine);
+
     void Execute(file_format::File *file);
 
-    const std::string *GetStringFromCache(uint32_t string_offset);
-    const std::string *CreateStringAndSetInCache(uint32_t string_offset);
+    /// Execute ahead-of-time compiled code of the file, bytecode is the one that code was compiled from
+    bool ExecuteCompiled(file_format::File *file, const byte_t *bytecode, size_t bytecode_size,
+                         Interpreter::CompiledFunction entry);
+
+    /// Literal of the string pool prepared at load time, data points to emitted bytecode
+    struct StringLiteral {
+        const uint8_t *data {nullptr};
+        size_t length {0}; // with terminating \0, as in string objects
+    };
+
+    /// idx is the immediate of newstr: index of the literal in the string pool
+    const StringLiteral &GetStringLiteral(size_t idx) const
+    {
+        assert(idx < string_literals_.size());
+        return string_literals_[idx];
+    }
 
     ClassManager *GetClassManager()
     {
@@ -82,7 +113,8 @@ private:
     Runtime() = default;
     ~Runtime() = default;
 
-    void InitializeRuntime();
+    bool InitializeRuntime(size_t min_heap_size, size_t max_heap_size);
+    void LoadStringLiterals(file_format::File *file);
 
 private:
     static Runtime *instance_;
@@ -90,9 +122,10 @@ private:
     std::unique_ptr<HeapManager> heap_manager_;
     std::unique_ptr<Interpreter> interpreter_;
     std::unique_ptr<GarbageCollectorIncremental> gc_;
+    std::unique_ptr<AllocationProfiler> alloc_profiler_;
 
     std::vector<byte_t> bytecode_;
-    std::unordered_map<uint32_t, std::string> string_cache_;
+    std::vector<StringLiteral> string_literals_;
 
     ClassManager class_manager_;
 
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+
+#include "aot/byte2cpp.h"
+#include "assembler/asm2byte/asm2byte.h"
+#include "runtime/runtime.h"
+
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+namespace evm::compiled {
+// Generated from program.ea by evm-aot
+bool RunCompiledProgram(file_format::File *file);
+} // namespace evm::compiled
+
+namespace evm::aot {
+
+static constexpr size_t N_CHECKED_REGS = 64;
+
+class AotTest : public testing::Test {
+public:
+    void SetUp() override
+    {
+        std::ifstream input(AOT_TEST_PROGRAM);
+        ASSERT_TRUE(input);
+
+        std::stringstream source;
+        source << input.rdbuf();
+        source_ = source.str();
+
+        ASSERT_TRUE(runtime::Runtime::Create());
+    }
+
+    void TearDown() override
+    {
+        ASSERT_TRUE(runtime::Runtime::Destroy());
+    }
+
+    static std::vector<int64_t> GetRegs()
+    {
+        const auto *frame = runtime::Runtime::GetInstance()->GetInterpreter()->GetCurrFrame();
+
+        std::vector<int64_t> regs;
+        for (size_t i = 0; i < N_CHECKED_REGS; ++i) {
+            regs.push_back(frame->GetReg(i)->GetInt64());
+        }
+        return regs;
+    }
+
+protected:
+    std::string source_;
+};
+
+TEST_F(AotTest, FunctionPerCallTarget)
+{
+    file_format::File file;
+    asm2byte::AsmToByte asm2byte;
+    ASSERT_TRUE(asm2byte.ParseAsmString(source_, &file));
+
+    std::ostringstream out;
+    ByteToCpp byte2cpp;
+    ASSERT_TRUE(byte2cpp.Generate(&file, source_, out));
+
+    // Entrypoint, "fill" and "sum_points"
+    const auto &entries = byte2cpp.GetFunctionEntries();
+    ASSERT_EQ(entries.size(), 3);
+    ASSERT_EQ(entries[0], file.GetCodeSection()->GetOffset());
+
+    for (size_t entry : entries) {
+        ASSERT_NE(out.str().find("static bool Function_" + std::to_string(entry) + "("), std::string::npos);
+    }
+}
+
+TEST_F(AotTest, SameResultAsInterpreter)
+{
+    file_format::File interpreted_file;
+    asm2byte::AsmToByte asm2byte;
+    ASSERT_TRUE(asm2byte.ParseAsmString(source_, &interpreted_file));
+
+    runtime::Runtime::GetInstance()->Execute(&interpreted_file);
+    std::vector<int64_t> interpreted_regs = GetRegs();
+
+    ASSERT_TRUE(runtime::Runtime::Destroy());
+    ASSERT_TRUE(runtime::Runtime::Create());
+
+    file_format::File compiled_file;
+    ASSERT_TRUE(compiled::RunCompiledProgram(&compiled_file));
+    std::vector<int64_t> compiled_regs = GetRegs();
+
+    // Registers with object pointers differ between runs
+    for (size_t reg : {1, 2, 3, 4, 5, 40, 41, 42, 43}) {
+        ASSERT_EQ(compiled_regs[reg], interpreted_regs[reg]) << "x" << reg;
+    }
+
+    ASSERT_EQ(compiled_regs[4], 328350); // sum of squares of [0, 100)
+    ASSERT_EQ(compiled_regs[5], 4950);   // sum of [0, 100)
+    ASSERT_EQ(compiled_regs[42], 0);     // skipped by dynamic jump
+    ASSERT_EQ(compiled_regs[43], 42);
+}
+
+} // namespace evm::aot
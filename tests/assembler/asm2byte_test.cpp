@@ -0,0 +1,228 @@
+#include <gtest/gtest.h>
+
+#include "assembler/asm2byte/asm2byte.h"
+#include "assembler/asm2byte/lexer.h"
+#include "file_format/file.h"
+#include "file_format/symbolizer.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace evm::asm2byte {
+
+TEST(LexerTest, Tokens)
+{
+    std::string_view source = "  label:\n"
+                              "\n"
+                              "\tadd x1, x2,x3\r\n"
+                              "    int a; int b;\n"
+                              "    str_immut x100, 'Foo, bar:null'\n"
+                              "    exit";
+
+    Lexer lexer(source);
+    LineInfo line;
+
+    ASSERT_TRUE(lexer.NextLine(&line));
+    ASSERT_EQ(line.size(), 1);
+    ASSERT_EQ(line[0], "label:");
+    ASSERT_EQ(line.GetLineNumber(), 1);
+
+    ASSERT_TRUE(lexer.NextLine(&line));
+    ASSERT_EQ(line.size(), 4);
+    ASSERT_EQ(line[0], "add");
+    ASSERT_EQ(line[1], "x1");
+    ASSERT_EQ(line[2], "x2");
+    ASSERT_EQ(line[3], "x3");
+    ASSERT_EQ(line[4], "");
+    ASSERT_EQ(line.GetLineNumber(), 3);
+
+    ASSERT_TRUE(lexer.NextLine(&line));
+    ASSERT_EQ(line.size(), 4);
+    ASSERT_EQ(line[1], "a");
+    ASSERT_EQ(line[3], "b");
+
+    ASSERT_TRUE(lexer.NextLine(&line));
+    ASSERT_EQ(line.size(), 3);
+    ASSERT_EQ(line[2], "Foo, bar:null");
+
+    ASSERT_TRUE(lexer.NextLine(&line));
+    ASSERT_EQ(line.size(), 1);
+    ASSERT_EQ(line[0], "exit");
+    // Tokens point into the source buffer
+    ASSERT_EQ(line[0].data(), source.data() + source.size() - 4);
+
+    ASSERT_FALSE(lexer.NextLine(&line));
+    ASSERT_FALSE(lexer.HasError());
+}
+
+TEST(LexerTest, Errors)
+{
+    LineInfo line;
+
+    Lexer unterminated("newstr x1, 'abc\nexit\n");
+    ASSERT_FALSE(unterminated.NextLine(&line));
+    ASSERT_TRUE(unterminated.HasError());
+
+    Lexer invalid_symbol("add x1, x2, x\x01");
+    ASSERT_FALSE(invalid_symbol.NextLine(&line));
+    ASSERT_TRUE(invalid_symbol.HasError());
+}
+
+static std::string GenerateProgram(size_t n_functions)
+{
+    std::string source = R"(
+        .class Foo
+            int a;
+            arr x[3];
+        .class
+        .class Bar
+            class Foo foo;
+        .class
+
+        movif x0, func_0
+        call x0
+        exit
+    )";
+
+    for (size_t i = 0; i < n_functions; ++i) {
+        std::string idx = std::to_string(i);
+        source += "\nfunc_" + idx + ":\n";
+        source += "    newobj x1, Bar\n";
+        source += "    obj_get_field x2, Bar@foo, x1\n";
+        source += "    movif x3, " + idx + "\n";
+        source += "    obj_set_field x2, Foo@a, x3\n";
+        source += "    str_immut x4, 'str " + std::to_string(i % 7) + "'\n";
+        source += "    movif x5, func_" + std::to_string((i + 1) % n_functions) + "\n";
+        source += "    jmp_if_imm x3, func_" + std::to_string(i / 2) + "\n";
+        source += "    ret\n";
+    }
+
+    return source;
+}
+
+static std::vector<byte_t> Assemble(const std::vector<std::string_view> &sources, size_t n_threads)
+{
+    file_format::File file;
+    AsmToByte asm2byte;
+    asm2byte.SetParallelism(n_threads, 0);
+    EXPECT_TRUE(asm2byte.ParseAsmStrings(sources, &file));
+
+    std::vector<byte_t> bytecode;
+    file.EmitBytecode(&bytecode);
+    return bytecode;
+}
+
+TEST(AsmToByteTest, ParallelSameAsSequential)
+{
+    std::string source = GenerateProgram(100);
+
+    std::vector<byte_t> sequential = Assemble({source}, 1);
+    ASSERT_FALSE(sequential.empty());
+
+    for (size_t n_threads : {2, 3, 8}) {
+        ASSERT_EQ(Assemble({source}, n_threads), sequential);
+    }
+}
+
+TEST(AsmToByteTest, MultipleSources)
+{
+    std::string source = GenerateProgram(20);
+
+    size_t split = source.find("func_10:");
+    ASSERT_NE(split, std::string::npos);
+
+    std::string_view view = source;
+    std::vector<std::string_view> sources {view.substr(0, split), view.substr(split)};
+
+    std::vector<byte_t> whole = Assemble({source}, 1);
+    ASSERT_EQ(Assemble(sources, 1), whole);
+    ASSERT_EQ(Assemble(sources, 4), whole);
+}
+
+TEST(AsmToByteTest, ClassOfEarlierSource)
+{
+    std::string_view first = R"(
+        .class Foo
+            int a;
+        .class
+    )";
+    std::string_view second = R"(
+        .class Bar
+            class Foo foo;
+            class Foo items[2];
+        .class
+
+        newobj x1, Bar
+        exit
+    )";
+    std::string whole = std::string(first) + std::string(second);
+
+    // Field classes of a later source are resolved after sources are merged, as in a single one
+    std::vector<byte_t> sequential = Assemble({whole}, 1);
+    ASSERT_EQ(Assemble({first, second}, 1), sequential);
+    ASSERT_EQ(Assemble({first, second}, 2), sequential);
+
+    file_format::File file;
+    AsmToByte asm2byte;
+    ASSERT_TRUE(asm2byte.ParseAsmStrings({first, second}, &file));
+    auto &bar = file.GetHeader()->GetClassSection()->GetInstances()->back();
+    for (auto &field : *bar.GetInstances()) {
+        ASSERT_EQ(field.GetClassRefIdx(), 0U);
+        ASSERT_TRUE(field.GetClassRefName().empty());
+    }
+
+    file_format::File undefined_file;
+    ASSERT_FALSE(asm2byte.ParseAsmStrings({second}, &undefined_file));
+}
+
+TEST(AsmToByteTest, MoreThan32KInstructions)
+{
+    constexpr size_t N_INSTRS = 100000;
+
+    std::string source = "main:\n";
+    for (size_t i = 0; i < N_INSTRS; ++i) {
+        source += "    movif x1, " + std::to_string(i) + "\n";
+    }
+    source += "    movif x2, main\n    exit\n";
+
+    file_format::File file;
+    AsmToByte asm2byte;
+    ASSERT_TRUE(asm2byte.ParseAsmString(source, &file));
+    ASSERT_EQ(file.GetCodeSection()->GetInstructions().size(), N_INSTRS + 2);
+
+    std::vector<byte_t> bytecode;
+    file.EmitBytecode(&bytecode);
+    ASSERT_EQ(bytecode.size(), file.GetBytecodeSize());
+}
+
+TEST(AsmToByteTest, Symbolizer)
+{
+    auto source = R"(
+        movif x1, func
+        call x1, x0
+        exit
+    func:
+    alias:
+        movif x2, 1
+        ret
+    other:
+        exit
+    )";
+
+    file_format::File file;
+    AsmToByte asm2byte;
+    ASSERT_TRUE(asm2byte.ParseAsmString(source, &file));
+
+    size_t code_start = file.GetCodeSection()->GetOffset();
+    const auto &labels = file.GetCodeSection()->GetLabels();
+    size_t func = code_start + labels.at("func");
+
+    file_format::Symbolizer symbolizer(&file);
+    ASSERT_EQ(symbolizer.GetName(code_start), "main");
+    ASSERT_EQ(symbolizer.GetName(func), "alias");
+    ASSERT_EQ(symbolizer.GetName(func + 1), "alias");
+    ASSERT_EQ(symbolizer.GetName(code_start + labels.at("other") + 100), "other");
+}
+
+} // namespace evm::asm2byte
@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+
+#include "common/utils/chunked_vector.h"
+
+#include <vector>
+
+namespace evm::common {
+
+TEST(ChunkedVectorTest, StableAddresses)
+{
+    constexpr size_t N_ELEMENTS = 100;
+
+    ChunkedVector<int, 8> vector;
+    std::vector<int *> addresses;
+
+    for (size_t i = 0; i < N_ELEMENTS; ++i) {
+        addresses.push_back(&vector.emplace_back(static_cast<int>(i)));
+    }
+
+    ASSERT_EQ(vector.size(), N_ELEMENTS);
+    ASSERT_EQ(vector.back(), static_cast<int>(N_ELEMENTS - 1));
+
+    int expected = 0;
+    for (int &elem : vector) {
+        ASSERT_EQ(&elem, addresses[expected]);
+        ASSERT_EQ(elem, expected++);
+    }
+}
+
+TEST(ChunkedVectorTest, Splice)
+{
+    ChunkedVector<int, 4> first;
+    ChunkedVector<int, 4> second;
+    ChunkedVector<int, 4> empty;
+
+    for (int i = 0; i < 5; ++i) {
+        first.emplace_back(i);
+    }
+    int *moved = nullptr;
+    for (int i = 5; i < 11; ++i) {
+        int &elem = second.emplace_back(i);
+        moved = i == 5 ? &elem : moved;
+    }
+
+    first.Splice(&empty);
+    first.Splice(&second);
+    ASSERT_TRUE(second.empty());
+
+    // Partially filled chunks are left in the middle, new elements go to the end
+    first.emplace_back(11);
+    ASSERT_EQ(first.size(), 12);
+
+    int expected = 0;
+    for (const int &elem : first) {
+        if (expected == 5) {
+            ASSERT_EQ(&elem, moved);
+        }
+        ASSERT_EQ(elem, expected++);
+    }
+    ASSERT_EQ(expected, 12);
+}
+
+} // namespace evm::common
@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+
+#include "common/utils/crc32.h"
+
+#include <cstring>
+#include <vector>
+
+namespace evm::common {
+
+TEST(Crc32Test, CheckValue)
+{
+    // Standard check value of CRC-32C
+    const char *check_str = "123456789";
+    const auto *data = reinterpret_cast<const uint8_t *>(check_str);
+
+    ASSERT_EQ(Crc32SlicingBy8(data, std::strlen(check_str)), 0xe3069283);
+    ASSERT_EQ(Crc32(data, std::strlen(check_str)), 0xe3069283);
+
+    if (IsCrc32HwSupported()) {
+        ASSERT_EQ(Crc32Sse42(data, std::strlen(check_str)), 0xe3069283);
+    }
+}
+
+TEST(Crc32Test, ImplementationsMatch)
+{
+    constexpr size_t MAX_LENGTH = 300;
+    constexpr size_t MAX_MISALIGNMENT = 8;
+
+    std::vector<uint8_t> buffer(MAX_LENGTH + MAX_MISALIGNMENT);
+    for (size_t i = 0; i < buffer.size(); ++i) {
+        buffer[i] = static_cast<uint8_t>(i * 31 + 7);
+    }
+
+    for (size_t offset = 0; offset < MAX_MISALIGNMENT; ++offset) {
+        for (size_t length = 0; length <= MAX_LENGTH; ++length) {
+            const uint8_t *data = buffer.data() + offset;
+            uint32_t expected = Crc32SlicingBy8(data, length);
+
+            ASSERT_EQ(Crc32(data, length), expected);
+            if (IsCrc32HwSupported()) {
+                ASSERT_EQ(Crc32Sse42(data, length), expected);
+            }
+        }
+    }
+}
+
+TEST(Crc32Test, Incremental)
+{
+    const char *str = "incremental crc32 calculation";
+    const auto *data = reinterpret_cast<const uint8_t *>(str);
+    size_t length = std::strlen(str);
+
+    uint32_t part = Crc32(data, length / 2);
+    ASSERT_EQ(Crc32(data + length / 2, length - length / 2, part), Crc32(data, length));
+}
+
+} // namespace evm::common
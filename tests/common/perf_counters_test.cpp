@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+
+#include "common/perf_counters.h"
+
+#include <cstdio>
+#include <string>
+
+namespace evm::perf {
+
+namespace {
+
+// Loop which isn't optimized away, its iterations take task clock and instructions
+uint64_t Spin(size_t n_iterations)
+{
+    volatile uint64_t sum = 0;
+    for (size_t i = 0; i < n_iterations; ++i) {
+        sum = sum + i;
+    }
+    return sum;
+}
+
+} // namespace
+
+TEST(PerfCountersTest, NestedPhases)
+{
+    bool is_enabled = PerfCounters::Enable();
+    ASSERT_EQ(is_enabled, PerfCounters::IsEnabled());
+    {
+        ScopedPerfPhase interpreter_phase(Phase::INTERPRETER);
+        Spin(2000000);
+        {
+            ScopedPerfPhase mark_phase(Phase::GC_MARK);
+            Spin(2000000);
+        }
+        Spin(2000000);
+    }
+    // Counts outside of phases aren't attributed
+    Spin(2000000);
+    PerfCounters::Disable();
+
+    // Containers may have no counters at all, then phases only must not break anything
+    if (!is_enabled) {
+        for (size_t counter = 0; counter < static_cast<size_t>(Counter::N_COUNTERS); ++counter) {
+            ASSERT_FALSE(PerfCounters::IsAvailable(static_cast<Counter>(counter)));
+        }
+        return;
+    }
+
+    for (auto counter : {Counter::INSTRUCTIONS, Counter::TASK_CLOCK_NS}) {
+        if (!PerfCounters::IsAvailable(counter)) {
+            continue;
+        }
+        ASSERT_GT(PerfCounters::GetTotal(Phase::INTERPRETER, counter), 0U);
+        ASSERT_GT(PerfCounters::GetTotal(Phase::GC_MARK, counter), 0U);
+        ASSERT_EQ(PerfCounters::GetTotal(Phase::GC_SWEEP, counter), 0U);
+    }
+    // Enclosing phase ran twice as long as the nested one
+    if (PerfCounters::IsAvailable(Counter::INSTRUCTIONS)) {
+        ASSERT_GT(PerfCounters::GetTotal(Phase::INTERPRETER, Counter::INSTRUCTIONS),
+                  PerfCounters::GetTotal(Phase::GC_MARK, Counter::INSTRUCTIONS));
+    }
+
+    char buffer[4096] = {};
+    FILE *file = fmemopen(buffer, sizeof(buffer) - 1, "w");
+    ASSERT_NE(file, nullptr);
+    PerfCounters::Report(file);
+    std::fclose(file);
+
+    std::string report(buffer);
+    ASSERT_NE(report.find("interpreter"), std::string::npos);
+    ASSERT_NE(report.find("gc_mark"), std::string::npos);
+    ASSERT_NE(report.find("task_clock_ns"), std::string::npos);
+}
+
+} // namespace evm::perf
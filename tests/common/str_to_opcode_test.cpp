@@ -0,0 +1,30 @@
+#include <gtest/gtest.h>
+
+#include "common/opcode_to_str.h"
+#include "common/str_to_opcode.h"
+#include "isa/opcodes.h"
+
+namespace evm::common {
+
+TEST(StrToOpcodeTest, AllMnemonics)
+{
+    // clang-format off
+    #define DEFINE_INSTR(instr, opcode, interpret) \
+        ASSERT_EQ(StringToOpcode(OpcodeToString(Opcode::instr)), Opcode::instr);
+
+    #include "isa/isa.def"
+
+    #undef DEFINE_INSTR
+    // clang-format on
+}
+
+TEST(StrToOpcodeTest, InvalidMnemonics)
+{
+    ASSERT_EQ(StringToOpcode(""), Opcode::INVALID);
+    ASSERT_EQ(StringToOpcode("ADD"), Opcode::INVALID);
+    ASSERT_EQ(StringToOpcode("ad"), Opcode::INVALID);
+    ASSERT_EQ(StringToOpcode("addd"), Opcode::INVALID);
+    ASSERT_EQ(StringToOpcode("label:"), Opcode::INVALID);
+}
+
+} // namespace evm::common
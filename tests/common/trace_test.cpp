@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+
+#include "common/trace.h"
+#include "isa/opcodes.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace evm::trace {
+
+TEST(TracerTest, DisabledTracerRecordsNothing)
+{
+    Tracer::Enable(4);
+    Tracer::Disable();
+    TRACE_EVENT(INSTRUCTION, Opcode::ADD, 0x10);
+    ASSERT_EQ(Tracer::GetRecordedCount(), 0U);
+}
+
+TEST(TracerTest, RingBufferKeepsLastEvents)
+{
+    // Capacity is rounded up to 8
+    Tracer::Enable(5);
+    for (uint32_t pc = 0; pc < 20; ++pc) {
+        TRACE_EVENT(INSTRUCTION, Opcode::ADD, pc);
+    }
+    {
+        ScopedTrace scope(EventKind::GC_BEGIN, EventKind::GC_END, static_cast<uint8_t>(GcPhase::SWEEP));
+    }
+    Tracer::Disable();
+
+    std::vector<Event> events(16);
+    size_t n_events = Tracer::Collect(events.data(), events.size());
+    ASSERT_EQ(Tracer::GetRecordedCount(), 22U);
+    ASSERT_EQ(n_events, 8U);
+    for (size_t i = 0; i < 6; ++i) {
+        ASSERT_EQ(events[i].index, 14 + i);
+        ASSERT_EQ(events[i].kind, EventKind::INSTRUCTION);
+        ASSERT_EQ(events[i].code, Opcode::ADD);
+        ASSERT_EQ(events[i].pc, 14 + i);
+    }
+    ASSERT_EQ(events[6].kind, EventKind::GC_BEGIN);
+    ASSERT_EQ(events[7].kind, EventKind::GC_END);
+    ASSERT_EQ(events[7].code, static_cast<uint8_t>(GcPhase::SWEEP));
+    ASSERT_LE(events[0].time, events[7].time);
+}
+
+TEST(TracerTest, DumpIsReadable)
+{
+    Tracer::Enable(4);
+    TRACE_EVENT(INSTRUCTION, Opcode::CALL, 0x2a);
+    TRACE_EVENT(GC_BEGIN, GcPhase::MARK, 0);
+    Tracer::Disable();
+
+    FILE *file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+    Tracer::Dump(fileno(file));
+
+    std::string dump;
+    std::rewind(file);
+    for (int c = std::fgetc(file); c != EOF; c = std::fgetc(file)) {
+        dump.push_back(static_cast<char>(c));
+    }
+    std::fclose(file);
+
+    ASSERT_NE(dump.find(" instr CALL 0x2a\n"), std::string::npos);
+    ASSERT_NE(dump.find(" gc_begin mark 0x0\n"), std::string::npos);
+}
+
+TEST(TracerTest, ChromeTraceExport)
+{
+    Tracer::Enable(16, Tracer::TIMELINE_KINDS, 100);
+    TRACE_EVENT(INSTRUCTION, Opcode::CALL, 0x10);
+    TRACE_EVENT(CALL, 0, 0x40);
+    Tracer::RecordAllocation(50);
+    Tracer::RecordAllocation(200);
+    {
+        ScopedTrace scope(EventKind::GC_BEGIN, EventKind::GC_END, static_cast<uint8_t>(GcPhase::ROOTS));
+    }
+    TRACE_EVENT(RET, 0, 0x18);
+    Tracer::Disable();
+
+    // Instructions and small allocations are not recorded
+    ASSERT_EQ(Tracer::GetRecordedCount(), 5U);
+
+    char path[] = "/tmp/evm_trace_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    close(fd);
+    ASSERT_TRUE(Tracer::ExportChromeTrace(path, [](uint32_t pc) { return "func_" + std::to_string(pc); }));
+
+    std::string json;
+    FILE *file = std::fopen(path, "r");
+    ASSERT_NE(file, nullptr);
+    for (int c = std::fgetc(file); c != EOF; c = std::fgetc(file)) {
+        json.push_back(static_cast<char>(c));
+    }
+    std::fclose(file);
+    std::remove(path);
+
+    ASSERT_EQ(json.find("{\"displayTimeUnit\": \"ns\", \"traceEvents\": ["), 0U);
+    ASSERT_NE(json.find("\"name\": \"func_64\", \"cat\": \"bytecode\", \"ph\": \"B\""), std::string::npos);
+    ASSERT_NE(json.find("\"name\": \"alloc\", \"cat\": \"memory\", \"ph\": \"i\""), std::string::npos);
+    ASSERT_NE(json.find("\"args\": {\"size\": 200}"), std::string::npos);
+    ASSERT_EQ(json.find("\"size\": 50"), std::string::npos);
+    ASSERT_NE(json.find("\"name\": \"roots\", \"cat\": \"gc\", \"ph\": \"E\""), std::string::npos);
+    ASSERT_NE(json.find("\"cat\": \"bytecode\", \"ph\": \"E\""), std::string::npos);
+}
+
+} // namespace evm::trace
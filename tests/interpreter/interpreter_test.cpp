@@ -8,8 +8,12 @@
 #include "runtime/runtime.h"
 
 #include "assembler/asm2byte/asm2byte.h"
+#include "file_format/symbolizer.h"
+#include "runtime/jit/jit.h"
 #include "runtime/memory/types/array.h"
 #include "runtime/memory/types/class.h"
+#include "runtime/memory/types/string.h"
+#include "runtime/profiler/sampling_profiler.h"
 
 namespace evm {
 
@@ -600,6 +604,33 @@ TEST_F(InterpreterTest, STRING_PULL)
               runtime_->GetInterpreter()->GetCurrFrame()->GetReg(0x1)->GetInt64());
 }
 
+TEST_F(InterpreterTest, STRING_LITERALS)
+{
+    auto source = R"(
+        str_immut x0, 'two'
+        newstr x1, 'one'
+        newstr x2, 'two'
+        newstr x3, 'one'
+        print_str_immut x0
+        print_str x2
+
+        exit
+    )";
+
+    ExecuteFromSource(source);
+
+    auto *frame = runtime_->GetInterpreter()->GetCurrFrame();
+    // Literals are copied with their length calculated at load time
+    auto *one = reinterpret_cast<runtime::types::String *>(frame->GetReg(0x1)->GetInt64());
+    auto *two = reinterpret_cast<runtime::types::String *>(frame->GetReg(0x2)->GetInt64());
+    auto *other_one = reinterpret_cast<runtime::types::String *>(frame->GetReg(0x3)->GetInt64());
+    ASSERT_STREQ(reinterpret_cast<const char *>(one->GetData()), "one");
+    ASSERT_STREQ(reinterpret_cast<const char *>(two->GetData()), "two");
+    ASSERT_EQ(one->GetLength(), 4U);
+    ASSERT_NE(one, other_one);
+    ASSERT_EQ(runtime::types::String::CompareStrings(one, other_one), 0);
+}
+
 // User-objects operations
 
 TEST_F(InterpreterTest, CLASS_SECTION)
@@ -931,6 +962,251 @@ TEST_F(InterpreterTest, ARRAY_OF_OBJECTS)
     }
 }
 
+// Object copy operations
+
+TEST_F(InterpreterTest, CPOBJ_SHALLOW)
+{
+    auto source = R"(
+        .class A
+            int x;
+        .class
+
+        .class B
+            class A a;
+            int id;
+        .class
+
+        movif x1, 13
+        movif x2, 42
+
+        newobj x3, B
+        obj_set_field x3, B@id, x1
+        obj_get_field x4, B@a, x3
+        obj_set_field x4, A@x, x1
+
+        cpobj x5, x3
+        obj_set_field x5, B@id, x2
+
+        obj_get_field x6, B@id, x3
+        obj_get_field x7, B@id, x5
+        obj_get_field x8, B@a, x5
+
+        newstr x10, 'copied string'
+        cpobj x11, x10
+
+        exit
+    )";
+
+    ExecuteFromSource(source);
+
+    auto *frame = runtime_->GetInterpreter()->GetCurrFrame();
+    ASSERT_NE(frame->GetReg(0x5)->GetInt64(), frame->GetReg(0x3)->GetInt64());
+    ASSERT_EQ(frame->GetReg(0x6)->GetInt64(), 13);
+    ASSERT_EQ(frame->GetReg(0x7)->GetInt64(), 42);
+    // Shallow copy shares referenced objects
+    ASSERT_EQ(frame->GetReg(0x8)->GetInt64(), frame->GetReg(0x4)->GetInt64());
+
+    ASSERT_NE(frame->GetReg(0xb)->GetInt64(), frame->GetReg(0xa)->GetInt64());
+    auto *str = reinterpret_cast<runtime::types::String *>(frame->GetReg(0xb)->GetPtr());
+    ASSERT_STREQ(reinterpret_cast<const char *>(str->GetData()), "copied string");
+}
+
+TEST_F(InterpreterTest, CPOBJ_DEEP)
+{
+    auto source = R"(
+        .class Foo
+            int x;
+        .class
+
+        movif x1, 0
+        movif x2, 1
+        movif x3, 2
+        movif x4, 7
+
+        newobj x5, Foo
+        obj_set_field x5, Foo@x, x4
+
+        newarr_imm x10, Foo, 3
+        starr x10, x1, x5
+        starr x10, x2, x5
+
+        cpobj_deep x11, x10
+
+        larr x12, x11, x1
+        larr x13, x11, x2
+        larr x14, x11, x3
+        obj_get_field x15, Foo@x, x12
+
+        exit
+    )";
+
+    ExecuteFromSource(source);
+
+    auto *frame = runtime_->GetInterpreter()->GetCurrFrame();
+    ASSERT_NE(frame->GetReg(0xb)->GetInt64(), frame->GetReg(0xa)->GetInt64());
+    // Object is copied, but reference shared between two elements stays shared
+    ASSERT_NE(frame->GetReg(0xc)->GetInt64(), frame->GetReg(0x5)->GetInt64());
+    ASSERT_EQ(frame->GetReg(0xc)->GetInt64(), frame->GetReg(0xd)->GetInt64());
+    ASSERT_EQ(frame->GetReg(0xe)->GetInt64(), 0);
+    ASSERT_EQ(frame->GetReg(0xf)->GetInt64(), 7);
+}
+
+// Bulk array operations
+
+TEST_F(InterpreterTest, ARRAY_BULK_INT)
+{
+    // Length is not a multiple of SIMD width to check tail handling
+    auto source = R"(
+        movif x1, 13
+        movif x2, 0
+        movif x3, 1
+        movif x4, 7
+
+        newarr x10, int, x1
+        newarr x11, int, x1
+        newarr x12, int, x1
+
+        loop:
+            smei x5, x2, x1
+            jmp_if_imm x5, loop_exit
+
+            starr x10, x2, x2
+            sub x6, x4, x2
+            starr x11, x2, x6
+
+            add x2, x2, x3
+            jmp_imm loop
+
+        loop_exit:
+            arr_sum x20, x10
+            arr_min x21, x11
+            arr_max x22, x11
+
+            arr_add x12, x10, x11
+            arr_sum x23, x12
+
+            arr_mul x12, x10, x11
+            arr_index_of x24, x12, x4
+            movif x5, -30
+            arr_index_of x25, x12, x5
+            movif x5, 1000
+            arr_index_of x26, x12, x5
+
+            arr_fill x11, x4
+            arr_sum x27, x11
+
+            movif x5, 5
+            movif x6, 8
+            arr_copy x10, x3, x10, x5, x6
+
+            exit
+    )";
+
+    ExecuteFromSource(source);
+
+    auto *frame = runtime_->GetInterpreter()->GetCurrFrame();
+
+    ASSERT_EQ(frame->GetReg(20)->GetInt64(), 78);  // 0 + 1 + ... + 12
+    ASSERT_EQ(frame->GetReg(21)->GetInt64(), -5);  // 7 - 12
+    ASSERT_EQ(frame->GetReg(22)->GetInt64(), 7);   // 7 - 0
+    ASSERT_EQ(frame->GetReg(23)->GetInt64(), 91);  // 13 * 7
+    ASSERT_EQ(frame->GetReg(24)->GetInt64(), -1);  // i * (7 - i) == 7 has no solutions
+    ASSERT_EQ(frame->GetReg(25)->GetInt64(), 10);  // 10 * (7 - 10)
+    ASSERT_EQ(frame->GetReg(26)->GetInt64(), -1);
+    ASSERT_EQ(frame->GetReg(27)->GetInt64(), 91);  // 13 * 7
+
+    auto *array = reinterpret_cast<runtime::types::Array *>(frame->GetReg(10)->GetPtr());
+    for (size_t idx = 0; idx < array->GetLength(); ++idx) {
+        int64_t value = 0;
+        array->Get(&value, idx);
+
+        int64_t expected = (idx >= 1 && idx < 9) ? static_cast<int64_t>(idx) + 4 : static_cast<int64_t>(idx);
+        ASSERT_EQ(value, expected);
+    }
+}
+
+TEST_F(InterpreterTest, ARRAY_BULK_DOUBLE)
+{
+    auto source = R"(
+        movif x1, 10
+        movif x2, 0
+        movif x3, 1
+        movif x4, 0.5
+
+        newarr x10, double, x1
+        newarr x11, double, x1
+
+        loop:
+            smei x5, x2, x1
+            jmp_if_imm x5, loop_exit
+
+            convif x6, x2
+            mulf x6, x6, x4
+            starr x10, x2, x6
+
+            add x2, x2, x3
+            jmp_imm loop
+
+        loop_exit:
+            arr_sum x20, x10
+            arr_max x21, x10
+            arr_min x22, x10
+
+            arr_fill x11, x4
+            arr_mul x11, x11, x10
+            arr_add x11, x11, x10
+            arr_sum x23, x11
+
+            movif x5, 3.5
+            arr_index_of x24, x10, x5
+
+            exit
+    )";
+
+    ExecuteFromSource(source);
+
+    auto *frame = runtime_->GetInterpreter()->GetCurrFrame();
+
+    ASSERT_DOUBLE_EQ(frame->GetReg(20)->GetDouble(), 22.5);
+    ASSERT_DOUBLE_EQ(frame->GetReg(21)->GetDouble(), 4.5);
+    ASSERT_DOUBLE_EQ(frame->GetReg(22)->GetDouble(), 0.0);
+    ASSERT_DOUBLE_EQ(frame->GetReg(23)->GetDouble(), 22.5 * 1.5);
+    ASSERT_EQ(frame->GetReg(24)->GetInt64(), 7);
+}
+
+TEST_F(InterpreterTest, ARRAY_FILL_REFERENCE)
+{
+    auto source = R"(
+    .class Box
+        int value;
+    .class
+
+        newarr_imm x10, Box, 4
+        newobj x1, Box
+        arr_fill x10, x1
+
+        newarr_imm x11, Box, 4
+        arr_fill x11, x1
+        movif x2, 0
+        arr_fill x11, x2
+
+        exit
+    )";
+
+    ExecuteFromSource(source);
+
+    auto *frame = runtime_->GetInterpreter()->GetCurrFrame();
+    auto *box = reinterpret_cast<runtime::ObjectHeader *>(frame->GetReg(1)->GetPtr());
+    auto *filled = reinterpret_cast<runtime::types::Array *>(frame->GetReg(10)->GetPtr());
+    auto *cleared = reinterpret_cast<runtime::types::Array *>(frame->GetReg(11)->GetPtr());
+
+    // Reference array is filled with an object or null, other primitive values are fatal errors
+    for (size_t idx = 0; idx < 4; ++idx) {
+        ASSERT_EQ(filled->GetReference(idx), box);
+        ASSERT_EQ(cleared->GetReference(idx), nullptr);
+    }
+}
+
 TEST_F(InterpreterTest, STRING_COMPARISON)
 {
     auto source = R"(
@@ -945,6 +1221,11 @@ TEST_F(InterpreterTest, STRING_COMPARISON)
 
         strcmp x4, x1, x2
         strcmp x5, x0, x1
+        newstr x6, 'a'
+        newstr x7, 'b'
+        strcmp x8, x6, x7
+        strcmp x9, x7, x6
+        strcmp x10, x3, x0
 
         exit
     )";
@@ -956,7 +1237,11 @@ TEST_F(InterpreterTest, STRING_COMPARISON)
               runtime_->GetInterpreter()->GetCurrFrame()->GetReg(0x2)->GetInt64());
 
     ASSERT_EQ(runtime_->GetInterpreter()->GetCurrFrame()->GetReg(0x4)->GetInt64(), 0);
-    ASSERT_EQ(runtime_->GetInterpreter()->GetCurrFrame()->GetReg(0x5)->GetInt64(), 0);
+    // Strings of different hashes or lengths are ordered by their data
+    ASSERT_LT(runtime_->GetInterpreter()->GetCurrFrame()->GetReg(0x5)->GetInt64(), 0);
+    ASSERT_LT(runtime_->GetInterpreter()->GetCurrFrame()->GetReg(0x8)->GetInt64(), 0);
+    ASSERT_GT(runtime_->GetInterpreter()->GetCurrFrame()->GetReg(0x9)->GetInt64(), 0);
+    ASSERT_GT(runtime_->GetInterpreter()->GetCurrFrame()->GetReg(0xa)->GetInt64(), 0);
 }
 
 TEST_F(InterpreterTest, STRING_CONCAT)
@@ -978,4 +1263,323 @@ TEST_F(InterpreterTest, STRING_CONCAT)
     ASSERT_EQ(runtime_->GetInterpreter()->GetCurrFrame()->GetReg(0x4)->GetInt64(), 0);
 }
 
+// Handlers of tail-call engine don't grow the native stack: the loop executes hundreds of thousands of instructions
+static constexpr const char *TAIL_CALL_LOOP_SOURCE = R"(
+    .class Box
+        int value;
+    .class
+
+        movif x1, 0
+        movif x2, 50000
+        movif x3, 1
+        movif x4, 0
+        movif x10, body
+    loop:
+        smei x5, x1, x2
+        jmp_if_imm x5, done
+        call x10, x1
+        accr x6
+        add x4, x4, x6
+        add x1, x1, x3
+        jmp_imm loop
+    done:
+        racc x4
+        exit
+
+    body:
+        newobj x1, Box
+        obj_set_field x1, Box@value, x0
+        obj_get_field x2, Box@value, x1
+        movif x3, 1
+        add x2, x2, x3
+        racc x2
+        ret
+)";
+
+TEST_F(InterpreterTest, TAIL_CALL_ENGINE)
+{
+    runtime_->GetInterpreter()->SetEngine(runtime::Interpreter::Engine::TAIL_CALL);
+    ExecuteFromSource(TAIL_CALL_LOOP_SOURCE);
+
+    int64_t expected = int64_t {50000} * 50001 / 2;
+    auto *interpreter = runtime_->GetInterpreter();
+    ASSERT_EQ(interpreter->GetCurrFrame()->GetReg(0x4)->GetInt64(), expected);
+    ASSERT_EQ(interpreter->GetAccum().GetInt64(), expected);
+    ASSERT_EQ(interpreter->GetFramesStack().size(), 1U);
+}
+
+TEST_F(InterpreterTest, TAIL_CALL_ENGINE_JIT)
+{
+    runtime_->GetInterpreter()->SetEngine(runtime::Interpreter::Engine::TAIL_CALL);
+    runtime_->EnableJit(100);
+    ExecuteFromSource(TAIL_CALL_LOOP_SOURCE);
+
+    auto *interpreter = runtime_->GetInterpreter();
+    ASSERT_EQ(interpreter->GetCurrFrame()->GetReg(0x4)->GetInt64(), int64_t {50000} * 50001 / 2);
+    ASSERT_GT(interpreter->GetJit()->GetStats().n_entries + interpreter->GetJit()->GetStats().n_osr_entries, 0U);
+}
+
+
+TEST_F(InterpreterTest, SAMPLING_PROFILER)
+{
+    const char *source = R"(
+        movif x1, 0
+        movif x2, 1000
+        movif x3, 1
+        movif x10, outer
+    main_loop:
+        smei x4, x1, x2
+        jmp_if_imm x4, done
+        call x10, x1
+        add x1, x1, x3
+        jmp_imm main_loop
+    done:
+        exit
+
+    outer:
+        movif x10, inner
+        call x10, x1
+        ret
+
+    inner:
+        movif x1, 0
+        movif x2, 1000
+        movif x3, 1
+    inner_loop:
+        smei x4, x1, x2
+        jmp_if_imm x4, inner_done
+        add x1, x1, x3
+        jmp_imm inner_loop
+    inner_done:
+        ret
+)";
+    file_format::File file;
+    asm2byte::AsmToByte asm2byte;
+    ASSERT_TRUE(asm2byte.ParseAsmString(source, &file));
+
+    runtime::SamplingProfiler profiler;
+    const auto &call_stack = runtime_->GetInterpreter()->GetPublishedCallStack();
+    ASSERT_TRUE(profiler.Start(&call_stack, 100));
+    runtime_->Execute(&file);
+    profiler.Stop();
+
+    // Only the frame of the entrypoint is left
+    ASSERT_EQ(call_stack.GetDepth(), 1U);
+    ASSERT_GT(profiler.GetSamplesCount(), 0U);
+
+    file_format::Symbolizer symbolizer(&file);
+    auto stacks = profiler.FoldStacks([&symbolizer](uint32_t pc) { return symbolizer.GetName(pc); });
+    size_t n_samples = 0;
+    for (const auto &[stack, count] : stacks) {
+        ASSERT_TRUE(stack == "main" || stack == "main;outer" || stack == "main;outer;inner") << stack;
+        n_samples += count;
+    }
+    ASSERT_EQ(n_samples, profiler.GetSamplesCount());
+    ASSERT_NE(stacks.find("main;outer;inner"), stacks.end());
+}
+
+
+TEST_F(InterpreterTest, ALLOCATION_PROFILER)
+{
+    const char *source = R"(
+    .class Box
+        int value;
+    .class
+
+        newarr_imm x5, int, 100
+        movif x1, 0
+        movif x2, 50000
+        movif x3, 1
+        movif x10, make_box
+    main_loop:
+        smei x4, x1, x2
+        jmp_if_imm x4, done
+        call x10, x1
+        add x1, x1, x3
+        jmp_imm main_loop
+    done:
+        exit
+
+    make_box:
+        newobj x1, Box
+        obj_set_field x1, Box@value, x0
+        ret
+)";
+    file_format::File file;
+    asm2byte::AsmToByte asm2byte;
+    ASSERT_TRUE(asm2byte.ParseAsmString(source, &file));
+
+    // Every allocation is sampled with interval of 1 byte
+    runtime_->EnableAllocationProfiler(1);
+    runtime_->Execute(&file);
+
+    file_format::Symbolizer symbolizer(&file);
+    auto sites = runtime_->GetAllocationProfiler()->GetSites();
+    ASSERT_EQ(sites.size(), 2U);
+
+    // Boxes die young, while the array is kept in a register till exit
+    const auto &box_site = sites[0];
+    ASSERT_EQ(symbolizer.GetName(box_site.pc), "make_box");
+    ASSERT_EQ(box_site.n_objects, 50000U);
+    ASSERT_EQ(box_site.n_bytes % box_site.n_objects, 0U);
+    ASSERT_LT(box_site.n_survived_objects, box_site.n_objects / 10);
+
+    const auto &array_site = sites[1];
+    ASSERT_EQ(symbolizer.GetName(array_site.pc), "main");
+    ASSERT_EQ(array_site.n_objects, 1U);
+    ASSERT_EQ(array_site.n_survived_objects, 1U);
+    ASSERT_EQ(array_site.n_live_bytes, array_site.n_bytes);
+}
+
+
+TEST_F(InterpreterTest, HEAP_CENSUS)
+{
+    const char *source = R"(
+    .class Box
+        int value;
+    .class
+
+        newarr_imm x5, Box, 10
+        movif x1, 0
+        movif x2, 10
+        movif x3, 1
+    fill_loop:
+        smei x4, x1, x2
+        jmp_if_imm x4, make_garbage
+        newobj x6, Box
+        starr x5, x1, x6
+        add x1, x1, x3
+        jmp_imm fill_loop
+    make_garbage:
+        newobj x6, Box
+        newobj x6, Box
+        newstr x7, 'census'
+        exit
+)";
+    std::vector<runtime::HeapCensus> censuses;
+    runtime_->GetGC()->SetHeapCensusCallback(
+        [&censuses](const runtime::HeapCensus &census) { censuses.push_back(census); });
+    ExecuteFromSource(source);
+
+    auto census = runtime_->GetGC()->TakeHeapCensus();
+    ASSERT_EQ(census.n_live_objects, 13U);
+    ASSERT_EQ(census.n_garbage_objects, 1U);
+    ASSERT_EQ(census.heap_size, runtime_->GetHeapManager()->GetHeapSize());
+    ASSERT_GT(census.free_list.free_bytes, 0U);
+
+    const auto *class_manager = runtime_->GetClassManager();
+    ASSERT_EQ(census.classes.size(), 3U);
+    ASSERT_EQ(class_manager->GetDisplayName(census.classes[0].class_descr), "Box");
+    ASSERT_EQ(census.classes[0].n_objects, 11U);
+    ASSERT_EQ(class_manager->GetDisplayName(census.classes[1].class_descr), "obj[]");
+
+    // Lengths from 8 to 15 are in bucket 4
+    ASSERT_EQ(census.array_lengths.size(), 5U);
+    ASSERT_EQ(census.array_lengths[4], 1U);
+    ASSERT_EQ(census.n_strings, 1U);
+    ASSERT_EQ(census.n_string_chars, std::strlen("census") + 1);
+
+    // Program is too short for a cycle of incremental GC, the census above is a collection of its own
+    ASSERT_TRUE(censuses.empty());
+    ASSERT_EQ(runtime_->GetHeapManager()->GetObjectsList().size(), 13U);
+}
+
+TEST_F(InterpreterTest, GC_STATS)
+{
+    // 5 instructions before the loop, 14 per iteration and 3 after it, exit isn't counted
+    constexpr size_t N_INSTRS = 5 + 50000 * 14 + 3;
+
+    ExecuteFromSource(TAIL_CALL_LOOP_SOURCE);
+    auto stats = runtime_->GetGC()->GetStats();
+    ASSERT_EQ(stats.n_instrs, N_INSTRS);
+    ASSERT_GT(stats.n_cycles, 0U);
+    ASSERT_GE(stats.n_pauses, stats.n_cycles);
+    ASSERT_GE(stats.pause_ns, stats.max_pause_ns);
+    ASSERT_EQ(runtime_->GetHeapManager()->GetAllocatedObjectsCount(), 50000U);
+    ASSERT_GT(runtime_->GetHeapManager()->GetAllocatedBytes(), 0U);
+
+    // Tail-call engine reports instructions in batches, the last one is reported at exit
+    ASSERT_TRUE(runtime::Runtime::Destroy());
+    ASSERT_TRUE(runtime::Runtime::Create());
+    runtime_ = runtime::Runtime::GetInstance();
+    runtime_->GetInterpreter()->SetEngine(runtime::Interpreter::Engine::TAIL_CALL);
+    ExecuteFromSource(TAIL_CALL_LOOP_SOURCE);
+    ASSERT_EQ(runtime_->GetGC()->GetStats().n_instrs, N_INSTRS);
+}
+
+TEST_F(InterpreterTest, HEAP_GROWTH)
+{
+    const char *source = R"(
+    .class Box
+        int value;
+    .class
+
+        newarr_imm x5, Box, 40000
+        movif x1, 0
+        movif x2, 40000
+        movif x3, 1
+    fill_loop:
+        smei x4, x1, x2
+        jmp_if_imm x4, drop_array
+        newobj x6, Box
+        starr x5, x1, x6
+        add x1, x1, x3
+        jmp_imm fill_loop
+    drop_array:
+        movif x5, 0
+        movif x6, 0
+        exit
+)";
+    constexpr size_t MAX_HEAP_SIZE = 64 * MBYTE_SIZE;
+
+    ASSERT_TRUE(runtime::Runtime::Destroy());
+    ASSERT_TRUE(runtime::Runtime::Create(runtime::HeapManager::CHUNK_SIZE, MAX_HEAP_SIZE));
+    runtime_ = runtime::Runtime::GetInstance();
+    auto *heap_manager = runtime_->GetHeapManager();
+    ASSERT_EQ(heap_manager->GetHeapSize(), runtime::HeapManager::CHUNK_SIZE);
+    ASSERT_EQ(heap_manager->GetMaxHeapSize(), MAX_HEAP_SIZE);
+
+    // Live objects don't fit the minimal heap, it's grown by chunks
+    ExecuteFromSource(source);
+    ASSERT_GT(heap_manager->GetHeapSize(), runtime::HeapManager::CHUNK_SIZE);
+    ASSERT_LE(heap_manager->GetHeapSize(), MAX_HEAP_SIZE);
+    ASSERT_EQ(heap_manager->GetAllocatedObjectsCount(), 40001U);
+
+    // Free chunks are returned to the OS after the sweep, heap keeps its minimal size. Array could be marked
+    // by the cycle which the growth started, so it's swept by the next one
+    runtime_->GetGC()->TakeHeapCensus();
+    runtime_->GetGC()->TakeHeapCensus();
+    ASSERT_EQ(heap_manager->GetUsedMemorySize(), 0U);
+    ASSERT_EQ(heap_manager->GetHeapSize(), runtime::HeapManager::CHUNK_SIZE);
+    ASSERT_LT(heap_manager->GetFreeListStats().free_bytes, runtime::HeapManager::CHUNK_SIZE);
+}
+
+TEST_F(InterpreterTest, HEAP_COLLECTED_BEFORE_GROWTH)
+{
+    const char *source = R"(
+        movif x1, 0
+        movif x2, 2000
+        movif x3, 1
+    alloc_loop:
+        smei x4, x1, x2
+        jmp_if_imm x4, end
+        newarr_imm x6, int, 1000
+        add x1, x1, x3
+        jmp_imm alloc_loop
+    end:
+        movif x6, 0
+        exit
+)";
+    constexpr size_t MAX_HEAP_SIZE = 64 * MBYTE_SIZE;
+
+    ASSERT_TRUE(runtime::Runtime::Destroy());
+    ASSERT_TRUE(runtime::Runtime::Create(runtime::HeapManager::CHUNK_SIZE, MAX_HEAP_SIZE));
+    runtime_ = runtime::Runtime::GetInstance();
+    auto *heap_manager = runtime_->GetHeapManager();
+
+    // Arrays of the loop are garbage, they are collected instead of growing the heap to fit all of them
+    ExecuteFromSource(source);
+    ASSERT_LE(heap_manager->GetHeapSize(), 4 * runtime::HeapManager::CHUNK_SIZE);
+}
+
 } // namespace evm
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+
+#include "runtime/jit/assembler_x86_64.h"
+#include "runtime/jit/code_cache.h"
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace evm::runtime::jit {
+
+// Expected encodings are checked with objdump
+static std::vector<uint8_t> Encode(const std::function<void(Assembler *)> &emit)
+{
+    Assembler masm;
+    emit(&masm);
+    EXPECT_TRUE(masm.Finalize());
+    return masm.GetCode();
+}
+
+using Bytes = std::vector<uint8_t>;
+
+TEST(AssemblerX86_64Test, RegisterAndMemoryOperands)
+{
+    ASSERT_EQ(Encode([](Assembler *masm) { masm->Mov(Reg::RAX, Reg::RCX); }), (Bytes {0x48, 0x89, 0xc8}));
+    ASSERT_EQ(Encode([](Assembler *masm) { masm->Mov(Reg::R12, Mem(Reg::RSP, 8)); }),
+              (Bytes {0x4c, 0x8b, 0x64, 0x24, 0x08}));
+    ASSERT_EQ(Encode([](Assembler *masm) { masm->Mov(Mem(Reg::R13, 0), Reg::R9); }),
+              (Bytes {0x4d, 0x89, 0x4d, 0x00}));
+    ASSERT_EQ(Encode([](Assembler *masm) { masm->Mov(Reg::RAX, Mem(Reg::RAX, Reg::RDX, 3, 16)); }),
+              (Bytes {0x48, 0x8b, 0x44, 0xd0, 0x10}));
+    ASSERT_EQ(Encode([](Assembler *masm) { masm->Bts(Mem(Reg::RBP, 0x810), 6); }),
+              (Bytes {0x48, 0x0f, 0xba, 0xad, 0x10, 0x08, 0x00, 0x00, 0x06}));
+    ASSERT_EQ(Encode([](Assembler *masm) { masm->Cmpb(Mem(Reg::R11, 9), 2); }),
+              (Bytes {0x41, 0x80, 0x7b, 0x09, 0x02}));
+}
+
+TEST(AssemblerX86_64Test, Arithmetic)
+{
+    ASSERT_EQ(Encode([](Assembler *masm) { masm->Add(Reg::RAX, 1); }), (Bytes {0x48, 0x83, 0xc0, 0x01}));
+    ASSERT_EQ(Encode([](Assembler *masm) { masm->Sub(Reg::R15, 1000); }),
+              (Bytes {0x49, 0x81, 0xef, 0xe8, 0x03, 0x00, 0x00}));
+    ASSERT_EQ(Encode([](Assembler *masm) { masm->Mov(Reg::RDX, int64_t {0x123456789}); }),
+              (Bytes {0x48, 0xba, 0x89, 0x67, 0x45, 0x23, 0x01, 0x00, 0x00, 0x00}));
+    ASSERT_EQ(Encode([](Assembler *masm) { masm->Imul(Reg::RCX, Reg::R10); }), (Bytes {0x49, 0x0f, 0xaf, 0xca}));
+    ASSERT_EQ(Encode([](Assembler *masm) { masm->Setcc(Cond::L, Reg::RSI); }), (Bytes {0x40, 0x0f, 0x9c, 0xc6}));
+    ASSERT_EQ(Encode([](Assembler *masm) { masm->Ucomisd(XmmReg::XMM1, XmmReg::XMM0); }),
+              (Bytes {0x66, 0x0f, 0x2e, 0xc8}));
+    ASSERT_EQ(Encode([](Assembler *masm) { masm->Cvtsi2sd(XmmReg::XMM0, Reg::R8); }),
+              (Bytes {0xf2, 0x49, 0x0f, 0x2a, 0xc0}));
+    ASSERT_EQ(Encode([](Assembler *masm) { masm->Push(Reg::R12); }), (Bytes {0x41, 0x54}));
+}
+
+TEST(AssemblerX86_64Test, Labels)
+{
+    Assembler masm;
+    Assembler::Label unbound = masm.CreateLabel();
+    masm.Jmp(unbound);
+    ASSERT_FALSE(masm.Finalize());
+
+    // Backward jump to the start: displacement is counted from the end of 5-byte jump
+    ASSERT_EQ(Encode([](Assembler *assembler) {
+                  Assembler::Label start = assembler->CreateLabel();
+                  assembler->Bind(start);
+                  assembler->Jmp(start);
+              }),
+              (Bytes {0xe9, 0xfb, 0xff, 0xff, 0xff}));
+}
+
+TEST(CodeCacheTest, ExecuteInstalledCode)
+{
+    // sum(n) = n + (n - 1) + ... + 1
+    Assembler masm;
+    Assembler::Label loop = masm.CreateLabel();
+    Assembler::Label done = masm.CreateLabel();
+    masm.Mov(Reg::RAX, int64_t {0});
+    masm.Bind(loop);
+    masm.Test(Reg::RDI, Reg::RDI);
+    masm.Jcc(Cond::E, done);
+    masm.Add(Reg::RAX, Reg::RDI);
+    masm.Sub(Reg::RDI, 1);
+    masm.Jmp(loop);
+    masm.Bind(done);
+    masm.Ret();
+    ASSERT_TRUE(masm.Finalize());
+
+    CodeCache code_cache;
+    const uint8_t *code = code_cache.Install(masm.GetCode());
+    ASSERT_NE(code, nullptr);
+    ASSERT_GE(code_cache.GetUsedSize(), masm.GetSize());
+
+    auto *sum = reinterpret_cast<int64_t (*)(int64_t)>(code);
+    ASSERT_EQ(sum(100), 5050);
+
+    // Next code goes to the same chunk
+    const uint8_t *other = code_cache.Install(masm.GetCode());
+    ASSERT_NE(other, nullptr);
+    ASSERT_EQ(reinterpret_cast<int64_t (*)(int64_t)>(other)(10), 55);
+}
+
+} // namespace evm::runtime::jit
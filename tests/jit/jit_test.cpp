@@ -0,0 +1,632 @@
+#include <gtest/gtest.h>
+
+#include "assembler/asm2byte/asm2byte.h"
+#include "file_format/class_section.h"
+#include "runtime/jit/codegen_x86_64.h"
+#include "runtime/jit/code_cache.h"
+#include "runtime/jit/ir.h"
+#include "runtime/jit/jit.h"
+#include "runtime/jit/optimizations.h"
+#include "runtime/jit/register_allocator.h"
+#include "runtime/jit/runtime_helpers.h"
+#include "runtime/memory/types/array.h"
+#include "runtime/runtime.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace evm::runtime::jit {
+
+// Optimizations and code generation on a graph built by hand:
+//     for (i = 0; i < len(arr); ++i) accum = arr[i]
+class JitGraphTest : public testing::Test {
+public:
+    void SetUp() override
+    {
+        ASSERT_TRUE(Runtime::Create());
+
+        BasicBlock *entry = graph_.CreateBlock(0);
+        BasicBlock *header = graph_.CreateBlock(10);
+        BasicBlock *body = graph_.CreateBlock(20);
+        BasicBlock *exit = graph_.CreateBlock(40);
+        entry->is_entry = true;
+        graph_.AddEntry(entry);
+        graph_.AddEdge(entry, header);
+        graph_.AddEdge(header, body);
+        graph_.AddEdge(header, exit);
+        graph_.AddEdge(body, header);
+
+        Inst *array = Append(entry, IrOpcode::PARAM, {}, 0);
+        array->kind = ValueKind::REFERENCE;
+        Inst *length = Append(entry, IrOpcode::ARR_LEN, {array});
+        Inst *zero = Append(entry, IrOpcode::CONST, {}, 0);
+        Inst *one = Append(entry, IrOpcode::CONST, {}, 1);
+        Append(entry, IrOpcode::JUMP);
+
+        Inst *idx = Append(header, IrOpcode::PHI, {zero, nullptr});
+        Inst *cond = Append(header, IrOpcode::CMP_LT, {idx, length});
+        Append(header, IrOpcode::BRANCH, {cond});
+
+        Inst *check = Append(body, IrOpcode::CHECK_ARRAY, {array}, static_cast<int64_t>(ArrayElementKind::PRIMITIVE));
+        check->state = CreateState(20, {});
+        Inst *body_length = Append(body, IrOpcode::ARR_LEN, {array});
+        Inst *bounds_check = Append(body, IrOpcode::BOUNDS_CHECK, {idx, body_length});
+        bounds_check->state = CreateState(20, {{5, idx}});
+        Inst *load = Append(body, IrOpcode::LOAD_ELEM, {array, idx});
+        Append(body, IrOpcode::STORE_ACCUM, {load});
+        Inst *next_idx = Append(body, IrOpcode::ADD, {idx, one});
+        Inst *safepoint = Append(body, IrOpcode::SAFEPOINT, {}, 5);
+        safepoint->state = CreateState(30, {{5, next_idx}});
+        Append(body, IrOpcode::JUMP);
+        idx->inputs[1] = next_idx;
+
+        Inst *exit_inst = Append(exit, IrOpcode::EXIT);
+        exit_inst->state = CreateState(40, {{5, idx}});
+
+        for (Inst *inst : {length, zero, one, idx, cond, body_length, load, next_idx}) {
+            inst->kind = ValueKind::PRIMITIVE;
+        }
+    }
+
+    void TearDown() override
+    {
+        ASSERT_TRUE(Runtime::Destroy());
+    }
+
+    size_t Count(IrOpcode opcode, const BasicBlock *block = nullptr) const
+    {
+        size_t count = 0;
+        for (const BasicBlock *b : graph_.GetRpo()) {
+            for (const Inst *inst : b->insts) {
+                count += (block == nullptr || block == b) && inst->opcode == opcode ? 1 : 0;
+            }
+        }
+        return count;
+    }
+
+protected:
+    Inst *Append(BasicBlock *block, IrOpcode opcode, std::vector<Inst *> inputs = {}, int64_t imm = 0)
+    {
+        Inst *inst = graph_.CreateInst(opcode);
+        inst->inputs = std::move(inputs);
+        inst->imm = imm;
+        inst->block = block;
+        block->insts.push_back(inst);
+        return inst;
+    }
+
+    static std::unique_ptr<FrameState> CreateState(size_t pc, RegValues regs)
+    {
+        auto state = std::make_unique<FrameState>();
+        state->pc = pc;
+        state->regs = std::move(regs);
+        return state;
+    }
+
+    Graph graph_;
+};
+
+TEST_F(JitGraphTest, LoopOptimizations)
+{
+    RunOptimizations(&graph_);
+
+    const BasicBlock *entry = graph_.GetEntries()[0];
+    const BasicBlock *body = graph_.GetBlocks()[2].get();
+
+    // Loop condition checks the index, length is the same as in the loop
+    ASSERT_EQ(Count(IrOpcode::BOUNDS_CHECK), 0U);
+    ASSERT_EQ(Count(IrOpcode::ARR_LEN), 1U);
+    // Array check is loop invariant
+    ASSERT_EQ(Count(IrOpcode::CHECK_ARRAY, body), 0U);
+    ASSERT_EQ(Count(IrOpcode::CHECK_ARRAY, entry), 1U);
+}
+
+TEST_F(JitGraphTest, ExecuteCompiledLoop)
+{
+    RunOptimizations(&graph_);
+    RegisterAllocator regalloc(graph_);
+    regalloc.Run();
+    CodegenX86_64 codegen(graph_, regalloc);
+    ASSERT_TRUE(codegen.Run());
+
+    CodeCache code_cache;
+    const uint8_t *code = code_cache.Install(codegen.GetCode());
+    ASSERT_NE(code, nullptr);
+    auto *entry = reinterpret_cast<size_t (*)(JitContext *, Frame *)>(
+        code + codegen.GetEntryOffset(graph_.GetEntries()[0]));
+
+    constexpr size_t LENGTH = 17;
+    auto *array = types::Array::Create(memory::Type::INT, LENGTH);
+    ASSERT_NE(array, nullptr);
+    for (size_t i = 0; i < LENGTH; ++i) {
+        array->SetPrimitive(static_cast<int64_t>(i * i), i);
+    }
+
+    Register accum;
+    bool accum_root = true;
+    JitContext ctx;
+    ctx.gc_period = INT32_MAX;
+    ctx.gc_countdown = INT32_MAX;
+    ctx.accum = &accum;
+    ctx.accum_root = &accum_root;
+
+    Frame frame(0, {});
+    frame.GetReg(0)->SetInt64(reinterpret_cast<int64_t>(array));
+    frame.MarkReg(0);
+    frame.MarkReg(5);
+
+    ASSERT_EQ(entry(&ctx, &frame), 40U);
+    ASSERT_EQ(accum.GetInt64(), static_cast<int64_t>((LENGTH - 1) * (LENGTH - 1)));
+    ASSERT_FALSE(accum_root);
+    ASSERT_EQ(frame.GetReg(5)->GetInt64(), static_cast<int64_t>(LENGTH));
+    ASSERT_FALSE(frame.IsRegMarked(5));
+    ASSERT_TRUE(frame.IsRegMarked(0));
+
+    // Each iteration counts instructions for GC
+    ASSERT_EQ(ctx.gc_countdown, INT32_MAX - static_cast<int64_t>(5 * LENGTH));
+
+    // Array of references fails the hoisted check before the loop
+    auto *references = types::Array::Create(memory::Type::ARRAY_OBJECT, LENGTH);
+    frame.GetReg(0)->SetInt64(reinterpret_cast<int64_t>(references));
+    ASSERT_EQ(entry(&ctx, &frame), 10U);
+}
+
+TEST_F(JitGraphTest, ScalarReplacement)
+{
+    file_format::Class pair("Pair");
+    pair.GetInstances()->emplace_back("first", memory::Type::INT);
+    pair.GetInstances()->emplace_back("second", memory::Type::INT);
+    pair.GetInstances()->emplace_back("nested", memory::Type::CLASS_OBJECT, 0);
+
+    BasicBlock *body = graph_.GetBlocks()[2].get();
+    Inst *load = *std::find_if(body->insts.begin(), body->insts.end(),
+                               [](const Inst *inst) { return inst->opcode == IrOpcode::LOAD_ELEM; });
+    auto insert = [this, body, &pair](IrOpcode opcode, std::vector<Inst *> inputs, int64_t imm, ValueKind kind) {
+        Inst *inst = graph_.CreateInst(opcode);
+        inst->inputs = std::move(inputs);
+        inst->imm = imm;
+        inst->kind = kind;
+        inst->aux_class = &pair;
+        body->InsertBeforeTerminator(inst);
+        return inst;
+    };
+
+    // Temporary object: the stored value is read back, the field which is never stored is zero
+    Inst *obj = insert(IrOpcode::NEW_OBJECT, {}, 0, ValueKind::REFERENCE);
+    insert(IrOpcode::SET_FIELD, {obj, load}, 0, ValueKind::UNKNOWN);
+    Inst *first = insert(IrOpcode::GET_FIELD, {obj}, 0, ValueKind::PRIMITIVE);
+    Inst *second = insert(IrOpcode::GET_FIELD, {obj}, 1, ValueKind::PRIMITIVE);
+    Inst *sum = insert(IrOpcode::ADD, {first, second}, 0, ValueKind::PRIMITIVE);
+    insert(IrOpcode::STORE_ACCUM, {sum}, 0, ValueKind::UNKNOWN);
+
+    // Nested object is allocated together with the object, so the object is needed to read it
+    Inst *other = insert(IrOpcode::NEW_OBJECT, {}, 0, ValueKind::REFERENCE);
+    Inst *nested = insert(IrOpcode::GET_FIELD, {other}, 2, ValueKind::NULLABLE_REFERENCE);
+    insert(IrOpcode::STORE_ACCUM, {nested}, 0, ValueKind::UNKNOWN);
+
+    RunOptimizations(&graph_);
+
+    ASSERT_EQ(Count(IrOpcode::NEW_OBJECT), 1U);
+    ASSERT_EQ(Count(IrOpcode::GET_FIELD), 1U);
+    ASSERT_EQ(Count(IrOpcode::SET_FIELD), 0U);
+    ASSERT_EQ(sum->inputs[0], load);
+    ASSERT_EQ(sum->inputs[1]->opcode, IrOpcode::CONST);
+    ASSERT_EQ(sum->inputs[1]->imm, 0);
+}
+
+// Programs are executed by interpreter and with compilation of everything entered at least once,
+// registers of the main frame must be the same
+class JitTest : public testing::Test {
+public:
+    static constexpr size_t N_CHECKED_REGS = 64;
+
+    struct Result {
+        std::vector<int64_t> regs;
+        int64_t accum {0};
+        Jit::Stats stats;
+    };
+
+    static Result Execute(const char *source, bool use_jit)
+    {
+        Result result;
+        EXPECT_TRUE(Runtime::Create());
+        auto *runtime = Runtime::GetInstance();
+        if (use_jit) {
+            runtime->EnableJit(1);
+        }
+
+        file_format::File file;
+        asm2byte::AsmToByte asm2byte;
+        EXPECT_TRUE(asm2byte.ParseAsmString(source, &file));
+        runtime->Execute(&file);
+
+        const auto *interpreter = runtime->GetInterpreter();
+        for (size_t i = 0; i < N_CHECKED_REGS; ++i) {
+            result.regs.push_back(interpreter->GetCurrFrame()->GetReg(i)->GetInt64());
+        }
+        result.accum = interpreter->GetAccum().GetInt64();
+        if (interpreter->GetJit() != nullptr) {
+            result.stats = interpreter->GetJit()->GetStats();
+        }
+
+        EXPECT_TRUE(Runtime::Destroy());
+        return result;
+    }
+
+    static Jit::Stats CheckSameResults(const char *source)
+    {
+        Result expected = Execute(source, false);
+        Result actual = Execute(source, true);
+        EXPECT_EQ(expected.regs, actual.regs);
+        EXPECT_EQ(expected.accum, actual.accum);
+        EXPECT_GT(actual.stats.n_compiled, 0U);
+        EXPECT_GT(actual.stats.n_entries + actual.stats.n_osr_entries, 0U);
+        return actual.stats;
+    }
+};
+
+// Main loop calls body(i) and sums results in x4
+#define MAIN_LOOP(n_calls)          \
+    "    movif x1, 0\n"             \
+    "    movif x2, " #n_calls "\n"  \
+    "    movif x3, 1\n"             \
+    "    movif x4, 0\n"             \
+    "    movif x10, body\n"         \
+    "loop:\n"                       \
+    "    smei x5, x1, x2\n"         \
+    "    jmp_if_imm x5, done\n"     \
+    "    call x10, x1\n"            \
+    "    accr x6\n"                 \
+    "    add x4, x4, x6\n"          \
+    "    add x1, x1, x3\n"          \
+    "    jmp_imm loop\n"            \
+    "done:\n"                       \
+    "    movif x6, 0\n"             \
+    "    exit\n"
+
+TEST_F(JitTest, IntegerLoop)
+{
+    auto source = MAIN_LOOP(30) R"(
+    body:
+        movif x1, 0
+        movif x2, 0
+        movif x3, 1
+        movif x4, 7
+        movif x5, 5
+        movif x6, 100
+        add x6, x6, x0
+    body_loop:
+        slti x7, x1, x6
+        jmp_if_imm x7, body_iter
+        racc x2
+        ret
+    body_iter:
+        mul x8, x1, x1
+        div x9, x8, x4
+        rem x10, x1, x5
+        sub x8, x8, x9
+        xor x8, x8, x10
+        and x11, x8, x4
+        or x8, x8, x11
+        add x2, x2, x8
+        add x1, x1, x3
+        jmp_imm body_loop
+    )";
+
+    Jit::Stats stats = CheckSameResults(source);
+    // Calls of body after the first one run compiled code, as well as the main loop after returns
+    ASSERT_GE(stats.n_entries, 2U * 30U - 1U);
+}
+
+TEST_F(JitTest, FloatLoop)
+{
+    auto source = MAIN_LOOP(10) R"(
+    body:
+        movif x1, 0.0
+        movif x2, 1.0
+        movif x3, 0.0
+        movif x4, 1000.0
+        convif x5, x0
+        movif x6, 50.0
+        addf x6, x6, x5
+    body_loop:
+        smef x7, x1, x6
+        jmp_if_imm x7, body_done
+        addf x1, x1, x2
+        divf x8, x2, x1
+        mulf x8, x8, x4
+        subf x8, x8, x2
+        addf x3, x3, x8
+        eqf x9, x1, x4
+        neqf x10, x1, x4
+        add x9, x9, x10
+        convif x9, x9
+        addf x3, x3, x9
+        jmp_imm body_loop
+    body_done:
+        convfi x11, x3
+        racc x11
+        ret
+    )";
+
+    CheckSameResults(source);
+}
+
+TEST_F(JitTest, Arrays)
+{
+    auto source = MAIN_LOOP(10) R"(
+    body:
+        movif x1, 50
+        add x1, x1, x0
+        newarr x2, int, x1
+        movif x3, 0
+        movif x4, 1
+    fill:
+        smei x5, x3, x1
+        jmp_if_imm x5, fill_done
+        mul x6, x3, x3
+        starr x2, x3, x6
+        add x3, x3, x4
+        jmp_imm fill
+    fill_done:
+        arr_size x7, x2
+        movif x3, 0
+        movif x8, 0
+    sum:
+        slti x5, x3, x7
+        jmp_if_imm x5, sum_iter
+        racc x8
+        ret
+    sum_iter:
+        larr x6, x2, x3
+        add x8, x8, x6
+        add x3, x3, x4
+        jmp_imm sum
+    )";
+
+    CheckSameResults(source);
+}
+
+TEST_F(JitTest, ObjectsAndGC)
+{
+    // Allocations in compiled loops are long enough to make GC run from safepoints
+    auto source = R"(
+    .class Point
+        int x;
+        int y;
+    .class
+
+    )" MAIN_LOOP(3) R"(
+    body:
+        movif x1, 3000
+        newarr x2, Point, x1
+        movif x3, 0
+        movif x4, 1
+    fill:
+        smei x5, x3, x1
+        jmp_if_imm x5, fill_done
+        newobj x6, Point
+        obj_set_field x6, Point@x, x3
+        add x7, x3, x0
+        obj_set_field x6, Point@y, x7
+        starr x2, x3, x6
+        add x3, x3, x4
+        jmp_imm fill
+    fill_done:
+        movif x6, 0
+        movif x3, 0
+        movif x8, 0
+    sum:
+        smei x5, x3, x1
+        jmp_if_imm x5, sum_done
+        larr x6, x2, x3
+        obj_get_field x9, Point@x, x6
+        obj_get_field x10, Point@y, x6
+        sub x9, x10, x9
+        add x8, x8, x9
+        add x8, x8, x3
+        add x3, x3, x4
+        jmp_imm sum
+    sum_done:
+        racc x8
+        ret
+    )";
+
+    CheckSameResults(source);
+}
+
+TEST_F(JitTest, ScalarReplacement)
+{
+    // Temporary objects of the loop are not allocated by compiled code
+    auto source = R"(
+    .class Pair
+        int first;
+        int second;
+    .class
+
+    )" MAIN_LOOP(10) R"(
+    body:
+        movif x1, 0
+        movif x2, 200
+        add x2, x2, x0
+        movif x3, 1
+        movif x4, 0
+    body_loop:
+        slti x5, x1, x2
+        jmp_if_imm x5, body_iter
+        racc x4
+        ret
+    body_iter:
+        newobj x6, Pair
+        obj_set_field x6, Pair@first, x1
+        mul x7, x1, x1
+        obj_set_field x6, Pair@second, x7
+        obj_get_field x8, Pair@first, x6
+        obj_get_field x9, Pair@second, x6
+        add x4, x4, x8
+        add x4, x4, x9
+        add x1, x1, x3
+        jmp_imm body_loop
+    )";
+
+    CheckSameResults(source);
+}
+
+TEST_F(JitTest, GuardsAndEntryChecks)
+{
+    // load(array, idx) is compiled for array of integers, then array of objects fails the guard.
+    // ident(x) is compiled for integer argument, then object fails the entry check.
+    auto source = R"(
+    .class Box
+        int value;
+    .class
+
+        movif x1, 4
+        newarr x2, int, x1
+        newarr x3, Box, x1
+        movif x4, 2
+        movif x5, 42
+        starr x2, x4, x5
+        newobj x6, Box
+        obj_set_field x6, Box@value, x5
+        starr x3, x4, x6
+
+        movif x10, load
+        call x10, x2, x4
+        accr x11
+        call x10, x3, x4
+        accr x12
+        obj_get_field x13, Box@value, x12
+
+        movif x10, ident
+        call x10, x4
+        accr x14
+        call x10, x6
+        accr x15
+        obj_get_field x16, Box@value, x15
+
+        movif x2, 0
+        movif x3, 0
+        movif x6, 0
+        movif x12, 0
+        movif x15, 0
+        racc x4
+        exit
+
+    load:
+        larr x2, x0, x1
+        racc x2
+        ret
+
+    ident:
+        racc x0
+        ret
+    )";
+
+    CheckSameResults(source);
+    Result result = Execute(source, true);
+    ASSERT_EQ(result.regs[11], 42);
+    ASSERT_EQ(result.regs[13], 42);
+    ASSERT_EQ(result.regs[14], 2);
+    ASSERT_EQ(result.regs[16], 42);
+}
+
+TEST_F(JitTest, Deoptimization)
+{
+    // load(array, idx) is compiled for array of integers and deoptimizes on arrays of objects
+    // until it is compiled again for them
+    auto source = R"(
+    .class Box
+        int value;
+    .class
+
+        movif x1, 4
+        newarr x2, int, x1
+        newarr x3, Box, x1
+        movif x4, 2
+        movif x5, 42
+        starr x2, x4, x5
+        newobj x6, Box
+        obj_set_field x6, Box@value, x5
+        starr x3, x4, x6
+
+        movif x10, load
+        movif x20, 0
+        movif x21, 100
+        movif x22, 1
+        movif x23, 0
+    ints:
+        call x10, x2, x4
+        accr x11
+        add x23, x23, x11
+        add x20, x20, x22
+        slti x24, x20, x21
+        jmp_if_imm x24, ints
+
+        movif x20, 0
+    boxes:
+        call x10, x3, x4
+        accr x12
+        obj_get_field x13, Box@value, x12
+        add x23, x23, x13
+        add x20, x20, x22
+        slti x24, x20, x21
+        jmp_if_imm x24, boxes
+
+        movif x2, 0
+        movif x3, 0
+        movif x6, 0
+        movif x12, 0
+        racc x23
+        exit
+
+    load:
+        larr x2, x0, x1
+        racc x2
+        ret
+    )";
+
+    Jit::Stats stats = CheckSameResults(source);
+    ASSERT_GE(stats.n_deopts, Jit::MAX_DEOPTS);
+    ASSERT_GE(stats.n_invalidated, 1U);
+    // Compiled again for the new feedback
+    ASSERT_GE(stats.n_compiled, stats.n_invalidated + 1U);
+    ASSERT_LT(stats.n_deopts, 100U);
+}
+
+TEST_F(JitTest, OnStackReplacement)
+{
+    // Main function is never entered by call, so its loops are compiled from back edges
+    auto source = R"(
+        movif x1, 0
+        movif x2, 200
+        movif x3, 1
+        movif x4, 0
+    outer:
+        smei x5, x1, x2
+        jmp_if_imm x5, done
+        movif x6, 0
+    inner:
+        slti x7, x6, x1
+        jmp_if_imm x7, inner_iter
+        add x1, x1, x3
+        jmp_imm outer
+    inner_iter:
+        mul x8, x6, x1
+        add x4, x4, x8
+        add x6, x6, x3
+        jmp_imm inner
+    done:
+        exit
+    )";
+
+    Jit::Stats stats = CheckSameResults(source);
+    ASSERT_EQ(stats.n_entries, 0U);
+    ASSERT_GE(stats.n_osr_entries, 1U);
+}
+
+#undef MAIN_LOOP
+
+} // namespace evm::runtime::jit
@@ -4,6 +4,7 @@
 #include "common/constants.h"
 
 #include <sys/mman.h>
+#include <vector>
 
 namespace evm::runtime {
 
@@ -106,4 +107,58 @@ TEST_F(FreeListAllocatorTest, DeallocateManyObjects)
     }
 }
 
+
+TEST_F(FreeListAllocatorTest, FreeListStats)
+{
+    std::vector<void *> allocated_ptr;
+    for (size_t idx = 0; idx < NUMBER_OF_TEST_OBJECTS / 2; ++idx) {
+        allocated_ptr.push_back(allocator_->Alloc(TEST_OBJECT_SIZE));
+        ASSERT_EQ(FreelistAllocator::GetBlockSize(allocated_ptr.back()), TEST_OBJECT_SIZE);
+    }
+
+    auto stats = allocator_->GetFreeListStats();
+    ASSERT_EQ(stats.n_free_blocks, 1U);
+    ASSERT_EQ(stats.largest_free_block, stats.free_bytes);
+
+    // Freed blocks aren't coalesced with each other and with the rest of the heap
+    allocator_->Dealloc(allocated_ptr[10]);
+    allocator_->Dealloc(allocated_ptr[11]);
+
+    auto fragmented_stats = allocator_->GetFreeListStats();
+    ASSERT_EQ(fragmented_stats.n_free_blocks, 3U);
+    ASSERT_EQ(fragmented_stats.free_bytes, stats.free_bytes + 2 * TEST_OBJECT_SIZE);
+    ASSERT_EQ(fragmented_stats.largest_free_block, stats.largest_free_block);
+}
+
+TEST_F(FreeListAllocatorTest, AddAndRemoveFreeRanges)
+{
+    constexpr size_t HALF_HEAP_SIZE = TEST_HEAP_SIZE / 2;
+    FreelistAllocator allocator(heap_, HALF_HEAP_SIZE);
+    std::vector<void *> allocated_ptr;
+    while (void *ptr = allocator.Alloc(TEST_OBJECT_SIZE)) {
+        allocated_ptr.push_back(ptr);
+    }
+    ASSERT_EQ(allocated_ptr.size(), NUMBER_OF_TEST_OBJECTS / 2);
+
+    // Added range is taken by the next allocation
+    allocator.AddFreeRange({heap_ + HALF_HEAP_SIZE, HALF_HEAP_SIZE});
+    ASSERT_EQ(allocator.GetHeapCapacity(), TEST_HEAP_SIZE);
+    void *ptr = allocator.Alloc(TEST_OBJECT_SIZE);
+    ASSERT_EQ(ptr, heap_ + HALF_HEAP_SIZE + ALLOCATION_HEADER_SIZE);
+    allocator.Dealloc(ptr);
+
+    // Free blocks are cut by ranges, memory out of ranges stays free
+    allocator.Dealloc(allocated_ptr[0]);
+    allocator.Dealloc(allocated_ptr[1]);
+    allocator.RemoveFreeRanges({{heap_ + FULL_TEST_OBJECT_SIZE / 2, FULL_TEST_OBJECT_SIZE},
+                                {heap_ + HALF_HEAP_SIZE, HALF_HEAP_SIZE}});
+    ASSERT_EQ(allocator.GetHeapCapacity(), HALF_HEAP_SIZE - FULL_TEST_OBJECT_SIZE);
+
+    auto stats = allocator.GetFreeListStats();
+    ASSERT_EQ(stats.n_free_blocks, 2U);
+    ASSERT_EQ(stats.free_bytes, FULL_TEST_OBJECT_SIZE - 2 * ALLOCATION_HEADER_SIZE);
+    ASSERT_EQ(allocator.Alloc(TEST_OBJECT_SIZE), nullptr);
+    ASSERT_EQ(allocator.Alloc(FULL_TEST_OBJECT_SIZE / 2 - ALLOCATION_HEADER_SIZE), heap_ + ALLOCATION_HEADER_SIZE);
+}
+
 } // namespace evm::runtime
@@ -0,0 +1,390 @@
+#include <gtest/gtest.h>
+
+#include "assembler/asm2byte/asm2byte.h"
+#include "opt/optimizer.h"
+#include "opt/program.h"
+#include "runtime/runtime.h"
+
+#include <sstream>
+#include <string>
+
+namespace evm::opt {
+
+class OptimizerTest : public testing::Test {
+public:
+    static std::string Optimize(const std::string &source, Optimizer::Stats *stats = nullptr)
+    {
+        Program program;
+        EXPECT_TRUE(program.Load(source));
+
+        Optimizer optimizer;
+        optimizer.Run(&program);
+        if (stats != nullptr) {
+            *stats = optimizer.GetStats();
+        }
+
+        std::ostringstream out;
+        program.Print(out);
+        return out.str();
+    }
+
+    static std::string Execute(const std::string &source)
+    {
+        file_format::File file;
+        asm2byte::AsmToByte asm2byte;
+        EXPECT_TRUE(asm2byte.ParseAsmString(source, &file));
+
+        EXPECT_TRUE(runtime::Runtime::Create());
+        testing::internal::CaptureStdout();
+        runtime::Runtime::GetInstance()->Execute(&file);
+        std::string output = testing::internal::GetCapturedStdout();
+        EXPECT_TRUE(runtime::Runtime::Destroy());
+
+        // Debug build logs to stdout too
+        std::istringstream lines(output);
+        std::string program_output;
+        for (std::string line; std::getline(lines, line);) {
+            if (line.rfind("[/", 0) != 0) {
+                program_output += line + "\n";
+            }
+        }
+        return program_output;
+    }
+
+    static bool Contains(const std::string &text, const std::string &substr)
+    {
+        return text.find(substr) != std::string::npos;
+    }
+};
+
+TEST_F(OptimizerTest, FoldConstants)
+{
+    std::string source = R"(
+    movif x1, 6
+    movif x2, 7
+    mul x3, x1, x2
+    movif x4, 1.5
+    convif x5, x3
+    addf x6, x5, x4
+    printi x3
+    printf x6
+    exit
+)";
+
+    std::string optimized = Optimize(source);
+    ASSERT_TRUE(Contains(optimized, "movif x3, 42"));
+    ASSERT_FALSE(Contains(optimized, "mul"));
+    ASSERT_FALSE(Contains(optimized, "addf"));
+    // Unused inputs of folded instructions are removed
+    ASSERT_FALSE(Contains(optimized, "movif x1"));
+    ASSERT_FALSE(Contains(optimized, "convif"));
+
+    ASSERT_EQ(Execute(optimized), Execute(source));
+}
+
+TEST_F(OptimizerTest, KeepDivisionByZero)
+{
+    std::string optimized = Optimize(R"(
+    movif x1, 1
+    movif x2, 0
+    div x3, x1, x2
+    exit
+)");
+    ASSERT_TRUE(Contains(optimized, "div x3, x1, x2"));
+}
+
+TEST_F(OptimizerTest, FoldBranchAndRemoveUnreachable)
+{
+    std::string source = R"(
+    movif x1, 0
+    jmp_if_imm x1, never
+    movif x2, 5
+    printi x2
+    exit
+
+never:
+    movif x2, 10
+    printi x2
+    exit
+)";
+
+    Optimizer::Stats stats;
+    std::string optimized = Optimize(source, &stats);
+    ASSERT_FALSE(Contains(optimized, "jmp_if_imm"));
+    ASSERT_FALSE(Contains(optimized, "10"));
+    ASSERT_TRUE(Contains(optimized, "never:"));
+    ASSERT_EQ(stats.n_removed_unreachable, 3);
+
+    ASSERT_EQ(Execute(optimized), Execute(source));
+}
+
+TEST_F(OptimizerTest, ThreadJumps)
+{
+    std::string source = R"(
+    movif x1, 0
+    movif x2, 1
+    movif x3, 5
+
+loop:
+    slti x4, x1, x3
+    jmp_if_imm x4, body
+    jmp_imm exit
+
+body:
+    printi x1
+    add x1, x1, x2
+    jmp_imm first
+
+first:
+    jmp_imm second
+
+second:
+    jmp_imm loop
+
+exit:
+    exit
+)";
+
+    Optimizer::Stats stats;
+    std::string optimized = Optimize(source, &stats);
+    ASSERT_TRUE(Contains(optimized, "jmp_imm loop\n"));
+    ASSERT_FALSE(Contains(optimized, "jmp_imm first"));
+    ASSERT_FALSE(Contains(optimized, "jmp_imm second"));
+    ASSERT_GT(stats.n_threaded_jumps, 0);
+
+    ASSERT_EQ(Execute(optimized), Execute(source));
+    ASSERT_EQ(Execute(optimized), "0\n1\n2\n3\n4\n");
+}
+
+TEST_F(OptimizerTest, PropagateCopies)
+{
+    std::string source = R"(
+    scani x1
+    mov x2, x1
+    mov x3, x2
+    add x4, x3, x3
+    printi x4
+    exit
+)";
+
+    std::string optimized = Optimize(source);
+    ASSERT_TRUE(Contains(optimized, "add x4, x1, x1"));
+    ASSERT_FALSE(Contains(optimized, "mov "));
+}
+
+TEST_F(OptimizerTest, RemoveUnusedObjects)
+{
+    // let f = new Foo(); f = foo[i]
+    std::string source = R"(
+.class Foo
+    int x;
+.class
+
+    movif x1, 1
+    newarr x2, Foo, x1
+    movif x3, 0
+    newobj x4, Foo
+    obj_set_field x4, Foo@x, x1
+    starr x2, x3, x4
+    newobj x5, Foo
+    larr x5, x2, x3
+    obj_get_field x6, Foo@x, x5
+    printi x6
+    exit
+)";
+
+    Optimizer::Stats stats;
+    std::string optimized = Optimize(source, &stats);
+    ASSERT_TRUE(Contains(optimized, "newobj x4, Foo"));
+    ASSERT_FALSE(Contains(optimized, "newobj x5"));
+    ASSERT_GE(stats.n_removed_dead, 1U);
+
+    ASSERT_EQ(Execute(optimized), Execute(source));
+    ASSERT_EQ(Execute(optimized), "1\n");
+}
+
+TEST_F(OptimizerTest, FunctionArgumentsAreUnknown)
+{
+    std::string source = R"(
+    movif x1, 3
+    movif x10, square
+    accr x11
+    jmp_if_imm x11, call_site
+    movif x10, square
+
+call_site:
+    call x10, x1
+    accr x2
+    printi x2
+    printi x1
+    exit
+
+square:
+    mul x1, x0, x0
+    racc x1
+    ret
+)";
+
+    Optimizer::Stats stats;
+    std::string optimized = Optimize(source, &stats);
+    // Target of call is not known statically, so it is not inlined. Caller's registers are kept during call
+    ASSERT_EQ(stats.n_inlined_calls, 0);
+    ASSERT_TRUE(Contains(optimized, "mul x1, x0, x0"));
+    ASSERT_EQ(Execute(optimized), Execute(source));
+    ASSERT_EQ(Execute(optimized), "9\n3\n");
+}
+
+TEST_F(OptimizerTest, InlineLeafFunction)
+{
+    std::string source = R"(
+    movif x0, 0
+    movif x1, 1
+    movif x2, 10
+    movif x3, 0
+    movif x10, abs_diff
+
+loop:
+    slti x4, x0, x2
+    jmp_if_imm x4, body
+    printi x3
+    exit
+
+body:
+    movif x5, 5
+    call x10, x0, x5
+    accr x6
+    add x3, x3, x6
+    add x0, x0, x1
+    jmp_imm loop
+
+abs_diff:
+    movif x4, 0
+    sub x2, x0, x1
+    slti x3, x2, x4
+    jmp_if_imm x3, negate
+    racc x2
+    ret
+
+negate:
+    sub x2, x4, x2
+    racc x2
+    ret
+)";
+
+    Optimizer::Stats stats;
+    std::string optimized = Optimize(source, &stats);
+    ASSERT_EQ(stats.n_inlined_calls, 1);
+    ASSERT_FALSE(Contains(optimized, "call"));
+    // Function is not called anymore
+    ASSERT_FALSE(Contains(optimized, "ret\n"));
+
+    ASSERT_EQ(Execute(optimized), Execute(source));
+    ASSERT_EQ(Execute(optimized), "25\n");
+}
+
+TEST_F(OptimizerTest, InlineReturnedValue)
+{
+    std::string source = R"(
+    movif x1, 6
+    movif x2, 7
+    movif x10, mul
+    call x10, x1, x2
+    accr x3
+    printi x3
+    exit
+
+mul:
+    mul x2, x0, x1
+    racc x2
+    ret
+)";
+
+    std::string optimized = Optimize(source);
+    // Arguments and returned value are propagated into the caller
+    ASSERT_TRUE(Contains(optimized, "movif x3, 42"));
+    ASSERT_FALSE(Contains(optimized, "accr"));
+    ASSERT_EQ(Execute(optimized), "42\n");
+}
+
+TEST_F(OptimizerTest, KeepCallsOfUnsuitableFunctions)
+{
+    std::string source = R"(
+    movif x1, 4
+    movif x10, uses_zero_reg
+    call x10, x1
+    accr x2
+    printi x2
+    movif x11, recursive
+    call x11, x1
+    exit
+
+uses_zero_reg:
+    add x3, x0, x5
+    racc x3
+    ret
+
+recursive:
+    movif x2, 0
+    eqi x3, x0, x2
+    jmp_if_imm x3, recursive_end
+    movif x4, 1
+    sub x0, x0, x4
+    movif x10, recursive
+    call x10, x0
+recursive_end:
+    ret
+)";
+
+    Optimizer::Stats stats;
+    std::string optimized = Optimize(source, &stats);
+    // Registers of new frame are zero and callee reads x5 which is not passed
+    ASSERT_EQ(stats.n_inlined_calls, 0);
+    ASSERT_EQ(Execute(optimized), Execute(source));
+}
+
+TEST_F(OptimizerTest, DynamicJumpsPreventOptimization)
+{
+    // Offset of jmp_if in a register skips exit, removal or insertion of instructions would change its target
+    const std::string source = R"(
+    movif x1, 1
+    movif x2, 8
+    jmp_if x1, x2
+    exit
+    printi x1
+    exit
+)";
+    ASSERT_EQ(Execute(source), "1\n");
+
+    Program program;
+    ASSERT_FALSE(program.Load(source));
+}
+
+TEST_F(OptimizerTest, OptimizedProgramIsValid)
+{
+    std::string optimized = Optimize(R"(
+.class Point
+    int x;
+    double y;
+.class
+
+    newobj x1, Point
+    movif x2, 4
+    movif x3, 3
+    add x4, x2, x3
+    obj_set_field x1, Point@x, x4
+    obj_get_field x5, Point@x, x1
+    str_immut x6, 'unused'
+    newstr x7, 'text'
+    print_str x7
+    printi x5
+    exit
+)");
+
+    file_format::File file;
+    asm2byte::AsmToByte asm2byte;
+    ASSERT_TRUE(asm2byte.ParseAsmString(optimized, &file));
+    ASSERT_FALSE(Contains(optimized, "str_immut"));
+    ASSERT_EQ(Execute(optimized), "text\n7\n");
+}
+
+} // namespace evm::opt
@@ -1,28 +1,461 @@
 #include "common/logs.h"
+#include "common/perf_counters.h"
+#include "common/trace.h"
 #include "assembler/asm2byte/asm2byte.h"
+#include "file_format/symbolizer.h"
+#include "opt/optimizer.h"
+#include "opt/program.h"
+#include "runtime/jit/jit.h"
+#include "runtime/profiler/heap_census.h"
+#include "runtime/profiler/sampling_profiler.h"
 #include "runtime/runtime.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
 namespace evm {
 
+// Program is optimized before execution, it's kept as is if it cannot be optimized
+static bool ParseOptimized(const char *path, file_format::File *file)
+{
+    std::ifstream input(path);
+    if (!input) {
+        PrintErr("Cannot open file '", path, "'");
+        return false;
+    }
+
+    std::stringstream source;
+    source << input.rdbuf();
+
+    opt::Program program;
+    std::ostringstream optimized;
+    if (program.Load(source.str())) {
+        opt::Optimizer optimizer;
+        optimizer.Run(&program);
+        program.Print(optimized);
+    } else {
+        optimized << source.str();
+    }
+
+    asm2byte::AsmToByte asm2byte;
+    return asm2byte.ParseAsmString(optimized.str(), file);
+}
+
+// Timeline keeps spans of the whole run, while the text dump only needs the last events before exit or crash
+static constexpr size_t TIMELINE_TRACE_CAPACITY = 1U << 20;
+
+static void EnableTracing(bool text_trace, bool timeline_trace)
+{
+    if (timeline_trace) {
+        uint32_t kinds = text_trace ? trace::Tracer::ALL_KINDS : trace::Tracer::TIMELINE_KINDS;
+        trace::Tracer::Enable(TIMELINE_TRACE_CAPACITY, kinds);
+    } else if (text_trace) {
+        trace::Tracer::Enable();
+    }
+    // Last events are also dumped to stderr on crash and on SIGUSR1
+    if (text_trace) {
+        trace::Tracer::InstallSignalHandlers();
+    }
+}
+
+static bool WriteTraces(file_format::File *file, const char *trace_path, const char *timeline_path)
+{
+    trace::Tracer::Disable();
+
+    if (trace_path != nullptr) {
+        int fd = open(trace_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            PrintErr("Cannot open trace file '", trace_path, "'");
+            return false;
+        }
+        trace::Tracer::Dump(fd);
+        close(fd);
+    }
+
+    if (timeline_path != nullptr) {
+        file_format::Symbolizer symbolizer(file);
+        auto pc_name = [&symbolizer](uint32_t pc) { return symbolizer.GetName(pc); };
+        if (!trace::Tracer::ExportChromeTrace(timeline_path, pc_name)) {
+            PrintErr("Cannot write trace file '", timeline_path, "'");
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool WriteProfile(file_format::File *file, const runtime::SamplingProfiler &profiler, const char *path)
+{
+    if (profiler.GetDroppedCount() != 0) {
+        PrintErr("Profile buffer is full, ", profiler.GetDroppedCount(), " samples are dropped");
+    }
+    file_format::Symbolizer symbolizer(file);
+    auto pc_name = [&symbolizer](uint32_t pc) { return symbolizer.GetName(pc); };
+    if (!profiler.WriteFoldedStacks(path, pc_name)) {
+        PrintErr("Cannot write profile file '", path, "'");
+        return false;
+    }
+    return true;
+}
+
+static bool WriteAllocationProfile(file_format::File *file, const char *path)
+{
+    file_format::Symbolizer symbolizer(file);
+    auto pc_name = [&symbolizer](uint32_t pc) { return symbolizer.GetName(pc); };
+    if (!runtime::Runtime::GetInstance()->GetAllocationProfiler()->WriteReport(path, pc_name)) {
+        PrintErr("Cannot write allocation profile '", path, "'");
+        return false;
+    }
+    return true;
+}
+
+// Censuses of all GC cycles are summarized in one line each, the one with the most live bytes is kept whole
+// together with the census at exit: the peak sizes the heap, while the last one shows what the program retains
+class HeapCensusLog {
+public:
+    void Record(const runtime::HeapCensus &census)
+    {
+        char line[160];
+        std::snprintf(line, sizeof(line), "  %8zu %10zu %12zu %10zu %12zu %8.3f\n", census.gc_cycle,
+                      census.n_live_objects, census.n_live_bytes, census.n_garbage_objects,
+                      census.free_list.free_bytes, census.GetFragmentation());
+        summary_ += line;
+        if (census.n_live_bytes >= peak_.n_live_bytes) {
+            peak_ = census;
+        }
+    }
+
+    bool Write(const char *path, const runtime::HeapCensus &last) const
+    {
+        FILE *file = std::fopen(path, "w");
+        if (file == nullptr) {
+            return false;
+        }
+        const auto &class_manager = *runtime::Runtime::GetInstance()->GetClassManager();
+        std::fprintf(file, "# %8s %10s %12s %10s %12s %8s\n", "gc_cycle", "live_objs", "live_bytes", "garbage",
+                     "free_bytes", "frag");
+        std::fprintf(file, "%s\n# Peak\n", summary_.c_str());
+        peak_.Print(file, class_manager);
+        std::fprintf(file, "\n# At exit\n");
+        last.Print(file, class_manager);
+        return std::fclose(file) == 0;
+    }
+
+private:
+    std::string summary_;
+    runtime::HeapCensus peak_;
+};
+
+// Settings of each runtime created by evm
+struct RuntimeOptions {
+    bool tail_call {false};
+    bool jit {false};
+    size_t min_heap_size {runtime::Runtime::DEFAULT_MIN_HEAP_SIZE};
+    size_t max_heap_size {runtime::Runtime::DEFAULT_MAX_HEAP_SIZE};
+};
+
+static bool CreateRuntime(const RuntimeOptions &options)
+{
+    if (!runtime::Runtime::Create(options.min_heap_size, options.max_heap_size)) {
+        PrintErr("Failed to create runtime");
+        return false;
+    }
+    if (options.tail_call) {
+        runtime::Runtime::GetInstance()->SetInterpreterEngine(runtime::Interpreter::Engine::TAIL_CALL);
+    }
+    if (options.jit) {
+        runtime::Runtime::GetInstance()->EnableJit(runtime::jit::Jit::DEFAULT_HOTNESS_THRESHOLD);
+    }
+    return true;
+}
+
+// Measurements of a single execution of the program by a new runtime
+struct BenchRun {
+    uint64_t wall_ns {0};
+    size_t n_instrs {0};
+    size_t n_allocated_bytes {0};
+    size_t n_allocated_objects {0};
+    size_t n_gc_cycles {0};
+    size_t n_gc_pauses {0};
+    uint64_t gc_pause_ns {0};
+    uint64_t max_gc_pause_ns {0};
+};
+
+// Nearest-rank percentile, values must be sorted
+template <typename T>
+static T GetPercentile(const std::vector<T> &values, double percentile)
+{
+    auto rank = static_cast<size_t>(percentile * static_cast<double>(values.size()) + 0.999999);
+    return values[std::clamp<size_t>(rank, 1, values.size()) - 1];
+}
+
+template <typename T>
+static std::vector<T> Collect(const std::vector<BenchRun> &runs, T BenchRun::*field)
+{
+    std::vector<T> values;
+    values.reserve(runs.size());
+    for (const BenchRun &run : runs) {
+        values.push_back(run.*field);
+    }
+    std::sort(values.begin(), values.end());
+    return values;
+}
+
+static bool WriteBenchReport(FILE *file, const std::vector<BenchRun> &runs, size_t n_warmup, bool tail_call,
+                             bool jit)
+{
+    std::vector<uint64_t> wall_ns = Collect(runs, &BenchRun::wall_ns);
+    uint64_t total_ns = 0;
+    for (uint64_t ns : wall_ns) {
+        total_ns += ns;
+    }
+    // Counters don't depend on timing, they differ between runs only with JIT
+    auto median = [&runs](auto field) { return GetPercentile(Collect(runs, field), 0.5); };
+
+    std::fprintf(file, "{\n  \"engine\": \"%s\",\n  \"jit\": %s,\n  \"warmup\": %zu,\n  \"runs\": %zu,\n",
+                 tail_call ? "tail_call" : "computed_goto", jit ? "true" : "false", n_warmup, runs.size());
+    std::fprintf(file,
+                 "  \"wall_ns\": {\"min\": %lu, \"median\": %lu, \"p99\": %lu, \"max\": %lu, \"mean\": %lu},\n",
+                 static_cast<unsigned long>(wall_ns.front()), static_cast<unsigned long>(GetPercentile(wall_ns, 0.5)),
+                 static_cast<unsigned long>(GetPercentile(wall_ns, 0.99)), static_cast<unsigned long>(wall_ns.back()),
+                 static_cast<unsigned long>(total_ns / wall_ns.size()));
+    std::fprintf(file, "  \"samples_ns\": [");
+    for (size_t i = 0; i < runs.size(); ++i) {
+        std::fprintf(file, "%s%lu", i == 0 ? "" : ", ", static_cast<unsigned long>(runs[i].wall_ns));
+    }
+    std::fprintf(file, "],\n");
+    std::fprintf(file, "  \"instructions\": %zu,\n  \"allocated_bytes\": %zu,\n  \"allocated_objects\": %zu,\n",
+                 median(&BenchRun::n_instrs), median(&BenchRun::n_allocated_bytes),
+                 median(&BenchRun::n_allocated_objects));
+    std::fprintf(file, "  \"gc\": {\"cycles\": %zu, \"pauses\": %zu, \"pause_ns\": %lu, \"max_pause_ns\": %lu}\n}\n",
+                 median(&BenchRun::n_gc_cycles), median(&BenchRun::n_gc_pauses),
+                 static_cast<unsigned long>(median(&BenchRun::gc_pause_ns)),
+                 static_cast<unsigned long>(Collect(runs, &BenchRun::max_gc_pause_ns).back()));
+    return std::ferror(file) == 0;
+}
+
+// Program is executed n_warmup + n_runs times, each time by a new runtime so that runs don't share heap and JIT state.
+// Only execution is timed: the file is assembled once and creation of runtimes is outside of measurements
+static bool RunBenchmark(file_format::File *file, size_t n_runs, size_t n_warmup, const RuntimeOptions &options,
+                         const char *out_path)
+{
+    std::vector<BenchRun> runs;
+    runs.reserve(n_runs);
+    for (size_t i = 0; i < n_warmup + n_runs; ++i) {
+        if (!CreateRuntime(options)) {
+            return false;
+        }
+        auto *runtime = runtime::Runtime::GetInstance();
+
+        auto begin = std::chrono::steady_clock::now();
+        runtime->Execute(file);
+        auto end = std::chrono::steady_clock::now();
+        std::fflush(stdout);
+
+        BenchRun run;
+        run.wall_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count());
+        auto gc_stats = runtime->GetGC()->GetStats();
+        run.n_instrs = gc_stats.n_instrs;
+        run.n_gc_cycles = gc_stats.n_cycles;
+        run.n_gc_pauses = gc_stats.n_pauses;
+        run.gc_pause_ns = gc_stats.pause_ns;
+        run.max_gc_pause_ns = gc_stats.max_pause_ns;
+        run.n_allocated_bytes = runtime->GetHeapManager()->GetAllocatedBytes();
+        run.n_allocated_objects = runtime->GetHeapManager()->GetAllocatedObjectsCount();
+        runtime::Runtime::Destroy();
+
+        if (i >= n_warmup) {
+            runs.push_back(run);
+        }
+    }
+
+    FILE *out = out_path != nullptr ? std::fopen(out_path, "w") : stderr;
+    if (out == nullptr) {
+        PrintErr("Cannot open benchmark report '", out_path, "'");
+        return false;
+    }
+    bool is_written = WriteBenchReport(out, runs, n_warmup, options.tail_call, options.jit);
+    if (out != stderr) {
+        is_written = std::fclose(out) == 0 && is_written;
+    }
+    if (!is_written) {
+        PrintErr("Cannot write benchmark report");
+    }
+    return is_written;
+}
+
+// Size in bytes with an optional K, M or G suffix
+static bool ParseSize(const char *str, size_t *size)
+{
+    char *end = nullptr;
+    unsigned long long value = std::strtoull(str, &end, 10);
+    if (end == str) {
+        return false;
+    }
+    switch (*end) {
+        case 'K':
+            value *= KBYTE_SIZE;
+            ++end;
+            break;
+        case 'M':
+            value *= MBYTE_SIZE;
+            ++end;
+            break;
+        case 'G':
+            value *= GBYTE_SIZE;
+            ++end;
+            break;
+        default:
+            break;
+    }
+    *size = value;
+    return *end == '\0';
+}
+
 int Main(int argc, char *argv[])
 {
-    if (argc != 2) {
-        PrintErr("Input file required");
+    bool optimize = false;
+    RuntimeOptions options;
+    bool is_heap_size_valid = true;
+    const char *trace_path = nullptr;
+    const char *timeline_path = nullptr;
+    const char *profile_path = nullptr;
+    const char *alloc_profile_path = nullptr;
+    const char *census_path = nullptr;
+    bool perf_counters = false;
+    size_t alloc_sample_interval = runtime::AllocationProfiler::DEFAULT_SAMPLE_INTERVAL;
+    size_t bench_runs = 0;
+    size_t bench_warmup = 0;
+    const char *bench_path = nullptr;
+    const char *path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "-O") == 0) {
+            optimize = true;
+        } else if (std::strcmp(argv[i], "--jit") == 0) {
+            options.jit = true;
+        } else if (std::strcmp(argv[i], "--tail-call") == 0) {
+            options.tail_call = true;
+        } else if (std::strcmp(argv[i], "--min-heap") == 0 && i + 1 < argc) {
+            is_heap_size_valid = ParseSize(argv[++i], &options.min_heap_size) && is_heap_size_valid;
+        } else if (std::strcmp(argv[i], "--max-heap") == 0 && i + 1 < argc) {
+            is_heap_size_valid = ParseSize(argv[++i], &options.max_heap_size) && is_heap_size_valid;
+        } else if (std::strcmp(argv[i], "--perf-counters") == 0) {
+            perf_counters = true;
+        } else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            trace_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--chrome-trace") == 0 && i + 1 < argc) {
+            timeline_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--profile") == 0 && i + 1 < argc) {
+            profile_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--alloc-profile") == 0 && i + 1 < argc) {
+            alloc_profile_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--heap-census") == 0 && i + 1 < argc) {
+            census_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--alloc-sample-bytes") == 0 && i + 1 < argc) {
+            alloc_sample_interval = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--bench") == 0 && i + 1 < argc) {
+            bench_runs = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--warmup") == 0 && i + 1 < argc) {
+            bench_warmup = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--bench-out") == 0 && i + 1 < argc) {
+            bench_path = argv[++i];
+        } else if (path == nullptr) {
+            path = argv[i];
+        } else {
+            path = nullptr;
+            break;
+        }
+    }
+    if (path == nullptr) {
+        PrintErr("Usage: evm [-O] [--jit] [--tail-call] [--trace <out.txt>] [--chrome-trace <out.json>] ",
+                 "[--profile <out.folded>] [--alloc-profile <out.txt> [--alloc-sample-bytes <n>]] ",
+                 "[--heap-census <out.txt>] [--perf-counters] [--min-heap <size>] [--max-heap <size>] ",
+                 "[--bench <runs> [--warmup <runs>] [--bench-out <out.json>]] <file.ea>");
+        return 1;
+    }
+    if (!is_heap_size_valid || options.min_heap_size == 0 || options.min_heap_size > options.max_heap_size) {
+        PrintErr("Heap sizes are bytes with optional K, M or G suffix, min heap must be in (0, max heap]");
+        return 1;
+    }
+    // Profiles and traces are collected by a single runtime, while benchmark creates one per run
+    bool is_profiled = trace_path != nullptr || timeline_path != nullptr || profile_path != nullptr ||
+                       alloc_profile_path != nullptr || census_path != nullptr;
+    if (bench_runs != 0 && is_profiled) {
+        PrintErr("Benchmark can't be combined with profiles and traces");
         return 1;
     }
 
-    asm2byte::AsmToByte asm2byte;
+    EnableTracing(trace_path != nullptr, timeline_path != nullptr);
+    // Program runs without counters when they aren't available
+    if (perf_counters) {
+        perf_counters = perf::PerfCounters::Enable();
+    }
+
     file_format::File file;
-    asm2byte.ParseAsmFile(argv[1], &file);
+    if (optimize) {
+        if (!ParseOptimized(path, &file)) {
+            return 1;
+        }
+    } else {
+        asm2byte::AsmToByte asm2byte;
+        asm2byte.SetParallelism(std::thread::hardware_concurrency());
+        asm2byte.ParseAsmFile(path, &file);
+    }
 
-    if (!runtime::Runtime::Create()) {
-        PrintErr("Failed to create runtime");
+    if (bench_runs != 0) {
+        bool is_finished = RunBenchmark(&file, bench_runs, bench_warmup, options, bench_path);
+        if (perf_counters) {
+            perf::PerfCounters::Disable();
+            perf::PerfCounters::Report(stderr);
+        }
+        return is_finished ? 0 : 1;
+    }
+
+    if (!CreateRuntime(options)) {
         return 1;
     }
 
+    if (alloc_profile_path != nullptr) {
+        runtime::Runtime::GetInstance()->EnableAllocationProfiler(alloc_sample_interval);
+    }
+    HeapCensusLog census_log;
+    if (census_path != nullptr) {
+        runtime::Runtime::GetInstance()->GetGC()->SetHeapCensusCallback(
+            [&census_log](const runtime::HeapCensus &census) { census_log.Record(census); });
+    }
+    runtime::SamplingProfiler profiler(profile_path != nullptr ? runtime::SamplingProfiler::DEFAULT_MAX_SAMPLES : 0);
+    if (profile_path != nullptr &&
+        !profiler.Start(&runtime::Runtime::GetInstance()->GetInterpreter()->GetPublishedCallStack())) {
+        return 1;
+    }
     runtime::Runtime::GetInstance()->Execute(&file);
+    profiler.Stop();
+
+    if (perf_counters) {
+        perf::PerfCounters::Disable();
+        perf::PerfCounters::Report(stderr);
+    }
 
-    return 0;
+    if (profile_path != nullptr && !WriteProfile(&file, profiler, profile_path)) {
+        return 1;
+    }
+    if (alloc_profile_path != nullptr && !WriteAllocationProfile(&file, alloc_profile_path)) {
+        return 1;
+    }
+    if (census_path != nullptr &&
+        !census_log.Write(census_path, runtime::Runtime::GetInstance()->GetGC()->TakeHeapCensus())) {
+        PrintErr("Cannot write heap census '", census_path, "'");
+        return 1;
+    }
+    return WriteTraces(&file, trace_path, timeline_path) ? 0 : 1;
 }
 
 } // namespace evm